@@ -0,0 +1,186 @@
+//////////////////////////////////////////////////////////////////////////
+// dist_bench.c
+//
+// Check and microbenchmark of the batch generators of the distributions
+// in src/dist.  For every distribution, the values of gen_batch() on
+// batches of 1 to PIP_GEN_BATCH seeds are checked to be identical to the
+// ones of gen() on the same seeds, and the Poisson values also to the ones
+// of pip_poisson().  The cost per value of both generators is reported,
+// with the mean and variance of the values next to the expected ones.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <math.h>
+#include <sys/time.h>
+
+#include "postgres.h"
+#include "executor/spi.h"
+
+#include "pip.h"
+
+#define SAMPLES (1 << 20)
+
+static int64  seeds[SAMPLES];
+static float8 scalar[SAMPLES];
+static float8 batch[SAMPLES];
+
+////////////////////// Stubs for the backend and the rest of pip
+
+void elog_start(const char *filename, int lineno, const char *funcname){ }
+void elog_finish(int elevel, const char *fmt,...)
+{
+  va_list ap;
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  if(elevel >= ERROR) exit(1);
+}
+
+// The parameters are set directly in the group state
+float8 dist_param_float8(HeapTupleHeader params, int n, float8 default_val)
+{
+  fprintf(stderr, "dist_param_float8() is not available in the benchmark\n");
+  exit(1);
+}
+
+// As in pip.c
+int64 pip_prng_step(int64 v)
+{
+  return pip_prng_step_inline(v);
+}
+float8 pip_prng_float(int64 *seed)
+{
+  return pip_prng_float_inline(seed);
+}
+
+////////////////////// Distributions
+
+extern pip_functable_entry normal_functable;
+extern pip_functable_entry uniform_functable;
+extern pip_functable_entry exponential_functable;
+extern pip_functable_entry poisson_functable;
+extern pip_functable_entry zero_functable;
+
+extern float8 pip_poisson(float8 lambda, int64 *seed); //dist/poisson.c
+
+typedef struct {
+  const char          *name;
+  pip_functable_entry *dist;
+  float8               params[2];
+  float8               mean, var;
+} dist_case;
+
+static dist_case cases[] = {
+  { "normal(3,2)",       &normal_functable,      { 3.0, 2.0 },  3.0, 4.0 },
+  { "uniform(-1,4)",     &uniform_functable,     { -1.0, 4.0 }, 1.5, 25.0 / 12.0 },
+  { "exponential(2)",    &exponential_functable, { 2.0 },       0.5, 0.25 },
+  { "poisson(0.5)",      &poisson_functable,     { 0.5 },       0.5, 0.5 },
+  { "poisson(20)",       &poisson_functable,     { 20.0 },      20.0, 20.0 },
+  { "zero",              &zero_functable,        { 0.0 },       0.0, 0.0 }
+};
+
+////////////////////// Benchmark driver
+
+static double get_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void bench(dist_case *c)
+{
+  union {
+    pip_var var;
+    char    space[sizeof(pip_var) + 2 * sizeof(float8)];
+  } v;
+  double start, t_scalar, t_batch, sum = 0.0, sumsq = 0.0, mean, var;
+  int i, count;
+
+  memset(&v, 0, sizeof(v));
+  memcpy(v.var.group_state, c->params, sizeof(c->params));
+
+  start = get_time();
+  for(i = 0; i < SAMPLES; i++){
+    scalar[i] = c->dist->gen(&v.var, seeds[i]);
+  }
+  t_scalar = get_time() - start;
+
+  start = get_time();
+  for(i = 0; i < SAMPLES; i += count){
+    count = (SAMPLES - i < PIP_GEN_BATCH) ? (SAMPLES - i) : PIP_GEN_BATCH;
+    c->dist->gen_batch(&v.var, seeds + i, count, batch + i);
+  }
+  t_batch = get_time() - start;
+
+  for(i = 0; i < SAMPLES; i++){
+    sum += batch[i];
+    sumsq += batch[i] * batch[i];
+  }
+  mean = sum / SAMPLES;
+  var = sumsq / SAMPLES - mean * mean;
+
+  printf("%-16s %10.1f %10.1f %10.4f %10.4f %10.4f %10.4f\n", c->name,
+         t_scalar * 1e9 / SAMPLES, t_batch * 1e9 / SAMPLES,
+         mean, c->mean, var, c->var);
+
+  for(i = 0; i < SAMPLES; i++){
+    if(batch[i] != scalar[i]){
+      fprintf(stderr, "%s: seed %d gives %.17g in a batch of %d, %.17g alone\n",
+              c->name, i, batch[i], PIP_GEN_BATCH, scalar[i]);
+      exit(1);
+    }
+  }
+
+  // The values must not depend on the size of the batch or the position in it
+  for(i = 0, count = 1; i < SAMPLES; i += count, count = count % PIP_GEN_BATCH + 1){
+    if(count > SAMPLES - i) count = SAMPLES - i;
+    c->dist->gen_batch(&v.var, seeds + i, count, batch + i);
+  }
+  for(i = 0; i < SAMPLES; i++){
+    if(batch[i] != scalar[i]){
+      fprintf(stderr, "%s: seed %d gives %.17g in a shorter batch, %.17g alone\n",
+              c->name, i, batch[i], scalar[i]);
+      exit(1);
+    }
+  }
+
+  if(c->dist == &poisson_functable){
+    for(i = 0; i < SAMPLES; i++){
+      int64 seed = seeds[i];
+      float8 expected = pip_poisson(c->params[0], &seed);
+      if(batch[i] != expected){
+        fprintf(stderr, "%s: seed %d gives %.17g, pip_poisson() gives %.17g\n",
+                c->name, i, batch[i], expected);
+        exit(1);
+      }
+    }
+  }
+
+  if(fabs(mean - c->mean) > 0.01 * (1.0 + c->mean) ||
+     fabs(var - c->var) > 0.02 * (1.0 + c->var)){
+    fprintf(stderr, "%s: the values do not follow the distribution\n", c->name);
+    exit(1);
+  }
+}
+
+int main(int argc, char **argv)
+{
+  int i;
+
+  srandom(42);
+  for(i = 0; i < SAMPLES; i++){
+    seeds[i] = ((int64)random() << 31) ^ random();
+  }
+
+  printf("%-16s %10s %10s %10s %10s %10s %10s\n", "distribution",
+         "gen ns", "batch ns", "mean", "expected", "variance", "expected");
+  for(i = 0; i < sizeof(cases) / sizeof(cases[0]); i++){
+    bench(&cases[i]);
+  }
+  return 0;
+}
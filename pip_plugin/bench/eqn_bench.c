@@ -0,0 +1,302 @@
+//////////////////////////////////////////////////////////////////////////
+// eqn_bench.c
+//
+// Microbenchmark of the two ways to sample a pip_eqn: walking the tree
+// with pip_eqn_evaluate_seed() once per sample, and running the program
+// built by pip_eqn_compile() on PIP_EQN_BATCH samples at a time.  Both are
+// run on the same seeds for equations of 4 to 128 variables (the 16 bit
+// offsets of the flattened trees do not allow much more), the cost per
+// sample is reported, and the values are checked to be identical.  The
+// same is done on the samples of a pip_sample_set, where the variables are
+// looked up in the index of the set (src/type/sample_set.c).
+//
+// The variables are generated by a cheap hash of the seed, so that the
+// numbers show the cost of the evaluators rather than the one of the
+// distributions.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "postgres.h"
+#include "executor/spi.h"
+
+#include "pip.h"
+
+#define SAMPLES (1 << 18)
+#define SET_SAMPLES (1 << 14)
+
+static int64  seeds[SAMPLES];
+static float8 interp[SAMPLES];
+static float8 compiled[SAMPLES];
+
+////////////////////// Stubs for the backend and the rest of pip
+
+MemoryContext CurrentMemoryContext = NULL;
+
+static void *bench_alloc(Size size)
+{
+  void *p = malloc(size > 0 ? size : 1);
+  if(p == NULL){
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  return p;
+}
+
+void *SPI_palloc(Size size){ return bench_alloc(size); }
+void *MemoryContextAlloc(MemoryContext context, Size size){ return bench_alloc(size); }
+void *MemoryContextAllocZero(MemoryContext context, Size size){ return memset(bench_alloc(size), 0, size); }
+void pfree(void *pointer){ free(pointer); }
+
+void elog_start(const char *filename, int lineno, const char *funcname){ }
+void elog_finish(int elevel, const char *fmt,...)
+{
+  va_list ap;
+  if(elevel < ERROR) return;
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  exit(1);
+}
+bool errstart(int elevel, const char *filename, int lineno, const char *funcname)
+{
+  fprintf(stderr, "error at %s:%d\n", filename, lineno);
+  exit(1);
+}
+void errfinish(int dummy,...){ }
+int errcode(int sqlerrcode){ return 0; }
+int errmsg(const char *fmt,...){ return 0; }
+
+static void unused(const char *name)
+{
+  fprintf(stderr, "%s() is not available in the benchmark\n", name);
+  exit(1);
+}
+
+int pip_atom_sprint(char *str, int len, pip_atom *atom){ unused(__FUNCTION__); return 0; }
+int pip_atom_parse(char *str, pip_atom **atom, int *size_ret){ unused(__FUNCTION__); return 0; }
+int pip_atom_has_var(pip_atom *atom, pip_var *var){ unused(__FUNCTION__); return 0; }
+bool pip_atom_evaluate_seed(pip_atom *atom, int64 seed){ unused(__FUNCTION__); return false; }
+bool pip_atom_evaluate_sample(pip_atom *atom, pip_sample_set *set, int sample){ unused(__FUNCTION__); return false; }
+bool pip_cset_add(pip_cset *set, void *item){ unused(__FUNCTION__); return false; }
+void pip_cset_link(pip_cset *set, void *itemA, void *itemB){ unused(__FUNCTION__); }
+int pip_var_parse(char *str, pip_var **pvar){ unused(__FUNCTION__); return 0; }
+int pip_var_sprint(char *str, int len, pip_var *pvar){ unused(__FUNCTION__); return 0; }
+bool pip_var_eq(pip_var *a, pip_var *b){ unused(__FUNCTION__); return false; }
+
+// As in pip.c and pvar.c
+int64 pip_prng_step(int64 v)
+{
+  return pip_prng_step_inline(v);
+}
+bool pip_var_id_eq(pip_var_id *a, pip_var_id *b)
+{
+  return (a->group == b->group) && (a->variable == b->variable);
+}
+
+// A value in [0, 1) that depends on the variable and the seed.
+float8 pip_var_gen_w_name_and_seed(pip_var *var, int64 seed)
+{
+  uint64 h = (uint64)(seed ^ (var->vid.variable * 0x9E3779B97F4A7C15LL));
+  h ^= h >> 33;
+  h *= 0xFF51AFD7ED558CCDLL;
+  h ^= h >> 33;
+  return (float8)(h >> 11) / (float8)(1LL << 53);
+}
+void pip_var_gen_w_name_and_seeds(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  int i;
+  for(i = 0; i < n; i++){
+    out[i] = pip_var_gen_w_name_and_seed(var, seeds[i]);
+  }
+}
+
+////////////////////// Equations
+
+static pip_eqn *make_var(int64 id)
+{
+  pip_var var;
+  memset(&var, 0, sizeof(var));
+  SET_VARSIZE(&var, sizeof(pip_var));
+  var.vid.variable = id;
+  return pip_eqn_for_var(&var);
+}
+
+// x1 + x2 + ... + xn, built left-deep like the sums of the aggregates
+static pip_eqn *make_sum(int n)
+{
+  pip_eqn *eqn = make_var(1);
+  int i;
+  for(i = 2; i <= n; i++){
+    eqn = pip_eqn_compose_ee(PIP_EQN_ADD, eqn, make_var(i));
+  }
+  return eqn;
+}
+
+// (...((x1 * 0.5 + x2) * 0.5 + x3)...) * 0.5 + xn, where the constants
+// are the left operands
+static pip_eqn *make_horner(int n)
+{
+  pip_eqn *eqn = make_var(1);
+  int i;
+  for(i = 2; i <= n; i++){
+    eqn = pip_eqn_compose_ef(PIP_EQN_MULT, eqn, 0.5);
+    eqn = pip_eqn_compose_ee(PIP_EQN_ADD, eqn, make_var(i));
+  }
+  return eqn;
+}
+
+// -(x1 + 0.5) * -(x2 + 0.5) * ... * -(xn + 0.5)
+static pip_eqn *make_factor(int64 id)
+{
+  return pip_eqn_compose_one(PIP_EQN_NEGA, pip_eqn_compose_ef(PIP_EQN_ADD, make_var(id), 0.5));
+}
+static pip_eqn *make_product(int n)
+{
+  pip_eqn *eqn = make_factor(1);
+  int i;
+  for(i = 2; i <= n; i++){
+    eqn = pip_eqn_compose_ee(PIP_EQN_MULT, eqn, make_factor(i));
+  }
+  return eqn;
+}
+
+////////////////////// Benchmark driver
+
+static double get_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static float8 sum_of(float8 *vals, int n)
+{
+  float8 sum = 0.0;
+  int i;
+  for(i = 0; i < n; i++){
+    sum += vals[i];
+  }
+  return sum;
+}
+
+static void bench(const char *name, pip_eqn *eqn, int n)
+{
+  pip_eqn_program *prog;
+  double start, sum;
+  int i, count;
+
+  sum = 0.0;
+  start = get_time();
+  for(i = 0; i < SAMPLES; i++){
+    interp[i] = pip_eqn_evaluate_seed(eqn, seeds[i]);
+    sum += interp[i];
+  }
+  printf("%-8s %6d %-10s %12.1f %16.4f\n", name, n, "interp",
+         (get_time() - start) * 1e9 / SAMPLES, sum);
+
+  sum = 0.0;
+  start = get_time();
+  prog = pip_eqn_compile(eqn);
+  for(i = 0; i < SAMPLES; i += count){
+    count = (SAMPLES - i < PIP_EQN_BATCH) ? (SAMPLES - i) : PIP_EQN_BATCH;
+    pip_eqn_program_evaluate_seeds(prog, seeds + i, count, compiled + i);
+  }
+  for(i = 0; i < SAMPLES; i++){
+    sum += compiled[i];
+  }
+  printf("%-8s %6d %-10s %12.1f %16.4f\n", name, n, "compiled",
+         (get_time() - start) * 1e9 / SAMPLES, sum);
+
+  for(i = 0; i < SAMPLES; i++){
+    if(compiled[i] != interp[i]){
+      fprintf(stderr, "%s of %d variables: sample %d is %.17g, expected %.17g\n",
+              name, n, i, compiled[i], interp[i]);
+      exit(1);
+    }
+  }
+  pip_eqn_program_free(prog);
+}
+
+// The same equation evaluated on the samples of a set that has values for
+// every other variable of the equation in two thirds of the samples, next
+// to as many variables that are not in the equation.  The variables are
+// looked up in the index of the set once per sample by the tree walk, once
+// per batch by the unbound program, and once by the program bound to the
+// set.
+static void bench_sampled(const char *name, pip_eqn *eqn, int n)
+{
+  pip_sample_set *set = pip_sample_set_create(SET_SAMPLES, 2 * n);
+  pip_eqn_program *prog;
+  double start;
+  int i, k, count, pass;
+
+  set->seed = 42;
+  for(k = 0; k < n; k++){
+    pip_var_id id;
+    id.variable = (k % 2 == 0) ? k + 1 : 1000 + k;
+    id.group = 0;
+    pip_sample_name_set(set, 2 * k + (k % 2), &id);
+    if(k % 2 == 0){
+      for(i = 0; i < SET_SAMPLES; i++){
+        if(i % 3 != 0) pip_sample_val_set_by_id(set, 2 * k, i, 0.001 * i + k);
+      }
+    }
+  }
+
+  start = get_time();
+  for(i = 0; i < SET_SAMPLES; i++){
+    interp[i] = pip_eqn_evaluate_sample(eqn, set, i);
+  }
+  printf("%-8s %6d %-10s %12.1f %16.4f\n", name, n, "set-interp",
+         (get_time() - start) * 1e9 / SET_SAMPLES, sum_of(interp, SET_SAMPLES));
+
+  prog = pip_eqn_compile(eqn);
+  for(pass = 0; pass < 2; pass++){
+    if(pass == 1) pip_eqn_program_bind(prog, set);
+    start = get_time();
+    for(i = 0; i < SET_SAMPLES; i += count){
+      count = (SET_SAMPLES - i < PIP_EQN_BATCH) ? (SET_SAMPLES - i) : PIP_EQN_BATCH;
+      pip_eqn_program_evaluate_samples(prog, set, i, count, compiled + i);
+    }
+    printf("%-8s %6d %-10s %12.1f %16.4f\n", name, n, pass ? "set-bound" : "set-lookup",
+           (get_time() - start) * 1e9 / SET_SAMPLES, sum_of(compiled, SET_SAMPLES));
+
+    for(i = 0; i < SET_SAMPLES; i++){
+      if(compiled[i] != interp[i]){
+        fprintf(stderr, "%s of %d variables on a %s set: sample %d is %.17g, expected %.17g\n",
+                name, n, pass ? "bound" : "unbound", i, compiled[i], interp[i]);
+        exit(1);
+      }
+    }
+  }
+  pip_eqn_program_free(prog);
+  pfree(set);
+}
+
+int main(int argc, char **argv)
+{
+  int n, i;
+
+  srandom(42);
+  for(i = 0; i < SAMPLES; i++){
+    seeds[i] = random();
+  }
+
+  printf("%-8s %6s %-10s %12s %16s\n", "eqn", "vars", "evaluator", "ns/sample", "sum");
+  for(n = 4; n <= 128; n *= 2){
+    bench("sum", make_sum(n), n);
+    bench("horner", make_horner(n), n);
+    bench("product", make_product(n), n);
+  }
+  for(n = 4; n <= 128; n *= 2){
+    bench_sampled("sum", make_sum(n), n);
+    bench_sampled("horner", make_horner(n), n);
+  }
+  return 0;
+}
@@ -0,0 +1,254 @@
+//////////////////////////////////////////////////////////////////////////
+// sample_set_bench.c
+//
+// Check and microbenchmark of the index from variable ids to mappings in
+// src/type/sample_set.c.  Sets of 1 to 64 mappings are named one mapping
+// at a time, so that the index is checked at every fill level of every
+// index size up to 128 entries.  After every name, all named variables
+// must be found at their mapping and variables that were not named must
+// not be found.  Sets whose variables all hash to the same slot check the
+// probing, renames check the rebuild of the index, and a name given to two
+// mappings must find the first one.  For sets of 1 to 4096 mappings, the
+// index must find the same mappings as a scan over the mappings, and the
+// cost of a lookup with both is reported.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "postgres.h"
+#include "executor/spi.h"
+
+#include "pip.h"
+
+#define MAXVARS 4096
+#define LOOKUPS (1 << 22)
+
+////////////////////// Stubs for the backend and the rest of pip
+
+static void *bench_alloc(Size size)
+{
+  void *p = malloc(size > 0 ? size : 1);
+  if(p == NULL){
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  return p;
+}
+
+void *SPI_palloc(Size size){ return bench_alloc(size); }
+void *MemoryContextAlloc(MemoryContext context, Size size){ return bench_alloc(size); }
+void pfree(void *pointer){ free(pointer); }
+
+void elog_start(const char *filename, int lineno, const char *funcname){ }
+void elog_finish(int elevel, const char *fmt,...)
+{
+  va_list ap;
+  if(elevel < ERROR) return;
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  exit(1);
+}
+
+static void unused(const char *name)
+{
+  fprintf(stderr, "%s() is not available in the benchmark\n", name);
+  exit(1);
+}
+
+bool pip_atom_evaluate_seed(pip_atom *atom, int64 seed){ unused(__FUNCTION__); return false; }
+pip_eqn_program *pip_eqn_compile(pip_eqn *eqn){ unused(__FUNCTION__); return NULL; }
+void pip_eqn_program_free(pip_eqn_program *prog){ unused(__FUNCTION__); }
+void pip_eqn_program_evaluate_seeds(pip_eqn_program *prog, int64 *seeds, int count, float8 *out){ unused(__FUNCTION__); }
+float8 pip_var_gen_w_name_and_seed(pip_var *var, int64 seed){ unused(__FUNCTION__); return 0.0; }
+void pip_var_gen_w_name_and_seeds(pip_var *var, int64 *seeds, int n, float8 *out){ unused(__FUNCTION__); }
+
+// As in pip.c and pvar.c
+int64 pip_prng_step(int64 v)
+{
+  return pip_prng_step_inline(v);
+}
+bool pip_var_id_eq(pip_var_id *a, pip_var_id *b)
+{
+  return (a->group == b->group) && (a->variable == b->variable);
+}
+
+////////////////////// Checks
+
+static pip_var_id ids[MAXVARS];
+
+static void fail(const char *what, int vars, int i)
+{
+  fprintf(stderr, "set of %d mappings: %s (mapping %d)\n", vars, what, i);
+  exit(1);
+}
+
+// The mapping found for a variable by scanning the set, like before the index
+static int scan_var_to_id(pip_sample_set *set, pip_var_id *var)
+{
+  int i;
+  for(i = 0; i < set->var_cnt; i++){
+    if(pip_sample_name_is(set, i, var)) return i;
+  }
+  return -1;
+}
+
+// Name the mappings of a set one at a time and check all lookups after
+// every name.
+static pip_sample_set *check_fill(int vars)
+{
+  pip_sample_set *set = pip_sample_set_create(1, vars);
+  pip_var_id absent;
+  int i, j;
+
+  for(i = 0; i < vars; i++){
+    pip_sample_name_set(set, i, &ids[i]);
+    for(j = 0; j < vars; j++){
+      if(pip_sample_var_to_id(set, &ids[j]) != (j <= i ? j : -1)){
+        fail(j <= i ? "a named variable is not found" : "a variable is found before it is named", vars, j);
+      }
+    }
+    absent.variable = ids[i].variable;
+    absent.group = ids[i].group + 1;
+    if(pip_sample_var_to_id(set, &absent) != -1){
+      fail("a variable of another group is found", vars, i);
+    }
+  }
+  return set;
+}
+
+// Variables whose ids all hash to the same slot of the index of a set of
+// the given size
+static void find_colliding_ids(int vars)
+{
+  pip_var_id id = { 1, 1 };
+  int n = 0, slot = -1;
+
+  // The slot of a variable is the one it takes in an empty index
+  while(n < vars){
+    pip_sample_set *empty = pip_sample_set_create(1, vars);
+    int32 *index;
+    int s;
+    pip_sample_name_set(empty, 0, &id);
+    index = (int32 *)(empty->data + empty->var_cnt * (sizeof(pip_sample_mapping) + sizeof(float8)));
+    for(s = 0; index[s] != 0; s++);
+    if(slot == -1) slot = s;
+    if(s == slot) ids[n++] = id;
+    id.variable++;
+    pfree(empty);
+  }
+}
+
+static void check_index(void)
+{
+  pip_sample_set *set;
+  pip_var_id other = { 1000000007, 3 };
+  int vars, i;
+
+  // Every fill level of every index size
+  for(vars = 1; vars <= 64; vars++){
+    for(i = 0; i < vars; i++){
+      ids[i].variable = 1 + i * 7919;
+      ids[i].group = 1 + i % 3;
+    }
+    pfree(check_fill(vars));
+  }
+
+  // All variables in the same slot
+  for(vars = 2; vars <= 32; vars *= 2){
+    find_colliding_ids(vars);
+    pfree(check_fill(vars));
+  }
+
+  // Renames rebuild the index
+  vars = 16;
+  for(i = 0; i < vars; i++){
+    ids[i].variable = 1 + i;
+    ids[i].group = 1;
+  }
+  set = check_fill(vars);
+  for(i = 0; i < vars; i += 2){
+    pip_sample_name_set(set, i, &other);
+    if(pip_sample_var_to_id(set, &other) != 0) fail("a renamed variable is not found at its first mapping", vars, i);
+    if(pip_sample_var_to_id(set, &ids[i]) != -1) fail("the old name of a renamed mapping is found", vars, i);
+    if(i + 1 < vars && pip_sample_var_to_id(set, &ids[i + 1]) != i + 1) fail("a variable is lost by a rename", vars, i + 1);
+  }
+
+  // A name of two mappings finds the first one, whichever is named first
+  pip_sample_name_set(set, 5, &ids[3]);
+  if(pip_sample_var_to_id(set, &ids[3]) != 3) fail("a name of two mappings does not find the first", vars, 3);
+  pip_sample_name_set(set, 3, &ids[1]);
+  if(pip_sample_var_to_id(set, &ids[3]) != 5) fail("a name left on one mapping is not found", vars, 5);
+  if(pip_sample_var_to_id(set, &ids[1]) != 1) fail("a name of two mappings does not find the first", vars, 1);
+  pfree(set);
+}
+
+////////////////////// Benchmark driver
+
+static double get_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void bench(int vars)
+{
+  pip_sample_set *set = pip_sample_set_create(1, vars);
+  double start, t_index, t_scan;
+  int64 found = 0;
+  int i, lookups = LOOKUPS / vars;
+
+  for(i = 0; i < vars; i++){
+    ids[i].variable = 1 + (int64)i * 104729;
+    ids[i].group = 1;
+    pip_sample_name_set(set, i, &ids[i]);
+  }
+
+  // Half of the lookups are for variables that are not in the set
+  for(i = 0; i < 2 * vars; i++){
+    pip_var_id id = ids[i / 2];
+    id.group = 1 + (i & 1);
+    if(pip_sample_var_to_id(set, &id) != scan_var_to_id(set, &id)){
+      fail("the index and the scan find different mappings", vars, i / 2);
+    }
+  }
+
+  start = get_time();
+  for(i = 0; i < LOOKUPS; i++){
+    pip_var_id id = ids[i % vars];
+    id.group = 1 + (i & 1);
+    found += pip_sample_var_to_id(set, &id);
+  }
+  t_index = get_time() - start;
+
+  start = get_time();
+  for(i = 0; i < lookups; i++){
+    pip_var_id id = ids[i % vars];
+    id.group = 1 + (i & 1);
+    found += scan_var_to_id(set, &id);
+  }
+  t_scan = get_time() - start;
+
+  printf("%8d %14.1f %14.1f %16lld\n", vars, t_index * 1e9 / LOOKUPS, t_scan * 1e9 / lookups,
+         (long long)found);
+  pfree(set);
+}
+
+int main(int argc, char **argv)
+{
+  int vars;
+
+  check_index();
+
+  printf("%8s %14s %14s %16s\n", "mappings", "index ns", "scan ns", "sum");
+  for(vars = 1; vars <= MAXVARS; vars *= 4){
+    bench(vars);
+  }
+  return 0;
+}
@@ -0,0 +1,318 @@
+//////////////////////////////////////////////////////////////////////////
+// world_presence_bench.c
+//
+// Check and microbenchmark of the bit array kernels of world presences in
+// src/type/world_presence.c.  The count, the OR, and the masks built by
+// the value bundle comparisons (AND) and by conf_naive_g (OR) are checked
+// against the bit at a time loops they replaced, for every world count
+// from 0 to 1100 and for larger counts that are not a multiple of 8 or of
+// 64, at every byte offset from an 8 byte boundary.  The bits past the
+// last world are set, and must not be counted, and the bytes around the
+// bit arrays must not be written.  The cost per 1000 worlds of both paths
+// is reported.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "postgres.h"
+#include "executor/spi.h"
+
+#include "pip.h"
+
+#define MAXWORLDS ((1 << 20) + 13)
+#define MAXBYTES  PIP_WORLD_BYTES(MAXWORLDS)
+#define GUARD     8
+#define GUARD_BYTE 0xa5
+// As PIP_WORLD_CMP_BATCH in src/funcs/pip_value_bundle.c
+#define MASK_BATCH 512
+#define BENCH_WORLDS (1 << 20)
+#define BENCH_ROUNDS 20
+
+////////////////////// Stubs for the backend
+
+void *SPI_palloc(Size size)
+{
+  void *p = malloc(size > 0 ? size : 1);
+  if(p == NULL){
+    fprintf(stderr, "out of memory\n");
+    exit(1);
+  }
+  return p;
+}
+
+void elog_start(const char *filename, int lineno, const char *funcname){ }
+void elog_finish(int elevel, const char *fmt,...)
+{
+  va_list ap;
+  if(elevel < ERROR) return;
+  va_start(ap, fmt);
+  vfprintf(stderr, fmt, ap);
+  va_end(ap);
+  fputc('\n', stderr);
+  exit(1);
+}
+
+////////////////////// The bit at a time loops
+
+#define GET_BIT(bits, i) (((bits)[(i)/8] >> (7-((i)%8))) & 0x01)
+#define SET_BIT(bits, i) ((bits)[(i)/8] |= (1 << (7-((i)%8))))
+#define UNSET_BIT(bits, i) ((bits)[(i)/8] &= ((~(1 << (7-((i)%8))))&0xff))
+
+static int bit_count(const unsigned char *bits, int worldcount)
+{
+  int i, cnt = 0;
+  for(i = 0; i < worldcount; i++){
+    cnt += GET_BIT(bits, i);
+  }
+  return cnt;
+}
+
+static void bit_or(unsigned char *bits, const unsigned char *other, int worldcount)
+{
+  int i;
+  for(i = 0; i < worldcount; i++){
+    if(GET_BIT(other, i)) SET_BIT(bits, i);
+  }
+}
+
+// The value bundle comparisons: worlds that are not kept are removed
+static void bit_keep(unsigned char *bits, const bool *keep, int worldcount)
+{
+  int i;
+  for(i = 0; i < worldcount; i++){
+    if(!keep[i]) UNSET_BIT(bits, i);
+  }
+}
+
+// conf_naive_g: worlds that fail are added
+static void bit_fail(unsigned char *bits, const bool *fails, int worldcount)
+{
+  int i;
+  for(i = 0; i < worldcount; i++){
+    if(fails[i]) SET_BIT(bits, i);
+  }
+}
+
+////////////////////// The word at a time path, as in src/funcs
+
+static void word_keep(unsigned char *bits, const bool *keep, int worldcount)
+{
+  unsigned char mask[MASK_BATCH/8];
+  int first, n;
+  for(first = 0; first < worldcount; first += MASK_BATCH){
+    n = Min(MASK_BATCH, worldcount - first);
+    pip_world_bits_pack(keep + first, n, true, mask);
+    pip_world_bits_and(bits + first/8, mask, PIP_WORLD_BYTES(n));
+  }
+}
+
+static void word_fail(unsigned char *bits, const bool *fails, int worldcount)
+{
+  unsigned char *mask = SPI_palloc(PIP_WORLD_BYTES(worldcount));
+  pip_world_bits_pack(fails, worldcount, false, mask);
+  pip_world_bits_or(bits, mask, PIP_WORLD_BYTES(worldcount));
+  free(mask);
+}
+
+////////////////////// Checks
+
+static unsigned char space_a[MAXBYTES + 2 * GUARD + 8];
+static unsigned char space_b[MAXBYTES + 2 * GUARD + 8];
+static unsigned char space_ref[MAXBYTES + 2 * GUARD + 8];
+static bool          vals[MAXWORLDS];
+
+static void fail(const char *what, int worldcount, int offset)
+{
+  fprintf(stderr, "%d worlds at offset %d: %s\n", worldcount, offset, what);
+  exit(1);
+}
+
+// Random bits with the bits past the last world set, and guard bytes
+// around them
+static void fill(unsigned char *space, int offset, int worldcount)
+{
+  unsigned char *bits = space + GUARD + offset;
+  int i, nbytes = PIP_WORLD_BYTES(worldcount);
+  memset(space, GUARD_BYTE, MAXBYTES + 2 * GUARD + 8);
+  for(i = 0; i < nbytes; i++){
+    bits[i] = random();
+  }
+  if(worldcount % 8){
+    bits[nbytes - 1] |= 0xff >> (worldcount % 8);
+  }
+}
+
+static void check_guards(unsigned char *space, int offset, int worldcount, const char *what)
+{
+  unsigned char *bits = space + GUARD + offset;
+  int i, nbytes = PIP_WORLD_BYTES(worldcount);
+  for(i = 0; i < GUARD + offset; i++){
+    if(space[i] != GUARD_BYTE) fail(what, worldcount, offset);
+  }
+  for(i = 0; i < GUARD; i++){
+    if(bits[nbytes + i] != GUARD_BYTE) fail(what, worldcount, offset);
+  }
+}
+
+static void check_same(unsigned char *a, unsigned char *b, int offset, int worldcount, const char *what)
+{
+  int i;
+  for(i = 0; i < worldcount; i++){
+    if(GET_BIT(a + GUARD + offset, i) != GET_BIT(b + GUARD + offset, i)){
+      fprintf(stderr, "world %d differs\n", i);
+      fail(what, worldcount, offset);
+    }
+  }
+  check_guards(a, offset, worldcount, what);
+}
+
+static void check(int worldcount, int offset)
+{
+  unsigned char *a = space_a + GUARD + offset;
+  unsigned char *b = space_b + GUARD + offset;
+  unsigned char *ref = space_ref + GUARD + offset;
+  int i, nbytes = PIP_WORLD_BYTES(worldcount);
+
+  fill(space_a, offset, worldcount);
+  fill(space_b, offset, worldcount);
+  if(pip_world_bits_count(a, worldcount) != bit_count(a, worldcount)){
+    fail("the counts differ", worldcount, offset);
+  }
+
+  memcpy(space_ref, space_a, sizeof(space_ref));
+  bit_or(ref, b, worldcount);
+  pip_world_bits_or(a, b, nbytes);
+  check_same(space_a, space_ref, offset, worldcount, "the ORs differ");
+  if(pip_world_bits_count(a, worldcount) != bit_count(ref, worldcount)){
+    fail("the counts after an OR differ", worldcount, offset);
+  }
+
+  // About a third of the worlds are kept or fail
+  for(i = 0; i < worldcount; i++){
+    vals[i] = (random() % 3) == 0;
+  }
+
+  fill(space_a, offset, worldcount);
+  memcpy(space_ref, space_a, sizeof(space_ref));
+  bit_keep(ref, vals, worldcount);
+  word_keep(a, vals, worldcount);
+  check_same(space_a, space_ref, offset, worldcount, "the comparison masks differ");
+
+  fill(space_a, offset, worldcount);
+  memcpy(space_ref, space_a, sizeof(space_ref));
+  bit_fail(ref, vals, worldcount);
+  word_fail(a, vals, worldcount);
+  check_same(space_a, space_ref, offset, worldcount, "the conf_naive_g masks differ");
+}
+
+static void check_kernels(void)
+{
+  static const int large[] = { 4095, 4097, 65535, 65536 + 37, MAXWORLDS };
+  pip_world_presence *wp;
+  int worldcount, offset, i;
+
+  for(worldcount = 0; worldcount <= 1100; worldcount++){
+    for(offset = 0; offset < 8; offset++){
+      check(worldcount, offset);
+    }
+  }
+  for(i = 0; i < sizeof(large) / sizeof(large[0]); i++){
+    for(offset = 0; offset < 8; offset += 3){
+      check(large[i], offset);
+    }
+  }
+
+  // A new world presence has the bits past the last world set too
+  for(worldcount = 0; worldcount <= 200; worldcount++){
+    wp = pip_world_presence_alloc(worldcount, true);
+    if(pip_world_bits_count(wp->data, wp->worldcount) != worldcount){
+      fail("a new world presence does not have all worlds", worldcount, 0);
+    }
+    free(wp);
+    wp = pip_world_presence_alloc(worldcount, false);
+    if(pip_world_bits_count(wp->data, wp->worldcount) != 0){
+      fail("a new empty world presence has worlds", worldcount, 0);
+    }
+    free(wp);
+  }
+}
+
+////////////////////// Benchmark driver
+
+static double get_time(void)
+{
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void report(const char *name, double t_bit, double t_word, long long sum)
+{
+  double per = 1000.0 / ((double)BENCH_WORLDS * BENCH_ROUNDS);
+  printf("%-12s %14.1f %14.1f %12lld\n", name, t_bit * 1e9 * per, t_word * 1e9 * per, sum);
+}
+
+static void bench(void)
+{
+  unsigned char *a = space_a + GUARD + 4;
+  unsigned char *b = space_b + GUARD + 4;
+  int worldcount = BENCH_WORLDS + 5;
+  int nbytes = PIP_WORLD_BYTES(worldcount);
+  double start, t_bit, t_word;
+  long long sum = 0;
+  int r, i;
+
+  // World presences out of a tuple are int but not 8 byte aligned
+  fill(space_a, 4, worldcount);
+  fill(space_b, 4, worldcount);
+  for(i = 0; i < worldcount; i++){
+    vals[i] = (random() % 3) != 0;
+  }
+
+  printf("%-12s %14s %14s %12s\n", "kernel", "bit ns/1000", "word ns/1000", "sum");
+
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) sum += bit_count(a, worldcount);
+  t_bit = get_time() - start;
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) sum += pip_world_bits_count(a, worldcount);
+  t_word = get_time() - start;
+  report("count", t_bit, t_word, sum);
+
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) bit_or(a, b, worldcount);
+  t_bit = get_time() - start;
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) pip_world_bits_or(a, b, nbytes);
+  t_word = get_time() - start;
+  report("or", t_bit, t_word, pip_world_bits_count(a, worldcount));
+
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) bit_keep(a, vals, worldcount);
+  t_bit = get_time() - start;
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) word_keep(a, vals, worldcount);
+  t_word = get_time() - start;
+  report("comparison", t_bit, t_word, pip_world_bits_count(a, worldcount));
+
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) bit_fail(a, vals, worldcount);
+  t_bit = get_time() - start;
+  start = get_time();
+  for(r = 0; r < BENCH_ROUNDS; r++) word_fail(a, vals, worldcount);
+  t_word = get_time() - start;
+  report("conf_naive_g", t_bit, t_word, pip_world_bits_count(a, worldcount));
+}
+
+int main(int argc, char **argv)
+{
+  srandom(42);
+  check_kernels();
+  bench();
+  return 0;
+}
@@ -12,6 +12,7 @@
 
 void    pip_exponential_init (pip_var *var, HeapTupleHeader params);
 float8  pip_exponential_gen  (pip_var *var, int64 seed);
+void    pip_exponential_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out);
 float8  pip_exponential_pdf  (pip_var *var, float8 point);
 float8  pip_exponential_cdf  (pip_var *var, float8 point);
 float8  pip_exponential_icdf (pip_var *var, float8 point);
@@ -23,6 +24,7 @@ DECLARE_PIP_DISTRIBUTION(exponential) = {
   .size = sizeof(float8),
   .init= &pip_exponential_init,
   .gen = &pip_exponential_gen,
+  .gen_batch = &pip_exponential_gen_batch,
   .pdf = &pip_exponential_pdf,
   .cdf = &pip_exponential_cdf,
   .icdf= &pip_exponential_icdf,
@@ -37,7 +39,19 @@ void    pip_exponential_init (pip_var *var, HeapTupleHeader params)
 }
 float8  pip_exponential_gen  (pip_var *var, int64 seed)
 {
-  return pip_exponential_icdf(var, pip_prng_float(&seed));
+  float8 ret;
+  pip_exponential_gen_batch(var, &seed, 1, &ret);
+  return ret;
+}
+//inlines pip_exponential_icdf()
+void    pip_exponential_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  float8 lambda = ((float8 *)var->group_state)[0];
+  int i;
+  for(i = 0; i < n; i++){
+    int64 seed = seeds[i];
+    out[i] = - log(1 - pip_prng_float_inline(&seed)) / lambda;
+  }
 }
 float8  pip_exponential_pdf  (pip_var *var, float8 point)
 {
@@ -16,6 +16,7 @@
 
 void    pip_normal_init (pip_var *var, HeapTupleHeader params);
 float8  pip_normal_gen  (pip_var *var, int64 seed);
+void    pip_normal_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out);
 float8  pip_normal_pdf  (pip_var *var, float8 point);
 float8  pip_normal_cdf  (pip_var *var, float8 point);
 float8  pip_normal_icdf (pip_var *var, float8 point);
@@ -27,6 +28,7 @@ DECLARE_PIP_DISTRIBUTION(normal) = {
   .size = sizeof(float8) * 2,
   .init= &pip_normal_init,
   .gen = &pip_normal_gen,
+  .gen_batch = &pip_normal_gen_batch,
   .pdf = &pip_normal_pdf,
   .cdf = &pip_normal_cdf,
   .icdf= &pip_normal_icdf,
@@ -65,10 +67,26 @@ void    pip_normal_init (pip_var *var, HeapTupleHeader params)
 }
 float8  pip_normal_gen  (pip_var *var, int64 seed)
 {
-  float8 X, Y;
-  pip_box_muller(&X, &Y, &seed);
-  // value = Normal(0,1) * stddev + mean
-  return (X * ((float8 *)var->group_state)[1]) + ((float8 *)var->group_state)[0];  
+  float8 ret;
+  pip_normal_gen_batch(var, &seed, 1, &ret);
+  return ret;
+}
+void    pip_normal_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  float8 mean   = ((float8 *)var->group_state)[0];
+  float8 stddev = ((float8 *)var->group_state)[1];
+  int i;
+  //Variables are generated from one seed each, so there is no use for the
+  //second value of a pair.  Instead of the polar form with its rejection
+  //loop, use the basic form of the Box-Muller transform, which takes a fixed
+  //two steps of the prng per value.  u is in (0, 1] to keep log(u) finite.
+  for(i = 0; i < n; i++){
+    int64  seed = pip_prng_step_inline(seeds[i]);
+    float8 u = ((float8)(seed & RANDOM_MAX) + 1.0) / ((float8)RANDOM_MAX + 1.0);
+    float8 v = pip_prng_float_inline(&seed);
+    // value = Normal(0,1) * stddev + mean
+    out[i] = (sqrt(-2.0 * log(u)) * cos(2.0 * M_PI * v)) * stddev + mean;
+  }
 }
 float8  pip_normal_pdf  (pip_var *var, float8 point)
 {
@@ -13,6 +13,7 @@ static float8 gammln(const float8 xx);
 float8  pip_poisson(float8 lambda, int64 *seed);
 void    pip_poisson_init (pip_var *var, HeapTupleHeader params);
 float8  pip_poisson_gen  (pip_var *var, int64 seed);
+void    pip_poisson_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out);
 float8  pip_poisson_pdf  (pip_var *var, float8 point);
 int pip_poisson_in   (pip_var *var, char *str);
 int pip_poisson_out  (pip_var *var, int len, char *str);
@@ -22,6 +23,7 @@ DECLARE_PIP_DISTRIBUTION(poisson) = {
   .size = sizeof(float8),
   .init= &pip_poisson_init,
   .gen = &pip_poisson_gen,
+  .gen_batch = &pip_poisson_gen_batch,
   .pdf = &pip_poisson_pdf,
   .cdf = NULL,
   .icdf= NULL,
@@ -81,7 +83,24 @@ void    pip_poisson_init (pip_var *var, HeapTupleHeader params)
 }
 float8  pip_poisson_gen  (pip_var *var, int64 seed)
 {
-  return pip_poisson(*((float8 *)var->group_state), &seed);
+  float8 ret;
+  pip_poisson_gen_batch(var, &seed, 1, &ret);
+  return ret;
+}
+//pip_poisson() with exp(-lambda) computed once for the batch
+void    pip_poisson_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  float8 L = exp(-*((float8 *)var->group_state));
+  int i;
+  for(i = 0; i < n; i++){
+    int64 seed = seeds[i];
+    float8 k = 0, p = 1;
+    while(p >= L){
+      k += 1.0;
+      p *= pip_prng_float_inline(&seed);
+    }
+    out[i] = k-1;
+  }
 }
 float8  pip_poisson_pdf  (pip_var *var, float8 point)
 {
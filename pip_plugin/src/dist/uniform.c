@@ -12,6 +12,7 @@
 
 void    pip_uniform_init (pip_var *var, HeapTupleHeader params);
 float8  pip_uniform_gen  (pip_var *var, int64 seed);
+void    pip_uniform_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out);
 float8  pip_uniform_pdf  (pip_var *var, float8 point);
 float8  pip_uniform_cdf  (pip_var *var, float8 point);
 float8  pip_uniform_icdf (pip_var *var, float8 point);
@@ -23,6 +24,7 @@ DECLARE_PIP_DISTRIBUTION(uniform) = {
   .size = sizeof(float8) * 2,
   .init= &pip_uniform_init,
   .gen = &pip_uniform_gen,
+  .gen_batch = &pip_uniform_gen_batch,
   .pdf = &pip_uniform_pdf,
   .cdf = &pip_uniform_cdf,
   .icdf= &pip_uniform_icdf,
@@ -45,11 +47,21 @@ void    pip_uniform_init (pip_var *var, HeapTupleHeader params)
 }
 float8  pip_uniform_gen  (pip_var *var, int64 seed)
 {
-  double rng = pip_prng_float(&seed);
-  double ret = ((float8 *)var->group_state)[0] + rng * ( ((float8 *)var->group_state)[1] - ((float8 *)var->group_state)[0] );
-//  elog(NOTICE, "Generating Uniform: [%lf, %lf](%lf) = %lf", ((float8 *)var->group_state)[0], ((float8 *)var->group_state)[1], rng, ret);
+  float8 ret;
+  pip_uniform_gen_batch(var, &seed, 1, &ret);
+//  elog(NOTICE, "Generating Uniform: [%lf, %lf] = %lf", ((float8 *)var->group_state)[0], ((float8 *)var->group_state)[1], ret);
   return ret;
 }
+void    pip_uniform_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  float8 low   = ((float8 *)var->group_state)[0];
+  float8 width = ((float8 *)var->group_state)[1] - low;
+  int i;
+  for(i = 0; i < n; i++){
+    int64 seed = seeds[i];
+    out[i] = low + pip_prng_float_inline(&seed) * width;
+  }
+}
 float8  pip_uniform_pdf  (pip_var *var, float8 point)
 {
   if( (point >= ((float8 *)var->group_state)[1]) || (point <= ((float8 *)var->group_state)[0]) ) { 
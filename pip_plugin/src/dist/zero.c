@@ -2,6 +2,7 @@
 #include "pip.h"
 
 float8  pip_zero_gen  (pip_var *var, int64 seed);
+void    pip_zero_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out);
 float8  pip_zero_pdf  (pip_var *var, float8 point);
 
 //the script gen_disttable.sh treats this file specially, as the zero distribution must be at index 0
@@ -11,6 +12,7 @@ DECLARE_PIP_DISTRIBUTION(zero) = {
   .size = 0,
   .init= NULL,
   .gen = &pip_zero_gen,
+  .gen_batch = &pip_zero_gen_batch,
   .pdf = &pip_zero_pdf,
   .cdf = NULL,
   .icdf= NULL,
@@ -23,6 +25,13 @@ float8  pip_zero_gen  (pip_var *var, int64 seed)
 {
   return 0.0;
 }
+void    pip_zero_gen_batch(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  int i;
+  for(i = 0; i < n; i++){
+    out[i] = 0.0;
+  }
+}
 float8  pip_zero_pdf  (pip_var *var, float8 point)
 {
   return ( point == 0.0 ) ? ( 1.0 ) : ( 0.0 );
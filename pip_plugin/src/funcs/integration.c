@@ -17,10 +17,8 @@ Datum   conf_one (PG_FUNCTION_ARGS)
   pip_atom        **atoms = NULL;
   float8            result;
   
-  //SPI_connect();
-  atom_count = pip_extract_clause(row, &atoms);
+  atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   result = pip_compute_independent_probability(atom_count, atoms, samples);
-  //SPI_finish();
   
 	PG_RETURN_FLOAT8(result);
 }
@@ -33,57 +31,58 @@ Datum   pip_atom_conf_sample_g(PG_FUNCTION_ARGS)
   pip_sample_set   *samples = (pip_sample_set *)PG_GETARG_BYTEA_P(2);
   int               atom_count = 0;
   pip_atom        **atoms = NULL;
+  bool             *holds;
   int i;
   
-  SPI_connect();
-
-  atom_count = pip_extract_clause(row, &atoms);
+  atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
+  holds = palloc(sizeof(bool) * (samples->sample_cnt > 0 ? samples->sample_cnt : 1));
+  pip_sample_test_clause_all(samples, atom_count, atoms, holds);
 
   for(i = 0; i < samples->sample_cnt; i++){
-    if(pip_sample_test_clause(samples, i, atom_count, atoms)){
+    if(holds[i]){
       if(!pip_conf_tally_up(tally, samples->ssid, i)){
         tally = pip_conf_tally_addgroup(tally, samples->ssid, samples->sample_cnt);
         pip_conf_tally_up(tally, samples->ssid, i);
       }
     }
   }
-  
-  SPI_finish();
+  pfree(holds);
   
   PG_RETURN_POINTER(tally);
 }
 
 Datum   pip_atom_sample_set_presence(PG_FUNCTION_ARGS)
 {
-  pip_world_presence     *wp = (pip_world_presence *)PG_GETARG_BYTEA_P(0);
+  pip_world_presence     *wp = PIP_GETARG_WORLD_PRESENCE_FOR_UPDATE(0);
   HeapTupleHeader         row = PG_GETARG_HEAPTUPLEHEADER(1);
   pip_sample_set         *set = (pip_sample_set *)PG_GETARG_BYTEA_P(2);
   pip_atom              **clause = NULL;
   int                     clause_cnt;
-  int                     i, success = 0;
+  int                     i;
+  bool                   *fails;
+  unsigned char          *mask;
   
-  clause_cnt = pip_extract_clause(row, &clause);
+  clause_cnt = pip_extract_clause(fcinfo->flinfo, row, &clause);
+  fails = palloc(sizeof(bool) * (set->sample_cnt > 0 ? set->sample_cnt : 1));
+  pip_sample_test_clause_all(set, clause_cnt, clause, fails);
+  for(i = 0; i < set->sample_cnt; i++){
+    fails[i] = !fails[i];
+  }
 
   if(wp->worldcount < set->sample_cnt){
     pip_world_presence *wp_old = wp;
-    int len = set->sample_cnt;
-    wp = palloc0(sizeof(pip_world_presence) + (len+7)/8);
-    SET_VARSIZE(wp, sizeof(pip_world_presence) + (len+7)/8);
-    wp->worldcount = len;
+    wp = pip_world_presence_alloc(set->sample_cnt, false);
     //    elog(NOTICE, "Need to increase world size! %d->%d", wp_old->worldcount, wp->worldcount);
-    memcpy(wp->data, wp_old->data, (wp_old->worldcount+7)/8);
+    memcpy(wp->data, wp_old->data, PIP_WORLD_BYTES(wp_old->worldcount));
   }
   
-  for(i = 0; i < set->sample_cnt; i++){
-    if(pip_sample_test_clause(set, i, clause_cnt, clause)) {
-      continue;
-    }
-    success ++;
-    wp->data[i/8] |= 1 << (7 - (i%8));
-  }
+  //mark the worlds where the clause fails
+  mask = palloc(PIP_WORLD_BYTES(set->sample_cnt) > 0 ? PIP_WORLD_BYTES(set->sample_cnt) : 1);
+  pip_world_bits_pack(fails, set->sample_cnt, false, mask);
+  pip_world_bits_or(wp->data, mask, PIP_WORLD_BYTES(set->sample_cnt));
+  pfree(mask);
+  pfree(fails);
 
-  //elog(NOTICE, "finished clause scanning: (%d,%d) Result %d:%d / %d", wp->worldcount, set->sample_cnt, success, tot_success,set->sample_cnt * clause_cnt);
-  
   PG_RETURN_POINTER(wp);
 }
 
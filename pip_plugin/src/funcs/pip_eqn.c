@@ -49,10 +49,8 @@ Datum   pip_expectation (PG_FUNCTION_ARGS)
   int             atom_count = 0;
   pip_atom      **atoms = NULL;
   
-  SPI_connect();
-  atom_count = pip_extract_clause(row, &atoms);
+  atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   result = pip_compute_expectation(eqn, atom_count, atoms, samples);
-  SPI_finish();
   
   PG_RETURN_FLOAT8(result);
 }
@@ -65,12 +63,10 @@ Datum   pip_expectation_max_g (PG_FUNCTION_ARGS)
   int                 atom_count = 0;
   pip_atom          **atoms = NULL; 
   
-  SPI_connect();
   if(row){
-    atom_count = pip_extract_clause(row, &atoms);
+    atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   }
   set = pip_sample_set_vector_max(eqn, set, atom_count, atoms);
-  SPI_finish();
   
   PG_RETURN_POINTER(set);
 }
@@ -97,7 +93,7 @@ Datum   pip_expectation_max_g_one (PG_FUNCTION_ARGS)
 //      elog(ERROR, "----- %d", state->count);
     
     if(row){
-      atom_count = pip_extract_clause(row, &atoms);
+      atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
     }
     prob = pip_compute_conditioned_probability(state, atom_count, atoms, 1000);
     if(isnan(state->probability)){
@@ -145,12 +141,10 @@ Datum   pip_expectation_sum_g (PG_FUNCTION_ARGS)
   
   //log_eqn("Expect Sum", eqn->data);
 
-  SPI_connect();
   if(row){
-    atom_count = pip_extract_clause(row, &atoms);
+    atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   }
   set = pip_sample_set_vector_sum(eqn, set, atom_count, atoms);
-  SPI_finish();
   
   PG_RETURN_POINTER(set);
 }
@@ -163,14 +157,8 @@ Datum   pip_expectation_sum_g_one (PG_FUNCTION_ARGS)
   int                 atom_count = 0;
   pip_atom          **atoms = NULL;
   
-  DPING();
-  SPI_connect();
-  DPING();
-  atom_count = pip_extract_clause(row, &atoms);
-  DPING();
+  atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   val += pip_compute_expectation(eqn, atom_count, atoms, samples);
-  DPING();
-  SPI_finish();
   
   PG_RETURN_FLOAT8(val);
 }
@@ -396,10 +384,9 @@ Datum   pip_eqn_compile_sum (PG_FUNCTION_ARGS)
   int                 size = VARSIZE(right) - sizeof(pip_eqn);
   int                 i;
   
-  SPI_connect();
   if(fcinfo->nargs > 2){
     row = PG_GETARG_HEAPTUPLEHEADER(2);
-    atom_count = pip_extract_clause(row, &atoms);
+    atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
     for(i = 0; i < atom_count; i++){
       size += sizeof(pip_eqn_component) + VARSIZE(atoms[i]);
     }
@@ -415,8 +402,6 @@ Datum   pip_eqn_compile_sum (PG_FUNCTION_ARGS)
   
   memcpy(DEREF_CMPNT(left->data, size), right->data, VARSIZE(right) - sizeof(pip_eqn));
   pip_eqn_cmpnt_update_pointers(left->data+size, 0, size);
-
-  SPI_finish();
   
   PG_RETURN_POINTER(left);
 }
@@ -77,10 +77,8 @@ Datum  pip_exp_fix (PG_FUNCTION_ARGS)
   int              atom_count = 0;
   pip_atom       **atoms = NULL;
   
-  SPI_connect();
-  atom_count = pip_extract_clause(row, &atoms);
+  atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
   result = pip_compute_expectation(&exp->val.eqn, atom_count, atoms, 1000);
-  SPI_finish();
 
   ret = palloc0(sizeof(pip_exp));
   ret->type = PIP_EXP_FIX;
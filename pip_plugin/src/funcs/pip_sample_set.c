@@ -105,12 +105,9 @@ Datum   pip_sample_set_generate(PG_FUNCTION_ARGS)
   
   if(sample_count > 0){
   
-    SPI_connect();
-    
-    atom_count = pip_extract_clause(row, &atoms);
+    atom_count = pip_extract_clause(fcinfo->flinfo, row, &atoms);
     samples =    pip_sample_by_clause(atom_count, atoms, sample_count, NULL);
     
-    SPI_finish();
     PG_RETURN_POINTER(samples);
     
   } else {
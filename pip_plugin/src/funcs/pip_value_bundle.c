@@ -76,13 +76,22 @@ Datum   pip_value_bundle_create  (PG_FUNCTION_ARGS)
   PG_RETURN_POINTER(valbundle);
 }
 
-#define UNSET_WORLDBIT(i) wp->data[i/8] &= ((~(1 << (7-(i%8))))&0xff)
-#define MIN(a,b) ((a > b) ? (b) : (a))
+// Worlds where left_val <= right_val are removed from the world presence.
+// The comparisons of PIP_WORLD_CMP_BATCH worlds are packed into a mask
+// that is then ANDed into the world presence a word at a time.
+#define PIP_WORLD_CMP_BATCH 512
 
 #define CMP_FUNC(left_val,right_val) \
-  pip_world_presence *wp = (pip_world_presence *)PG_GETARG_BYTEA_P_COPY(0);\
-  int                 i;\
-  for(i = 0; i < wp->worldcount; i++) { if(left_val <= right_val) { UNSET_WORLDBIT(i); }}\
+  pip_world_presence *wp = PIP_GETARG_WORLD_PRESENCE_FOR_UPDATE(0);\
+  bool                keep[PIP_WORLD_CMP_BATCH];\
+  unsigned char       mask[PIP_WORLD_CMP_BATCH/8];\
+  int                 i, first, n;\
+  for(first = 0; first < wp->worldcount; first += n) {\
+    n = Min(PIP_WORLD_CMP_BATCH, wp->worldcount - first);\
+    for(i = first; i < first + n; i++) { keep[i-first] = !(left_val <= right_val); }\
+    pip_world_bits_pack(keep, n, true, mask);\
+    pip_world_bits_and(wp->data + first/8, mask, PIP_WORLD_BYTES(n));\
+  }\
   PG_RETURN_POINTER(wp)
 
 Datum   pip_value_bundle_cmp_vv  (PG_FUNCTION_ARGS)
@@ -151,7 +160,7 @@ Datum   pip_value_bundle_add_vv  (PG_FUNCTION_ARGS)
 
   {
     UPDATE_FUNC(
-      (!wp || ((wp->data[i/8] >> (7-(i%8))) & 0x01)) ? 
+      (!wp || PIP_WORLD_BIT(wp, i)) ? 
         (PIP_VB_VAL(valbundle_l)[i] + PIP_VB_VAL(valbundle_r)[i]) : 
         PIP_VB_VAL(valbundle_l)[i],
       valbundle_l->worldcount
@@ -182,7 +191,7 @@ Datum   pip_value_bundle_expect  (PG_FUNCTION_ARGS)
   int i, cnt = 0;
 
   for(i = low; i < high; i++){
-    if(!wp || ((wp->data[i/8] >> (7-(i%8))) & 0x01)){
+    if(!wp || PIP_WORLD_BIT(wp, i)){
       result += PIP_VB_VAL(valbundle)[i];
       cnt++;
     }
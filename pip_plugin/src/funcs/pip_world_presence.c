@@ -22,10 +22,7 @@ Datum   pip_world_presence_in   (PG_FUNCTION_ARGS)
               (errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
                errmsg("World Presence, couldn't load length (fresh)!")));
     }
-    wp = palloc0(sizeof(pip_world_presence) + (len+7)/8);
-    SET_VARSIZE(wp, sizeof(pip_world_presence) + (len+7)/8);
-    wp->worldcount = len;
-    memset(wp->data, (str[0] == '!') ? 0xff : 0x00, (len+7)/8);
+    wp = pip_world_presence_alloc(len, str[0] == '!');
     
   } else {
     if(sscanf(str, "%d:%n", &len, &c) != 2){
@@ -35,10 +32,7 @@ Datum   pip_world_presence_in   (PG_FUNCTION_ARGS)
     }
     str += c;
     
-    elog(PIP_MCDB_INFO_LOGLEVEL, "Allocating world presence (in) : %d bytes, %d length", (int)(sizeof(pip_world_presence) + (len+7)/8), len);
-    wp = palloc0(sizeof(pip_world_presence) + (len+7)/8);
-    SET_VARSIZE(wp, sizeof(pip_world_presence) + (len+7)/8);
-    wp->worldcount = len;
+    wp = pip_world_presence_alloc(len, false);
     
     for(c = 0; c < len; c+=4){ //read in one nibble at a time
       wp->data[c/2] <<= 4;
@@ -78,23 +72,16 @@ Datum   pip_world_presence_create(PG_FUNCTION_ARGS)
   int64               len = PG_GETARG_INT32(0);
   pip_world_presence *wp;
   
-  elog(PIP_MCDB_INFO_LOGLEVEL, "Allocating world presence (create) : %d bytes, %d length", (int)(sizeof(pip_world_presence) + (len+7)/8), (int)len);
-  wp = palloc0(sizeof(pip_world_presence) + (len+7)/8);
-  SET_VARSIZE(wp, sizeof(pip_world_presence) + (len+7)/8);
-  wp->worldcount = len;
-  memset(wp->data, 0xff, (len+7)/8);
+  wp = pip_world_presence_alloc(len, true);
   PG_RETURN_POINTER(wp);
 }
 Datum   pip_world_presence_count(PG_FUNCTION_ARGS)
 {
   pip_world_presence *wp = (pip_world_presence *)PG_GETARG_BYTEA_P(0);
-  int                 i;
-  int                 cnt = 0;
+  int                 cnt;
   float8              result;
   
-  for(i = 0; i < wp->worldcount; i++){
-    cnt += ((wp->data[i/8] >> (7-(i%8)))&0x01);
-  }
+  cnt = pip_world_bits_count(wp->data, wp->worldcount);
   
   result = ((float8)cnt) / ((float8)wp->worldcount);
   
@@ -102,14 +89,11 @@ Datum   pip_world_presence_count(PG_FUNCTION_ARGS)
 }
 Datum   pip_world_presence_union (PG_FUNCTION_ARGS)
 {
-  pip_world_presence *wp1 = (pip_world_presence *)PG_GETARG_BYTEA_P_COPY(0);
+  pip_world_presence *wp1 = PIP_GETARG_WORLD_PRESENCE_FOR_UPDATE(0);
   pip_world_presence *wp2 = (pip_world_presence *)PG_GETARG_BYTEA_P(1);
-  int                 i;
   
   //  elog(NOTICE, "UNION: %d(%d),%d(%d)", wp1->worldcount, VARSIZE(wp1), wp2->worldcount, VARSIZE(wp2));
-  for(i = 0; i < (MIN(wp1->worldcount, wp2->worldcount)+7) / 8; i++){
-    wp1->data[i] |= wp2->data[i];
-  }
+  pip_world_bits_or(wp1->data, wp2->data, PIP_WORLD_BYTES(Min(wp1->worldcount, wp2->worldcount)));
   //  elog(NOTICE, "UNION COMPLETE");
   PG_RETURN_POINTER(wp1);
 }
@@ -21,6 +21,7 @@
 /*************  DISTRIBUTION SPECIFICATION  ***************/
 typedef void   (pip_dist_init)(pip_var *var, HeapTupleHeader params);
 typedef float8 (pip_dist_gen) (pip_var *var, int64 seed);
+typedef void   (pip_dist_gen_batch)(pip_var *var, int64 *seeds, int n, float8 *out);
 typedef float8 (pip_dist_pdf) (pip_var *var, float8 point);
 typedef float8 (pip_dist_cdf) (pip_var *var, float8 point);
 typedef float8 (pip_dist_icdf)(pip_var *var, float8 point);
@@ -32,6 +33,7 @@ typedef struct pip_functable_entry {
   int            size;
   pip_dist_init *init;
   pip_dist_gen  *gen;
+  pip_dist_gen_batch *gen_batch; //optional; out[i] must be gen(var, seeds[i])
   pip_dist_pdf  *pdf;
   pip_dist_cdf  *cdf;
   pip_dist_icdf *icdf;
@@ -40,6 +42,9 @@ typedef struct pip_functable_entry {
   bool           joint;
 } pip_functable_entry;
 
+//the largest batch that pip_var_gen_w_name_and_seeds() passes to gen_batch
+#define PIP_GEN_BATCH 64
+
 #define DECLARE_PIP_DISTRIBUTION(dist_name) pip_functable_entry dist_name##_functable
 #define PVAR_SIZE(group_id) (sizeof(pip_var) + pip_distributions[group_id]->size)
 
@@ -56,6 +61,9 @@ typedef struct pip_functable_entry {
     (pip_distributions[pvar_id.group]->icdf != NULL) : false)
 #define PVAR_HAS_2WAY_CDF(pvar_id) \
   ((PVAR_HAS_CDF(pvar_id)) && (PVAR_HAS_ICDF(pvar_id)))
+#define PVAR_HAS_GEN_BATCH(pvar_id) \
+  ((pvar_id.group < pip_distribution_count) ? \
+    (pip_distributions[pvar_id.group]->gen_batch != NULL) : false)
 #define PVAR_IS_JOINT(pvar_id) \
   (pip_distributions[pvar_id.group]->joint)
 
@@ -77,6 +85,23 @@ int64  pip_prng_int     (int64 *seed);
 float8 pip_prng_float   (int64 *seed);
 void   pip_box_muller   (float8 *X, float8 *Y, int64 *seed); //dist/normal.c
 
+// The generators above, inlined for the gen_batch functions.  The prng is
+// a stateless hash of the seed, so a loop over a batch of seeds has no
+// dependencies between iterations and can be vectorized.
+static inline int64 pip_prng_step_inline(int64 v)
+{
+  v = v * 3935559000370003845LL + 2691343689449507681LL;
+  v ^= v >> 21; v^= v << 37; v ^= v >> 4;
+  v *= 4768777413237032717LL;
+  v ^= v >> 20; v^= v << 41; v ^= v >> 5;
+  return v;
+}
+static inline float8 pip_prng_float_inline(int64 *seed)
+{
+  *seed = pip_prng_step_inline(*seed);
+  return (1.0 / ((float8)RANDOM_MAX)) * (float8)(*seed & RANDOM_MAX);
+}
+
 /** Group Management **/
 int    pip_group_lookup (char *name); //pvar.c
 
@@ -90,4 +90,56 @@ void pip_eqn_cmpnt_update_pointers(char *base, int offset, int shift);
 bool pip_eqn_cmpnt_identical_structure(char *leftbase, int leftoffset, char *rightbase, int rightoffset);
 bool pip_eqn_cmpnt_simplify_1var(char *base, int offset, float8 *c, float8 *m, pip_var *var);
 
+////////////////////// Compiled Equations (eqn_program.c)
+// 
+// Sampling an equation by walking its tree costs a recursive call and a
+// switch per node and per sample.  Code that samples the same equation many
+// times compiles it once into a pip_eqn_program: a linear list of operations
+// over registers.  Every register holds the values of PIP_EQN_BATCH samples,
+// so each operation is a simple loop over contiguous float8 arrays.
+// Constraint atoms are compiled into the same program.  A program can be
+// bound to a sample set, which looks its variables up in the set once
+// instead of once per batch.
+
+#define PIP_EQN_BATCH 64
+
+typedef struct pip_eqn_op {
+  enum pip_eqn_op_type {
+    PIP_EQN_OP_CONST, // reg[dst] = c
+    PIP_EQN_OP_VAR,   // reg[dst] = sampled value of var
+    PIP_EQN_OP_MULT,  // reg[dst] = reg[arg[0]] * reg[arg[1]]
+    PIP_EQN_OP_ADD,   // reg[dst] = reg[arg[0]] + reg[arg[1]]
+    PIP_EQN_OP_NEGA,  // reg[dst] = - reg[arg[0]]
+    PIP_EQN_OP_CNSTRT,// reg[dst] = (reg[arg[1]] > reg[arg[2]]) ? reg[arg[0]] : 0
+    PIP_EQN_OP_GT     // reg[dst] = (reg[arg[0]] > reg[arg[1]]) ? 1 : 0
+  } type;
+  int16 dst;
+  int16 arg[3];
+  float8 c;
+  pip_var *var; //points into the compiled eqn
+  int32 slot;   //mapping of var in the bound sample set, or -1
+} pip_eqn_op;
+
+typedef struct pip_eqn_program {
+  int op_cnt;
+  int reg_cnt;
+  pip_eqn_op *ops;
+  float8 *regs; // reg_cnt * PIP_EQN_BATCH
+  pip_sample_set *bound;
+} pip_eqn_program;
+
+// The program refers to the variables of the eqn, which must outlive it.
+pip_eqn_program *pip_eqn_compile(pip_eqn *eqn);
+// The program of an atom gives 1.0 for the samples where the atom holds and
+// 0.0 for the others.
+pip_eqn_program *pip_atom_compile(pip_atom *atom);
+void pip_eqn_program_free(pip_eqn_program *prog);
+// Look the variables up in set, which must not be renamed afterwards.
+void pip_eqn_program_bind(pip_eqn_program *prog, pip_sample_set *set);
+
+// Evaluate up to PIP_EQN_BATCH samples at once, giving the same values as
+// pip_eqn_evaluate_seed() and pip_eqn_evaluate_sample() respectively.
+void pip_eqn_program_evaluate_seeds(pip_eqn_program *prog, int64 *seeds, int count, float8 *out);
+void pip_eqn_program_evaluate_samples(pip_eqn_program *prog, pip_sample_set *set, int first_sample, int count, float8 *out);
+
 #endif
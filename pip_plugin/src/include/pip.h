@@ -10,6 +10,7 @@
 #include "c.h"
 #include "postgres.h"
 #include "access/htup.h"
+#include "fmgr.h"
 #include "nodes/nodes.h"
 
 #include "list_utils.h"
@@ -24,6 +25,7 @@
 #include "sample_set.h"
 #include "conf_tally.h"
 #include "value_bundle.h"
+#include "world_presence.h"
 
 /** Hooking operations (pip.c) **/
 void _PG_init(void);
@@ -37,6 +39,7 @@ float8 pip_compute_expectation_conditionless(pip_eqn *eqn, int64 samples);
 /** Constrained Sampling operations (sample/csampling.c) **/
 pip_sample_set *pip_sample_by_clause   (int clause_cnt, pip_atom **clause, int sample_cnt, float8 *probability);
 bool pip_sample_test_clause(pip_sample_set *samples, int i, int clause_cnt, pip_atom **clause);
+void pip_sample_test_clause_all(pip_sample_set *samples, int clause_cnt, pip_atom **clause, bool *holds);
 
 /** Equation Solver (sample/solver.c) **/
 //solve bound may return NAN if it is not possible to extract a simple bound from the clause.
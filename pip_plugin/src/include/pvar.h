@@ -42,6 +42,12 @@ float8 pip_var_gen_w_name_and_seed(pip_var *var, int64 seed);
 //   all purposes, pip_var_gen_w_name_and_seed() is more appropriate.
 float8 pip_var_gen_wseed(pip_var *var, int64 seed);
 
+//the two functions above for a batch of n seeds; out[i] is the value generated
+//from seeds[i].  Distributions that define gen_batch generate the whole batch
+//in one call.
+void pip_var_gen_w_name_and_seeds(pip_var *var, int64 *seeds, int n, float8 *out);
+void pip_var_gen_wseeds(pip_var *var, int64 *seeds, int n, float8 *out);
+
 //generate a "bounded" randomly distributed value.
 //This function operates off of the distribution's iCDF; consequently the provided bounds
 //are restricted to the range [0.0, 1.0], where 0.0 corresponds to the variable's lower bound
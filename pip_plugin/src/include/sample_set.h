@@ -34,10 +34,17 @@ float8      pip_sample_val_get_by_id (pip_sample_set *set, int var, int sample);
 float8      pip_sample_val_get       (pip_sample_set *set, pip_var_id *var, int sample);
 int64       pip_sample_seed          (pip_sample_set *set, int sample);
 
+// The number of the mapping of a variable, or -1 if it is not in the set.
+// The mappings are indexed by a hash table stored in the set.
+int         pip_sample_var_to_id     (pip_sample_set *set, pip_var_id *var);
+
 // pip_sample_val_get will return NAN if the value has not been specifically defined
 // for the sample set.  For general lookups (ie, to generate the value from the 
 // sampleset's seed, use this function)
 float8 pip_sample_var_val(pip_sample_set *set, int sample, pip_var *var);
+void   pip_sample_var_vals(pip_sample_set *set, int first_sample, int count, pip_var *var, float8 *vals);
+// pip_sample_var_vals() for a variable already looked up with pip_sample_var_to_id()
+void   pip_sample_slot_vals(pip_sample_set *set, int id, int first_sample, int count, pip_var *var, float8 *vals);
 
 // Vector sampleset manipulation functions
 pip_sample_set *pip_sample_set_vector_max (pip_eqn *eqn, pip_sample_set *set, int clause_cnt, pip_atom **clause);
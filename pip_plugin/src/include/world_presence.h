@@ -0,0 +1,33 @@
+//////////////////////////////////////////////////////////////////////////
+// world_presence.h
+// 
+// A world presence is a bit array with one bit per sampled world, stored
+// most significant bit first: world i is bit (7 - i%8) of data[i/8].  The
+// operations on the bits work on 64 bits at a time; the bits past the
+// last world are unspecified.
+// 
+//////////////////////////////////////////////////////////////////////////
+
+#ifndef PIP_WORLD_PRESENCE_H
+#define PIP_WORLD_PRESENCE_H
+
+#define PIP_WORLD_BYTES(worldcount) (((worldcount)+7)/8)
+#define PIP_WORLD_BIT(wp, i) (((wp)->data[(i)/8] >> (7-((i)%8))) & 0x01)
+
+// The world presence argument n of a function that modifies and returns
+// it.  When the function is the transition function of an aggregate, the
+// argument is the aggregate's own state and is modified in place; in all
+// other cases it has to be copied first.
+#define PIP_GETARG_WORLD_PRESENCE_FOR_UPDATE(n) \
+  ((pip_world_presence *)((fcinfo->context && IsA(fcinfo->context, AggState)) ? \
+    PG_GETARG_BYTEA_P(n) : PG_GETARG_BYTEA_P_COPY(n)))
+
+pip_world_presence *pip_world_presence_alloc(int32 worldcount, bool present);
+
+int    pip_world_bits_count(const unsigned char *bits, int worldcount);
+void   pip_world_bits_or   (unsigned char *bits, const unsigned char *other, int nbytes);
+void   pip_world_bits_and  (unsigned char *bits, const unsigned char *other, int nbytes);
+// Pack count bools into bits; the rest of the last byte is set to pad.
+void   pip_world_bits_pack (const bool *vals, int count, bool pad, unsigned char *bits);
+
+#endif
@@ -105,16 +105,10 @@ float8 dist_param_float8(HeapTupleHeader params, int paramnum, float8 default_va
 }
 
 /*************  VARGEN SUPPORT  ***************/
-//Numerical Recipes v3: Sec 7.14
+//Numerical Recipes v3: Sec 7.14, see pip_prng_step_inline() in dist.h
 int64 pip_prng_step(int64 v)
 {
-
-  v = v * 3935559000370003845LL + 2691343689449507681LL;
-  v ^= v >> 21; v^= v << 37; v ^= v >> 4;
-  v *= 4768777413237032717LL;
-  v ^= v >> 20; v^= v << 41; v ^= v >> 5;
-
-  return v;
+  return pip_prng_step_inline(v);
 }
 
 int64 pip_prng_int(int64 *seed)
@@ -125,6 +119,6 @@ int64 pip_prng_int(int64 *seed)
 
 float8 pip_prng_float(int64 *seed)
 {
-  return (1.0 / ((float8)RANDOM_MAX)) * (float8)(pip_prng_int(seed) & RANDOM_MAX);
+  return pip_prng_float_inline(seed);
 }
 
@@ -25,17 +25,33 @@ typedef struct pip_sampler_state {
   int first_atom, last_atom;
   int first_var, last_var;
   float8 probability;
+  float8 *gen_buf; //PIP_GEN_BATCH candidate values per variable of the group
+  int gen_pos;     //the candidates to use in the current attempt
+  pip_eqn_program **atom_progs; //programs of the atoms, bound to samples
 } pip_sampler_state;
 
 static void rejection_sample(pip_cset *set, pip_cset_element *group, pip_sampler_state *state);
 static int sample_one(pip_cset *set, pip_var *var, pip_sampler_state *state);
 static int populate_sample_vars(pip_cset *set, pip_var *item, pip_sampler_state *state);
 static int sample_lineage_group(pip_cset *set, pip_cset_element *group, pip_sampler_state *state);
+static bool test_group_clause(pip_sampler_state *state);
 
 /*********************** Sampling Techniques *********************/
 static int sample_one(pip_cset *set, pip_var *var, pip_sampler_state *state)
 {
-  float8 val = pip_var_gen(var);
+  float8 *buf = &state->gen_buf[(state->last_var - state->first_var) * PIP_GEN_BATCH];
+  float8 val;
+  //every attempt uses one candidate of each variable, so the candidates of
+  //all variables of the group run out together.
+  if(state->gen_pos == 0){
+    int64 seeds[PIP_GEN_BATCH];
+    int i;
+    for(i = 0; i < PIP_GEN_BATCH; i++){
+      seeds[i] = random();
+    }
+    pip_var_gen_wseeds(var, seeds, PIP_GEN_BATCH, buf);
+  }
+  val = buf[state->gen_pos];
   //the iteration order is the same as the one used to populate the variables.
   pip_sample_val_set_by_id(state->samples, state->last_var, state->curr_sample, val);
 //  pip_sample_val_set(state->samples, &var->vid, state->curr_sample, val);
@@ -47,22 +63,21 @@ static void rejection_sample(pip_cset *set, pip_cset_element *group, pip_sampler
 {
   int cnt = 0;
   //elog(NOTICE, "Rejection Sampling: %d values, %d clauses", pip_cset_group_size(set, group), state->last_atom-state->first_atom);
+  state->gen_buf = palloc(sizeof(float8) * PIP_GEN_BATCH * pip_cset_group_size(set, group));
+  state->gen_pos = 0;
   for(; state->curr_sample < state->samples->sample_cnt; state->curr_sample++){
     do {
       state->last_var = state->first_var;
       pip_cset_iterate_group(set, group, (pip_cset_iterator *)&sample_one, state);
+      state->gen_pos = (state->gen_pos + 1) % PIP_GEN_BATCH;
       cnt++;
     } while(
-      !pip_sample_test_clause(
-          state->samples, 
-          state->curr_sample, 
-          state->last_atom-state->first_atom, 
-          &state->clause[state->first_atom]
-        )
+      !test_group_clause(state)
       &&
         (cnt < 10000000)
       );
   }
+  pfree(state->gen_buf);
   if(cnt > 10000000){ 
     int i;
     elog(WARNING, "Sampling condition with P < 1/10000000");
@@ -101,12 +116,7 @@ static bool cdf_sample_var(pip_cset *set, pip_var *var, pip_sampler_state *state
       pip_sample_val_set(state->samples, &var->vid, state->curr_sample, sample);
       cnt++;
     } while(
-      !pip_sample_test_clause(
-          state->samples, 
-          state->curr_sample, 
-          state->last_atom-state->first_atom, 
-          &state->clause[state->first_atom]
-        )
+      !test_group_clause(state)
       );
   }
   
@@ -120,6 +130,20 @@ static bool cdf_sample_var(pip_cset *set, pip_var *var, pip_sampler_state *state
 
 /*********************** Internal Functions **********************/
 
+//pip_sample_test_clause() on the atoms of the current group, for the
+//current sample.  The programs of the atoms know where their variables are
+//in the sample set, so that no variable is looked up per sample.
+static bool test_group_clause(pip_sampler_state *state)
+{
+  float8 holds;
+  int i;
+  for(i = state->first_atom; i < state->last_atom; i++){
+    pip_eqn_program_evaluate_samples(state->atom_progs[i], state->samples, state->curr_sample, 1, &holds);
+    if(holds == 0.0) return false;
+  }
+  return true;
+}
+
 static int populate_sample_vars(pip_cset *set, pip_var *item, pip_sampler_state *state)
 {
   pip_sample_name_set(state->samples, state->last_var, &item->vid);
@@ -132,6 +156,8 @@ int pip_runtime_enable_cdf_sampling = 1;
 
 static int sample_lineage_group(pip_cset *set, pip_cset_element *group, pip_sampler_state *state)
 {
+  int i;
+  
   state->first_atom = state->last_atom;
   state->last_atom = pip_group_atoms(set, group, state->clause_cnt, state->clause, state->first_atom);
   state->first_var = state->last_var;
@@ -140,6 +166,12 @@ static int sample_lineage_group(pip_cset *set, pip_cset_element *group, pip_samp
   
   pip_cset_iterate_group(set, group, (pip_cset_iterator *)&populate_sample_vars, state);
   
+  //the variables of the group are named now, so the atoms can be bound
+  for(i = state->first_atom; i < state->last_atom; i++){
+    state->atom_progs[i] = pip_atom_compile(state->clause[i]);
+    pip_eqn_program_bind(state->atom_progs[i], state->samples);
+  }
+  
   //elog(NOTICE, "Figuring out group of size %d", pip_cset_group_size(set, group));
   
   //this is where we figure out the best way to sample. 
@@ -165,6 +197,7 @@ pip_sample_set *pip_sample_by_clause   (int clause_cnt, pip_atom **clause, int s
 {
   pip_sampler_state     state;
   pip_cset              varset;
+  int                   i;
   
   if(sample_cnt <= 0){
     return NULL;
@@ -187,9 +220,15 @@ pip_sample_set *pip_sample_by_clause   (int clause_cnt, pip_atom **clause, int s
   state.clause_cnt = clause_cnt;
   state.clause     = clause;
   state.probability = 1.0;
+  state.atom_progs = palloc0(sizeof(pip_eqn_program *) * (clause_cnt > 0 ? clause_cnt : 1));
   DPING();
   pip_cset_iterate_roots(&varset, (pip_cset_iterator *)&sample_lineage_group, &state);
   
+  for(i = 0; i < clause_cnt; i++){
+    if(state.atom_progs[i]) pip_eqn_program_free(state.atom_progs[i]);
+  }
+  pfree(state.atom_progs);
+  
   if(probability) { *probability = state.probability; }
   
   return state.samples;
@@ -205,3 +244,29 @@ bool pip_sample_test_clause(pip_sample_set *set, int sample, int clause_cnt, pip
   }
   return true;
 }
+
+//pip_sample_test_clause() for every sample of the set; holds must have
+//room for set->sample_cnt results.  Each atom is compiled and bound to the
+//set once, and evaluated a batch of samples at a time.
+void pip_sample_test_clause_all(pip_sample_set *set, int clause_cnt, pip_atom **clause, bool *holds)
+{
+  pip_eqn_program *prog;
+  float8 vals[PIP_EQN_BATCH];
+  int i, j, k, count;
+  
+  for(i = 0; i < set->sample_cnt; i++){
+    holds[i] = true;
+  }
+  for(j = 0; j < clause_cnt; j++){
+    prog = pip_atom_compile(clause[j]);
+    pip_eqn_program_bind(prog, set);
+    for(i = 0; i < set->sample_cnt; i += count){
+      count = (set->sample_cnt - i < PIP_EQN_BATCH) ? (set->sample_cnt - i) : PIP_EQN_BATCH;
+      pip_eqn_program_evaluate_samples(prog, set, i, count, vals);
+      for(k = 0; k < count; k++){
+        if(vals[k] == 0.0) holds[i + k] = false;
+      }
+    }
+    pip_eqn_program_free(prog);
+  }
+}
@@ -135,16 +135,26 @@ float8 pip_compute_expectation(pip_eqn *eqn, int clause_cnt, pip_atom **clause,
 {
   float8 val = 0.0;
   float8 probability;
+  float8 vals[PIP_EQN_BATCH];
   int64 i;
+  int j, count;
   pip_sample_set *set;
+  pip_eqn_program *prog;
   
   //don't go through the overhead of sampling if we can avoid it.
   if(clause_cnt <= 0) return pip_compute_expectation_conditionless(eqn, samples);
   
   set = pip_sample_by_clause(clause_cnt, clause, samples, &probability);
-  for(i = 0; i <  samples; i++){
-    val += pip_eqn_evaluate_sample(eqn, set, i);
+  prog = pip_eqn_compile(eqn);
+  pip_eqn_program_bind(prog, set);
+  for(i = 0; i <  samples; i += count){
+    count = (samples - i < PIP_EQN_BATCH) ? (int)(samples - i) : PIP_EQN_BATCH;
+    pip_eqn_program_evaluate_samples(prog, set, i, count, vals);
+    for(j = 0; j < count; j++){
+      val += vals[j];
+    }
   }
+  pip_eqn_program_free(prog);
 //  elog(NOTICE, "probability: %lf, %lf = %lf/%ld samples", (float)probability,  (val / (float8)samples) * probability, val, samples);
   return (val / (float8)samples) * probability;
 }
@@ -152,9 +162,21 @@ float8 pip_compute_expectation(pip_eqn *eqn, int clause_cnt, pip_atom **clause,
 float8 pip_compute_expectation_conditionless(pip_eqn *eqn, int64 samples)
 {
   float8 val = 0.0;
+  float8 vals[PIP_EQN_BATCH];
+  int64 seeds[PIP_EQN_BATCH];
   int64 i;
-  for(i = 0; i <  samples; i++){
-    val += pip_eqn_evaluate_seed(eqn, random());
+  int j, count;
+  pip_eqn_program *prog = pip_eqn_compile(eqn);
+  for(i = 0; i <  samples; i += count){
+    count = (samples - i < PIP_EQN_BATCH) ? (int)(samples - i) : PIP_EQN_BATCH;
+    for(j = 0; j < count; j++){
+      seeds[j] = random();
+    }
+    pip_eqn_program_evaluate_seeds(prog, seeds, count, vals);
+    for(j = 0; j < count; j++){
+      val += vals[j];
+    }
   }
+  pip_eqn_program_free(prog);
   return val / (float8)samples;
 }
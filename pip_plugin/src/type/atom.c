@@ -8,42 +8,12 @@
 #include "utils/typcache.h"
 #include "utils/memutils.h"
 #include "access/heapam.h"
+#include "catalog/namespace.h"
 
 #include "pip.h"
 #include "eqn.h"
 #include "atom.h"
 
-static Oid pip_atom_oid();
-
-static Oid pip_atom_oid()
-{
-  static Oid PIP_ATOM_OID = (Oid)0;
-  
-  //a little bit of a hack, but it gets the job done.  This uses SPI to issue a query that
-  //generates a dummy pip_atom and extracts an OID based on the response.  It's ugly, and 
-  //it's probably not that fast... but it only needs to happen once per reset.
-  if(PIP_ATOM_OID == 0){
-    int connect_status;
-    elog(NOTICE, "Need to look up PIP_ATOM_OID");
-    connect_status = SPI_connect();
-    if(connect_status == SPI_ERROR_CONNECT){ 
-      //oops, we're already connected.  This is not how push/pop are supposed to be used
-      //buuuut... forcing people to put a push/pop around calls to extract_atoms is uglier
-      SPI_push();
-      SPI_connect();
-    }
-    if(SPI_execute("SELECT cast('>(25.0)(25.0)' AS pip_atom)", true, 1) == SPI_OK_SELECT){
-      PIP_ATOM_OID = SPI_gettypeid(SPI_tuptable->tupdesc, 1);
-    }
-    elog(NOTICE, "  PIP_ATOM_OID = %d", (int)PIP_ATOM_OID);
-    SPI_finish();
-    if(connect_status == SPI_ERROR_CONNECT){
-      SPI_pop();
-    }
-  }
-  return PIP_ATOM_OID;
-}
-
 int pip_atom_sprint(char *str, int len, pip_atom *atom)
 {
   int c = 1;
@@ -98,53 +68,108 @@ void pip_atom_log(pip_atom *atom)
   elog(NOTICE, "%s", str);
 }
 
+// The pip_atom columns of a row type.  Finding them takes a scan of the
+// row's tuple descriptor, so they are kept in fn_extra of the calling
+// function for the rest of the query, and only looked up again if the
+// function is handed a row of a different type.
+typedef struct pip_clause_cache {
+  Oid               atom_oid;
+  Oid               tupType;
+  int32             tupTypmod;
+  TupleDesc         tupDesc;
+  int               count;
+  AttrNumber        attnums[1]; // count entries
+} pip_clause_cache;
+
+static pip_clause_cache *pip_clause_cache_get(FmgrInfo *flinfo, HeapTupleHeader row)
+{
+  pip_clause_cache *cache = (flinfo) ? ((pip_clause_cache *)flinfo->fn_extra) : NULL;
+  MemoryContext     cxt = (flinfo) ? (flinfo->fn_mcxt) : (CurrentMemoryContext);
+  MemoryContext     oldcxt;
+  Oid               tupType = HeapTupleHeaderGetTypeId(row);
+  int32             tupTypmod = HeapTupleHeaderGetTypMod(row);
+  TupleDesc         tupDesc;
+  Oid               atom_oid;
+  int               i;
+  
+  if(cache && cache->tupType == tupType && cache->tupTypmod == tupTypmod){
+    return cache;
+  }
+  
+  if(cache){
+    atom_oid = cache->atom_oid;
+    FreeTupleDesc(cache->tupDesc);
+    pfree(cache);
+  } else {
+    atom_oid = TypenameGetTypid("pip_atom");
+    if(!OidIsValid(atom_oid)){
+      elog(ERROR, "type pip_atom is not in the search path");
+    }
+  }
+  
+  oldcxt = MemoryContextSwitchTo(cxt);
+  tupDesc = lookup_rowtype_tupdesc_copy(tupType, tupTypmod);
+  cache = palloc(sizeof(pip_clause_cache) + sizeof(AttrNumber) * tupDesc->natts);
+  MemoryContextSwitchTo(oldcxt);
+  
+  cache->atom_oid = atom_oid;
+  cache->tupType = tupType;
+  cache->tupTypmod = tupTypmod;
+  cache->tupDesc = tupDesc;
+  cache->count = 0;
+  for(i = 0; i < tupDesc->natts; i++){
+    if(tupDesc->attrs[i]->atttypid == atom_oid){
+      cache->attnums[cache->count++] = tupDesc->attrs[i]->attnum;
+    }
+  }
+  
+  if(flinfo) flinfo->fn_extra = cache;
+  return cache;
+}
+
 //The code for this function is based off of executor/execQual.c: GetAttributeByName()
-int pip_extract_clause(HeapTupleHeader row, pip_atom ***out)
+//The atoms are not copied: they point into the row (or into its detoasted
+//copy), and are valid as long as the row is.  flinfo may be NULL, in which
+//case nothing is cached.
+int pip_extract_clause(FmgrInfo *flinfo, HeapTupleHeader row, pip_atom ***out)
 {
   int               i, count = 0;
-	Oid			          tupType;
-	int32		          tupTypmod;
-	TupleDesc	        tupDesc;
-	HeapTupleData     tmptup;
-	Datum             atom_datum;
+  pip_clause_cache *cache;
+  HeapTupleData     tmptup;
+  Datum             atom_datum;
   bool              isnull;
-	
-	tupType = HeapTupleHeaderGetTypeId(row);
-	tupTypmod = HeapTupleHeaderGetTypMod(row);
-	tupDesc = lookup_rowtype_tupdesc(tupType, tupTypmod);
   
-	tmptup.t_len = HeapTupleHeaderGetDatumLength(row);
-	tmptup.t_tableOid = InvalidOid;
-	tmptup.t_data = row;
+  cache = pip_clause_cache_get(flinfo, row);
+  
+  tmptup.t_len = HeapTupleHeaderGetDatumLength(row);
+  tmptup.t_tableOid = InvalidOid;
+  tmptup.t_data = row;
   
   if(*out == NULL){
-    for(i = 0; i < tupDesc->natts; i++){
-	
-      if(tupDesc->attrs[i]->atttypid == pip_atom_oid()){ 
-	
-        count++;
-      }
-    }
-    *out = palloc0(count * sizeof(pip_atom *));
-    count = 0;
+    *out = palloc0(cache->count * sizeof(pip_atom *));
   }
   
-  for(i = 0; i < tupDesc->natts; i++){
-    if(tupDesc->attrs[i]->atttypid == pip_atom_oid()){
-      atom_datum = heap_getattr(&tmptup,
-                      tupDesc->attrs[i]->attnum,
-                      tupDesc,
-                      &isnull);
-      if(!isnull){
-        pip_atom *atom = (pip_atom *)PG_DETOAST_DATUM(atom_datum);
-        (*out)[count] = palloc0(VARSIZE(atom));
-        memcpy((*out)[count], atom, VARSIZE(atom));
-        count++;
+  for(i = 0; i < cache->count; i++){
+    atom_datum = heap_getattr(&tmptup, cache->attnums[i], cache->tupDesc, &isnull);
+    if(!isnull){
+      pip_atom *atom = (pip_atom *)PG_DETOAST_DATUM(atom_datum);
+      //pip_atom is stored with double alignment for its float8 constants,
+      //and toasted or packed atoms are detoasted into aligned copies, but
+      //rows written by an older pip.sql may not be aligned.
+      if((Pointer)atom != (Pointer)MAXALIGN(atom)){
+        pip_atom *copy = palloc(VARSIZE(atom));
+        memcpy(copy, atom, VARSIZE(atom));
+        atom = copy;
       }
+      (*out)[count] = atom;
+      count++;
     }
   }
-
-	ReleaseTupleDesc(tupDesc);
+  
+  if(!flinfo){
+    FreeTupleDesc(cache->tupDesc);
+    pfree(cache);
+  }
   
   return count;
 }
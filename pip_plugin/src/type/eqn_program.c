@@ -0,0 +1,321 @@
+//////////////////////////////////////////////////////////////////////////
+// eqn_program.c
+//
+// Compilation of pip_eqns into linear programs that evaluate a batch of
+// samples per operation.  The program is generated in two passes over the
+// flattened tree: the first numbers the components in preorder and computes
+// how many registers each one needs, the second emits the operations in
+// postorder.  The children of a component are evaluated in the order of
+// decreasing need, each into the next free register (Sethi-Ullman
+// numbering), so that the long chains of sums and products built by the
+// aggregates only need a few registers.
+//
+// A program that is bound to a sample set knows the mappings of its
+// variables in the set, so that sampling atoms and equations one sample at
+// a time never searches the set.
+//
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "postgres.h"
+
+#include "pip.h"
+#include "eqn.h"
+#include "atom.h"
+
+#define PIP_EQN_REG(prog, reg) ((prog)->regs + (reg) * PIP_EQN_BATCH)
+
+typedef struct pip_eqn_child {
+  char *base;
+  int   offset;
+} pip_eqn_child;
+
+typedef struct pip_eqn_node_info {
+  int need; // registers needed to evaluate the component
+  int size; // number of components in its tree
+} pip_eqn_node_info;
+
+static int  pip_eqn_cmpnt_children(char *base, int offset, pip_eqn_child *children);
+static int  pip_eqn_cmpnt_count(char *base, int offset);
+static void pip_eqn_cmpnt_number(char *base, int offset, pip_eqn_node_info *info, int idx);
+static void pip_eqn_cmpnt_emit(pip_eqn_program *prog, pip_eqn_node_info *info, char *base, int offset, int idx, int reg);
+static void pip_eqn_child_order(pip_eqn_node_info *info, int *child_idx, int n, int *order);
+static pip_eqn_program *pip_eqn_program_alloc(int op_cnt, int reg_cnt);
+static void pip_eqn_program_run(pip_eqn_program *prog, int64 *seeds, pip_sample_set *set, int first_sample, int count, float8 *out);
+
+// The operands of a component; the atom of a constraint contributes its
+// two sides.
+static int pip_eqn_cmpnt_children(char *base, int offset, pip_eqn_child *children)
+{
+  pip_eqn_component *cmp = DEREF_CMPNT(base,offset);
+  pip_atom *atom;
+  switch(cmp->type){
+    case PIP_EQN_MULT:
+    case PIP_EQN_ADD:
+      children[0].base = base; children[0].offset = cmp->val.branch.ptr_left;
+      children[1].base = base; children[1].offset = cmp->val.branch.ptr_right;
+      return 2;
+    case PIP_EQN_NEGA:
+      children[0].base = base; children[0].offset = cmp->val.ptr;
+      return 1;
+    case PIP_EQN_CNSTRT:
+      atom = DEREF_ATOM(base, cmp->val.branch.ptr_right);
+      children[0].base = base;       children[0].offset = cmp->val.branch.ptr_left;
+      children[1].base = atom->data; children[1].offset = atom->ptr_left;
+      children[2].base = atom->data; children[2].offset = atom->ptr_right;
+      return 3;
+    default:
+      return 0;
+  }
+}
+
+static int pip_eqn_cmpnt_count(char *base, int offset)
+{
+  pip_eqn_child children[3];
+  int i, n, count = 1;
+
+  n = pip_eqn_cmpnt_children(base, offset, children);
+  for(i = 0; i < n; i++){
+    count += pip_eqn_cmpnt_count(children[i].base, children[i].offset);
+  }
+  return count;
+}
+
+// Sort the children by decreasing need.  Children with the same need keep
+// their order.
+static void pip_eqn_child_order(pip_eqn_node_info *info, int *child_idx, int n, int *order)
+{
+  int i, j, tmp;
+
+  for(i = 0; i < n; i++){
+    order[i] = i;
+  }
+  for(i = 1; i < n; i++){
+    for(j = i; j > 0 && info[child_idx[order[j]]].need > info[child_idx[order[j-1]]].need; j--){
+      tmp = order[j]; order[j] = order[j-1]; order[j-1] = tmp;
+    }
+  }
+}
+
+static void pip_eqn_cmpnt_number(char *base, int offset, pip_eqn_node_info *info, int idx)
+{
+  pip_eqn_child children[3];
+  int child_idx[3], order[3];
+  int i, n;
+
+  n = pip_eqn_cmpnt_children(base, offset, children);
+  info[idx].size = 1;
+  for(i = 0; i < n; i++){
+    child_idx[i] = idx + info[idx].size;
+    pip_eqn_cmpnt_number(children[i].base, children[i].offset, info, child_idx[i]);
+    info[idx].size += info[child_idx[i]].size;
+  }
+
+  pip_eqn_child_order(info, child_idx, n, order);
+  info[idx].need = 1;
+  for(i = 0; i < n; i++){
+    if(info[child_idx[order[i]]].need + i > info[idx].need){
+      info[idx].need = info[child_idx[order[i]]].need + i;
+    }
+  }
+}
+
+static void pip_eqn_cmpnt_emit(pip_eqn_program *prog, pip_eqn_node_info *info, char *base, int offset, int idx, int reg)
+{
+  pip_eqn_component *cmp = DEREF_CMPNT(base,offset);
+  pip_eqn_child children[3];
+  int child_idx[3], order[3];
+  int i, n;
+  pip_eqn_op *op;
+
+  n = pip_eqn_cmpnt_children(base, offset, children);
+  for(i = 0; i < n; i++){
+    child_idx[i] = (i == 0) ? (idx + 1) : (child_idx[i-1] + info[child_idx[i-1]].size);
+  }
+  pip_eqn_child_order(info, child_idx, n, order);
+
+  //the k-th child to be evaluated goes into register reg+k
+  for(i = 0; i < n; i++){
+    pip_eqn_cmpnt_emit(prog, info, children[order[i]].base, children[order[i]].offset, child_idx[order[i]], reg + i);
+  }
+
+  op = &prog->ops[prog->op_cnt++];
+  op->dst = reg;
+  op->slot = -1;
+  for(i = 0; i < n; i++){
+    op->arg[order[i]] = reg + i;
+  }
+
+  switch(cmp->type){
+    case PIP_EQN_CONST:
+      op->type = PIP_EQN_OP_CONST;
+      op->c = cmp->val.c;
+      break;
+    case PIP_EQN_VAR:
+      op->type = PIP_EQN_OP_VAR;
+      op->var = &cmp->val.var;
+      break;
+    case PIP_EQN_MULT:
+      op->type = PIP_EQN_OP_MULT;
+      break;
+    case PIP_EQN_ADD:
+      op->type = PIP_EQN_OP_ADD;
+      break;
+    case PIP_EQN_NEGA:
+      op->type = PIP_EQN_OP_NEGA;
+      break;
+    case PIP_EQN_CNSTRT:
+      op->type = PIP_EQN_OP_CNSTRT;
+      break;
+    default:
+      //evaluates to 0.0, like pip_eqn_cmpnt_evaluate_seed() does
+      elog(NOTICE, "Unhandled equation component type: %d (%s(); %s:%d)", cmp->type, __FUNCTION__, __FILE__, __LINE__);
+      op->type = PIP_EQN_OP_CONST;
+      op->c = 0.0;
+      break;
+  }
+}
+
+static pip_eqn_program *pip_eqn_program_alloc(int op_cnt, int reg_cnt)
+{
+  pip_eqn_program *prog = palloc(sizeof(pip_eqn_program));
+  prog->op_cnt = 0;
+  prog->reg_cnt = reg_cnt;
+  prog->ops = palloc0(sizeof(pip_eqn_op) * op_cnt);
+  prog->regs = palloc(sizeof(float8) * PIP_EQN_BATCH * reg_cnt);
+  prog->bound = NULL;
+  return prog;
+}
+
+pip_eqn_program *pip_eqn_compile(pip_eqn *eqn)
+{
+  pip_eqn_program *prog;
+  pip_eqn_node_info *info;
+  int count;
+
+  count = pip_eqn_cmpnt_count(eqn->data, 0);
+  info = palloc(sizeof(pip_eqn_node_info) * count);
+  pip_eqn_cmpnt_number(eqn->data, 0, info, 0);
+
+  prog = pip_eqn_program_alloc(count, info[0].need);
+  pip_eqn_cmpnt_emit(prog, info, eqn->data, 0, 0, 0);
+
+  pfree(info);
+  return prog;
+}
+
+// The two sides of the atom are numbered and emitted like the children of
+// a component.
+pip_eqn_program *pip_atom_compile(pip_atom *atom)
+{
+  pip_eqn_program *prog;
+  pip_eqn_node_info *info;
+  pip_eqn_op *op;
+  int offset[2], idx[2];
+  int first, count;
+
+  offset[0] = atom->ptr_left;
+  offset[1] = atom->ptr_right;
+  idx[0] = 0;
+  idx[1] = pip_eqn_cmpnt_count(atom->data, offset[0]);
+  count = idx[1] + pip_eqn_cmpnt_count(atom->data, offset[1]);
+  info = palloc(sizeof(pip_eqn_node_info) * count);
+  pip_eqn_cmpnt_number(atom->data, offset[0], info, idx[0]);
+  pip_eqn_cmpnt_number(atom->data, offset[1], info, idx[1]);
+
+  first = (info[idx[1]].need > info[idx[0]].need) ? 1 : 0;
+  prog = pip_eqn_program_alloc(count + 1, Max(info[idx[first]].need, info[idx[1-first]].need + 1));
+  pip_eqn_cmpnt_emit(prog, info, atom->data, offset[first], idx[first], 0);
+  pip_eqn_cmpnt_emit(prog, info, atom->data, offset[1-first], idx[1-first], 1);
+
+  op = &prog->ops[prog->op_cnt++];
+  op->type = PIP_EQN_OP_GT;
+  op->dst = 0;
+  op->arg[first] = 0;
+  op->arg[1-first] = 1;
+  op->slot = -1;
+
+  pfree(info);
+  return prog;
+}
+
+void pip_eqn_program_bind(pip_eqn_program *prog, pip_sample_set *set)
+{
+  int o;
+  for(o = 0; o < prog->op_cnt; o++){
+    if(prog->ops[o].type == PIP_EQN_OP_VAR){
+      prog->ops[o].slot = pip_sample_var_to_id(set, &prog->ops[o].var->vid);
+    }
+  }
+  prog->bound = set;
+}
+
+void pip_eqn_program_free(pip_eqn_program *prog)
+{
+  pfree(prog->ops);
+  pfree(prog->regs);
+  pfree(prog);
+}
+
+// Run the program on count <= PIP_EQN_BATCH samples.  The variables are
+// generated from seeds, or taken from samples of set if it is given, a batch
+// at a time.  All other loops are plain loops over float8 arrays that the
+// compiler can vectorize.
+static void pip_eqn_program_run(pip_eqn_program *prog, int64 *seeds, pip_sample_set *set, int first_sample, int count, float8 *out)
+{
+  int i, o;
+
+  for(o = 0; o < prog->op_cnt; o++){
+    pip_eqn_op *op  = &prog->ops[o];
+    float8     *dst = PIP_EQN_REG(prog, op->dst);
+    float8     *a0  = PIP_EQN_REG(prog, op->arg[0]);
+    float8     *a1  = PIP_EQN_REG(prog, op->arg[1]);
+    float8     *a2  = PIP_EQN_REG(prog, op->arg[2]);
+
+    switch(op->type){
+      case PIP_EQN_OP_CONST:
+        for(i = 0; i < count; i++){ dst[i] = op->c; }
+        break;
+      case PIP_EQN_OP_VAR:
+        if(set && set == prog->bound){
+          pip_sample_slot_vals(set, op->slot, first_sample, count, op->var, dst);
+        } else if(set){
+          pip_sample_var_vals(set, first_sample, count, op->var, dst);
+        } else {
+          pip_var_gen_w_name_and_seeds(op->var, seeds, count, dst);
+        }
+        break;
+      case PIP_EQN_OP_MULT:
+        for(i = 0; i < count; i++){ dst[i] = a0[i] * a1[i]; }
+        break;
+      case PIP_EQN_OP_ADD:
+        for(i = 0; i < count; i++){ dst[i] = a0[i] + a1[i]; }
+        break;
+      case PIP_EQN_OP_NEGA:
+        for(i = 0; i < count; i++){ dst[i] = 0.0 - a0[i]; }
+        break;
+      case PIP_EQN_OP_CNSTRT:
+        for(i = 0; i < count; i++){ dst[i] = (a1[i] > a2[i]) ? a0[i] : 0.0; }
+        break;
+      case PIP_EQN_OP_GT:
+        for(i = 0; i < count; i++){ dst[i] = (a0[i] > a1[i]) ? 1.0 : 0.0; }
+        break;
+    }
+  }
+  memcpy(out, PIP_EQN_REG(prog, 0), sizeof(float8) * count);
+}
+
+void pip_eqn_program_evaluate_seeds(pip_eqn_program *prog, int64 *seeds, int count, float8 *out)
+{
+  Assert(count <= PIP_EQN_BATCH);
+  pip_eqn_program_run(prog, seeds, NULL, 0, count, out);
+}
+
+void pip_eqn_program_evaluate_samples(pip_eqn_program *prog, pip_sample_set *set, int first_sample, int count, float8 *out)
+{
+  Assert(count <= PIP_EQN_BATCH);
+  pip_eqn_program_run(prog, NULL, set, first_sample, count, out);
+}
@@ -131,6 +131,34 @@ float8 pip_var_gen_wseed(pip_var *var, int64 seed)
   }
   return pip_distributions[var->vid.group]->gen(var, seed);
 }
+void pip_var_gen_w_name_and_seeds(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  int64 named[PIP_GEN_BATCH];
+  int64 name = pip_prng_step(var->vid.variable);
+  int i, j, count;
+  for(i = 0; i < n; i += count){
+    count = (n - i < PIP_GEN_BATCH) ? (n - i) : PIP_GEN_BATCH;
+    for(j = 0; j < count; j++){
+      named[j] = seeds[i + j] ^ name;
+    }
+    pip_var_gen_wseeds(var, named, count, out + i);
+  }
+}
+void pip_var_gen_wseeds(pip_var *var, int64 *seeds, int n, float8 *out)
+{
+  int i;
+  if((var->vid.group >= pip_distribution_count) || (var->vid.group < 0)){
+    for(i = 0; i < n; i++){
+      out[i] = NAN;
+    }
+  } else if(PVAR_HAS_GEN_BATCH(var->vid)){
+    pip_distributions[var->vid.group]->gen_batch(var, seeds, n, out);
+  } else {
+    for(i = 0; i < n; i++){
+      out[i] = pip_distributions[var->vid.group]->gen(var, seeds[i]);
+    }
+  }
+}
 float8 pip_var_gen_w_range(pip_var *var, float8 low, float8 high)
 {
   int64 seed = random();
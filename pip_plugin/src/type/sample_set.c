@@ -29,8 +29,10 @@
 #include "eqn.h"
 #include "sample_set.h"
 
-int  pip_sample_var_to_id (pip_sample_set *set, pip_var_id *var);
 void pip_sample_seed_set  (pip_sample_set *set, int sample, int64 val);
+static int  pip_sample_index_hash   (pip_sample_set *set, pip_var_id *var);
+static void pip_sample_index_insert (pip_sample_set *set, int var);
+static void pip_sample_index_rebuild(pip_sample_set *set);
 
 /******************** Variable Operations **********************/
 
@@ -38,11 +40,25 @@ int64 pip_global_ssid = 0; //sample sets are not persistent, so we can loop.
 
 #define SAMPLE_SET_ENTRY(id) ((pip_sample_mapping *)(set->data + (id) * (sizeof(pip_sample_mapping) + sizeof(float8) * set->sample_cnt)))
 
+// The mappings are followed by an open addressing hash index from variable
+// ids to mappings, with linear probing.  An entry is the number of a
+// mapping, or -1 if it is empty.  The index is at most half full.
+#define SAMPLE_SET_INDEX(set)  ((int32 *)((set)->data + (set)->var_cnt * (sizeof(pip_sample_mapping) + sizeof(float8) * (set)->sample_cnt)))
+#define SAMPLE_SET_INDEX_MASK(set) (pip_sample_index_size((set)->var_cnt) - 1)
+
+static int pip_sample_index_size(int32 var_count)
+{
+  int size = 1;
+  while(size < 2 * var_count) size *= 2;
+  return size;
+}
+
 pip_sample_set *pip_sample_set_create(int32 sample_count, int32 var_count)
 {
   size_t varlen =
     sizeof(pip_sample_set) + 
-    ( sizeof(pip_sample_mapping) + sizeof(float8) * sample_count ) * var_count;
+    ( sizeof(pip_sample_mapping) + sizeof(float8) * sample_count ) * var_count +
+    sizeof(int32) * pip_sample_index_size(var_count);
   //Allocate with the SPI-aware palloc in case we want to
   //return the sample set.  Since sample_set is a SQL type, 
   //this will typically be the case; and if SPI isn't
@@ -58,26 +74,74 @@ pip_sample_set *pip_sample_set_create(int32 sample_count, int32 var_count)
   
   //bzero(set->data, ( sizeof(pip_sample_mapping) + sizeof(float8) * sample_count ) * var_count);
   for(i = 0; i < var_count; i++){
+    //no variable has id 0, so this marks the mapping as unnamed
+    SAMPLE_SET_ENTRY(i)->var.variable = 0;
+    SAMPLE_SET_ENTRY(i)->var.group = 0;
     for(j = 0; j < sample_count; j++){
       SAMPLE_SET_ENTRY(i)->val[j] = NAN;
     }
   }
+  for(i = 0; i <= SAMPLE_SET_INDEX_MASK(set); i++){
+    SAMPLE_SET_INDEX(set)[i] = -1;
+  }
   
   elog(PIP_PRESAMPLE_LOGLEVEL, "Creating pip sample set: %ds, %dv -> allocated %d", sample_count, var_count, (int)varlen);
   return set;
 }
 
-int       pip_sample_var_to_id     (pip_sample_set *set, pip_var_id *var)
+static int pip_sample_index_hash   (pip_sample_set *set, pip_var_id *var)
+{
+  return (int)(pip_prng_step_inline(var->variable ^ (var->group << 40)) & SAMPLE_SET_INDEX_MASK(set));
+}
+// If several mappings have the same name, the index keeps the first one.
+static void pip_sample_index_insert (pip_sample_set *set, int var)
+{
+  int32 *index = SAMPLE_SET_INDEX(set);
+  int mask = SAMPLE_SET_INDEX_MASK(set);
+  int h;
+  for(h = pip_sample_index_hash(set, &SAMPLE_SET_ENTRY(var)->var); index[h] >= 0; h = (h + 1) & mask){
+    if(pip_var_id_eq(&SAMPLE_SET_ENTRY(index[h])->var, &SAMPLE_SET_ENTRY(var)->var)){
+      if(var < index[h]) index[h] = var;
+      return;
+    }
+  }
+  index[h] = var;
+}
+static void pip_sample_index_rebuild(pip_sample_set *set)
 {
   int i;
+  for(i = 0; i <= SAMPLE_SET_INDEX_MASK(set); i++){
+    SAMPLE_SET_INDEX(set)[i] = -1;
+  }
   for(i = 0; i < set->var_cnt; i++){
-    if(pip_var_id_eq(&SAMPLE_SET_ENTRY(i)->var, var)) return i;
+    if(SAMPLE_SET_ENTRY(i)->var.variable != 0 || SAMPLE_SET_ENTRY(i)->var.group != 0){
+      pip_sample_index_insert(set, i);
+    }
+  }
+}
+
+int       pip_sample_var_to_id     (pip_sample_set *set, pip_var_id *var)
+{
+  int32 *index = SAMPLE_SET_INDEX(set);
+  int mask = SAMPLE_SET_INDEX_MASK(set);
+  int h;
+  for(h = pip_sample_index_hash(set, var); index[h] >= 0; h = (h + 1) & mask){
+    if(pip_var_id_eq(&SAMPLE_SET_ENTRY(index[h])->var, var)) return index[h];
   }
   return -1;
 }
 void      pip_sample_name_set      (pip_sample_set *set, int var, pip_var_id *name)
 {
+  bool renamed = 
+    (SAMPLE_SET_ENTRY(var)->var.variable != 0 || SAMPLE_SET_ENTRY(var)->var.group != 0) &&
+    !pip_var_id_eq(&SAMPLE_SET_ENTRY(var)->var, name);
   SAMPLE_SET_ENTRY(var)->var = *name;
+  //the index has no deletion, so a renamed mapping needs a new index
+  if(renamed){
+    pip_sample_index_rebuild(set);
+  } else {
+    pip_sample_index_insert(set, var);
+  }
 }
 pip_var_id *pip_sample_name_get      (pip_sample_set *set, int var)
 {
@@ -123,43 +187,101 @@ float8 pip_sample_var_val(pip_sample_set *set, int sample, pip_var *var)
   return val;
 }
 
-pip_sample_set *pip_sample_set_vector_max (pip_eqn *eqn, pip_sample_set *set, int clause_cnt, pip_atom **clause)
+// pip_sample_var_val() for count consecutive samples, looking up the variable
+// only once.  The values of a variable that is not in the set are generated
+// a batch at a time.
+void pip_sample_var_vals(pip_sample_set *set, int first_sample, int count, pip_var *var, float8 *vals)
+{
+  pip_sample_slot_vals(set, pip_sample_var_to_id(set, &var->vid), first_sample, count, var, vals);
+}
+void pip_sample_slot_vals(pip_sample_set *set, int id, int first_sample, int count, pip_var *var, float8 *vals)
 {
-  int i, j;
-  for(i = 0; i < set->sample_cnt; i++){
-    float8 val;
+  int64 seeds[PIP_GEN_BATCH];
+  int i, j, n;
+  if(id >= 0){
+    for(i = 0; i < count; i++){
+      vals[i] = pip_sample_val_get_by_id(set, id, first_sample + i);
+      if(isnan(vals[i])){
+        int seed = pip_sample_seed(set, first_sample + i);
+        vals[i] = pip_var_gen_w_name_and_seed(var, seed);
+      }
+    }
+  } else {
+    for(i = 0; i < count; i += n){
+      n = (count - i < PIP_GEN_BATCH) ? (count - i) : PIP_GEN_BATCH;
+      for(j = 0; j < n; j++){
+        //truncated to int like in pip_sample_var_val()
+        seeds[j] = (int)pip_sample_seed(set, first_sample + i + j);
+      }
+      pip_var_gen_w_name_and_seeds(var, seeds, n, vals + i);
+    }
+  }
+}
+
+// Evaluate eqn on the samples of set that satisfy the clause, PIP_EQN_BATCH
+// samples at a time.  The values are returned in vals, the samples they
+// belong to in samples.  Returns the number of values, 0 once all samples
+// are done.  The samples that fail the clause are set to 0 if they have no
+// value yet.
+static int pip_sample_set_vector_batch(pip_eqn_program *prog, pip_sample_set *set, int clause_cnt, pip_atom **clause, int *next, int *samples, float8 *vals)
+{
+  int64 seeds[PIP_EQN_BATCH];
+  int i, j, count = 0;
+  for(i = *next; i < set->sample_cnt && count < PIP_EQN_BATCH; i++){
+    int64 seed = pip_sample_seed(set, i);
     for(j = 0; j < clause_cnt; j++){
-      if(!pip_atom_evaluate_seed(clause[j], pip_sample_seed(set, i))) break;
+      if(!pip_atom_evaluate_seed(clause[j], seed)) break;
     }
     if(j >= clause_cnt){
-      val = pip_eqn_evaluate_seed(eqn, pip_sample_seed(set, i));
-      if(isnan(SAMPLE_SET_ENTRY(0)->val[i]) || (SAMPLE_SET_ENTRY(0)->val[i] < val)){
-        SAMPLE_SET_ENTRY(0)->val[i] = val;
-      }
+      samples[count] = i;
+      seeds[count] = seed;
+      count++;
     } else if(isnan(SAMPLE_SET_ENTRY(0)->val[i])){
       SAMPLE_SET_ENTRY(0)->val[i] = 0;
     }
   }
+  *next = i;
+  if(count > 0){
+    pip_eqn_program_evaluate_seeds(prog, seeds, count, vals);
+  }
+  return count;
+}
+
+pip_sample_set *pip_sample_set_vector_max (pip_eqn *eqn, pip_sample_set *set, int clause_cnt, pip_atom **clause)
+{
+  pip_eqn_program *prog = pip_eqn_compile(eqn);
+  int samples[PIP_EQN_BATCH];
+  float8 vals[PIP_EQN_BATCH];
+  int i, count, next = 0;
+  while(next < set->sample_cnt){
+    count = pip_sample_set_vector_batch(prog, set, clause_cnt, clause, &next, samples, vals);
+    for(i = 0; i < count; i++){
+      float8 *cur = &SAMPLE_SET_ENTRY(0)->val[samples[i]];
+      if(isnan(*cur) || (*cur < vals[i])){
+        *cur = vals[i];
+      }
+    }
+  }
+  pip_eqn_program_free(prog);
   return set;
 }
 pip_sample_set *pip_sample_set_vector_sum (pip_eqn *eqn, pip_sample_set *set, int clause_cnt, pip_atom **clause)
 {
-  int i, j;
-  for(i = 0; i < set->sample_cnt; i++){
-    float8 val;
-    for(j = 0; j < clause_cnt; j++){
-      if(!pip_atom_evaluate_seed(clause[j], pip_sample_seed(set, i))) break;
-    }
-    if(j >= clause_cnt){
-      val = pip_eqn_evaluate_seed(eqn, pip_sample_seed(set, i));
-      if(isnan(SAMPLE_SET_ENTRY(0)->val[i])){
-        SAMPLE_SET_ENTRY(0)->val[i] = val;    
+  pip_eqn_program *prog = pip_eqn_compile(eqn);
+  int samples[PIP_EQN_BATCH];
+  float8 vals[PIP_EQN_BATCH];
+  int i, count, next = 0;
+  while(next < set->sample_cnt){
+    count = pip_sample_set_vector_batch(prog, set, clause_cnt, clause, &next, samples, vals);
+    for(i = 0; i < count; i++){
+      float8 *cur = &SAMPLE_SET_ENTRY(0)->val[samples[i]];
+      if(isnan(*cur)){
+        *cur = vals[i];
       } else {
-        SAMPLE_SET_ENTRY(0)->val[i] += val;
+        *cur += vals[i];
       }
-    } else if(isnan(SAMPLE_SET_ENTRY(0)->val[i])){
-      SAMPLE_SET_ENTRY(0)->val[i] = 0;
     }
   }
+  pip_eqn_program_free(prog);
   return set;
 }
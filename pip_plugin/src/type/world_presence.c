@@ -0,0 +1,113 @@
+//////////////////////////////////////////////////////////////////////////
+// world_presence.c
+// 
+// Bit array operations for world presences.  The bits are processed a
+// 64 bit word at a time.  The words are read and written with memcpy()
+// because world presences are only int aligned when they come straight
+// out of a tuple; the compiler turns these into plain (or vector) loads.
+// 
+//////////////////////////////////////////////////////////////////////////
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "postgres.h"
+#include "fmgr.h"
+#include "executor/spi.h"
+
+#include "pip.h"
+#include "world_presence.h"
+
+static int pip_world_word_count(uint64 word);
+
+pip_world_presence *pip_world_presence_alloc(int32 worldcount, bool present)
+{
+  size_t              size = sizeof(pip_world_presence) + PIP_WORLD_BYTES(worldcount);
+  pip_world_presence *wp;
+  
+  elog(PIP_MCDB_INFO_LOGLEVEL, "Allocating world presence : %d bytes, %d length", (int)size, worldcount);
+  wp = SPI_palloc(size);
+  SET_VARSIZE(wp, size);
+  wp->worldcount = worldcount;
+  memset(wp->data, present ? 0xff : 0x00, PIP_WORLD_BYTES(worldcount));
+  return wp;
+}
+
+static int pip_world_word_count(uint64 word)
+{
+#ifdef __GNUC__
+  return __builtin_popcountll(word);
+#else
+  word = word - ((word >> 1) & UINT64CONST(0x5555555555555555));
+  word = (word & UINT64CONST(0x3333333333333333)) + ((word >> 2) & UINT64CONST(0x3333333333333333));
+  word = (word + (word >> 4)) & UINT64CONST(0x0f0f0f0f0f0f0f0f);
+  return (int)((word * UINT64CONST(0x0101010101010101)) >> 56);
+#endif
+}
+
+int pip_world_bits_count(const unsigned char *bits, int worldcount)
+{
+  int    nbytes = worldcount / 8;
+  int    i, cnt = 0;
+  uint64 word;
+  
+  for(i = 0; i + 8 <= nbytes; i += 8){
+    memcpy(&word, bits + i, 8);
+    cnt += pip_world_word_count(word);
+  }
+  for(; i < nbytes; i++){
+    cnt += pip_world_word_count(bits[i]);
+  }
+  //the bits past the last world don't count
+  if(worldcount % 8){
+    cnt += pip_world_word_count(bits[nbytes] & (0xff << (8 - worldcount % 8)) & 0xff);
+  }
+  return cnt;
+}
+
+void pip_world_bits_or(unsigned char *bits, const unsigned char *other, int nbytes)
+{
+  int    i;
+  uint64 a, b;
+  
+  for(i = 0; i + 8 <= nbytes; i += 8){
+    memcpy(&a, bits + i, 8);
+    memcpy(&b, other + i, 8);
+    a |= b;
+    memcpy(bits + i, &a, 8);
+  }
+  for(; i < nbytes; i++){
+    bits[i] |= other[i];
+  }
+}
+
+void pip_world_bits_and(unsigned char *bits, const unsigned char *other, int nbytes)
+{
+  int    i;
+  uint64 a, b;
+  
+  for(i = 0; i + 8 <= nbytes; i += 8){
+    memcpy(&a, bits + i, 8);
+    memcpy(&b, other + i, 8);
+    a &= b;
+    memcpy(bits + i, &a, 8);
+  }
+  for(; i < nbytes; i++){
+    bits[i] &= other[i];
+  }
+}
+
+void pip_world_bits_pack(const bool *vals, int count, bool pad, unsigned char *bits)
+{
+  int           i, j;
+  unsigned char byte;
+  
+  for(i = 0; i < count; i += 8){
+    byte = 0;
+    for(j = 0; j < 8; j++){
+      byte = (byte << 1) | (((i + j < count) ? vals[i + j] : pad) ? 1 : 0);
+    }
+    bits[i/8] = byte;
+  }
+}
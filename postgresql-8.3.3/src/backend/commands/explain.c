@@ -591,6 +591,11 @@ explain_outNode(StringInfo str,
 		case T_Unique:
 			pname = "Unique";
 			break;
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+			pname = "Repair Key";
+			break;
+		/* MAYBMS END */
 		case T_SetOp:
 			switch (((SetOp *) plan)->cmd)
 			{
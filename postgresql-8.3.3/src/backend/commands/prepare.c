@@ -96,6 +96,10 @@ PrepareQuery(PrepareStmt *stmt, const char *queryString)
 		}
 	}
 
+	/* MAYBMS BEGIN */
+	stmt->query = process(stmt->query);
+	/* MAYBMS END */
+
 	/*
 	 * Analyze the statement using these parameter types (any parameters
 	 * passed in from above us will not be visible to it), allowing
@@ -40,6 +40,14 @@
  */
 #define SEQ_LOG_VALS	32
 
+/* MAYBMS BEGIN */
+/*
+ * nextid() fetches the variable and domain IDs of repair-key and pick-tuples
+ * in blocks of at least this many values, see nextid_oid().
+ */
+#define SEQ_ID_BLOCK	1024
+/* MAYBMS END */
+
 /*
  * The "special area" of a sequence's buffer page looks like this.
  */
@@ -83,7 +91,9 @@ static SeqTable seqtab = NULL;	/* Head of list of SeqTable items */
  */
 static SeqTableData *last_used_seq = NULL;
 
-static int64 nextval_internal(Oid relid);
+/* MAYBMS BEGIN */
+static int64 nextval_internal(Oid relid, int64 mincache);
+/* MAYBMS END */
 static Relation open_share_lock(SeqTable seq);
 static void init_sequence(Oid relid, SeqTable *p_elm, Relation *p_rel);
 static Form_pg_sequence read_info(SeqTable elm, Relation rel, Buffer *buf);
@@ -401,7 +411,9 @@ nextval(PG_FUNCTION_ARGS)
 	sequence = makeRangeVarFromNameList(textToQualifiedNameList(seqin));
 	relid = RangeVarGetRelid(sequence, false);
 
-	PG_RETURN_INT64(nextval_internal(relid));
+	/* MAYBMS BEGIN */
+	PG_RETURN_INT64(nextval_internal(relid, 1));
+	/* MAYBMS END */
 }
 
 Datum
@@ -409,11 +421,37 @@ nextval_oid(PG_FUNCTION_ARGS)
 {
 	Oid			relid = PG_GETARG_OID(0);
 
-	PG_RETURN_INT64(nextval_internal(relid));
+	/* MAYBMS BEGIN */
+	PG_RETURN_INT64(nextval_internal(relid, 1));
+	/* MAYBMS END */
+}
+
+/* MAYBMS BEGIN */
+
+/*
+ * nextid is nextval() for the variable and domain IDs that repair-key and
+ * pick-tuples assign to every tuple they create.  Like values of a sequence
+ * with a large CACHE, the IDs are reserved in blocks of SEQ_ID_BLOCK values
+ * per backend, regardless of the CACHE of the sequence.  Creating a large
+ * U-relation thus locks the sequence buffer and writes WAL once per block,
+ * and concurrent loaders take disjoint blocks.  Unused values of a block are
+ * lost when the backend exits, as for any cached sequence values.
+ */
+Datum
+nextid_oid(PG_FUNCTION_ARGS)
+{
+	Oid			relid = PG_GETARG_OID(0);
+
+	PG_RETURN_INT64(nextval_internal(relid, SEQ_ID_BLOCK));
 }
 
+/*
+ * mincache is the least number of values to fetch into the local cache when
+ * it is used up, the CACHE of the sequence is fetched if that is more.
+ */
 static int64
-nextval_internal(Oid relid)
+nextval_internal(Oid relid, int64 mincache)
+/* MAYBMS END */
 {
 	SeqTable	elm;
 	Relation	seqrel;
@@ -460,7 +498,9 @@ nextval_internal(Oid relid)
 	incby = seq->increment_by;
 	maxv = seq->max_value;
 	minv = seq->min_value;
-	fetch = cache = seq->cache_value;
+	/* MAYBMS BEGIN */
+	fetch = cache = Max(seq->cache_value, mincache);
+	/* MAYBMS END */
 	log = seq->log_cnt;
 
 	if (!seq->is_called)
@@ -30,6 +30,7 @@
 #include "executor/nodeMaterial.h"
 #include "executor/nodeMergejoin.h"
 #include "executor/nodeNestloop.h"
+#include "executor/nodeRepairKey.h"
 #include "executor/nodeResult.h"
 #include "executor/nodeSeqscan.h"
 #include "executor/nodeSetOp.h"
@@ -181,6 +182,12 @@ ExecReScan(PlanState *node, ExprContext *exprCtxt)
 			ExecReScanUnique((UniqueState *) node, exprCtxt);
 			break;
 
+		/* MAYBMS BEGIN */
+		case T_RepairKeyState:
+			ExecReScanRepairKey((RepairKeyState *) node, exprCtxt);
+			break;
+		/* MAYBMS END */
+
 		case T_HashState:
 			ExecReScanHash((HashState *) node, exprCtxt);
 			break;
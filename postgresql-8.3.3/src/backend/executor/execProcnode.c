@@ -94,6 +94,7 @@
 #include "executor/nodeMaterial.h"
 #include "executor/nodeMergejoin.h"
 #include "executor/nodeNestloop.h"
+#include "executor/nodeRepairKey.h"
 #include "executor/nodeResult.h"
 #include "executor/nodeSeqscan.h"
 #include "executor/nodeSetOp.h"
@@ -246,6 +247,13 @@ ExecInitNode(Plan *node, EState *estate, int eflags)
 												  estate, eflags);
 			break;
 
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+			result = (PlanState *) ExecInitRepairKey((RepairKey *) node,
+													 estate, eflags);
+			break;
+		/* MAYBMS END */
+
 		case T_Hash:
 			result = (PlanState *) ExecInitHash((Hash *) node,
 												estate, eflags);
@@ -398,6 +406,12 @@ ExecProcNode(PlanState *node)
 			result = ExecUnique((UniqueState *) node);
 			break;
 
+		/* MAYBMS BEGIN */
+		case T_RepairKeyState:
+			result = ExecRepairKey((RepairKeyState *) node);
+			break;
+		/* MAYBMS END */
+
 		case T_HashState:
 			result = ExecHash((HashState *) node);
 			break;
@@ -564,6 +578,11 @@ ExecCountSlotsNode(Plan *node)
 		case T_Unique:
 			return ExecCountSlotsUnique((Unique *) node);
 
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+			return ExecCountSlotsRepairKey((RepairKey *) node);
+		/* MAYBMS END */
+
 		case T_Hash:
 			return ExecCountSlotsHash((Hash *) node);
 
@@ -701,6 +720,12 @@ ExecEndNode(PlanState *node)
 			ExecEndUnique((UniqueState *) node);
 			break;
 
+		/* MAYBMS BEGIN */
+		case T_RepairKeyState:
+			ExecEndRepairKey((RepairKeyState *) node);
+			break;
+		/* MAYBMS END */
+
 		case T_HashState:
 			ExecEndHash((HashState *) node);
 			break;
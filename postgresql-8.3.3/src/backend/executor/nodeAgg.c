@@ -768,9 +768,10 @@ lookup_hash_entry(AggState *aggstate, TupleTableSlot *inputslot)
 		
 		/* MAYBMS BEGIN */
 		
-		entry->lineage = palloc0( sizeof( lineageTable ) );
-		entry->state = palloc0( sizeof( stateData ) );
-		entry->argmax = palloc0( sizeof( argmaxState ) );
+		/* The states live as long as the hash table */
+		entry->lineage = MemoryContextAllocZero( aggstate->aggcontext, sizeof( lineageTable ) );
+		entry->state = MemoryContextAllocZero( aggstate->aggcontext, sizeof( stateData ) );
+		entry->argmax = MemoryContextAllocZero( aggstate->aggcontext, sizeof( argmaxState ) );
 		
 		/* MAYBMS END */
 	}
@@ -1183,7 +1184,10 @@ ExecInitAgg(Agg *node, EState *estate, int eflags)
 	
 	aggstate->state = palloc0( sizeof( stateData ) );
 	aggstate->lineage = palloc0( sizeof( lineageTable ) );
-	aggstate->genstate = palloc0( sizeof( generalState ) );
+	aggstate->genstates = NULL;
+	aggstate->genstate_count = 0;
+	aggstate->genstate_max = 0;
+	aggstate->genstate_live = 0;
 	aggstate->argmax = palloc0( sizeof( argmaxState ) );
 	
 	/* MAYBMS END */
@@ -1669,6 +1673,20 @@ ExecReScanAgg(AggState *node, ExprContext *exprCtxt)
 	 */
 	MemoryContextResetAndDeleteChildren(node->aggcontext);
 
+	/* MAYBMS BEGIN */
+
+	/* The states of conf and aconf were allocated in the aggcontext */
+	node->genstates = NULL;
+	node->genstate_count = 0;
+	node->genstate_max = 0;
+	node->genstate_live = 0;
+
+	/* So was the group context of the state of conf for hierarchical queries */
+	MemSet(node->state, 0, sizeof(stateData));
+	MemSet(node->lineage, 0, sizeof(lineageTable));
+
+	/* MAYBMS END */
+
 	if (((Agg *) node->ss.ps.plan)->aggstrategy == AGG_HASHED)
 	{
 		/* Rebuild an empty hash table */
@@ -0,0 +1,375 @@
+/*-------------------------------------------------------------------------
+ *
+ * nodeRepairKey.c
+ *	  Routines to handle the single pass of repair-key.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+/*
+ * INTERFACE ROUTINES
+ *		ExecRepairKey		- assign the condition columns of a repair-key
+ *		ExecInitRepairKey	- initialize node and subnodes
+ *		ExecEndRepairKey	- shutdown node and subnodes
+ *
+ * NOTES
+ *		Assumes tuples returned from subplan arrive in sorted order on the
+ *		key and then on all other columns and the weight, so that the
+ *		duplicates of a tuple follow it.  Copies of a tuple with different
+ *		weights do not match on the weight and are different alternatives.
+ *
+ *		A block of tuples sharing the same key is read into a tuplestore,
+ *		which spills to disk if the block does not fit into work_mem.  Each
+ *		distinct tuple gets a new domain value, which its duplicates share,
+ *		and the weights of the distinct tuples are summed up.  Then the
+ *		tuples of the block are returned with one new variable for the block
+ *		and their weights divided by the sum as probabilities.  Thus the input
+ *		is consumed only once, instead of three times as in a join of the
+ *		input with the duplicate elimination and with its per-key sums.
+ */
+
+#include "postgres.h"
+
+#include "catalog/namespace.h"
+#include "commands/sequence.h"
+#include "executor/executor.h"
+#include "executor/nodeRepairKey.h"
+#include "maybms/rewrite.h"
+#include "miscadmin.h"
+#include "nodes/makefuncs.h"
+#include "utils/memutils.h"
+#include "utils/tuplestore.h"
+
+static void fetch_block(RepairKeyState *node);
+static float4 get_weight(TupleTableSlot *slot, AttrNumber probColIdx);
+static int32 next_id(Oid seq, MemoryContext tempContext);
+
+
+/* ----------------------------------------------------------------
+ *		ExecRepairKey
+ *
+ *		Returns the tuples of the current block with their condition
+ *		columns, reading the next block when the current one is done.
+ * ----------------------------------------------------------------
+ */
+TupleTableSlot *				/* return: a tuple or NULL */
+ExecRepairKey(RepairKeyState *node)
+{
+	RepairKey  *plannode = (RepairKey *) node->ps.plan;
+	TupleTableSlot *resultTupleSlot = node->ps.ps_ResultTupleSlot;
+	TupleTableSlot *slot = node->blockSlot;
+	MemoryContext oldContext;
+	float4		weight;
+	int			natts;
+
+	/* The previous result tuple is not needed anymore */
+	MemoryContextReset(node->tempContext);
+
+	for (;;)
+	{
+		if (node->block != NULL)
+		{
+			if (tuplestore_gettupleslot((Tuplestorestate *) node->block,
+										true, slot))
+				break;
+
+			tuplestore_end((Tuplestorestate *) node->block);
+			node->block = NULL;
+		}
+
+		if (node->done)
+			return ExecClearTuple(resultTupleSlot);
+
+		fetch_block(node);
+	}
+
+	/*
+	 * Copy the tuple into the result slot and fill in the variable and the
+	 * probability.  The domain value was assigned when reading the block.
+	 */
+	natts = slot->tts_tupleDescriptor->natts;
+	slot_getallattrs(slot);
+
+	ExecClearTuple(resultTupleSlot);
+	memcpy(resultTupleSlot->tts_values, slot->tts_values, natts * sizeof(Datum));
+	memcpy(resultTupleSlot->tts_isnull, slot->tts_isnull, natts * sizeof(bool));
+
+	weight = get_weight(slot, plannode->probColIdx);
+
+	oldContext = MemoryContextSwitchTo(node->tempContext);
+
+	resultTupleSlot->tts_values[plannode->varColIdx - 1] = Int32GetDatum(node->var);
+	resultTupleSlot->tts_isnull[plannode->varColIdx - 1] = false;
+	resultTupleSlot->tts_values[plannode->probColIdx - 1] =
+		Float4GetDatum((float4) (weight / node->weightsum));
+
+	MemoryContextSwitchTo(oldContext);
+
+	return ExecStoreVirtualTuple(resultTupleSlot);
+}
+
+/*
+ * fetch_block
+ *
+ *		Read the next block of tuples sharing the same key into a new
+ *		tuplestore, assign the domain values and the variable of the block,
+ *		and sum up the weights.  The result slot is free at this point and
+ *		is used to put the tuples together with their domain values.
+ */
+static void
+fetch_block(RepairKeyState *node)
+{
+	RepairKey  *plannode = (RepairKey *) node->ps.plan;
+	PlanState  *outerPlan = outerPlanState(node);
+	TupleTableSlot *prevSlot = node->prevSlot;
+	TupleTableSlot *workSlot = node->ps.ps_ResultTupleSlot;
+	TupleTableSlot *slot;
+	Tuplestorestate *block;
+	int			natts;
+	int32		dom = 0;
+
+	/* The first tuple of the block was read with the previous block */
+	if (TupIsNull(prevSlot))
+	{
+		slot = ExecProcNode(outerPlan);
+		if (TupIsNull(slot))
+		{
+			node->done = true;
+			return;
+		}
+		ExecCopySlot(prevSlot, slot);
+	}
+
+	block = tuplestore_begin_heap(false, false, work_mem);
+	node->weightsum = 0;
+
+	natts = prevSlot->tts_tupleDescriptor->natts;
+	slot = prevSlot;
+
+	for (;;)
+	{
+		MemoryContextReset(node->tempContext);
+
+		/* A tuple that does not repeat the previous one is a new alternative */
+		if (slot == prevSlot ||
+			!execTuplesMatch(slot, prevSlot,
+							 plannode->numCols, plannode->sortColIdx,
+							 node->eqfunctions,
+							 node->tempContext))
+		{
+			dom = next_id(node->domSeq, node->tempContext);
+			node->weightsum += get_weight(slot, plannode->probColIdx);
+		}
+
+		slot_getallattrs(slot);
+
+		ExecClearTuple(workSlot);
+		memcpy(workSlot->tts_values, slot->tts_values, natts * sizeof(Datum));
+		memcpy(workSlot->tts_isnull, slot->tts_isnull, natts * sizeof(bool));
+		workSlot->tts_values[plannode->domColIdx - 1] = Int32GetDatum(dom);
+		workSlot->tts_isnull[plannode->domColIdx - 1] = false;
+		ExecStoreVirtualTuple(workSlot);
+
+		tuplestore_puttupleslot(block, workSlot);
+
+		if (slot != prevSlot)
+			ExecCopySlot(prevSlot, slot);
+
+		slot = ExecProcNode(outerPlan);
+		if (TupIsNull(slot))
+		{
+			node->done = true;
+			ExecClearTuple(prevSlot);
+			break;
+		}
+
+		if (!execTuplesMatch(slot, prevSlot,
+							 plannode->numKeyCols, plannode->sortColIdx,
+							 node->eqfunctions,
+							 node->tempContext))
+		{
+			/* Keep the tuple, it starts the next block */
+			ExecCopySlot(prevSlot, slot);
+			break;
+		}
+	}
+
+	ExecClearTuple(workSlot);
+	MemoryContextReset(node->tempContext);
+
+	node->block = block;
+	node->var = next_id(node->varSeq, node->tempContext);
+}
+
+/*
+ * get_weight
+ *
+ *		Return the weight of a tuple, which the rewriting of repair-key puts
+ *		into the probability column.
+ */
+static float4
+get_weight(TupleTableSlot *slot, AttrNumber probColIdx)
+{
+	Datum		weight;
+	bool		isnull;
+
+	weight = slot_getattr(slot, probColIdx, &isnull);
+	if (isnull)
+		elog(ERROR, "repair-key input has a null weight");
+
+	return DatumGetFloat4(weight);
+}
+
+/*
+ * next_id
+ *
+ *		Return the next value of a sequence of variables or domain values.
+ *		The int8 result is allocated in the short-term context.
+ */
+static int32
+next_id(Oid seq, MemoryContext tempContext)
+{
+	MemoryContext oldContext = MemoryContextSwitchTo(tempContext);
+	int32		id;
+
+	id = (int32) DatumGetInt64(DirectFunctionCall1(nextid_oid,
+												   ObjectIdGetDatum(seq)));
+
+	MemoryContextSwitchTo(oldContext);
+
+	return id;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecInitRepairKey
+ *
+ *		This initializes the repair-key node state structures and
+ *		the node's subplan.
+ * ----------------------------------------------------------------
+ */
+RepairKeyState *
+ExecInitRepairKey(RepairKey *node, EState *estate, int eflags)
+{
+	RepairKeyState *rkstate;
+	TupleDesc	tupDesc;
+
+	/* check for unsupported flags */
+	Assert(!(eflags & (EXEC_FLAG_BACKWARD | EXEC_FLAG_MARK)));
+
+	/*
+	 * create state structure
+	 */
+	rkstate = makeNode(RepairKeyState);
+	rkstate->ps.plan = (Plan *) node;
+	rkstate->ps.state = estate;
+	rkstate->block = NULL;
+	rkstate->done = false;
+
+	/*
+	 * Miscellaneous initialization
+	 *
+	 * RepairKey nodes never call ExecQual or ExecProject, but they need a
+	 * short-term memory context for calling execTuplesMatch and for the
+	 * pass-by-reference values of the result tuple.
+	 */
+	rkstate->tempContext =
+		AllocSetContextCreate(CurrentMemoryContext,
+							  "RepairKey",
+							  ALLOCSET_DEFAULT_MINSIZE,
+							  ALLOCSET_DEFAULT_INITSIZE,
+							  ALLOCSET_DEFAULT_MAXSIZE);
+
+#define REPAIRKEY_NSLOTS 3
+
+	/*
+	 * Tuple table initialization
+	 */
+	ExecInitResultTupleSlot(estate, &rkstate->ps);
+	rkstate->prevSlot = ExecInitExtraTupleSlot(estate);
+	rkstate->blockSlot = ExecInitExtraTupleSlot(estate);
+
+	/*
+	 * then initialize outer plan
+	 */
+	outerPlanState(rkstate) = ExecInitNode(outerPlan(node), estate, eflags);
+
+	/*
+	 * repair-key nodes do no projections, so initialize projection info for
+	 * this node appropriately
+	 */
+	ExecAssignResultTypeFromTL(&rkstate->ps);
+	rkstate->ps.ps_ProjInfo = NULL;
+
+	tupDesc = ExecGetResultType(outerPlanState(rkstate));
+	ExecSetSlotDescriptor(rkstate->prevSlot, tupDesc);
+	ExecSetSlotDescriptor(rkstate->blockSlot, tupDesc);
+
+	/*
+	 * Precompute fmgr lookup data for inner loop
+	 */
+	rkstate->eqfunctions =
+		execTuplesMatchPrepare(node->numCols,
+							   node->eqOperators);
+
+	/* Look up the sequences, like nextid() does for its argument */
+	rkstate->varSeq = RangeVarGetRelid(makeRangeVar(NULL, VARIDSEQ), false);
+	rkstate->domSeq = RangeVarGetRelid(makeRangeVar(NULL, DOMAINIDSEQ), false);
+
+	return rkstate;
+}
+
+int
+ExecCountSlotsRepairKey(RepairKey *node)
+{
+	return ExecCountSlotsNode(outerPlan(node)) +
+		ExecCountSlotsNode(innerPlan(node)) +
+		REPAIRKEY_NSLOTS;
+}
+
+/* ----------------------------------------------------------------
+ *		ExecEndRepairKey
+ *
+ *		This shuts down the subplan and frees resources allocated
+ *		to this node.
+ * ----------------------------------------------------------------
+ */
+void
+ExecEndRepairKey(RepairKeyState *node)
+{
+	/* clean up tuple table */
+	ExecClearTuple(node->ps.ps_ResultTupleSlot);
+	ExecClearTuple(node->prevSlot);
+	ExecClearTuple(node->blockSlot);
+
+	if (node->block != NULL)
+		tuplestore_end((Tuplestorestate *) node->block);
+	node->block = NULL;
+
+	MemoryContextDelete(node->tempContext);
+
+	ExecEndNode(outerPlanState(node));
+}
+
+
+void
+ExecReScanRepairKey(RepairKeyState *node, ExprContext *exprCtxt)
+{
+	/* discard the current block and start again with the first one */
+	ExecClearTuple(node->ps.ps_ResultTupleSlot);
+	ExecClearTuple(node->prevSlot);
+	ExecClearTuple(node->blockSlot);
+
+	if (node->block != NULL)
+		tuplestore_end((Tuplestorestate *) node->block);
+	node->block = NULL;
+	node->done = false;
+
+	/*
+	 * if chgParam of subnode is not null then plan will be re-scanned by
+	 * first ExecProcNode.
+	 */
+	if (((PlanState *) node)->lefttree->chgParam == NULL)
+		ExecReScan(((PlanState *) node)->lefttree, exprCtxt);
+}
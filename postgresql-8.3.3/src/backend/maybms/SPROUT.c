@@ -81,66 +81,51 @@
 #include "nodes/execnodes.h"
 #include "maybms/bitset.h"
 #include "maybms/conf_comp.h"
+#include "maybms/condvec.h"
+#include "access/hash.h"
 
 #define NOTAGGREGATED 0
 #define AGGREGATED   1
-#define HASHTABLESIZE 10000000
-
-/* MACRO for accumulating new tuples */
-#define accumulate( nargs ) \
-	MemoryContext oldcxt; \
-	AggState *aggState = ( AggState *) fcinfo->context; \
-	int n = nargs, i = 0; \
-	varType *vars;\
-	prob *probs;\
-	if ( groupcxt == NULL )\
-	{ \
-		groupcxt = AllocSetContextCreate( NULL, "GroupContext",  ALLOCSET_DEFAULT_MINSIZE, \
-                                        	 ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);\
-    }\
-    oldcxt = MemoryContextSwitchTo( groupcxt ); \
-	vars = palloc0( n * sizeof( varType ) ); \
-	probs = palloc0( n * sizeof( prob ) ); \
-	for( ; i < n ; i++ ){ \
-		*( vars + i ) = PG_GETARG_INT32( 1 + i*2 ); \
-		*( probs + i ) = PG_GETARG_FLOAT4( 2 + i*2 );	\
-	} \
-	advance( aggState, n, vars, probs ); \
-	MemoryContextSwitchTo( oldcxt ); \
-	PG_RETURN_DATUM( 1 );
+
+/* Minimal number of buckets and maximal fill factor (in percent) of the 
+ * variable tables 
+ */
+#define VARTABLEMINSIZE 64
+#define VARTABLEFILL 75
 
 /* variable entry in hash table */
 typedef struct varEntry{
 	varType var;
+	bool used;
 	probTableEntry *pte;
-	struct varEntry *next;
 } varEntry;
 
-/* variable list used in hash table */
-typedef struct varList{
-	varEntry *head;
-	varEntry *tail;
-} varList;
-
-/* The memory context for a group of duplicates */
-MemoryContext groupcxt = NULL;
+/* Open-addressing hash table from the variables of a column to the entries 
+ * of the probability table. The entries are kept inline and probed linearly.
+ */
+typedef struct varTable{
+	varEntry *entries;
+	int size;		/* number of buckets, a power of 2 */
+	int count;		/* number of used buckets */
+} varTable;
 
 /* local utility functions */
 static sigNode *get1stLeafChild( sigNode *node );
 static void storeLineage( lineageTable *lineage, int n, varType *vars, prob *probs );
 static void addVarProb( varprob *vp, lineageTable *lineage );
 static void resetLineageCursor( lineageTable *lineage );
-static void	advance( AggState *aggState, int n, varType *vars, prob *probs );
+static void	advance( stateData *state, lineageTable *lineage, int n, varType *vars, prob *probs );
 static prob indeEventConjunc( prob a, prob b );
 static bool isAValidVar( sigNode *info, varType var );
 static prob lookup( sigNode *info, varType var, prob probability );
-static int hashFunction( varType var );
 static void insertIntoProbTable( probTable *pt, probTableEntry *entry );
-static void insertIntoVarList( varList *list, varEntry *entry );
 static prob getProduct( sigNode *info, prob p, readySum **plist );
 static readySum *insertIntoReadySumList( readySum *head, prob sum );
-static probTableEntry *getPTEFromHT( varList *ht, varType var );
-static void newVarEntry( varType var, probTableEntry *pte, varList *ht );
+static void initVarTable( varTable *ht, int expected );
+static varEntry *findVarEntry( varTable *ht, varType var );
+static void expandVarTable( varTable *ht );
+static probTableEntry *getPTEFromHT( varTable *ht, varType var );
+static void newVarEntry( varType var, probTableEntry *pte, varTable *ht );
 
 /* local function for the scheduler */
 static void schedule( sigNode *node, lineageTable *lineage );
@@ -182,94 +167,44 @@ conf_accum1(PG_FUNCTION_ARGS)
 	PG_RETURN_FLOAT4( result );
 }
 
-/*  conf_accum2
+/*  conf_accum
  *
- *  Transition function for conf with 2 pairs of condition columns.
+ *  Transition function for conf with several pairs of condition columns,
+ *  which are passed as arrays of variables and probabilities (see condvec.c).
  */
 Datum 
-conf_accum2(PG_FUNCTION_ARGS)
+conf_accum(PG_FUNCTION_ARGS)
 {
-	accumulate( 2 )
-}
+	MemoryContext oldcxt;
+	AggState *aggState = ( AggState *) fcinfo->context;
+	stateData *state;
+	lineageTable *lineage;
+	varType *args_vars, *vars;
+	prob *args_probs, *probs;
+	int n = getCondColumns( fcinfo, 1, &args_vars, NULL, &args_probs );
 
-/*  conf_accum3
- *
- *  Transition function for conf with 3 pairs of condition columns.
- */
-Datum 
-conf_accum3(PG_FUNCTION_ARGS)
-{
-	accumulate( 3 )
-}
+	getStateAndLineage( aggState, &state, &lineage );
 
-/*  conf_accum4
- *
- *  Transition function for conf with 4 pairs of condition columns.
- */
-Datum 
-conf_accum4(PG_FUNCTION_ARGS)
-{
-	accumulate( 4 )
-}
+	if ( state->groupcxt == NULL )
+	{
+		state->groupcxt = AllocSetContextCreate( aggState->aggcontext, "GroupContext",  ALLOCSET_DEFAULT_MINSIZE,
+                                        	 ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);
+		state->finalized = false;
+	}
 
-/*  conf_accum5
- *
- *  Transition function for conf with 5 pairs of condition columns.
- */
-Datum 
-conf_accum5(PG_FUNCTION_ARGS)
-{
-	accumulate( 5 )
-}
+	oldcxt = MemoryContextSwitchTo( state->groupcxt );
 
-/*  conf_accum6
- *
- *  Transition function for conf with 6 pairs of condition columns.
- */
-Datum 
-conf_accum6(PG_FUNCTION_ARGS)
-{
-	accumulate( 6 )
-}
-
-/*  conf_accum7
- *
- *  Transition function for conf with 7 pairs of condition columns.
- */
-Datum 
-conf_accum7(PG_FUNCTION_ARGS)
-{
-	accumulate( 7 )
-}
+	/* The condition columns are kept with the lineage of the group */
+	vars = palloc( n * sizeof( varType ) );
+	probs = palloc( n * sizeof( prob ) );
+	memcpy( vars, args_vars, n * sizeof( varType ) );
+	memcpy( probs, args_probs, n * sizeof( prob ) );
 
-/*  conf_accum8
- *
- *  Transition function for conf with 8 pairs of condition columns.
- */
-Datum 
-conf_accum8(PG_FUNCTION_ARGS)
-{
-	accumulate( 8 )
-}
+	advance( state, lineage, n, vars, probs );
 
-/*  conf_accum9
- *
- *  Transition function for conf with 9 pairs of condition columns.
- */
-Datum 
-conf_accum9(PG_FUNCTION_ARGS)
-{
-	accumulate( 9 )
-}
+	MemoryContextSwitchTo( oldcxt );
 
-/*  conf_accum10
- *
- *  Transition function for conf with 10 pairs of condition columns.
- */
-Datum 
-conf_accum10(PG_FUNCTION_ARGS)
-{
-	accumulate( 10 )
+	PG_RETURN_DATUM( 1 );
 }
 
 /*  conf_final 
@@ -286,15 +221,19 @@ conf_final(PG_FUNCTION_ARGS)
 	MemoryContext oldcxt;
 	bool onescan = isOneScan;
 
+	/* Get the current state of confidence computation */	
+	getStateAndLineage( aggState, &state, &lineage );
+
+	/* The group of a hash table entry is finalized again on rescans */
+	if( state->finalized )
+		PG_RETURN_FLOAT4( state->result );
+
 	/* If the group context is NULL, return 0 */	
-	if( groupcxt == NULL )
+	if( state->groupcxt == NULL )
 		PG_RETURN_FLOAT4(0);
 	
 	/* Switch to the group context */	
-	oldcxt = MemoryContextSwitchTo( groupcxt ); 
-
-	/* Get the current state of confidence computation */	
-	getStateAndLineage( aggState, &state, &lineage );
+	oldcxt = MemoryContextSwitchTo( state->groupcxt ); 
 
 	/* Process a NULL tuple to close the last partition */
 	if ( onescan )
@@ -302,6 +241,7 @@ conf_final(PG_FUNCTION_ARGS)
 		processTuple( state, NULL, &result );
 
 		state->counter = 0;
+		state->NoOfVars = 0;
 	}
 	/* Aggregate the variable columns to gain 1scan property and compute the 
 	 * confidence with 1scan property.
@@ -325,22 +265,34 @@ conf_final(PG_FUNCTION_ARGS)
 		derivePos( sigTreeRoot, 0 );
 		calSib( sigTreeRoot );
 		calDomain( sigTreeRoot );
+
+		/* Keep the rebuilt signature for the next execution of the query */
+		if ( currentSignature != NULL )
+			currentSignature->sigTreeRoot = sigTreeRoot;
 		
 		/* Switch to group context */
-		MemoryContextSwitchTo( groupcxt ); 
+		MemoryContextSwitchTo( state->groupcxt ); 
 
 		/* Reset the pointers in the lineage */
 		lineage->head = NULL;
 		lineage->tail = NULL;
 		lineage->cursor = NULL;
+		lineage->count = 0;
 	}
 	
 	/* Switch to the old context */
 	MemoryContextSwitchTo( oldcxt );
 	
 	/* Delete the group context */
-	MemoryContextDelete( groupcxt );
-	groupcxt = NULL;   
+	MemoryContextDelete( state->groupcxt );
+	state->groupcxt = NULL;   
+
+	/* Keep the result for rescans of a hash table */
+	if (((Agg *) aggState->ss.ps.plan)->aggstrategy == AGG_HASHED)
+	{
+		state->finalized = true;
+		state->result = result;
+	}
 
 	/* Return the result */
 	PG_RETURN_FLOAT4( result );
@@ -456,13 +408,14 @@ addVarProb( varprob *vp, lineageTable *lineage )
 		lineage->tail->next = vp;
 		lineage->tail = vp;
 	}
+
+	lineage->count++;
 }
 
 /* getStateAndLineage
  *
- * Get the pointer of state and lineage.
- * TODO: This function is not necessary anymore, because hashing is not used in
- * duplicate elimination due to the sorting in the rewriting.
+ * Get the pointer of state and lineage of the current group. With hashing,
+ * every entry of the hash table has its own.
  */
 static void 
 getStateAndLineage( AggState *aggState, stateData **state, lineageTable **lineage )
@@ -483,14 +436,10 @@ getStateAndLineage( AggState *aggState, stateData **state, lineageTable **lineag
  * Process one tuple of lineage.
  */
 static void	
-advance(AggState *aggState, int n, varType *vars, prob *probs)
+advance(stateData *state, lineageTable *lineage, int n, varType *vars, prob *probs)
 {
-	stateData *state;
-	lineageTable *lineage;	
 	bool onescan = isOneScan; 
 
-	getStateAndLineage( aggState, &state, &lineage );
-
 	/* Accumulate the tuple of lineage to the confidence if 1scan property
 	 * is present.
 	 */
@@ -506,6 +455,8 @@ advance(AggState *aggState, int n, varType *vars, prob *probs)
 			state->vars = sig;
 			state->NoOfVars = n; 
 		}
+		else if( state->NoOfVars != n )
+			elog( ERROR, "tuples of the lineage of a group differ in length" );
 
 		/* Set the condition columns for confidence computation */
 		state->curTuple = vars;
@@ -538,12 +489,17 @@ simpleAggregation( sigNode **vars, int NoOfVars, lineageTable *lineage )
 	probTable *pt = palloc0( 1 * sizeof(probTable) );
 	int i;
 	int pos[NoOfVars];
-	varList *hashTable0 = (varList *) palloc0( HASHTABLESIZE * sizeof(varList) ); 
-	varList *hashTable1 = (varList *) palloc0( HASHTABLESIZE * sizeof(varList) ); 
+	varTable ht0, ht1;
+	varTable *hashTable0 = &ht0;
+	varTable *hashTable1 = &ht1;
 	bool newX, newY;
 	probTableEntry *pte;
 	varprob *tuple = NULL;
 
+	/* A column has at most as many variables as the lineage has tuples */
+	initVarTable( hashTable0, lineage->count );
+	initVarTable( hashTable1, lineage->count );
+
 	/* Set the positions of all variables */
 	for(i=0; i<NoOfVars ;i++ )
 	{
@@ -562,8 +518,8 @@ simpleAggregation( sigNode **vars, int NoOfVars, lineageTable *lineage )
 		if ( tuple == NULL )
 		{
 			vars[0]->pt = pt;
-			pfree( hashTable0 );
-			pfree( hashTable1 );
+			pfree( hashTable0->entries );
+			pfree( hashTable1->entries );
 			break;
 		}
 
@@ -678,8 +634,13 @@ complexAggregation( sigNode **vars, int NoOfVars, lineageTable *lineage )
 	varprob *tuple = NULL;
 	probTable *pt = palloc0( 1 * sizeof(probTable) );
 	bool newX = false, newY, updatePTE, calculating;
-	varList *hashTable0 = ( varList * ) palloc0( HASHTABLESIZE * sizeof(varList) ); 
-	varList *hashTable1 = ( varList * ) palloc0( HASHTABLESIZE * sizeof(varList) ); 
+	varTable ht0, ht1;
+	varTable *hashTable0 = &ht0;
+	varTable *hashTable1 = &ht1;
+
+	/* A column has at most as many variables as the lineage has tuples */
+	initVarTable( hashTable0, lineage->count );
+	initVarTable( hashTable1, lineage->count );
 	
 	/* Set the positions of all involved variable columns */
 	for( i=0; i<NoOfVars ;i++ )
@@ -706,8 +667,8 @@ complexAggregation( sigNode **vars, int NoOfVars, lineageTable *lineage )
 finish:;
 			/* Attach the probability table to the variable node */
 			vars[0]->pt = pt; 
-			pfree( hashTable0 );
-			pfree( hashTable1 );
+			pfree( hashTable0->entries );
+			pfree( hashTable1->entries );
 			break;
 		}
 
@@ -971,25 +932,6 @@ insertIntoReadySumList( readySum *head, prob sum )
 	return s;
 }
 
-/* insertIntoVarList
- *
- * Insert a variable into a hash table entry.
- */
-static void 
-insertIntoVarList(varList *list, varEntry *entry)
-{
-	if ( list->head == NULL )
-	{
-		list->head = entry;
-		list->tail = entry;
-	}
-	else
-	{
-		list->tail->next = entry;
-		list->tail = entry;
-	}
-}
-
 /* insertIntoProbTable
  *
  * Insert a representative and its probability to probability table.
@@ -1009,50 +951,93 @@ insertIntoProbTable( probTable *pt, probTableEntry *entry )
 	}
 }
 
-/* hashFunction
+/* initVarTable
  *
- * Return a hash value.
+ * Create an empty variable table with room for the expected number of 
+ * variables.
  */
-static int 
-hashFunction( varType var )
+static void
+initVarTable( varTable *ht, int expected )
 {
-	return var % HASHTABLESIZE;
+	ht->size = VARTABLEMINSIZE;
+
+	while( ht->size < ( int64 ) expected * 100 / VARTABLEFILL )
+		ht->size *= 2;
+
+	ht->entries = palloc0( ht->size * sizeof(varEntry) );
+	ht->count = 0;
 }
 
-/* getPTEFromHT
+/* findVarEntry
  *
- * Return a variable entry from the probability table.
+ * Return the bucket of a variable, or the free bucket where it belongs.
  */
-static probTableEntry *
-getPTEFromHT(varList *ht, varType var)
+static varEntry *
+findVarEntry( varTable *ht, varType var )
 {
-	varEntry *entry = ht[hashFunction(var)].head;
+	uint32 mask = ht->size - 1;
+	uint32 i = DatumGetUInt32( hash_uint32( ( uint32 ) var ) ) & mask;
 
-	while( entry != NULL )
-	{
-		if ( entry->var == var )
-		{
-			return entry->pte;
-		}
-		
-		entry = entry->next;
-	}
+	while( ht->entries[i].used && ht->entries[i].var != var )
+		i = ( i + 1 ) & mask;
+
+	return ht->entries + i;
+}
+
+/* expandVarTable
+ *
+ * Double the number of buckets of a variable table.
+ */
+static void
+expandVarTable( varTable *ht )
+{
+	varEntry *old = ht->entries;
+	int oldsize = ht->size;
+	int i;
 
-	return NULL;
+	ht->size *= 2;
+	ht->entries = palloc0( ht->size * sizeof(varEntry) );
+
+	for( i = 0; i < oldsize; i++ )
+		if( old[i].used )
+			*findVarEntry( ht, old[i].var ) = old[i];
+
+	pfree( old );
+}
+
+/* getPTEFromHT
+ *
+ * Return the probability table entry of a variable, or NULL if the variable
+ * is not in the table.
+ */
+static probTableEntry *
+getPTEFromHT( varTable *ht, varType var )
+{
+	return findVarEntry( ht, var )->pte;
 }
 
 /* newVarEntry
  *
- * Create an entry for a variable and put it into the corresponding hash table
- * entry.
+ * Map a variable to a probability table entry. A variable that is already in
+ * the table keeps its first entry.
  */
 static void 
-newVarEntry( varType var, probTableEntry *pte, varList *ht )
+newVarEntry( varType var, probTableEntry *pte, varTable *ht )
 {
-	varEntry *ve = palloc0( 1 * sizeof(varEntry) );
+	varEntry *ve;
+
+	if( ( int64 ) ( ht->count + 1 ) * 100 > ( int64 ) ht->size * VARTABLEFILL )
+		expandVarTable( ht );
+
+	ve = findVarEntry( ht, var );
+
+	if( ve->used )
+		return;
+
 	ve->var = var;
+	ve->used = true;
 	ve->pte = pte;
-	insertIntoVarList( &(ht[hashFunction(var)]), ve );
+	ht->count++;
 }
 
 /* isAValidVar
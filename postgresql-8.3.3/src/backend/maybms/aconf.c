@@ -8,18 +8,13 @@
  * INTERFACE ROUTINES:
  *
  *	  aconf_final()
- *	  aconf_accum<i>()
+ *	  aconf_accum()
  *
  *
- * GLOBAL INTERFACE VARIABLES:
+ * STATE:
  *
- *        double epsilon
- *        double delta 
- *
- *
- * EXTERNAL GLOBAL VARIABLES USED:
- *
- *        WSD_LEN, NUM_WSDS, fcinfo, S[] (TODO: complete this list)
+ *        The lineage, epsilon and delta are kept in the generalState of
+ *        the group of duplicates, see localcond.h.
  *
  *
  * NOTES:
@@ -90,7 +85,16 @@
  *	  The unbiased estimator in the Vazirani version is implemented in the
  *	  local function compute_estimator(). The Dagum-Karp-Luby-Ross
  *	  optimal Monte Carlo estimation algorithm is implemented in
- *	  AA_algorithm().
+ *	  AA_algorithm(). The clauses and the values of the variables are
+ *	  sampled in constant time from Walker alias tables that are built
+ *	  once per lineage in sampler_init().
+ *
+ *	  The estimators are computed in batches by aconf_threads workers, 
+ *	  the backend and a pool of threads, see next_estimate(). Every
+ *	  estimator draws from a random stream keyed by aconf_seed and its
+ *	  number, so the result only depends on the seed. The threads are
+ *	  available whenever configure has found POSIX threads (HAVE_PTHREAD),
+ *	  otherwise the backend computes all estimates itself.
  *
  *
  * Copyright (c) 2008, MayBMS Development Group
@@ -101,87 +105,458 @@
 
 #include "postgres.h"
 #include <math.h>
+#ifdef HAVE_PTHREAD
+#include <pthread.h>
+#include <signal.h>
+#endif
 #include "maybms/localcond.h"
 #include "maybms/conf_comp.h"
+#include "miscadmin.h"
+
+/* GUC variables */
+int aconf_threads = 1;
+int aconf_seed = 0;
 
+/* Initial and maximal number of estimates computed by a worker per batch */
+#define INIT_BATCH_PER_WORKER 64
+#define MAX_BATCH_PER_WORKER 4096
 
-/* Global variables */
-/* FIXME: eliminate these.
- * Can we improve encapsulation? These variables are set from
- * include/maybms/lineage.h . 
+/*
+ * Walker's alias table for sampling an index from [0..size) in constant time:
+ * index i is taken with probability cut[i] / size, and alias[i] otherwise.
+ *
+ * A. J. Walker. An Efficient Method for Generating Discrete Random Variables
+ * with General Distributions. ACM Trans. Math. Softw., 3(3):253-256, 1977.
  */
-double epsilon;
-double delta;
+typedef struct aliasTable
+{
+	int size;
+	float8 *cut;
+	int *alias;
+} aliasTable;
+
+/*
+ * The sampler of the Karp-Luby estimator, built once per lineage. A possible
+ * world is represented by the range entry tau[v] of every world table entry
+ * v, which is only sampled when it is first read in the current sample.
+ *
+ * Every clause is led by one of its mappings v->r. The clauses led by the
+ * mappings of v are listed in led_clauses, those led by its range entry r
+ * starting at led_start[rng_base[v] + r].
+ */
+typedef struct aconfSampler
+{
+	uint64 key;				/* key of the random streams, from aconf_seed */
+	aliasTable clauses;		/* over the clauses, by clause_bag_prob */
+	aliasTable *rngs;		/* over the range entries of every variable */
+	int *rng_base;			/* first range entry of the variable overall */
+	int *led_start;
+	int *led_clauses;
+	int *leader_vars;		/* world table entries leading some clause */
+	int num_leader_vars;
+} aconfSampler;
+
+/*
+ * The private part of a worker computing estimates: the possible world of its
+ * current sample, and the random stream of the sample.
+ */
+typedef struct aconfWorker
+{
+	struct aconfPool *pool;
+	int id;
+	int *tau;				/* range entry of the variable in the world */
+	int *stamp;				/* sample that has set tau of the variable */
+	int sample;				/* number of samples taken by the worker */
+	uint64 random;			/* state of the random stream of the sample */
+} aconfWorker;
+
+/*
+ * The workers computing the estimates of the Monte Carlo steps. The backend
+ * itself is worker 0, the others are threads if aconf_threads > 1.
+ *
+ * Estimate i is computed from a random stream of its own that only depends
+ * on aconf_seed and i. The estimates are computed in batches and consumed in
+ * the order of i, so that the result does not depend on the number of 
+ * workers, and the steps stop after the same estimate as with a single one.
+ */
+typedef struct aconfPool
+{
+	generalState *state;
+	aconfSampler *sampler;
+	int num_workers;
+	aconfWorker *workers;
+	float8 *estimates;		/* the estimates of the current batch */
+	uint64 first;			/* number of the first estimate of the batch */
+	int count;				/* number of estimates in the batch */
+	int max_count;
+	int next;				/* next estimate of the batch to be consumed */
+#ifdef HAVE_PTHREAD
+	pthread_t *threads;
+	pthread_mutex_t lock;
+	pthread_cond_t start;	/* a new batch is posted, or the pool shuts down */
+	pthread_cond_t done;	/* a thread has finished its part of a batch */
+	int batch;				/* number of the current batch */
+	int finished;			/* threads that have finished the current batch */
+	bool shutdown;
+#endif
+} aconfPool;
 
 
 /* Local functions */
-static int choose_with_distribution(int distrib_size, prob *distrib);
-static int choose_with_distribution_2(worldTableEntry* entry);
-static prob compute_estimator( generalState *state, prob* clause_bag_prob );
-static prob AA_algorithm( generalState *state, prob* clause_bag_prob );
+static uint64 prng_step(uint64 v);
+static float8 prng_float(aconfWorker *worker);
+static void alias_init(aliasTable *table, int size, prob *weights);
+static int alias_sample(aliasTable *table, aconfWorker *worker);
+static void sift_down(int *heap, int heap_size, int *key, int i);
+static void choose_leaders(generalState *state, int *leader);
+static void sampler_init(aconfSampler *sampler, generalState *state, prob *clause_bag_prob);
+static int sample_tau(aconfSampler *sampler, aconfWorker *worker, int wt);
+static prob compute_estimator( generalState *state, aconfSampler *sampler, aconfWorker *worker, uint64 n );
+static void pool_init(aconfPool *pool, generalState *state, aconfSampler *sampler);
+static void pool_shutdown(aconfPool *pool);
+static void compute_batch(aconfPool *pool, int id);
+static float8 next_estimate(aconfPool *pool);
+#ifdef HAVE_PTHREAD
+static void *pool_thread(void *arg);
+#endif
+static prob AA_algorithm( generalState *state, aconfPool *pool, double delta );
+static prob aconf_prob( generalState *state, int nparts );
 
 
-/* FIXME: choose_with_distribution[2]() is a naive and inefficient method
- * of sampling a clause resp. a variable assignment.
+/* prng_step
+ *
+ * The hash of the random streams, from Numerical Recipes, 3rd edition, 
+ * section 7.1.4. It is the same as pip_prng_step() of PIP.
  */
+static uint64
+prng_step(uint64 v)
+{
+	v = v * UINT64CONST(3935559000370003845) + UINT64CONST(2691343689449507681);
+	v ^= v >> 21; v ^= v << 37; v ^= v >> 4;
+	v *= UINT64CONST(4768777413237032717);
+	v ^= v >> 20; v ^= v << 41; v ^= v >> 5;
 
+	return v;
+}
 
-/* choose_with_distribution: sample a clause
+/* prng_float
  *
- * Choose an index i from [0..distrib_size] with probability distrib[i]
- * This could be optimized by performing binary search.
+ * Draw a number from [0, 1) with 53 random bits from the stream of a worker.
  */
-static int 
-choose_with_distribution(int distrib_size, prob *distrib)
+static float8
+prng_float(aconfWorker *worker)
 {
-  int i;
-  
-  prob pick = (prob)rand(); /* in interval [0 .. RAND_MAX] */
-  
-  prob offset = 0;
-  
-  for(i = 0; i < distrib_size; i++)
-  {
-    offset += distrib[i] * (prob)RAND_MAX;	 
-    if(pick <= offset) 
-    	return i;
-  }
-  
-  /* Due to the precision of float numbers problem, the code can reach here.
-   * We know that pick is not bigger be offset. We return the index of the
-   * last distribution.   
-   */
-  return distrib_size - 1;
+	worker->random = prng_step( worker->random );
+
+	return ( float8 ) ( worker->random >> 11 ) * ( 1.0 / ( float8 ) ( UINT64CONST(1) << 53 ) );
+}
+
+/* alias_init
+ *
+ * Build the alias table of the distribution given by size weights, which 
+ * need not sum up to 1. This takes O(size) time, see Vose's variant in
+ *
+ * M. D. Vose. A Linear Algorithm for Generating Random Numbers with a Given
+ * Distribution. IEEE Trans. Softw. Eng., 17(9):972-975, 1991.
+ */
+static void
+alias_init(aliasTable *table, int size, prob *weights)
+{
+	int *small = ( int * ) palloc( size * sizeof( int ) );
+	int *large = ( int * ) palloc( size * sizeof( int ) );
+	int num_small = 0, num_large = 0;
+	float8 sum = 0;
+	int i;
+
+	table->size = size;
+	table->cut = ( float8 * ) palloc( size * sizeof( float8 ) );
+	table->alias = ( int * ) palloc( size * sizeof( int ) );
+
+	for( i = 0; i < size; i++ )
+		sum += weights[i];
+
+	/* Scale the weights such that their mean is 1 */
+	for( i = 0; i < size; i++ )
+	{
+		table->cut[i] = sum > 0 ? weights[i] * size / sum : 1;
+		table->alias[i] = i;
+
+		if( table->cut[i] < 1 )
+			small[ num_small++ ] = i;
+		else
+			large[ num_large++ ] = i;
+	}
+
+	/* Fill up every small column with the excess of a large one */
+	while( num_small > 0 && num_large > 0 )
+	{
+		int s = small[ --num_small ];
+		int l = large[ num_large - 1 ];
+
+		table->alias[s] = l;
+		table->cut[l] -= 1 - table->cut[s];
+
+		if( table->cut[l] < 1 )
+		{
+			num_large--;
+			small[ num_small++ ] = l;
+		}
+	}
+
+	/* The remaining columns are full up to rounding errors */
+	while( num_large > 0 )
+		table->cut[ large[ --num_large ] ] = 1;
+	while( num_small > 0 )
+		table->cut[ small[ --num_small ] ] = 1;
+
+	pfree( small );
+	pfree( large );
 }
 
+/* alias_sample
+ *
+ * Sample an index from an alias table. A single random number gives both 
+ * the column and the coin flip within it.
+ */
+static int
+alias_sample(aliasTable *table, aconfWorker *worker)
+{
+	float8 x = prng_float( worker ) * table->size;
+	int i = ( int ) x;
 
-/* choose_with_distribution_2: sample a variable assignment
+	return x - i < table->cut[i] ? i : table->alias[i];
+}
+
+/* sift_down
  *
- * Similar to choose_with_distribution except that the input is a world table
- * entry.
+ * Restore the max-heap of variables below position i. The variables are
+ * ordered by key, and by their world table index on ties.
  */
-static int 
-choose_with_distribution_2( worldTableEntry* entry )
-{	
-  	int i;
-    
-	prob pick = (prob)rand(); /* in interval [0 .. RAND_MAX] */
-  	
-  	prob offset = 0;
-
-  	for(i = 0; i < entry->rng_entry_count; i++)
-  	{
-    		offset += ( entry->rng_entries + i )->p * (prob)RAND_MAX;	
-    		 
-    		if(pick <= offset) 
-    			return (entry->rng_entries + i)->rng;
-  	}  
-  
-	/* Due to the precision of float numbers problem, the code can reach
-         * here.  We know that pick is not bigger be offset.  We return the
-         * index of the last distribution.   
-         */
-  	return (entry->rng_entries + entry->rng_entry_count - 1)->rng;
+#define HEAP_ABOVE( key, v, w ) \
+	( ( key )[v] > ( key )[w] || ( ( key )[v] == ( key )[w] && ( v ) < ( w ) ) )
+
+static void
+sift_down(int *heap, int heap_size, int *key, int i)
+{
+	int v = heap[i];
+
+	while( 2 * i + 1 < heap_size )
+	{
+		int c = 2 * i + 1;
+
+		if( c + 1 < heap_size && HEAP_ABOVE( key, heap[ c + 1 ], heap[c] ) )
+			c++;
+
+		if( !HEAP_ABOVE( key, heap[c], v ) )
+			break;
+
+		heap[i] = heap[c];
+		i = c;
+	}
+
+	heap[i] = v;
+}
+
+/* choose_leaders
+ *
+ * Choose the leader of every clause, such that few variables lead clauses:
+ * the values of all leading variables are sampled for every estimator. This
+ * is the greedy set cover, which repeatedly makes the variable occurring in
+ * the most clauses without a leader the leader of these clauses. The counts
+ * only decrease, so the variables are kept in a max-heap by their count when
+ * they were last pushed, and a variable with a stale count is pushed again.
+ * A clause of the reserved variable only is led by its last mapping.
+ */
+static void
+choose_leaders(generalState *state, int *leader)
+{
+	clauseStore *S = state->clauses;
+	int size = Max( state->wt_entry_count, 1 ) * sizeof( int );
+	int *count = ( int * ) palloc0( size );
+	int *key = ( int * ) palloc( size );
+	int *heap = ( int * ) palloc( size );
+	int heap_size = 0;
+	int i, j, k;
+
+	for( i = 0; i < state->num_wsds; i++ )
+	{
+		leader[i] = -1;
+
+		for( k = MAP( state, i, 0 ); k < MAP( state, i + 1, 0 ); k++ )
+			if( S->var[k] != RESERVED_VAR )
+				count[ S->wt_index[k] ]++;
+	}
+
+	for( i = 0; i < state->wt_entry_count; i++ )
+		if( count[i] > 0 )
+		{
+			key[i] = count[i];
+			heap[ heap_size++ ] = i;
+		}
+
+	for( i = heap_size / 2 - 1; i >= 0; i-- )
+		sift_down( heap, heap_size, key, i );
+
+	while( heap_size > 0 )
+	{
+		int top = heap[0];
+
+		if( key[top] != count[top] )
+		{
+			/* Push the variable again with its current count */
+			if( count[top] > 0 )
+				key[top] = count[top];
+			else
+				heap[0] = heap[ --heap_size ];
+
+			sift_down( heap, heap_size, key, 0 );
+
+			continue;
+		}
+
+		heap[0] = heap[ --heap_size ];
+		sift_down( heap, heap_size, key, 0 );
+
+		/* Lead the clauses of the variable that have no leader yet */
+		for( j = 0; j < state->wt_entries[top].rng_entry_count; j++ )
+		{
+			rngEntry *rng_entry = state->wt_entries[top].rng_entries + j;
+
+			for( k = 0; k < rng_entry->clause_entry_count; k++ )
+			{
+				clauseEntry *clause_entry = rng_entry->clause_entries + k;
+				int c = clause_entry->clause;
+				int m;
+
+				if( leader[c] != -1 )
+					continue;
+
+				leader[c] = MAP( state, c, clause_entry->column );
+
+				for( m = MAP( state, c, 0 ); m < MAP( state, c + 1, 0 ); m++ )
+					if( S->var[m] != RESERVED_VAR )
+						count[ S->wt_index[m] ]--;
+			}
+		}
+	}
+
+	for( i = 0; i < state->num_wsds; i++ )
+		if( leader[i] == -1 )
+			leader[i] = MAP( state, i, state->wsd_len - 1 );
+
+	pfree( count );
+	pfree( key );
+	pfree( heap );
+}
+
+/* sampler_init
+ *
+ * Build the alias tables of the clauses and the variables of a state, and
+ * the index of the clauses by their leaders, see choose_leaders().
+ */
+static void
+sampler_init(aconfSampler *sampler, generalState *state, prob *clause_bag_prob)
+{
+	clauseStore *S = state->clauses;
+	int *leader = ( int * ) palloc( state->num_wsds * sizeof( int ) );
+	prob *weights;
+	int max_rngs = 0;
+	int num_rngs = 0;
+	int i, j;
+
+	sampler->key = prng_step( ( uint64 ) aconf_seed );
+
+	alias_init( &sampler->clauses, state->num_wsds, clause_bag_prob );
+
+	sampler->rngs = ( aliasTable * ) palloc( state->wt_entry_count * sizeof( aliasTable ) );
+	sampler->rng_base = ( int * ) palloc( state->wt_entry_count * sizeof( int ) );
+
+	for( i = 0; i < state->wt_entry_count; i++ )
+	{
+		sampler->rng_base[i] = num_rngs;
+		num_rngs += state->wt_entries[i].rng_entry_count;
+		max_rngs = Max( max_rngs, state->wt_entries[i].rng_entry_count );
+	}
+
+	weights = ( prob * ) palloc( max_rngs * sizeof( prob ) );
+
+	for( i = 0; i < state->wt_entry_count; i++ )
+	{
+		worldTableEntry *entry = state->wt_entries + i;
+
+		for( j = 0; j < entry->rng_entry_count; j++ )
+			weights[j] = entry->rng_entries[j].p;
+
+		alias_init( sampler->rngs + i, entry->rng_entry_count, weights );
+	}
+
+	pfree( weights );
+
+	/* Count the clauses led by every range entry */
+	sampler->led_start = ( int * ) palloc0( ( num_rngs + 1 ) * sizeof( int ) );
+
+	choose_leaders( state, leader );
+
+	for( i = 0; i < state->num_wsds; i++ )
+	{
+		int m = leader[i];
+
+		sampler->led_start[ sampler->rng_base[ S->wt_index[m] ] + S->rng_index[m] ]++;
+	}
+
+	/* Turn the counts into the ends of the lists, and collect the leaders */
+	sampler->leader_vars = ( int * ) palloc( state->wt_entry_count * sizeof( int ) );
+	sampler->num_leader_vars = 0;
+
+	for( i = 0; i < state->wt_entry_count; i++ )
+	{
+		int first = sampler->rng_base[i];
+		int last = first + state->wt_entries[i].rng_entry_count;
+		bool leads = false;
+
+		for( j = first; j < last; j++ )
+		{
+			leads |= sampler->led_start[j] > 0;
+
+			if( j > 0 )
+				sampler->led_start[j] += sampler->led_start[ j - 1 ];
+		}
+
+		if( leads )
+			sampler->leader_vars[ sampler->num_leader_vars++ ] = i;
+	}
+
+	sampler->led_start[ num_rngs ] = state->num_wsds;
+
+	/* Fill the lists from their ends, which leaves led_start at their starts */
+	sampler->led_clauses = ( int * ) palloc( Max( state->num_wsds, 1 ) * sizeof( int ) );
+
+	for( i = state->num_wsds - 1; i >= 0; i-- )
+	{
+		int m = leader[i];
+		int r = sampler->rng_base[ S->wt_index[m] ] + S->rng_index[m];
+
+		sampler->led_clauses[ --sampler->led_start[r] ] = i;
+	}
+
+	pfree( leader );
+}
+
+/* sample_tau
+ *
+ * Return the range entry of a world table entry in the world of the current
+ * sample, sampling it on first use.
+ */
+static int
+sample_tau(aconfSampler *sampler, aconfWorker *worker, int wt)
+{
+	if( worker->stamp[ wt ] != worker->sample )
+	{
+		worker->tau[ wt ] = alias_sample( sampler->rngs + wt, worker );
+		worker->stamp[ wt ] = worker->sample;
+	}
+
+	return worker->tau[ wt ];
 }
 
 
@@ -193,69 +568,269 @@ choose_with_distribution_2( worldTableEntry* entry )
  * This is the version from the Vazirani book and converges more
  * quickly than the basic coverage algorithm from Karp-Luby-Madras.
  * It is similar to the algorithm from section 5 of that paper.
+ *
+ * A clause is sampled from its alias table and fixes the values of its 
+ * variables. The values of the other variables are only sampled when a
+ * clause that may be satisfied reads them, so a sample costs time in the
+ * number of leading variables and of clauses agreeing with the world on 
+ * their leaders rather than in the size of the lineage.
+ *
+ * The estimator number n is computed from its own random stream, and only
+ * reads the state and the sampler, so that workers can compute estimators 
+ * concurrently.
  */ 
 static prob 
-compute_estimator(generalState* state, prob* clause_bag_prob)
+compute_estimator(generalState* state, aconfSampler *sampler, aconfWorker *worker, uint64 n)
 {
-    int i = choose_with_distribution(NUM_WSDS, clause_bag_prob);
-    
-    int j, k;
-	
-    int c_tau = 0; /* count how many clauses are satisfied by tau */
-    
-    /* Pick one truth assignment tau from those of C[i] with probability
-     * P(tau)/Sum_{tau' in C[i]} P(tau').
-     */
-    for(j = 0; j < state->wt_entry_count; j++)
-    {
-    	worldTableEntry *entry = state->wt_entries + j;
-    	
-      	int Cij = -1;
-      	for(k = 0; k < WSD_LEN; k++) 
-         	if(  S[i]->data[k]->var == entry->var ) 
-         		Cij = S[i]->data[k]->rng;
-
-		/* clause i does not determine value of x_j */
-      	if(Cij == -1) 
-      	{
-            /* Randomly complete the truth assignment with the right weight. */
-	    	entry->tau = choose_with_distribution_2( entry );
-      	}
-      	/* clause i determines value of x_j */
-      	else 
-      	{ 
-      	    entry->tau = Cij;
-      	}
-    }
-    
-    /* Here is where the difference to the basic Karp-Luby estimator
-     * starts. Rather than checking whether the chosen clause is the first
-     * among those that satisfy the chosen possible world with respect to
-     * some arbitrary fixed order of the clauses, and returning either
-     * 1 or 0 based on this, we count the number of clauses that satisfy
-     * the world and return the ratio of 1 to that count.
-     */
-    
-    for(i = 0; i < NUM_WSDS; i++)
-    {
-      	bool clause_satisfied = true;
-      	
-      	for(k = 0; k < WSD_LEN; k++)
-      	{
-            if ( S[i]->data[k]->wt_entry->tau != S[i]->data[k]->rng )
-            {
-               clause_satisfied = false;
-               break;
-            }
-        }
-      	
-      	if(clause_satisfied)
-      	{
-      	    c_tau++;
-      	}
-    }
-
-    return (prob)1 / (prob)c_tau;
+	clauseStore *S = state->clauses;
+	int len = state->wsd_len;
+	int c_tau = 0; /* count how many clauses are satisfied by tau */
+	int i, j, k;
+
+	worker->random = sampler->key ^ prng_step( n );
+	worker->sample++;
+
+	i = alias_sample( &sampler->clauses, worker );
+
+	/* Pick one truth assignment tau from those of C[i] with probability
+	 * P(tau)/Sum_{tau' in C[i]} P(tau'): the mappings of C[i] are fixed,
+	 * and the other variables are completed lazily with the right weight.
+	 */
+	for( k = MAP( state, i, 0 ); k < MAP( state, i + 1, 0 ); k++ )
+	{
+		worker->tau[ S->wt_index[k] ] = S->rng_index[k];
+		worker->stamp[ S->wt_index[k] ] = worker->sample;
+	}
+
+	/* Here is where the difference to the basic Karp-Luby estimator
+	 * starts. Rather than checking whether the chosen clause is the first
+	 * among those that satisfy the chosen possible world with respect to
+	 * some arbitrary fixed order of the clauses, and returning either
+	 * 1 or 0 based on this, we count the number of clauses that satisfy
+	 * the world and return the ratio of 1 to that count.
+	 *
+	 * A satisfied clause agrees with tau on its leader, so only the clauses
+	 * in the inverted index of tau of every leading variable are checked.
+	 */
+	for( j = 0; j < sampler->num_leader_vars; j++ )
+	{
+		int wt = sampler->leader_vars[j];
+		int r = sampler->rng_base[ wt ] + sample_tau( sampler, worker, wt );
+
+		for( k = sampler->led_start[r]; k < sampler->led_start[ r + 1 ]; k++ )
+		{
+			int first = MAP( state, sampler->led_clauses[k], 0 );
+			int m;
+
+			for( m = first; m < first + len; m++ )
+				if( sample_tau( sampler, worker, S->wt_index[m] ) != S->rng_index[m] )
+					break;
+
+			if( m == first + len )
+				c_tau++;
+		}
+	}
+
+	return (prob)1 / (prob)c_tau;
+}
+
+
+/* pool_init
+ *
+ * Set up the workers computing the estimates of a sampler, and start the 
+ * threads among them. If a thread cannot be started, the pool makes do with
+ * the workers it has.
+ */
+static void
+pool_init(aconfPool *pool, generalState *state, aconfSampler *sampler)
+{
+	int i;
+
+	pool->state = state;
+	pool->sampler = sampler;
+	pool->num_workers = 1;
+#ifdef HAVE_PTHREAD
+	pool->num_workers = Max( aconf_threads, 1 );
+#endif
+	pool->workers = ( aconfWorker * ) palloc( pool->num_workers * sizeof( aconfWorker ) );
+
+	for( i = 0; i < pool->num_workers; i++ )
+	{
+		aconfWorker *worker = pool->workers + i;
+
+		worker->pool = pool;
+		worker->id = i;
+		worker->tau = ( int * ) palloc( Max( state->wt_entry_count, 1 ) * sizeof( int ) );
+		worker->stamp = ( int * ) palloc0( Max( state->wt_entry_count, 1 ) * sizeof( int ) );
+		worker->sample = 0;
+	}
+
+	pool->max_count = MAX_BATCH_PER_WORKER * pool->num_workers;
+	pool->estimates = ( float8 * ) palloc( pool->max_count * sizeof( float8 ) );
+	pool->first = 0;
+	pool->count = 0;
+	pool->next = 0;
+
+#ifdef HAVE_PTHREAD
+	pool->threads = NULL;
+
+	if( pool->num_workers > 1 )
+	{
+		sigset_t block, old;
+
+		pool->threads = ( pthread_t * ) palloc( pool->num_workers * sizeof( pthread_t ) );
+		pthread_mutex_init( &pool->lock, NULL );
+		pthread_cond_init( &pool->start, NULL );
+		pthread_cond_init( &pool->done, NULL );
+		pool->batch = 0;
+		pool->finished = 0;
+		pool->shutdown = false;
+
+		/* The signal handlers of the backend must only run in the backend */
+		sigfillset( &block );
+		pthread_sigmask( SIG_SETMASK, &block, &old );
+
+		for( i = 1; i < pool->num_workers; i++ )
+			if( pthread_create( pool->threads + i, NULL, pool_thread, pool->workers + i ) != 0 )
+				break;
+
+		pthread_sigmask( SIG_SETMASK, &old, NULL );
+
+		if( i < pool->num_workers )
+		{
+			elog( DEBUG1, "aconf: started %d of %d worker threads", i - 1, pool->num_workers - 1 );
+			pool->num_workers = i;
+		}
+	}
+#endif
+}
+
+/* pool_shutdown
+ *
+ * Stop the threads of a pool. This must happen before an error leaves the 
+ * computation, since the threads read the memory of the group.
+ */
+static void
+pool_shutdown(aconfPool *pool)
+{
+#ifdef HAVE_PTHREAD
+	int i;
+
+	if( pool->threads == NULL )
+		return;
+
+	pthread_mutex_lock( &pool->lock );
+	pool->shutdown = true;
+	pthread_cond_broadcast( &pool->start );
+	pthread_mutex_unlock( &pool->lock );
+
+	for( i = 1; i < pool->num_workers; i++ )
+		pthread_join( pool->threads[i], NULL );
+
+	pthread_mutex_destroy( &pool->lock );
+	pthread_cond_destroy( &pool->start );
+	pthread_cond_destroy( &pool->done );
+	pool->threads = NULL;
+#endif
+}
+
+/* compute_batch
+ *
+ * Compute the share of a worker of the estimates of the current batch. 
+ */
+static void
+compute_batch(aconfPool *pool, int id)
+{
+	aconfWorker *worker = pool->workers + id;
+	int from = ( int ) ( ( int64 ) pool->count * id / pool->num_workers );
+	int to = ( int ) ( ( int64 ) pool->count * ( id + 1 ) / pool->num_workers );
+	int i;
+
+	for( i = from; i < to; i++ )
+		pool->estimates[i] = compute_estimator( pool->state, pool->sampler, worker, pool->first + i );
+}
+
+#ifdef HAVE_PTHREAD
+/* pool_thread
+ *
+ * Main loop of a worker thread: compute its share of every batch posted until
+ * the pool shuts down. The thread must not call into the backend, in 
+ * particular neither palloc() nor elog().
+ */
+static void *
+pool_thread(void *arg)
+{
+	aconfWorker *worker = ( aconfWorker * ) arg;
+	aconfPool *pool = worker->pool;
+	int batch = 0;
+
+	pthread_mutex_lock( &pool->lock );
+
+	for( ;; )
+	{
+		while( !pool->shutdown && pool->batch == batch )
+			pthread_cond_wait( &pool->start, &pool->lock );
+
+		if( pool->shutdown )
+			break;
+
+		batch = pool->batch;
+		pthread_mutex_unlock( &pool->lock );
+
+		compute_batch( pool, worker->id );
+
+		pthread_mutex_lock( &pool->lock );
+		pool->finished++;
+		pthread_cond_signal( &pool->done );
+	}
+
+	pthread_mutex_unlock( &pool->lock );
+
+	return NULL;
+}
+#endif
+
+/* next_estimate
+ *
+ * Return the next estimate of a pool. When a batch is used up, the next one
+ * is computed by all workers. Batches start small, so that little work is
+ * wasted on small lineage, and double up to MAX_BATCH_PER_WORKER estimates 
+ * per worker.
+ */
+static float8
+next_estimate(aconfPool *pool)
+{
+	if( pool->next == pool->count )
+	{
+		CHECK_FOR_INTERRUPTS();
+
+		pool->first += pool->count;
+		pool->count = pool->count == 0 ? INIT_BATCH_PER_WORKER * pool->num_workers :
+			Min( pool->count * 2, pool->max_count );
+		pool->next = 0;
+
+#ifdef HAVE_PTHREAD
+		if( pool->threads != NULL )
+		{
+			pthread_mutex_lock( &pool->lock );
+			pool->batch++;
+			pool->finished = 0;
+			pthread_cond_broadcast( &pool->start );
+			pthread_mutex_unlock( &pool->lock );
+
+			compute_batch( pool, 0 );
+
+			pthread_mutex_lock( &pool->lock );
+			while( pool->finished < pool->num_workers - 1 )
+				pthread_cond_wait( &pool->done, &pool->lock );
+			pthread_mutex_unlock( &pool->lock );
+		}
+		else
+#endif
+			compute_batch( pool, 0 );
+	}
+
+	return pool->estimates[ pool->next++ ];
 }
 
 
@@ -314,12 +889,16 @@ compute_estimator(generalState* state, prob* clause_bag_prob)
  * add up the S values hierarchically, so that the gap between the values
  * added never reaches extremes.
  *
+ * The estimate exceeds the relative error epsilon of the state with 
+ * probability at most delta.
  */
 static prob 
-AA_algorithm(generalState *state, prob* clause_bag_prob)
+AA_algorithm(generalState *state, aconfPool *pool, double delta)
 {
 	const float8 e = 2.718281828459;
 
+	const double epsilon = state->epsilon;
+
    	const float8 upsilon  = 4.0 * (e - 2.0) * log(2 / delta)
                             / (epsilon * epsilon);
 
@@ -349,7 +928,7 @@ AA_algorithm(generalState *state, prob* clause_bag_prob)
 		while(S < upsilon1_sra)
 		{
 		   N++;
-		   S += compute_estimator( state, clause_bag_prob );
+		   S += next_estimate( pool );
 		}
 
 		mu_hat = upsilon1_sra / (float8)N;
@@ -363,8 +942,8 @@ AA_algorithm(generalState *state, prob* clause_bag_prob)
    
    		for(i = 1; i <= N; i++)
    		{
-      		   prob kl2 = compute_estimator( state, clause_bag_prob )
-		            - compute_estimator( state, clause_bag_prob );
+      		   prob kl2 = next_estimate( pool )
+		            - next_estimate( pool );
       		   S += kl2 * kl2 / 2.0;
    		}
    
@@ -379,7 +958,7 @@ AA_algorithm(generalState *state, prob* clause_bag_prob)
 		int i;
 
    		for(i = 0; i < N; i++)
-		   S += compute_estimator( state, clause_bag_prob );
+		   S += next_estimate( pool );
 
    		return (prob)(S / N);
 	}
@@ -389,124 +968,97 @@ AA_algorithm(generalState *state, prob* clause_bag_prob)
 /* aconf_accum0 
  *
  * Transition function for approximation of confidence computation 
- * involving 1 uncertain relations. Do nothing.
+ * involving 1 uncertain relations. Do nothing, the group has no state.
  */
 Datum 
 aconf_accum0(PG_FUNCTION_ARGS)
 {
-	PG_RETURN_INT32(1);	
+	PG_RETURN_NULL();	
 }
 
-/* aconf_accum1 
+/* aconf_accum 
  *
- * Transition function for approximation of confidence computation 
- * involving 1 uncertain relations.
+ * Transition function for approximation of confidence computation. The 
+ * arguments are epsilon, delta and the condition columns of a tuple as arrays
+ * of variables, range values and probabilities (see conf_accum_ge).
  */
 Datum 
-aconf_accum1(PG_FUNCTION_ARGS)
+aconf_accum(PG_FUNCTION_ARGS)
 {
-	aconf_accum(1)
-}
+	varType *vars;
+	rngType *rngs;
+	prob *probs;
+	int n = getCondColumns( fcinfo, 3, &vars, &rngs, &probs );
+	generalState *state = getGenState( fcinfo, n );
 
-/* aconf_accum2 
- *
- * Transition function for approximation of confidence computation 
- * involving 2 uncertain relations.
- */
-Datum 
-aconf_accum2(PG_FUNCTION_ARGS)
-{
-	aconf_accum(2)
-}
+	state->epsilon = PG_GETARG_FLOAT4( 1 );
+	state->delta = PG_GETARG_FLOAT4( 2 );
+	advance( state, fcinfo, n, vars, rngs, probs );
 
-/* aconf_accum3 
- *
- * Transition function for approximation of confidence computation 
- * involving 3 uncertain relations.
- */
-Datum 
-aconf_accum3(PG_FUNCTION_ARGS)
-{
-	aconf_accum(3)
+	PG_RETURN_INT32( state->slot );
 }
 
-/* aconf_accum4 
- *
- * Transition function for approximation of confidence computation 
- * involving 4 uncertain relations.
- */
-Datum 
-aconf_accum4(PG_FUNCTION_ARGS)
-{
-	aconf_accum(4)
-}
 
-/* aconf_accum5 
+/* aconf_prob
  *
- * Transition function for approximation of confidence computation 
- * involving 5 uncertain relations.
+ * Approximate the probability of the clauses of a state in memory, which are
+ * one of nparts independent parts of the lineage. A relative approximation of
+ * every part is a relative approximation of their disjunction, so only the
+ * probability delta of missing it is shared among the parts.
  */
-Datum 
-aconf_accum5(PG_FUNCTION_ARGS)
+static prob
+aconf_prob(generalState *state, int nparts)
 {
-	aconf_accum(5)
-}
+	prob nM = 0;
+	prob *clause_bag_prob; 	/* clause_prob / nM */
+	aconfSampler sampler;
+	aconfPool pool;
+	prob result = 0;
+	int i;
 
-/* aconf_accum6 
- *
- * Transition function for approximation of confidence computation 
- * involving 6 uncertain relations.
- */
-Datum 
-aconf_accum6(PG_FUNCTION_ARGS)
-{
-	aconf_accum(6)
-}
+	/* Complete the missing range values for all variables */
+	getMissingRngs( state ); 
+	
+	/* Calculate the bag sum nM and the bag ratios of the confidences of
+     * all clauses.
+     */
 
-/* aconf_accum7 
- *
- * Transition function for approximation of confidence computation 
- * involving 7 uncertain relations.
- */
-Datum 
-aconf_accum7(PG_FUNCTION_ARGS)
-{
-	aconf_accum(7)
-}
+	/* The corresponding deallocation happens when freeing the current
+	 * memory context in aconf_final()
+	 */
+	clause_bag_prob = ( prob * ) palloc( state->num_wsds * sizeof( prob ) )  ;
+	
+	for( i = 0; i < state->num_wsds; i++ )
+	{
+		nM += state->clauses->prob[i];
+	}
+	
+	for( i = 0; i < state->num_wsds; i++ )
+	{
+		clause_bag_prob[ i ] = state->clauses->prob[i] / nM;
+	}
 
-/* aconf_accum8 
- *
- * Transition function for approximation of confidence computation 
- * involving 8 uncertain relations.
- */
-Datum 
-aconf_accum8(PG_FUNCTION_ARGS)
-{
-	aconf_accum(8)
-}
+	/* Build the alias tables for sampling clauses and worlds */
+	sampler_init( &sampler, state, clause_bag_prob );
 
-/* aconf_accum9 
- *
- * Transition function for approximation of confidence computation 
- * involving 9 uncertain relations.
- */
-Datum 
-aconf_accum9(PG_FUNCTION_ARGS)
-{
-	aconf_accum(9)
-}
+	/* Confidence approximation, stopping the worker threads on errors */
+	pool_init( &pool, state, &sampler );
 
-/* aconf_accum10 
- *
- * Transition function for approximation of confidence computation 
- * involving 10 uncertain relations.
- */
-Datum 
-aconf_accum10(PG_FUNCTION_ARGS)
-{
-	aconf_accum(10)
-}
+	PG_TRY();
+	{
+		result = AA_algorithm( state, &pool, state->delta / nparts ) * nM;
+	}
+	PG_CATCH();
+	{
+		pool_shutdown( &pool );
+		PG_RE_THROW();
+	}
+	PG_END_TRY();
 
+	pool_shutdown( &pool );
+
+	return result; 
+}
 
 /* aconf_final 
  *
@@ -515,59 +1067,29 @@ aconf_accum10(PG_FUNCTION_ARGS)
 Datum 
 aconf_final(PG_FUNCTION_ARGS)
 {	
-	prob nM = 0;
-	prob *clause_bag_prob; 	/* clause_prob / nM */
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate;
+	generalState *state = findGenState( fcinfo );
 	prob result = 0;
 	MemoryContext oldcxt; 
-        int i;
 	
 	/* If there is no tuple, return probability 0.  */
-	if (groupcxt == NULL)	
+	if (state == NULL)	
 		PG_RETURN_FLOAT4(0);	
-	
-	/* Switch to the right context. */	
-	oldcxt = MemoryContextSwitchTo( groupcxt ); 
-
-	/* Complete the missing range values for all variables */
-	getMissingRngs( state ); 
-	
-	/* Compute the entry pointers of all clauses */
-	computeEntryPointers(state);
-	
-	/* Calculate the bag sum nM and the bag ratios of the confidences of
-     * all clauses.
-     */
 
-	/* The corresponding deallocation happens when freeing the current
-	 * memory context in aconf_final()
-	 */
-	clause_bag_prob = ( prob * ) palloc( NUM_WSDS * sizeof( prob ) )  ;
-	
-	for( i = 0; i < NUM_WSDS; i++ )
-	{
-		nM += S[i]->prob;
-	}
+	/* The group has been computed before a rescan */
+	if (state->finalized)
+		PG_RETURN_FLOAT4(state->result);
 	
-	for( i = 0; i < NUM_WSDS; i++ )
-	{
-		clause_bag_prob[ i ] = S[i]->prob / nM;
-	}
+	/* Switch to the right context. */	
+	oldcxt = MemoryContextSwitchTo( state->groupcxt ); 
 
 	/* Confidence approximation */
-	result = AA_algorithm( state, clause_bag_prob ) * nM; 
+	result = lineageProb( state, aconf_prob );
 
 	/* Switch to the old context */
 	MemoryContextSwitchTo( oldcxt );
 	
 	/* Delete the context for the current group of duplicates */
-	MemoryContextDelete( groupcxt );
-	
-	/* Set the relevant variables to NULL */
-	NUM_WSDS = 0;
-	S = NULL;
-	groupcxt = NULL;
+	releaseGenState( fcinfo, state, result );
 
 	PG_RETURN_FLOAT4( result );	
 }
-
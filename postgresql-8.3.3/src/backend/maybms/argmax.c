@@ -18,6 +18,9 @@
 #include "fmgr.h"
 #include "maybms/argmax.h"
 #include "nodes/execnodes.h"
+#include "utils/builtins.h"
+#include "utils/lsyscache.h"
+#include "utils/typcache.h"
 
 /* Local functions.  */
 static argmaxState *get_argmax_state(AggState *aggState);
@@ -211,6 +214,52 @@ test_from_0_to_1(PG_FUNCTION_ARGS)
 	PG_RETURN_FLOAT4(weight);
 }
 
+/* keyhash
+ *
+ * Combine a hash value with the hash of a key, like the hash of a tuple in
+ * a hash table of the executor. The key is hashed with the hash function of
+ * the equality operator of its type, so that equal keys get the same hash. A
+ * null key does not change the hash value except for the rotation.
+ */
+Datum
+keyhash(PG_FUNCTION_ARGS)
+{
+	uint32		hashkey = PG_ARGISNULL(0) ? 0 : (uint32) PG_GETARG_INT32(0);
+	FmgrInfo   *hashfn = (FmgrInfo *) fcinfo->flinfo->fn_extra;
+
+	/* rotate hashkey left 1 bit */
+	hashkey = (hashkey << 1) | ((hashkey & 0x80000000) ? 1 : 0);
+
+	if (PG_ARGISNULL(1))
+		PG_RETURN_INT32((int32) hashkey);
+
+	/* Look up the hash function of the key type once per query */
+	if (hashfn == NULL)
+	{
+		Oid			keytype = get_fn_expr_argtype(fcinfo->flinfo, 1);
+		TypeCacheEntry *typentry;
+		Oid			hashproc;
+		Oid			righthashproc;
+
+		typentry = lookup_type_cache(keytype, TYPECACHE_EQ_OPR);
+		if (!OidIsValid(typentry->eq_opr) ||
+			!get_op_hash_functions(typentry->eq_opr, &hashproc, &righthashproc))
+			ereport(ERROR,
+					(errcode(ERRCODE_UNDEFINED_FUNCTION),
+					 errmsg("could not identify a hash function for type %s",
+							format_type_be(keytype))));
+
+		hashfn = (FmgrInfo *) MemoryContextAlloc(fcinfo->flinfo->fn_mcxt,
+												 sizeof(FmgrInfo));
+		fmgr_info_cxt(hashproc, hashfn, fcinfo->flinfo->fn_mcxt);
+		fcinfo->flinfo->fn_extra = (void *) hashfn;
+	}
+
+	hashkey ^= DatumGetUInt32(FunctionCall1(hashfn, PG_GETARG_DATUM(1)));
+
+	PG_RETURN_INT32((int32) hashkey);
+}
+
 /* get_argmax_state
  *
  * Get argmaxState from the aggState.
@@ -3,13 +3,19 @@
  * bitset.c
  *	  	Auxiliary functions for ws-tree algorithm.
  *
+ *	  All operations work on whole words of the bitset. The bits beyond
+ *	  nbits in the last word are always kept zero, so that counting and
+ *	  emptiness tests need not mask them. The loops over whole bitsets use
+ *	  AVX2 or SSE2 if the compiler targets them (e.g. CFLAGS=-mavx2) and
+ *	  plain word operations otherwise.
+ *
  *
  * Copyright (c) 2008, MayBMS Development Group
  *
  *-------------------------------------------------------------------------
  */
- 
- 
+
+
 #include <limits.h>
 #include <stdlib.h>
 #include <string.h>
@@ -21,6 +27,9 @@
 /* Local macros */
 #define SEGFAULT() abort()
 
+/* Initial number of free bitsets a pool can hold */
+#define BITSET_POOL_SIZE 32
+
 #define BITSET_BITS \
 	( CHAR_BIT * sizeof(size_t) )
 
@@ -33,6 +42,114 @@
 #define BITSET_USED(nbits) \
 	( ((nbits) + (BITSET_BITS - 1)) / BITSET_BITS )
 
+/* Mask of the valid bits in the last word */
+#define BITSET_TAIL_MASK(nbits) \
+	( ((nbits) % BITSET_BITS) == 0 ? ~((size_t)0) : BITSET_MASK(nbits) - 1 )
+
+/* Population count and number of trailing zeros of a word */
+#if defined(__GNUC__)
+#define BITSET_POPCOUNT(word)	__builtin_popcountll((unsigned long long) (word))
+#define BITSET_CTZ(word)		__builtin_ctzll((unsigned long long) (word))
+#else
+#define BITSET_POPCOUNT(word)	popcount_word(word)
+#define BITSET_CTZ(word)		ctz_word(word)
+#endif
+
+/* Vector kernels; BITSET_VEC_WORDS is the number of words in a vector */
+#if defined(__AVX2__)
+#include <immintrin.h>
+typedef __m256i bitset_vec;
+#define BITSET_VEC_WORDS		( sizeof(__m256i) / sizeof(size_t) )
+#define VEC_LOAD(p)				_mm256_loadu_si256((const __m256i *) (p))
+#define VEC_STORE(p, v)			_mm256_storeu_si256((__m256i *) (p), (v))
+#define VEC_OR(a, b)			_mm256_or_si256((a), (b))
+#define VEC_XOR(a, b)			_mm256_xor_si256((a), (b))
+#define VEC_ANDNOT(a, b)		_mm256_andnot_si256((a), (b))	/* ~a & b */
+#define VEC_IS_ZERO(v)			_mm256_testz_si256((v), (v))
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+typedef __m128i bitset_vec;
+#define BITSET_VEC_WORDS		( sizeof(__m128i) / sizeof(size_t) )
+#define VEC_LOAD(p)				_mm_loadu_si128((const __m128i *) (p))
+#define VEC_STORE(p, v)			_mm_storeu_si128((__m128i *) (p), (v))
+#define VEC_OR(a, b)			_mm_or_si128((a), (b))
+#define VEC_XOR(a, b)			_mm_xor_si128((a), (b))
+#define VEC_ANDNOT(a, b)		_mm_andnot_si128((a), (b))		/* ~a & b */
+#define VEC_IS_ZERO(v)			( _mm_movemask_epi8(_mm_cmpeq_epi8((v), _mm_setzero_si128())) == 0xFFFF )
+#endif
+
+/* Local functions */
+#if !defined(__GNUC__)
+static int popcount_word(size_t word);
+static int ctz_word(size_t word);
+#endif
+static int first_nonzero_word(bitset *set, size_t from);
+
+#if !defined(__GNUC__)
+/* popcount_word
+ *
+ * Count the set bits in a word
+ */
+static int
+popcount_word(size_t word)
+{
+	int count = 0;
+
+	/* Every iteration clears the lowest set bit */
+	while (word != 0)
+	{
+		word &= word - 1;
+		count++;
+	}
+
+	return count;
+}
+
+/* ctz_word
+ *
+ * Return the position of the lowest set bit of a non-zero word
+ */
+static int
+ctz_word(size_t word)
+{
+	int pos = 0;
+
+	while (!(word & 1))
+	{
+		word >>= 1;
+		pos++;
+	}
+
+	return pos;
+}
+#endif
+
+/* first_nonzero_word
+ *
+ * Return the index of the first non-zero word starting at from, or -1 if
+ * all remaining words are zero
+ */
+static int
+first_nonzero_word(bitset *set, size_t from)
+{
+	size_t i = from;
+	size_t used = BITSET_USED(set->nbits);
+
+#ifdef BITSET_VEC_WORDS
+	/* Skip zero vectors */
+	while (i + BITSET_VEC_WORDS <= used && VEC_IS_ZERO(VEC_LOAD(set->bits + i)))
+		i += BITSET_VEC_WORDS;
+#endif
+
+	while (i < used && set->bits[i] == (size_t)0)
+		i++;
+
+	if (i < used)
+		return i;
+
+	return -1;
+}
+
 /* bitset_init
  *
  * Initialization of a bitset 
@@ -41,14 +158,18 @@ bitset *
 bitset_init(size_t nbits) 
 {
   bitset *set;
-  set = (bitset*) palloc(sizeof(bitset));
+
+  /* The words are stored right after the header */
+  set = (bitset*) palloc(MAXALIGN(sizeof(bitset)) + BITSET_USED(nbits)*sizeof(size_t));
   assert(set);
 
-  set->bits = (size_t*) palloc(BITSET_USED(nbits)*sizeof(size_t));
+  set->bits = (size_t*) ((char *) set + MAXALIGN(sizeof(bitset)));
   set->nbits = nbits;
-  
-  assert(set->bits);
-  
+
+  /* Keep the unused bits of the last word zero */
+  if (nbits > 0)
+    set->bits[BITSET_USED(nbits) - 1] = (size_t)0;
+
   return set;
 }
 
@@ -69,9 +190,11 @@ bitset_reset(bitset *set)
 void 
 bitset_set(bitset *set) 
 {
-	size_t i;
-  for ( i = 0; i < set->nbits; i++)
-    bitset_set_bit(set,i);
+	if (set->nbits == 0)
+		return;
+
+	memset(set->bits, 0xFF, BITSET_USED(set->nbits) * sizeof(*set->bits));
+	set->bits[BITSET_USED(set->nbits) - 1] &= BITSET_TAIL_MASK(set->nbits);
 }
 
 /* bitset_count_set
@@ -81,13 +204,13 @@ bitset_set(bitset *set)
 size_t 
 bitset_count_set(bitset* set) 
 {
-  int count = 0;
-  size_t i;
-  for ( i = 0; i < set->nbits; i++)
-    if (bitset_test_bit(set,i))
-      count++;
+	size_t count = 0;
+	size_t i;
 
-  return count;
+	for ( i = 0; i < BITSET_USED(set->nbits); i++)
+		count += BITSET_POPCOUNT(set->bits[i]);
+
+	return count;
 }
 
 /* bitset_copy
@@ -109,10 +232,61 @@ void
 bitset_free(bitset *set) 
 {
   if (set) 
-  {
-    pfree(set->bits);
     pfree(set);
-  }
+}
+
+/* bitset_pool_init
+ *
+ * Create an empty pool of bitsets with nbits bits
+ */
+bitset_pool *
+bitset_pool_init(size_t nbits)
+{
+	bitset_pool *pool = (bitset_pool *) palloc(sizeof(bitset_pool));
+
+	pool->free_max = BITSET_POOL_SIZE;
+	pool->free = (bitset **) palloc(pool->free_max * sizeof(bitset *));
+	pool->free_count = 0;
+	pool->nbits = nbits;
+
+	return pool;
+}
+
+/* bitset_pool_get
+ *
+ * Take a bitset from the pool, or allocate a new one if the pool is empty.
+ * The content of the bitset is undefined. The pool is used as a stack, so
+ * that the recursion of the confidence computation reuses the bitsets freed
+ * at the same depth.
+ */
+bitset *
+bitset_pool_get(bitset_pool *pool)
+{
+	if (pool->free_count > 0)
+		return pool->free[--pool->free_count];
+
+	return bitset_init(pool->nbits);
+}
+
+/* bitset_pool_put
+ *
+ * Return a bitset to the pool
+ */
+void
+bitset_pool_put(bitset_pool *pool, bitset *set)
+{
+	if (set == NULL)
+		return;
+
+	assert(set->nbits == pool->nbits);
+
+	if (pool->free_count == pool->free_max)
+	{
+		pool->free_max *= 2;
+		pool->free = (bitset **) repalloc(pool->free, pool->free_max * sizeof(bitset *));
+	}
+
+	pool->free[pool->free_count++] = set;
 }
 
 /* bitset_clear_bit
@@ -149,7 +323,7 @@ bitset_set_bit(bitset *set, size_t pos)
  *
  * Test whether a bit is set in a bitset
  */
-int 
+int
 bitset_test_bit(bitset *set, size_t pos) 
 {
 	if (pos >= set->nbits) 
@@ -174,7 +348,7 @@ bitset_print(bitset *set)
 
  myLog("print bit set:\n");
 
-  if (set)
+  if (set) 
     for ( i = 0; i < set->nbits; i++) 
       if (bitset_test_bit(set, i)){
 		myLogi(i); myLog(",");
@@ -190,13 +364,21 @@ bitset_print(bitset *set)
 void 
 bitset_union(bitset *set1, bitset *set2)
 {
-	size_t i;
-  if (set2 == NULL)
-    return;
+	size_t i = 0;
+	size_t used;
 
-  for( i = 0; i < BITSET_USED(set1->nbits); i++)
-    set1->bits[i] |= set2->bits[i];
+	if (set2 == NULL)
+		return;
 
+	used = BITSET_USED(set1->nbits);
+
+#ifdef BITSET_VEC_WORDS
+	for ( ; i + BITSET_VEC_WORDS <= used; i += BITSET_VEC_WORDS)
+		VEC_STORE(set1->bits + i, VEC_OR(VEC_LOAD(set1->bits + i), VEC_LOAD(set2->bits + i)));
+#endif
+
+	for ( ; i < used; i++)
+		set1->bits[i] |= set2->bits[i];
 }
 
 /* bitset_complement
@@ -206,20 +388,25 @@ bitset_union(bitset *set1, bitset *set2)
 bitset *
 bitset_complement(bitset *ref_set, bitset *to_complement)
 {
-	size_t i;
+	size_t i = 0;
+	size_t used;
 	bitset *res;
-	
-  if (!ref_set || !to_complement)
-    return NULL;
 
-  res = bitset_init(ref_set->nbits);
-  bitset_reset(res);
+	if (!ref_set || !to_complement)
+		return NULL;
+
+	res = bitset_init(ref_set->nbits);
+	used = BITSET_USED(ref_set->nbits);
 
-  for ( i = 0; i < ref_set->nbits; i++)
-    if (bitset_test_bit(ref_set,i) && !bitset_test_bit(to_complement,i))
-      bitset_set_bit(res,i);
+#ifdef BITSET_VEC_WORDS
+	for ( ; i + BITSET_VEC_WORDS <= used; i += BITSET_VEC_WORDS)
+		VEC_STORE(res->bits + i, VEC_ANDNOT(VEC_LOAD(to_complement->bits + i), VEC_LOAD(ref_set->bits + i)));
+#endif
 
-  return res;
+	for ( ; i < used; i++)
+		res->bits[i] = ref_set->bits[i] & ~to_complement->bits[i];
+
+	return res;
 }
 
 /* bitset_subtract
@@ -228,94 +415,122 @@ bitset_complement(bitset *ref_set, bitset *to_complement)
  */
 void bitset_subtract(bitset *from_set, bitset *what)
 {
-	size_t i;
-  for ( i = 0; i < from_set->nbits; i++)
-    if (bitset_test_bit(what,i))
-      bitset_clear_bit(from_set,i);
+	size_t i = 0;
+	size_t used = BITSET_USED(from_set->nbits);
+
+#ifdef BITSET_VEC_WORDS
+	for ( ; i + BITSET_VEC_WORDS <= used; i += BITSET_VEC_WORDS)
+		VEC_STORE(from_set->bits + i, VEC_ANDNOT(VEC_LOAD(what->bits + i), VEC_LOAD(from_set->bits + i)));
+#endif
+
+	for ( ; i < used; i++)
+		from_set->bits[i] &= ~what->bits[i];
 }
 
 /* bitset_negate
  *
- * Negate a bitset
+ * Negate a bitset, i.e. flip the bits of to_negate that are set in ref_set
  */
 void 
 bitset_negate(bitset *ref_set, bitset *to_negate)
 {
-	size_t i;
+	size_t i = 0;
+	size_t used = BITSET_USED(ref_set->nbits);
 
-  	for ( i = 0; i < ref_set->nbits; i++)
-  	{
-    	if (bitset_test_bit(ref_set,i))
-    	{
-      		if (bitset_test_bit(to_negate,i))
-				bitset_clear_bit(to_negate,i);
-      		else
-				bitset_set_bit(to_negate,i);
-		}
-	}
+#ifdef BITSET_VEC_WORDS
+	for ( ; i + BITSET_VEC_WORDS <= used; i += BITSET_VEC_WORDS)
+		VEC_STORE(to_negate->bits + i, VEC_XOR(VEC_LOAD(to_negate->bits + i), VEC_LOAD(ref_set->bits + i)));
+#endif
+
+	for ( ; i < used; i++)
+		to_negate->bits[i] ^= ref_set->bits[i];
 }
 
 /* bitset_first_bit_set
  *
  * return -1 if set is empty, or the pos of the first set bit otherwise
  */
-int 
+int
 bitset_first_bit_set(bitset *set)
 {
-	int i = 0;
-	
-  if (!set) return -1;
-  
-  while (i < set->nbits && !bitset_test_bit(set, i))
-    i++;
-  if (i < set->nbits)
-    return i;
-    
-  return -1;
+	int i;
+
+	if (!set) return -1;
+
+	i = first_nonzero_word(set, 0);
+
+	if (i == -1)
+		return -1;
+
+	return i * BITSET_BITS + BITSET_CTZ(set->bits[i]);
+}
+
+/* bitset_next_bit_set
+ *
+ * return -1 if no bit at or after from is set, or the pos of the first such bit otherwise
+ */
+int
+bitset_next_bit_set(bitset *set, size_t from)
+{
+	int i;
+	size_t word;
+
+	if (!set || from >= set->nbits) return -1;
+
+	/* Ignore the bits before from in its word */
+	i = from / BITSET_BITS;
+	word = set->bits[i] & (~((size_t)0) << (from % BITSET_BITS));
+
+	if (word == 0)
+	{
+		i = first_nonzero_word(set, i + 1);
+
+		if (i == -1)
+			return -1;
+
+		word = set->bits[i];
+	}
+
+	return i * BITSET_BITS + BITSET_CTZ(word);
 }
 
 /* bitset_test_singleton
  *
  * return -1 if set is not singleton, otherwise the pos of the set bit
  */
-int 
+int
 bitset_test_singleton(bitset *set)
 {
-  int pos = -1;
-  int i = 0;
-  int how_many = 0;
-  
-  if (!set) return -1;
-
-  while (i < set->nbits && how_many < 2)
-    {
-      if(bitset_test_bit(set, i)) {
-	how_many++;
-	pos = i;
-      }
-    i++;
-    }
-  if (how_many == 1)
-    return pos;
-  return -1;
+	int i;
+	size_t word;
+
+	if (!set) return -1;
+
+	i = first_nonzero_word(set, 0);
+
+	if (i == -1)
+		return -1;
+
+	/* More than one bit is set in the first non-zero word */
+	word = set->bits[i];
+	if ((word & (word - 1)) != 0)
+		return -1;
+
+	/* Another bit is set in the following words */
+	if (first_nonzero_word(set, i + 1) != -1)
+		return -1;
+
+	return i * BITSET_BITS + BITSET_CTZ(word);
 }
 
 /* bitset_test_empty
  *
  * Test whether a bitset is empty 
  */
-int 
+int
 bitset_test_empty(bitset *set)
 {
-	size_t i = 0;
-	
-  if (!set) return 1;
+	if (!set) return 1;
 
-  
-  while (i < BITSET_USED(set->nbits) && set->bits[i] == (size_t)0)
-    i++;
-
-  return (i == BITSET_USED(set->nbits));
+	return first_nonzero_word(set, 0) == -1;
 }
-
-
@@ -0,0 +1,109 @@
+/*-------------------------------------------------------------------------
+ *
+ * condvec.c
+ *	  Reading the condition columns passed to tconf(), conf() and aconf().
+ *
+ *	  The rewriting (see rewrite.c) packs the condition columns of a tuple 
+ *	  into parallel one-dimensional arrays: the variables and range values as
+ *	  int4[] and the probabilities as float4[]. Position i of the arrays is
+ *	  the mapping var->rng of the i-th triple of condition columns, so a 
+ *	  function takes any number of triples. The elements are read in place 
+ *	  after a single detoast of every array. conf() and aconf() also take 
+ *	  the condition of a tuple as a single wsd (see wsd.c).
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "catalog/pg_type.h"
+#include "maybms/condvec.h"
+#include "maybms/wsd.h"
+#include "utils/array.h"
+
+static int condArray(FunctionCallInfo fcinfo, int narg, Oid elemtype, void **data);
+
+/* getCondColumns
+ *
+ * Get the condition columns passed in the arrays of variables, range values 
+ * and probabilities starting at argument narg. If rngs is NULL, there is no
+ * array of range values, which is the case for conf() of tuple-independent 
+ * relations. If argument narg is the last one, it is a wsd instead of the 
+ * arrays. Return the number of mappings.
+ */
+int
+getCondColumns(FunctionCallInfo fcinfo, int narg, varType **vars, 
+			   rngType **rngs, prob **probs)
+{
+	int n;
+
+	if( rngs != NULL && PG_NARGS() == narg + 1 )
+	{
+		if( PG_ARGISNULL( narg ) )
+			elog( ERROR, "condition columns must not be null" );
+
+		return wsdDecode( PG_GETARG_WSD_P( narg ), vars, rngs, probs );
+	}
+
+	n = condArray( fcinfo, narg, INT4OID, ( void ** ) vars );
+
+	if( rngs != NULL )
+	{
+		if( condArray( fcinfo, ++narg, INT4OID, ( void ** ) rngs ) != n )
+			elog( ERROR, "arrays of condition columns differ in length" );
+	}
+
+	if( condArray( fcinfo, narg + 1, FLOAT4OID, ( void ** ) probs ) != n )
+		elog( ERROR, "arrays of condition columns differ in length" );
+
+	return n;
+}
+
+/* getCondProbs
+ *
+ * Get the probabilities of tuple-independent relations passed in the array 
+ * of argument narg. Return the number of probabilities.
+ */
+int
+getCondProbs(FunctionCallInfo fcinfo, int narg, prob **probs)
+{
+	return condArray( fcinfo, narg, FLOAT4OID, ( void ** ) probs );
+}
+
+/* condArray
+ *
+ * Point data to the elements of the array in argument narg, which must be a
+ * one-dimensional array of the given type without nulls. Return the number 
+ * of elements.
+ */
+static int
+condArray(FunctionCallInfo fcinfo, int narg, Oid elemtype, void **data)
+{
+	ArrayType *array;
+
+	if( PG_ARGISNULL( narg ) )
+		elog( ERROR, "condition columns must not be null" );
+
+	array = PG_GETARG_ARRAYTYPE_P( narg );
+
+	if( ARR_ELEMTYPE( array ) != elemtype )
+		elog( ERROR, "condition columns have the wrong type" );
+
+	if( ARR_NDIM( array ) == 0 )
+	{
+		*data = NULL;
+		return 0;
+	}
+
+	if( ARR_NDIM( array ) != 1 )
+		elog( ERROR, "condition columns must be one-dimensional arrays" );
+
+	if( ARR_HASNULL( array ) )
+		elog( ERROR, "condition columns must not be null" );
+
+	*data = ARR_DATA_PTR( array );
+
+	return ARR_DIMS( array )[ 0 ];
+}
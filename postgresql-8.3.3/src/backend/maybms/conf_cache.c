@@ -0,0 +1,316 @@
+/*-------------------------------------------------------------------------
+ *
+ * conf_cache.c
+ *	  	Component cache for exact confidence computation in conf().
+ *
+ *	  The variable elimination of the ws-tree and decomposition tree
+ *	  algorithms often arrives at the same independent component of clauses
+ *	  on different branches. The probabilities of such components are kept
+ *	  in a hash table that lives in the memory context of the group of
+ *	  duplicates. Once the entries exceed conf_cache_size kilobytes, the
+ *	  least recently used entries are evicted.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "maybms/localcond.h"
+#include "maybms/conf_cache.h"
+#include "access/hash.h"
+
+/* GUC variables */
+int conf_cache_size = 1024;
+bool conf_cache_stats = false;
+
+#define INIT_CACHE_BUCKETS 1024
+
+/* Local functions */
+static int build_key(compCache *cache, bitset *set, generalState *state);
+static compCacheEntry *find_entry(compCache *cache, uint32 hash, int *key, int keylen);
+static void unlink_lru(compCache *cache, compCacheEntry *entry);
+static void push_lru(compCache *cache, compCacheEntry *entry);
+static void evict_entry(compCache *cache);
+static void expand_buckets(compCache *cache);
+
+/* build_key
+ *
+ * Write the canonical key of the residual clause set into the scratch space
+ * of the cache and return its length. The key consists of the clauses of the
+ * set in increasing order, each followed by the negated (1-based) columns of
+ * the mappings that are currently dropped from it.
+ */
+static int
+build_key(compCache *cache, bitset *set, generalState *state)
+{
+	int keylen = 0;
+	size_t w;
+	size_t nwords = (set->nbits + sizeof(size_t) * 8 - 1) / (sizeof(size_t) * 8);
+
+	for (w = 0; w < nwords; w++)
+	{
+		size_t word = set->bits[w];
+		int clause = w * sizeof(size_t) * 8;
+
+		/* Loop the set bits of a word */
+		for (; word != 0; word >>= 1, clause++)
+		{
+			int j;
+
+			if (!(word & 1))
+				continue;
+
+			/* Every clause contributes at most wsd_len + 1 entries */
+			if (keylen + state->wsd_len + 1 > cache->keybuf_max)
+			{
+				cache->keybuf_max = cache->keybuf_max * 2 + state->wsd_len + 1;
+				cache->keybuf = (int *) repalloc(cache->keybuf, cache->keybuf_max * sizeof(int));
+			}
+
+			cache->keybuf[keylen++] = clause;
+
+			for (j = 0; j < state->wsd_len; j++)
+				if (state->clauses->rng[MAP(state, clause, j)] == -1)
+					cache->keybuf[keylen++] = -(j + 1);
+		}
+	}
+
+	return keylen;
+}
+
+/* find_entry
+ *
+ * Find the entry with the given key.
+ */
+static compCacheEntry *
+find_entry(compCache *cache, uint32 hash, int *key, int keylen)
+{
+	compCacheEntry *entry = cache->buckets[hash & (cache->nbuckets - 1)];
+
+	while (entry != NULL)
+	{
+		if (entry->hash == hash && entry->keylen == keylen &&
+			memcmp(entry->key, key, keylen * sizeof(int)) == 0)
+			return entry;
+
+		entry = entry->next;
+	}
+
+	return NULL;
+}
+
+/* unlink_lru
+ *
+ * Remove an entry from the LRU list.
+ */
+static void
+unlink_lru(compCache *cache, compCacheEntry *entry)
+{
+	if (entry->lru_prev != NULL)
+		entry->lru_prev->lru_next = entry->lru_next;
+	else
+		cache->lru_head = entry->lru_next;
+
+	if (entry->lru_next != NULL)
+		entry->lru_next->lru_prev = entry->lru_prev;
+	else
+		cache->lru_tail = entry->lru_prev;
+}
+
+/* push_lru
+ *
+ * Make an entry the most recently used one.
+ */
+static void
+push_lru(compCache *cache, compCacheEntry *entry)
+{
+	entry->lru_prev = NULL;
+	entry->lru_next = cache->lru_head;
+
+	if (cache->lru_head != NULL)
+		cache->lru_head->lru_prev = entry;
+	else
+		cache->lru_tail = entry;
+
+	cache->lru_head = entry;
+}
+
+/* evict_entry
+ *
+ * Evict the least recently used entry.
+ */
+static void
+evict_entry(compCache *cache)
+{
+	compCacheEntry *victim = cache->lru_tail;
+	compCacheEntry **link = &cache->buckets[victim->hash & (cache->nbuckets - 1)];
+
+	/* Unlink the entry from its bucket */
+	while (*link != victim)
+		link = &(*link)->next;
+
+	*link = victim->next;
+
+	unlink_lru(cache, victim);
+
+	cache->used -= sizeof(compCacheEntry) + victim->keylen * sizeof(int);
+	cache->entry_count--;
+	cache->evictions++;
+
+	pfree(victim->key);
+	pfree(victim);
+}
+
+/* expand_buckets
+ *
+ * Double the number of buckets and redistribute the entries.
+ */
+static void
+expand_buckets(compCache *cache)
+{
+	int i;
+	int nbuckets = cache->nbuckets * 2;
+	compCacheEntry **buckets = (compCacheEntry **) palloc0(nbuckets * sizeof(compCacheEntry *));
+
+	for (i = 0; i < cache->nbuckets; i++)
+	{
+		compCacheEntry *entry = cache->buckets[i];
+
+		while (entry != NULL)
+		{
+			compCacheEntry *next = entry->next;
+			int index = entry->hash & (nbuckets - 1);
+
+			entry->next = buckets[index];
+			buckets[index] = entry;
+			entry = next;
+		}
+	}
+
+	pfree(cache->buckets);
+	cache->buckets = buckets;
+	cache->nbuckets = nbuckets;
+}
+
+/* compCacheInit
+ *
+ * Create a component cache for the clauses of a state in the current memory
+ * context. NULL is returned if the cache is disabled.
+ */
+compCache *
+compCacheInit(generalState *state)
+{
+	compCache *cache;
+
+	if (conf_cache_size <= 0)
+		return NULL;
+
+	cache = (compCache *) palloc0(sizeof(compCache));
+	cache->nbuckets = INIT_CACHE_BUCKETS;
+	cache->buckets = (compCacheEntry **) palloc0(cache->nbuckets * sizeof(compCacheEntry *));
+	cache->budget = (Size) conf_cache_size * 1024L;
+	cache->keybuf_max = 4 * (state->wsd_len + 1);
+	cache->keybuf = (int *) palloc(cache->keybuf_max * sizeof(int));
+
+	return cache;
+}
+
+/* compCacheLookup
+ *
+ * Look up the probability of a residual clause set in the cache of a state.
+ * True is returned and result is set if the set is cached. Otherwise, pending
+ * is set to a new entry for the set that is passed to compCacheInsert() once
+ * the probability is known.
+ */
+bool
+compCacheLookup(generalState *state, bitset *set, prob *result, compCacheEntry **pending)
+{
+	compCache *cache = state->comp_cache;
+	int keylen = build_key(cache, set, state);
+	uint32 hash = DatumGetUInt32(hash_any((unsigned char *) cache->keybuf, keylen * sizeof(int)));
+	compCacheEntry *entry = find_entry(cache, hash, cache->keybuf, keylen);
+
+	if (entry == NULL)
+	{
+		cache->misses++;
+
+		/* Keep the key, since the keys of recursive lookups overwrite it */
+		entry = (compCacheEntry *) palloc(sizeof(compCacheEntry));
+		entry->hash = hash;
+		entry->keylen = keylen;
+		entry->key = (int *) palloc(keylen * sizeof(int));
+		memcpy(entry->key, cache->keybuf, keylen * sizeof(int));
+
+		*pending = entry;
+
+		return false;
+	}
+
+	/* Move the entry to the front of the LRU list */
+	if (entry != cache->lru_head)
+	{
+		unlink_lru(cache, entry);
+		push_lru(cache, entry);
+	}
+
+	cache->hits++;
+	*result = entry->prob;
+
+	return true;
+}
+
+/* compCacheInsert
+ *
+ * Cache the probability of the set of an entry returned by compCacheLookup().
+ */
+void
+compCacheInsert(generalState *state, compCacheEntry *entry, prob result)
+{
+	compCache *cache = state->comp_cache;
+	Size size;
+	int index;
+
+	size = sizeof(compCacheEntry) + entry->keylen * sizeof(int);
+
+	/* The entry does not fit into the cache at all, or the set has been inserted by a recursive call */
+	if (size > cache->budget || find_entry(cache, entry->hash, entry->key, entry->keylen) != NULL)
+	{
+		pfree(entry->key);
+		pfree(entry);
+		return;
+	}
+
+	/* Make room for the new entry */
+	while (cache->used + size > cache->budget)
+		evict_entry(cache);
+
+	if (cache->entry_count >= cache->nbuckets)
+		expand_buckets(cache);
+
+	entry->prob = result;
+
+	index = entry->hash & (cache->nbuckets - 1);
+	entry->next = cache->buckets[index];
+	cache->buckets[index] = entry;
+
+	push_lru(cache, entry);
+
+	cache->used += size;
+	cache->entry_count++;
+}
+
+/* compCacheReport
+ *
+ * Report the statistics of the cache if conf_cache_stats is set.
+ */
+void
+compCacheReport(compCache *cache, const char *func)
+{
+	if (cache == NULL || !conf_cache_stats)
+		return;
+
+	elog(NOTICE, "%s: component cache hits: %ld, misses: %ld, evictions: %ld, entries: %d, bytes: %lu",
+		 func, cache->hits, cache->misses, cache->evictions, cache->entry_count,
+		 (unsigned long) cache->used);
+}
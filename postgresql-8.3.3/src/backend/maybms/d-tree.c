@@ -11,6 +11,7 @@
 
 #include "maybms/localcond.h"
 #include "maybms/conf_comp.h"
+#include "maybms/conf_cache.h"
 
 /* Macros used in bitset operation */
 #define BITSET_USED(nbits) \
@@ -28,13 +29,6 @@
 
 //#define STATISTICS 1
 
-/* The approach of confidence computation, true for relative and false for absolute */
-bool is_relative = true;
-char *appro_approach = NULL;
-
-/* The error allowed in approximation */
-prob appro_epsilon = 0.05;
-
 /* Variables used in statistics collection */
 int counter = 0;
 int ind_counter = 0;
@@ -74,31 +68,22 @@ typedef struct
 	bucket_info *bucket_list;	/* The set of all buckets */
 } buckets;
 
-/* If the results of equations are not bigger than stopping_number, 
- * then the decomposition tree refinement can stop or a leave can be safely closed
- * (the equations vary in different cases). It is calculated once before
- * the tree construction and is never changed afterwords.
- */
-float8 stopping_number;
-
-/* This variable is set to true when an epsilon-approximation is reached */
-bool has_satisfied_stopping_condition;
-
 /* Local functions */
 
 /* Functions used in quick sort */
-static void quicksort(WSD **array, int left, int right);
-static int partition(WSD **array, int left, int right);
-static prob findMedianOfMedians(WSD **array, int left, int right);
-static int findMedianIndex(WSD **array, int left, int right, int shift);
-static void swap(WSD **array, int a, int b);
+static prob d_tree_prob(generalState *state, int nparts);
+static void quicksort(generalState *state, int left, int right);
+static int partition(generalState *state, int left, int right);
+static prob findMedianOfMedians(generalState *state, int left, int right);
+static int findMedianIndex(generalState *state, int left, int right, int shift);
+static void swap(generalState *state, int a, int b);
 
 /* Heuristic for variable elimination */
 static void compute_upper_and_lower_bounds(bitset *set, float8 *upper, float8 *lower, generalState *state);
-static bool exists_in_bucket(WSD* wsd, bucket_info *bucket);
-static void add_to_bucket(WSD* wsd, bucket_info *bucket);
+static bool exists_in_bucket(int clause, bucket_info *bucket, generalState *state);
+static void add_to_bucket(int clause, bucket_info *bucket, generalState *state);
 static void add_var_to_bucket(int var, bucket_info *bucket);
-static void add_new_bucket(WSD *wsd, buckets *all_buckets);
+static void add_new_bucket(int clause, buckets *all_buckets, generalState *state);
 
 /* The major functions */
 static void decomposition_tree_approximate(bitset* set, generalState *state, 
@@ -112,14 +97,7 @@ static prob decomposition_tree_exact(bitset* set, generalState *state,
 static worldTableEntry *choose_var_max_occur_same_column(bitset* set, generalState *state, int latest_var_col, int *new_var_col);
 
 /* Functions used in bitset operation */
-static void bitset_union_removing_subsumption(bitset *set1, bitset *set2);
-static bitset* find_independent_split(bitset* set);
-static bitset* find_wsds_with_var_rng(bitset* set, int var, int rng);
-static bitset* find_wsds_without_var(bitset* set, int var);
-static void dfs (bitset* set, bitset* set_to_construct, int idx);
-static void reset_wsds_var_rng(bitset* set, int var, int rng);
-static int wsd_ind (WSD* d1, WSD* d2);
-static int compare_map (Map* m1, Map* m2);
+static void bitset_union_removing_subsumption(bitset *set1, bitset *set2, generalState *state);
 
 /* compute_upper_and_lower_bounds
  *
@@ -162,7 +140,7 @@ compute_upper_and_lower_bounds(bitset *set, float8 *upper, float8 *lower, genera
 	all_buckets->bucket_list = (bucket_info *) palloc0(sizeof(bucket_info) * all_buckets->capacity);
 	
 	/* Loop over all clauses */
-	for (i = 0; i < NUM_WSDS; i++)
+	for (i = 0; i < state->num_wsds; i++)
 		/* If the bit of a clause is set, process it */
 		if (bitset_test_bit(set,i))
 		{
@@ -182,9 +160,9 @@ compute_upper_and_lower_bounds(bitset *set, float8 *upper, float8 *lower, genera
 				/* If a clause does not share any variable with clauses in a bucket,
 				 * add it to the bucket.
 				 */
-				if (!exists_in_bucket(S[i], bucket))
+				if (!exists_in_bucket(i, bucket, state))
 				{
-					add_to_bucket(S[i], bucket);
+					add_to_bucket(i, bucket, state);
 					
 					bucket_is_found = true;
 					
@@ -197,7 +175,7 @@ compute_upper_and_lower_bounds(bitset *set, float8 *upper, float8 *lower, genera
 			 */
 			if (!bucket_is_found)
 			{			
-				add_new_bucket(S[i], all_buckets);
+				add_new_bucket(i, all_buckets, state);
 			}
 		}
 	
@@ -234,8 +212,10 @@ compute_upper_and_lower_bounds(bitset *set, float8 *upper, float8 *lower, genera
  * Return true if a clause share any variables with clauses in a bucket.
  */
 static bool
-exists_in_bucket(WSD* wsd, bucket_info *bucket)
+exists_in_bucket(int clause, bucket_info *bucket, generalState *state)
 {
+	clauseStore *S = state->clauses;
+	int first = MAP(state, clause, 0);
 	int i, j;
 	
 	/* Loop over all variables in the bucket */	
@@ -244,12 +224,12 @@ exists_in_bucket(WSD* wsd, bucket_info *bucket)
 		varType var = *(bucket->vars + i); 
 	
 		/* Loop over all variables in the clause */
-		for (j = 0; j < WSD_LEN; j++)
+		for (j = 0; j < state->wsd_len; j++)
 		{
 			/* If a variable has not been eliminated and it is the same as 
 			 * as a variable in the bucket, return true;
 			 */
-			if (wsd->data[j]->rng != -1 && wsd->data[j]->var == var)
+			if (S->rng[first + j] != -1 && S->var[first + j] == var)
 			{
 				return true;
 			}
@@ -265,22 +245,24 @@ exists_in_bucket(WSD* wsd, bucket_info *bucket)
  * Add all variables of a clause to a bucket.
  */
 static void
-add_to_bucket(WSD* wsd, bucket_info *bucket)
+add_to_bucket(int clause, bucket_info *bucket, generalState *state)
 {
+	clauseStore *S = state->clauses;
+	int first = MAP(state, clause, 0);
 	int i;
 	
 	/* Loop over all variables in the clause */
-	for (i = 0; i < WSD_LEN; i++)
+	for (i = 0; i < state->wsd_len; i++)
 	{
 		/* If a variable has not been eliminated, add it to the bucket */
-		if (wsd->data[i]->rng != -1)
+		if (S->rng[first + i] != -1)
 		{
-			add_var_to_bucket(wsd->data[i]->var, bucket);
+			add_var_to_bucket(S->var[first + i], bucket);
 		}
 	}
 	
 	/* Update the probability of the bucket */
-	bucket->prob = bucket->prob + wsd->prob - bucket->prob * wsd->prob;
+	bucket->prob = bucket->prob + S->prob[clause] - bucket->prob * S->prob[clause];
 }
 
 /* add_var_to_bucket
@@ -308,23 +290,23 @@ add_var_to_bucket(int var, bucket_info *bucket)
  * Add a variable to a bucket.
  */
 static void
-add_new_bucket(WSD *wsd, buckets *all_buckets)
+add_new_bucket(int clause, buckets *all_buckets, generalState *state)
 {
 	bucket_info *bucket;
 	
 	/* Initialization of a new bucket */
 	bucket = all_buckets->bucket_list + all_buckets->count;
 	
-	bucket->capacity = WSD_LEN;
+	bucket->capacity = state->wsd_len;
 	
 	bucket->count = 0;
 	
 	bucket->prob = 0;
 	
-	bucket->vars = (varType *) palloc0(sizeof(varType) * WSD_LEN);
+	bucket->vars = (varType *) palloc0(sizeof(varType) * state->wsd_len);
 	
 	/* Add a clause to the new bucket */
-	add_to_bucket(wsd, bucket);
+	add_to_bucket(clause, bucket, state);
 	
 	all_buckets->count++;
 
@@ -337,108 +319,6 @@ add_new_bucket(WSD *wsd, buckets *all_buckets)
 	}
 }
 
-/* find_independent_split 
- *
- * Partition the given wsd set into 2 independent sets
- * first set is returned and contains dependent wsds.
- */
-static bitset*
-find_independent_split(bitset* set)
-{
-	int i = 0;
-	bitset *subset;
-
-  	if (bitset_test_empty(set))
-    	return NULL;
-
-  	subset  = bitset_init(NUM_WSDS);
-  	bitset_reset(subset);
-
-  	while (i < NUM_WSDS && !bitset_test_bit(set,i))
-    	i++;
-
-  	if (i == NUM_WSDS)
-		elog(ERROR, "An invalid input of bitset!");
-
-  	dfs(set,subset,i);
-  
-  	return subset;
-}
-
-static void
-dfs (bitset* set, bitset* set_to_construct, int idx)
-{ 
-	int j;
-  	bitset_set_bit(set_to_construct,idx);
-  	for ( j=0; j<NUM_WSDS; j++)
-    	if (bitset_test_bit(set,j) && !bitset_test_bit(set_to_construct,j) &&
-    		!wsd_ind(S[idx],S[j]) && idx != j)
-      	dfs(set,set_to_construct,j);
-}
-
-/* wsd_ind
- *
- * Return 0 if not independent and 1 if independent.
- */
-static int 
-wsd_ind (WSD* d1, WSD* d2)
-{
-  	int is_independent = 1;
-
-  	int i=0;
-  	
-	while (i<WSD_LEN && is_independent)
-    {
-   		int j=0;
-      
-		while (j<WSD_LEN && compare_map(d1->data[i],d2->data[j]) == 0)
-        	j++;
-      	
-		if (j < WSD_LEN)
-        	is_independent = 0;
-
-      	i++;
-    }
-
-  	return is_independent;
-  
-}
-
-/*  compare_map
- *
- *  Return
- *  -2: equal 
- *  -1: mutex 
- *  0: different vars
- *  2: same vars, diff rng, both neg
- *  3: same vars, diff rng, diff neg (the positive one constrains the negative one)
- */
-static int
-compare_map (Map* m1, Map* m2)
-{
-	if (!m1 || !m2 || m1->rng == -1 || m2->rng == -1)
-		return 0;
-
-	if (m1->var == m2->var)
-	{
-		if (m1->rng == m2->rng)
-    	{
-      		if (m1->neg == m2->neg)
-				return -2;
-      		else
-				return -1;
-		}
-    	else if (m1->neg != m2->neg)
-			return 3;
-  		else if (m1->neg && m2->neg)
-	  		return 2;
-		else 
-	  		return -1;
-  	}
-  
-  	return 0;
-}
-
 /* choose_var_max_occur_same_column
  *
  * Find a variable in column latest_var_col with most occurrence. If all in this 
@@ -461,31 +341,35 @@ choose_var_max_occur_same_column(bitset* set, generalState *state, int latest_va
   	}	
 
 	/* Loop over all clauses and count the occurrence of every variable */
-	for( i = 0; i < NUM_WSDS; i++)
+	for( i = 0; i < state->num_wsds; i++)
     	if (bitset_test_bit(set, i)) 
 		{
-      		for ( j = 0; j < WSD_LEN; j++) 
+			int first = MAP( state, i, 0 );
+
+      		for ( j = 0; j < state->wsd_len; j++) 
 			{
 				/* If a variable has not been eliminated, increase its occurrence */
-				if( S[i]->data[j]->rng >= 0 )
+				if( state->clauses->rng[first + j] >= 0 )
 				{
-					S[i]->data[j]->wt_entry->occur_count++;
+					worldTableEntry *wt_entry = WT_ENTRY( state, first + j );
+
+					wt_entry->occur_count++;
 					
 					if (j == latest_var_col)
 					{
-						if (S[i]->data[j]->wt_entry->occur_count > same_column_max)
+						if (wt_entry->occur_count > same_column_max)
 						{
-							same_column_max_wt_entry = S[i]->data[j]->wt_entry;
-							same_column_max = S[i]->data[j]->wt_entry->occur_count;
+							same_column_max_wt_entry = wt_entry;
+							same_column_max = wt_entry->occur_count;
 							*new_var_col = j;
 						}	
 					}
 					else if (same_column_max == -1)
 					{
-						if (S[i]->data[j]->wt_entry->occur_count > other_columns_max)
+						if (wt_entry->occur_count > other_columns_max)
 						{
-							other_columns_max_wt_entry = S[i]->data[j]->wt_entry;
-							other_columns_max = S[i]->data[j]->wt_entry->occur_count;
+							other_columns_max_wt_entry = wt_entry;
+							other_columns_max = wt_entry->occur_count;
 							*new_var_col = j;
 						}							
 					}					
@@ -501,131 +385,21 @@ choose_var_max_occur_same_column(bitset* set, generalState *state, int latest_va
 		return other_columns_max_wt_entry;
 }
 
-/* find_wsds_without_var
- *
- * Find the wsds that do not contain mapping of the given var
- */
-static bitset*
-find_wsds_without_var(bitset* set, int var)
-{
-  	bitset *subset  = NULL;
-	int i;
- 
- 	/* Loop the world set descriptors */
-  	for ( i = 0; i < NUM_WSDS; i++)
-    	if (bitset_test_bit(set,i)) 
-		{
-      		int j = 0;
-      		
-			while (j < WSD_LEN && S[i]->data[j]->var != var)
-				j++;
-
-      		if (j == WSD_LEN) 
-			{
-				if (subset == NULL) 
-				{
-	  				subset = bitset_init(NUM_WSDS);
-	  				bitset_reset(subset);
-				}
-	
-				bitset_set_bit(subset,i);
-      		}
-    	}
-  
-  	return subset;
-}
-
-/* find_wsds_with_var_rng 
- *
- * Find the world set descriptors that contain mapping var->rng; also *temporarily* drop this mapping.
- */
-static bitset*
-find_wsds_with_var_rng(bitset* set, int var, int rng)
-{
-  	bitset *subset  = NULL;
-  	int found_empty_wsd = 0;
-	int i = 0;
-	
-  	while (i < NUM_WSDS && !found_empty_wsd) 
-  	{
-    	if (bitset_test_bit(set,i)) 
-    	{
-      		int j;
-      		
-      		for(j = 0; j < WSD_LEN; j++)
-      		{
-      			if (S[i]->data[j]->var == var && S[i]->data[j]->rng == rng)
-      			{
-					if (subset == NULL) 
-					{
-		  				subset = bitset_init(NUM_WSDS);
-		  				bitset_reset(subset);
-					}
-	
-					bitset_set_bit(subset,i);
-
-					/* Mark the used choices of rng for that var. */
-					S[i]->data[j]->rng = -1;
-					S[i]->prob /= S[i]->data[j]->prob;
-
-					/* Check if the remaining S[i] is empty, 
-					 * in which case the prob of all wsds agreeing with (var,rng) is just S[i]->data[j]->prob
-					 */
-					if (S[i]->prob == 1.0)
-			  			found_empty_wsd = 1;      				
-      			}
-      		}
-    	}
-    	
-    	i++;
-  	}
-  
-  	if (found_empty_wsd) 
-  	{
-  		reset_wsds_var_rng(subset, var, rng);
-    	bitset_reset(subset);
-  	}
-
-  	return subset;
-}
-
-/* reset_wsds_var_rng
- *
- * The temporarily dropped mappings (see find_wsds_with_var_rng) are restored.
- */
-static void
-reset_wsds_var_rng(bitset* set, int var, int rng)
-{
-	int i; int j;
-
-	/* Loop the world set descriptors */
-  	for ( i = 0; i < NUM_WSDS; i++)
-    	if (bitset_test_bit(set,i))
-    		/* Restore the world set descriptors */
-      		for ( j = 0; j < WSD_LEN; j++)
-				if(S[i]->data[j]->var == var) 
-				{
-	  				S[i]->data[j]->rng = rng;
-	  				S[i]->prob *= S[i]->data[j]->prob;
-				}
-  
-}
-
 /* quicksort
  *
  * Quicksort the array.
  */
 static void 
-quicksort(WSD **array, int left, int right)
+quicksort(generalState *state, int left, int right)
 {
 	int index;
 
     if(left >= right)
         return;
  
-    index = partition(array, left, right);
-    quicksort(array, left, index - 1);
-    quicksort(array, index + 1, right);
+    index = partition(state, left, right);
+    quicksort(state, left, index - 1);
+    quicksort(state, index + 1, right);
 }
  
 /* partition
@@ -634,31 +408,31 @@ quicksort(WSD **array, int left, int right)
  * array is partitioned.
  */
 static int 
-partition(WSD **array, int left, int right)
+partition(generalState *state, int left, int right)
 {
 	int pivotIndex, index, i;
 	prob pivotValue;
 
     /* Makes the leftmost element a good pivot, specifically the median of medians */ 	
-    findMedianOfMedians(array, left, right);
+    findMedianOfMedians(state, left, right);
 
     pivotIndex = left; 
     index = left;
     
- 	pivotValue = array[pivotIndex]->prob;
+ 	pivotValue = state->clauses->prob[pivotIndex];
      
-    swap(array, pivotIndex, right);
+    swap(state, pivotIndex, right);
     
     for(i = left; i < right; i++)
     {
-        if(array[i]->prob > pivotValue)
+        if(state->clauses->prob[i] > pivotValue)
         {
-            swap(array, i, index);
+            swap(state, i, index);
             index += 1;
         }
     }
     
-    swap(array, right, index);
+    swap(state, right, index);
  
     return index;
 }
@@ -670,26 +444,26 @@ partition(WSD **array, int left, int right)
  * hence only one Median.
  */ 
 static prob 
-findMedianOfMedians(WSD **array, int left, int right)
+findMedianOfMedians(generalState *state, int left, int right)
 {
 	int i, shift = 1;
 	
     if(left == right)
-        return array[left]->prob;
+        return state->clauses->prob[left];
      
     while(shift <= (right - left))
     {
         for(i = left; i <= right; i+=shift*5)
         {
             int endIndex = (i + shift*5 - 1 < right) ? i + shift*5 - 1 : right;
-            int medianIndex = findMedianIndex(array, i, endIndex, shift);
+            int medianIndex = findMedianIndex(state, i, endIndex, shift);
  
-            swap(array, i, medianIndex);
+            swap(state, i, medianIndex);
         }
         shift *= 5;
     }
  
-    return array[left]->prob;
+    return state->clauses->prob[left];
 }
  
 /* findMedianIndex
@@ -698,22 +472,22 @@ findMedianOfMedians(WSD **array, int left, int right)
  * "shift" positions.
  */ 
 static int 
-findMedianIndex(WSD **array, int left, int right, int shift)
+findMedianIndex(generalState *state, int left, int right, int shift)
 {
     int i, groups = (right - left)/shift + 1, k = left + groups/2*shift;
 
     for(i = left; i <= k; i+= shift)
     {
         int minIndex = i,  j;
-        prob minValue = array[minIndex]->prob;
+        prob minValue = state->clauses->prob[minIndex];
         
         for(j = i; j <= right; j+=shift)
-            if(array[j]->prob > minValue)
+            if(state->clauses->prob[j] > minValue)
             {
                 minIndex = j;
-                minValue = array[minIndex]->prob;
+                minValue = state->clauses->prob[minIndex];
             }
-        swap(array, i, minIndex);
+        swap(state, i, minIndex);
     }
  
     return k;
@@ -721,14 +495,44 @@ findMedianIndex(WSD **array, int left, int right, int shift)
  
 /* swap
  * 
- * Swap the positions of two world set descriptors.
+ * Swap the positions of two world set descriptors together with their mappings.
  */ 
 static void 
-swap(WSD **array, int a, int b)
+swap(generalState *state, int a, int b)
 {
-    WSD *tmp = array[a];
-    array[a] = array[b];
-    array[b] = tmp;
+	clauseStore *array = state->clauses;
+	prob tmp_prob;
+	int j;
+
+	if (a == b)
+		return;
+
+	tmp_prob = array->prob[a];
+	array->prob[a] = array->prob[b];
+	array->prob[b] = tmp_prob;
+
+	for (j = 0; j < state->wsd_len; j++)
+	{
+		int ma = MAP(state, a, j);
+		int mb = MAP(state, b, j);
+		varType tmp_var = array->var[ma];
+		rngType tmp_rng = array->rng[ma];
+		prob tmp_map_prob = array->map_prob[ma];
+		int tmp_wt_index = array->wt_index[ma];
+		int tmp_rng_index = array->rng_index[ma];
+
+		array->var[ma] = array->var[mb];
+		array->rng[ma] = array->rng[mb];
+		array->map_prob[ma] = array->map_prob[mb];
+		array->wt_index[ma] = array->wt_index[mb];
+		array->rng_index[ma] = array->rng_index[mb];
+
+		array->var[mb] = tmp_var;
+		array->rng[mb] = tmp_rng;
+		array->map_prob[mb] = tmp_map_prob;
+		array->wt_index[mb] = tmp_wt_index;
+		array->rng_index[mb] = tmp_rng_index;
+	}
 }
 
 /* bitset_union_removing_subsumption
@@ -737,7 +541,7 @@ swap(WSD **array, int a, int b)
  * CNF A is subsumed by CNF B if A implies B. 
  */
 static void 
-bitset_union_removing_subsumption(bitset *set1, bitset *set2)
+bitset_union_removing_subsumption(bitset *set1, bitset *set2, generalState *state)
 {
 	int i, j, k, h;
 	
@@ -749,17 +553,17 @@ bitset_union_removing_subsumption(bitset *set1, bitset *set2)
 	}
 
   	/* Copy the second bitset to a temporary one because modifications are needed */
-  	temp_set = bitset_init(NUM_WSDS);  
+  	temp_set = allocBitset(state);  
         	
 	bitset_copy(set2, temp_set);
 
 	/* Loop over all clauses in the first bitset */
-	for (i = 0; i < NUM_WSDS; i++)
+	for (i = 0; i < state->num_wsds; i++)
 		/* Pick a valid clause in the first bitset */
 		if (bitset_test_bit(set1,i))
 		{	
 			/* Loop over all clauses in the temporary bitset */
-			for (j = 0; j < NUM_WSDS; j++)
+			for (j = 0; j < state->num_wsds; j++)
 			{
 				/* Pick a valid clause in the second bitset */
 				if (bitset_test_bit(temp_set,j))
@@ -767,16 +571,16 @@ bitset_union_removing_subsumption(bitset *set1, bitset *set2)
 					bool vars_found = true;
 				
 					/* Loop over all variables in the first clause */
-					for (k = 0; k < WSD_LEN; k++)
+					for (k = 0; k < state->wsd_len; k++)
 					{
-						if (S[i]->data[k]->rng != -1)
+						if (state->clauses->rng[MAP(state, i, k)] != -1)
 						{
 							bool var_found = false;
 						
 							/* Loop over all variables in the second clause */
-							for (h = 0; h < WSD_LEN; h++)
+							for (h = 0; h < state->wsd_len; h++)
 							{
-								if (S[i]->data[k]->var == S[j]->data[h]->var)
+								if (state->clauses->var[MAP(state, i, k)] == state->clauses->var[MAP(state, j, h)])
 								{
 									var_found = true;
 									break;
@@ -813,7 +617,7 @@ bitset_union_removing_subsumption(bitset *set1, bitset *set2)
 		set1->bits[i] |= temp_set->bits[i];
 
 	/* Free the temporary bitset */
-	bitset_free(temp_set);
+	freeBitset(state, temp_set);
 }
 
 /* decomposition_tree_approximate
@@ -827,7 +631,6 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 	bound_information *bound_info, int latest_var_column)
 {
 	int pos;
-	int var = -1;
 	int i;
 	int j;
 	bitset* subset_without_var = NULL;
@@ -853,7 +656,7 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 	}
 
 	/* Find a subset of clauses which do not share variables with the rest of the clauses */	
-	subset = find_independent_split(set);
+	subset = findIndependentSplit(set, state);
 	
 	/* Get the bitset of the rest of the clauses so that their upper and lower bounds can be computed. */
 	bitset_negate(set, subset);
@@ -879,9 +682,9 @@ decomposition_tree_approximate (bitset* set, generalState *state,
  	/* Special case of 1 clause: the bounds are the probability of the clause */
   	if (pos != -1)
   	{
-  		p_left_lower = S[pos]->prob;
+  		p_left_lower = state->clauses->prob[pos];
   		
-  		p_left_upper = S[pos]->prob;
+  		p_left_upper = state->clauses->prob[pos];
   	}
   	/* Cases with more than 1 clause */
   	else
@@ -899,19 +702,16 @@ decomposition_tree_approximate (bitset* set, generalState *state,
   			
   			*upper = 1;
   			
-  			bitset_free(subset);
+  			freeBitset(state, subset);
   			
   			return;
    		}
    		
-   		/* The variable in the returned world table entry */
-		var = wt_entry->var;
-
 		/* All range values of the variable */
 		rng_entry = wt_entry->rng_entries;
 
 		/* The bitset of clauses which do not contain the eliminated variables */
-		subset_without_var = find_wsds_without_var(subset, var);     		
+		subset_without_var = findWsdsWithoutVar(subset, wt_entry, state);     		
 
 		/* The bounds for clauses where a range value of the variable is chose */
 		float8 upper_bounds[wt_entry->rng_entry_count];
@@ -934,7 +734,7 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 			float8 cur_prob = (rng_entry + i)->p;
 	
 			/* The bitset of clauses where the range value of the variable appears */
-			bitset* subset_var_rng = find_wsds_with_var_rng(subset, var, (rng_entry + i)->rng);
+			bitset* subset_var_rng = findWsdsWithVarRng(subset, rng_entry + i, state);
 		
 			/* No clauses contain the range value of the variable */
 			if (subset_var_rng == NULL) 
@@ -993,7 +793,7 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 					lower_bounds[i] *= cur_prob;
 			
 					/* Reset the bitset */
-					reset_wsds_var_rng(subset_var_rng, var, (rng_entry + i)->rng);
+					resetWsdsWithVarRng(state);
 				
 					/* Set the state of clauses for the range value */
 					state_of_subset_var_rng[i] = SUBSET_VAR_RNG_SHOULD_UNION;
@@ -1002,7 +802,7 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 			
 			/* Free local bitsets */
 			if (subset_var_rng)
-				bitset_free(subset_var_rng);
+				freeBitset(state, subset_var_rng);
 		}
 
 		/* Loop over all range values for the second round to decide whether to 
@@ -1066,20 +866,20 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 				bound_info->condition_constant_upper;
 
 			/* Relative cases */
-			if (is_relative)
+			if (state->is_relative)
 			{
 				/* Test the stopping condition */
-				if ((whole_upper - whole_lower) / whole_lower <= stopping_number)
+				if ((whole_upper - whole_lower) / whole_lower <= state->stopping_number)
 				{
-					has_satisfied_stopping_condition = true;
+					state->has_satisfied_stopping_condition = true;
 					break;
 				}	
 		
 				/* Test whether we can close an open leave */
-				if ((condition_whole_upper - whole_lower) / whole_lower <= stopping_number)
+				if ((condition_whole_upper - whole_lower) / whole_lower <= state->stopping_number)
 				{
 					/* Decide whether we should close the leave */
-					if (((upper_bounds[i] - lower_bounds[i]) * path_prob) / whole_lower <= 0.001 * stopping_number)
+					if (((upper_bounds[i] - lower_bounds[i]) * path_prob) / whole_lower <= 0.001 * state->stopping_number)
 					{					
 						continue;				
 					}
@@ -1089,17 +889,17 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 			else
 			{
 				/* Test the stopping condition */
-				if ((whole_upper - whole_lower) <= stopping_number)
+				if ((whole_upper - whole_lower) <= state->stopping_number)
 				{
-					has_satisfied_stopping_condition = true;
+					state->has_satisfied_stopping_condition = true;
 					break;
 				}	
 		
 				/* Test whether we can close an open leave */
-				if ((condition_whole_upper - whole_lower) <= stopping_number )
+				if ((condition_whole_upper - whole_lower) <= state->stopping_number )
 				{
 					/* Decide whether we should close the leave */
-					if (((upper_bounds[i] - lower_bounds[i]) * path_prob) <= 0.001 * stopping_number)
+					if (((upper_bounds[i] - lower_bounds[i]) * path_prob) <= 0.001 * state->stopping_number)
 					{	
 						continue;				
 					}
@@ -1172,13 +972,13 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 				else 
 				{
 					/* Compute the bitset of clauses containing the range value */				
-					bitset* subset_var_rng = find_wsds_with_var_rng(subset, var, (rng_entry + i)->rng);
+					bitset* subset_var_rng = findWsdsWithVarRng(subset, rng_entry + i, state);
 
 					/* Get the union of bitset of clauses that contain the range 
 					 * values and that do not contain the variable. Subsumed clases
 					 * are removed at the same time.
 					 */						
-					bitset_union_removing_subsumption(subset_var_rng, subset_without_var);
+					bitset_union_removing_subsumption(subset_var_rng, subset_without_var, state);
 				
 					/* Refine the leave */
 					decomposition_tree_approximate(subset_var_rng, state, 
@@ -1186,10 +986,10 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 						&next_bound_info, latest_var_column);		
 			
 					/* Reset the bitset */
-					reset_wsds_var_rng(subset_var_rng, var, (rng_entry + i)->rng);
+					resetWsdsWithVarRng(state);
 
 					/* Free the local bitset */
-					bitset_free(subset_var_rng);
+					freeBitset(state, subset_var_rng);
 					
 					/* Update the bounds with probability of the range value */		
 					lower_bounds[i] *= cur_prob;
@@ -1199,7 +999,7 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 			}
 			
 			/* If the an epsilon-refinement has been reached, stop the iteration */
-			if (has_satisfied_stopping_condition)
+			if (state->has_satisfied_stopping_condition)
 				break;
 		}  		  		
 
@@ -1222,28 +1022,28 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 		+ bound_info->constant_lower;
 
 	/* Relative cases */
-	if (is_relative)
+	if (state->is_relative)
 	{
 		/* Test the stopping condition */
-		if ((whole_upper - whole_lower) / whole_lower <= stopping_number)
+		if ((whole_upper - whole_lower) / whole_lower <= state->stopping_number)
 		{
-			has_satisfied_stopping_condition = true;
+			state->has_satisfied_stopping_condition = true;
 		}	
 	}
 	/* Absolute cases */
 	else
 	{
 		/* Test the stopping condition */
-		if ((whole_upper - whole_lower) <= stopping_number)
+		if ((whole_upper - whole_lower) <= state->stopping_number)
 		{
-			has_satisfied_stopping_condition = true;
+			state->has_satisfied_stopping_condition = true;
 		}	
 	}
 
 	/* If an epsilon-approximation has not been reached and the right partition 
 	 * is not NULL, proceed to the right partition. 
 	 */
-	if (!has_satisfied_stopping_condition && p_right_lower != 0)
+	if (!state->has_satisfied_stopping_condition && p_right_lower != 0)
 	{
 		/* The code below prepares the necessary information to refine a leave */
 		/* TODO: More detailed explanation of coefficients and constants below is needed */
@@ -1281,9 +1081,9 @@ decomposition_tree_approximate (bitset* set, generalState *state,
 
 	/* Free local bitsets */
 	if (subset_without_var)
-		bitset_free(subset_without_var);	
+		freeBitset(state, subset_without_var);	
 
-	bitset_free(subset);
+	freeBitset(state, subset);
 }
 
 
@@ -1300,13 +1100,13 @@ decomposition_tree_exact(bitset* set, generalState *state, int latest_var_column
   	int i;
   	bitset *subset;
   	int pos;
-  	int var;		
 	prob p_without_var = -1;
 	prob cur_prob = 0.0;
     worldTableEntry *wt_entry;
 	rngEntry *rng_entry;
 	bitset* subset_without_var = NULL;
 	bitset* subset_var_rng;
+	compCacheEntry *pending = NULL;
 
 	/* Return 0 if the set if empty */
   	if (bitset_test_empty(set))
@@ -1315,7 +1115,7 @@ decomposition_tree_exact(bitset* set, generalState *state, int latest_var_column
 	}
 
   	/* Find subset of S independent of the rest (subset repr. dependent wsds) */
-  	subset = find_independent_split(set);
+  	subset = findIndependentSplit(set, state);
  
 	#ifdef STATISTICS
 	counter++;
@@ -1336,7 +1136,10 @@ decomposition_tree_exact(bitset* set, generalState *state, int latest_var_column
 
 	/* Special case of 1 wsd */
 	if (pos != -1) 
-    	p_left = S[pos]->prob;
+    	p_left = state->clauses->prob[pos];
+	/* The component has been computed on another branch */
+	else if (state->comp_cache != NULL && compCacheLookup(state, subset, &p_left, &pending))
+		;
     /* Subset contains more than one wsd */
  	else 
  	{				
@@ -1346,209 +1149,120 @@ decomposition_tree_exact(bitset* set, generalState *state, int latest_var_column
 
 		/* All vars are used in the wsd set */
 		if (wt_entry == NULL)
-		{ 
-			return 1.0;
-   		}
+			p_left = 1.0;
+		else
+		{
+			subset_without_var = findWsdsWithoutVar(subset, wt_entry, state);
 
-		var = wt_entry->var;
+			rng_entry = wt_entry->rng_entries;
 
-		subset_without_var = find_wsds_without_var(subset, var);
+			/* Loop the range values for a single variable */
+			for ( i = 0; i < wt_entry->rng_entry_count; i++) 
+			{
+				cur_prob = ( rng_entry + i )->p;
+				subset_var_rng = findWsdsWithVarRng(subset, rng_entry + i, state);
 
-		rng_entry = wt_entry->rng_entries;
+			  	if (subset_var_rng == NULL) 
+			  	{
+					if (p_without_var == -1)
+					{
+			  			p_without_var = decomposition_tree_exact (subset_without_var, state, new_var_column);
+					}
+					
+					cur_prob *= p_without_var;
+			  	}
+			  	else 
+			  	{
+					if (bitset_test_empty(subset_var_rng))
+					{
+						#ifdef STATISTICS
+						subsumption_counter += bitset_count_set(set);
+						#endif				
+					}
+					else 
+					{
+						bitset_union_removing_subsumption(subset_var_rng, subset_without_var, state);
+						cur_prob *= decomposition_tree_exact (subset_var_rng, state, new_var_column);
+						resetWsdsWithVarRng(state);
+					}
+			  	}
 
-		/* Loop the range values for a single variable */
-		for ( i = 0; i < wt_entry->rng_entry_count; i++) 
-		{
-			cur_prob = ( rng_entry + i )->p;
-			subset_var_rng = find_wsds_with_var_rng(subset, var, ( rng_entry + i )->rng );
+				p_left += cur_prob;
 
-		  	if (subset_var_rng == NULL) 
-		  	{
-				if (p_without_var == -1)
-				{
-		  			p_without_var = decomposition_tree_exact (subset_without_var, state, new_var_column);
-				}
-				
-				cur_prob *= p_without_var;
-		  	}
-		  	else 
-		  	{
-				if (bitset_test_empty(subset_var_rng))
-				{
-					#ifdef STATISTICS
-					subsumption_counter += bitset_count_set(set);
-					#endif				
-				}
-				else 
-				{
-					bitset_union_removing_subsumption(subset_var_rng, subset_without_var);
-					cur_prob *= decomposition_tree_exact (subset_var_rng, state, new_var_column);
-					reset_wsds_var_rng(subset_var_rng, var, ( rng_entry + i )->rng );
-				}
-		  	}
-
-			p_left += cur_prob;
-
-			/* Stop early */
-		  	if ((p_left == 1.0) && (wt_entry->rng_entry_count == 1)) 
-		  	{
-				return 1.0;
-		  	}
-		  	
-		  	if (subset_var_rng != NULL)
-    			bitset_free(subset_var_rng);
-    	}
+			  	if (subset_var_rng != NULL)
+	    			freeBitset(state, subset_var_rng);
+
+				/* Stop early */
+			  	if ((p_left == 1.0) && (wt_entry->rng_entry_count == 1)) 
+					break;
+	    	}
+		}
+
+		if (pending != NULL)
+			compCacheInsert(state, pending, p_left);
   	}
 
+	/* All exits below release the bitsets of the left subset */
+	if (subset_without_var != NULL)
+		freeBitset(state, subset_without_var);
+
 	/* Stop early */
   	if (p_left == 1.0) 
   	{
+		freeBitset(state, subset);
+
     	return 1.0;
   	}
 
-	if (subset_without_var != NULL)
-		bitset_free(subset_without_var);
-
   	/* Process recursively the right subset */
 
   	bitset_negate(set,subset);
   	p_right = decomposition_tree_exact(subset, state, latest_var_column);	
 
-	bitset_free(subset);
+	freeBitset(state, subset);
 
   	/* Combine the probabilities of left and right subsets */
 
   	return p_left + p_right - p_left * p_right;
 }
 
-/* Following are transition functions for ws-tree algorithm.
- * They are actually only dummies and the task is done in the MACRO accum
- */
-
-/* TODO: We can use arrays to store the condition columns in the future. */
-
-/* conf_accum1_ge
- *
- * Transition function for exact confidence computation with 1 triple of 
- * condition columns 
- */
-Datum 
-conf_appro_accum1_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 1 )
-}
-
-/* conf_accum2_ge
- *
- * Transition function for exact confidence computation with 2 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum2_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 2 )
-}
-
-/* conf_accum3_ge
- *
- * Transition function for exact confidence computation with 3 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum3_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 3  )
-}
-
-/* conf_accum4_ge
- *
- * Transition function for exact confidence computation with 4 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum4_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 4 )
-}
-
-/* conf_accum5_ge
- *
- * Transition function for exact confidence computation with 5 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum5_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 5 )
-}
-
-/* conf_accum6_ge
- *
- * Transition function for exact confidence computation with 6 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum6_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 6 )
-}
-
-/* conf_accum7_ge
+/* conf_appro_accum_ge
  *
- * Transition function for exact confidence computation with 7 triples of 
- * condition columns 
+ * Transition function for approximate confidence computation. The arguments
+ * are the approach, epsilon and the condition columns of a tuple as arrays of
+ * variables, range values and probabilities (see conf_accum_ge).
  */
 Datum 
-conf_appro_accum7_ge(PG_FUNCTION_ARGS)
+conf_appro_accum_ge(PG_FUNCTION_ARGS)
 {
-	conf_appro_accum( 7 )
+	varType *vars;
+	rngType *rngs;
+	prob *probs;
+	int n = getCondColumns( fcinfo, 3, &vars, &rngs, &probs );
+	generalState *state = getGenState( fcinfo, n );
+	VarChar *source = PG_GETARG_VARCHAR_PP( 1 );
+
+	state->appro_approach = VARSIZE_ANY_EXHDR( source ) > 0 ? *VARDATA_ANY( source ) : '\0';
+	state->appro_epsilon = PG_GETARG_FLOAT4( 2 );
+	advance( state, fcinfo, n, vars, rngs, probs );
+
+	PG_RETURN_INT32( state->slot );
 }
 
-/* conf_accum8_ge
+/* d_tree_prob
  *
- * Transition function for exact confidence computation with 8 triples of 
- * condition columns 
+ * Compute the probability of the clauses of a state in memory, which are one
+ * of nparts independent parts of the lineage. A relative approximation of 
+ * every part is a relative approximation of their disjunction, but absolute
+ * errors add up, so each part gets an equal share of the absolute error.
  */
-Datum 
-conf_appro_accum8_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 8 )
-}
-
-/* conf_accum9_ge
- *
- * Transition function for exact confidence computation with 9 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum9_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 9 )
-}
-
-/* conf_accum10_ge
- *
- * Transition function for exact confidence computation with 10 triples of 
- * condition columns 
- */
-Datum 
-conf_appro_accum10_ge(PG_FUNCTION_ARGS)
-{
-	conf_appro_accum( 10 )
-}
-
-/* conf_final_ge
- *
- * The final function for confidence computation of decomposition tree.
- */
-Datum 
-conf_appro_final_ge(PG_FUNCTION_ARGS)
+static prob
+d_tree_prob(generalState *state, int nparts)
 {
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate;
 	prob result = 0;
 	bitset* set;
-	MemoryContext oldcxt;
 	bound_information bound_info;
+	prob epsilon = state->is_relative ? state->appro_epsilon : state->appro_epsilon / nparts;
 	
 	float8 lower = 0;
 	float8 upper = 0;
@@ -1561,52 +1275,24 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
 	
 	#endif
 	
-	/* Return 0 if there is no tuple */
-	if (groupcxt == NULL)
-		PG_RETURN_FLOAT4(0);	
-
-	/* Check the validity of the input */	
-	if (strncmp(appro_approach, "R", 1) == 0)
-		is_relative = true;
-	else if (strncmp(appro_approach, "A", 1) == 0)
-		is_relative = false;
-	else
-	{
-		/* Delete the memory context for the group of duplicates */
-		MemoryContextDelete( groupcxt );
-	
-		/* Set the world-set-descriptor-related global variables to NULL */
-		NUM_WSDS = 0;
-		S = NULL;
-		groupcxt = NULL;  		
-	
-		elog(ERROR, "The approximation approach can only be 'R' (relative approximation) or 'A' (absolute approximation).");
-	}
-	
-	/* Switch to the group context */
-	oldcxt = MemoryContextSwitchTo( groupcxt ); 
-
 	/* Complete the local world table */
 	getMissingRngs( state ); 
-
-	/* Compute the entry pointers of all clauses */
-	computeEntryPointers(state);
   	
   	/* bitset related operation */
-  	set = bitset_init(NUM_WSDS);  
+  	set = allocBitset(state);  
 
   	bitset_set(set);            
 
 	/* If epsilon is larger than 0, call the approximate approach */
-	if (appro_epsilon > 0)
+	if (epsilon > 0)
 	{
 		/* Set the stopping number used to decide whether an epsilon approximation is reached */
-		if (is_relative)
-	 		stopping_number = 2 * appro_epsilon / (1 - appro_epsilon);
+		if (state->is_relative)
+	 		state->stopping_number = 2 * epsilon / (1 - epsilon);
 		else
-			stopping_number = 2 * appro_epsilon;
+			state->stopping_number = 2 * epsilon;
 
-		has_satisfied_stopping_condition = false;
+		state->has_satisfied_stopping_condition = false;
 
 		/* Prepare the coefficients and constants for efficient upper and lower bound computation */	
 		bound_info.coefficient_upper = 1;
@@ -1624,28 +1310,31 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
     	subsumption_counter = 0;
     
     	/* Quicksort the clauses according to their probabilities */
-    	quicksort(S, 0, NUM_WSDS - 1);
+    	quicksort(state, 0, state->num_wsds - 1);
+
+		/* The clause positions have changed, so the inverted index is rebuilt */
+		rebuildClauseIndex(state);
 	
 		/* Compute the upper and lower bounds before any node is constructed */
 		compute_upper_and_lower_bounds(set, &upper, &lower, state);
 
 		/* Relative case */
-		if (is_relative)
+		if (state->is_relative)
 		{
 			/* Test the stopping condition */
-			if ((upper - lower) / lower <= stopping_number)
-				has_satisfied_stopping_condition = true;
+			if ((upper - lower) / lower <= state->stopping_number)
+				state->has_satisfied_stopping_condition = true;
 		}
 		/* Absolute case */
 		else
 		{
 			/* Test the stopping condition */
-			if ((upper - lower) <= stopping_number)
-				has_satisfied_stopping_condition = true;
+			if ((upper - lower) <= state->stopping_number)
+				state->has_satisfied_stopping_condition = true;
 		}
 
 		/* If an epsilon approximation is not reached, construct the decomposition tree */
-		if (!has_satisfied_stopping_condition)
+		if (!state->has_satisfied_stopping_condition)
 		{
 			lower = 0;
 			upper = 0;
@@ -1654,9 +1343,9 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
 		}
 		
 		/* Relative case */
-		if (is_relative)
+		if (state->is_relative)
 		{
-			result = (upper * (1- appro_epsilon) + lower * (1 + appro_epsilon)) / 2;
+			result = (upper * (1- epsilon) + lower * (1 + epsilon)) / 2;
 		}
 		/* Absolute case */
 		else
@@ -1673,7 +1362,13 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
 		/* Call the exact confidence computation */
 		if (upper - lower > 0)
 		{
+			/* Create the cache of component probabilities */
+			state->comp_cache = compCacheInit(state);
+
 			result = decomposition_tree_exact(set, state, -1);
+
+			compCacheReport(state->comp_cache, "conf");
+			state->comp_cache = NULL;
 		}
 		/* Stop early */
 		else
@@ -1689,9 +1384,9 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
 	
 	fprintf(fp, "---------stats for 1 set of duplicates:\n");
 	
-	fprintf(fp, "#clauses: %d\n", NUM_WSDS);
+	fprintf(fp, "#clauses: %d\n", state->num_wsds);
 	
-	fprintf(fp, "#variables in a clause:%d\n", WSD_LEN);
+	fprintf(fp, "#variables in a clause:%d\n", state->wsd_len);
 	
 	fprintf(fp, "#variables:%d\n", state->wt_entry_count);
 	
@@ -1709,16 +1404,49 @@ conf_appro_final_ge(PG_FUNCTION_ARGS)
 
 	fclose(fp);
 
-	#endif	
+	#endif
+
+	return result;
+}
+
+/* conf_final_ge
+ *
+ * The final function for confidence computation of decomposition tree.
+ */
+Datum 
+conf_appro_final_ge(PG_FUNCTION_ARGS)
+{
+	generalState *state = findGenState( fcinfo );
+	prob result = 0;
+	MemoryContext oldcxt;
+	
+	/* Return 0 if there is no tuple */
+	if (state == NULL)
+		PG_RETURN_FLOAT4(0);	
+
+	/* The group has been computed before a rescan */
+	if (state->finalized)
+		PG_RETURN_FLOAT4(state->result);
+
+	/* Check the validity of the input */	
+	if (state->appro_approach == 'R')
+		state->is_relative = true;
+	else if (state->appro_approach == 'A')
+		state->is_relative = false;
+	else
+		elog(ERROR, "The approximation approach can only be 'R' (relative approximation) or 'A' (absolute approximation).");
 	
+	/* Switch to the group context */
+	oldcxt = MemoryContextSwitchTo( state->groupcxt ); 
+
+	/* Compute the probability */
+	result = lineageProb( state, d_tree_prob );
+
 	/* Switch back to the old context */
 	MemoryContextSwitchTo( oldcxt );
-	MemoryContextDelete( groupcxt );
-	
-	/* Set the world-set-descriptor-related global variables to NULL */
-	NUM_WSDS = 0;
-	S = NULL;
-	groupcxt = NULL;      
+
+	/* Release the memory of the group of duplicates */
+	releaseGenState( fcinfo, state, result );
 
 	/* Return the result */
 	PG_RETURN_FLOAT4(result);	
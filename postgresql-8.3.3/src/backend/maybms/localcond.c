@@ -2,8 +2,11 @@
  *
  * localcond.c
  *	  	Storing and accessing the lineage for world-set tree algorithm and 
- * Monte-Carlo simulations. Right now, these two confidence computation 
- * procedures main-memory-based and random acccess to lineage is required. 
+ * Monte-Carlo simulations. These confidence computation procedures are
+ * main-memory-based and random acccess to lineage is required. A lineage
+ * exceeding conf_work_mem is therefore written to a temporary file, and at
+ * the end it is split into sets of independent components that are loaded
+ * one at a time, see lineageProb().
  *
  * Copyright (c) 2008, MayBMS Development Group
  *
@@ -11,6 +14,10 @@
  */
 
 #include "maybms/localcond.h"
+#include "utils/hsearch.h"
+
+/* GUC variables */
+int conf_work_mem = 65536;
 
 /* Initial number of bits used for maksing */
 #define INIT_NBITS 10
@@ -21,6 +28,9 @@
 /* Initial size of the array storing domain values in each variable */
 #define RNGENTRYSIZE 3
 
+/* Initial size of the array storing the clauses of a range value */
+#define CLAUSEENTRYSIZE 4
+
 /* Initial size of a bucket storing pointers to the world table entries */
 #define LIST_INIT_SIZE 30
 #define KEY_NOT_FOUND -1
@@ -29,47 +39,243 @@
 #define GETMASK(nbits) ((1 << nbits) - 1)
 #define HASHFUNC(key, mask) (key & mask)
 
-/* create_map
+/* Initial number of states of conf() and aconf() in an AggState */
+#define GENSTATEINITSIZE 4
+
+/* Estimated memory of a clause of n mappings, including its inverted index entries */
+#define CLAUSE_SIZE(n) ((n) * (sizeof(varType) + sizeof(rngType) + sizeof(prob) + \
+						2 * sizeof(int) + sizeof(clauseEntry)) + sizeof(prob))
+
+/* Estimated memory of an entry of the local world table */
+#define WT_ENTRY_SIZE (sizeof(worldTableEntry) + RNGENTRYSIZE * sizeof(rngEntry))
+
+/* Initial number of nodes of the union-find forest over the spilled variables */
+#define FORESTINITSIZE 1024
+
+/* A variable of the spilled lineage and its node in the union-find forest */
+typedef struct spillVarEntry
+{
+	varType var;
+	int node;
+} spillVarEntry;
+
+/*
+ * The union-find forest connecting the variables that occur in a common 
+ * clause of the spilled lineage. Node 0 stands for the clauses without any
+ * variable but the reserved one.
+ */
+typedef struct spillForest
+{
+	HTAB *vars;
+	int *parent;
+	long *size;			/* number of clauses in the component of a root */
+	int num_nodes;
+	int max_nodes;
+} spillForest;
+
+/* Local functions */
+static void reserveClause(generalState *state);
+static void insertClause(generalState *state);
+static Size lineageSize(generalState *state);
+static void spillLineage(generalState *state, MemoryContext parent);
+static bool loadClause(generalState *state, BufFile *file);
+static void writeClause(BufFile *file, int n, varType *vars, rngType *rngs, prob *probs);
+static bool readClause(BufFile *file, int n, varType *vars, rngType *rngs, prob *probs);
+static void rewindFile(BufFile *file);
+static int forestNode(spillForest *forest, varType var);
+static int forestFind(spillForest *forest, int node);
+static int clauseRoot(spillForest *forest, int n, varType *vars, bool connect);
+
+/* getGenState
+ *
+ * Get the state of the group of duplicates of a call of a transition function
+ * of conf() or aconf(), whose clauses consist of n mappings. The transition 
+ * value is the index of the state in the AggState, and it is NULL for the 
+ * first clause of a group. In that case, a new state is set up.
+ */
+generalState *
+getGenState(FunctionCallInfo fcinfo, int n)
+{
+	AggState *aggstate = ( AggState * ) fcinfo->context;
+	generalState *state;
+	MemoryContext oldcxt;
+
+	if( !PG_ARGISNULL( 0 ) )
+		return aggstate->genstates[ PG_GETARG_INT32( 0 ) ];
+
+	/* The states live as long as the aggregation */
+	oldcxt = MemoryContextSwitchTo( aggstate->aggcontext );
+
+	/* Allocate or expand the array of states */
+	if( aggstate->genstates == NULL )
+	{
+		aggstate->genstate_max = GENSTATEINITSIZE;
+		aggstate->genstates = 
+			( generalState ** ) palloc0( aggstate->genstate_max * sizeof( generalState * ) );
+	}
+	else if( aggstate->genstate_count == aggstate->genstate_max )
+	{
+		aggstate->genstates = 
+			( generalState ** ) repalloc( aggstate->genstates, aggstate->genstate_max * 2 * sizeof( generalState * ) );
+		MemSet( aggstate->genstates + aggstate->genstate_max, 0, aggstate->genstate_max * sizeof( generalState * ) );
+		aggstate->genstate_max = aggstate->genstate_max * 2;
+	}
+
+	/* Reuse the state of a finalized group if there is one */
+	state = aggstate->genstates[ aggstate->genstate_count ];
+
+	if( state == NULL )
+	{
+		state = ( generalState * ) palloc( sizeof( generalState ) );
+		aggstate->genstates[ aggstate->genstate_count ] = state;
+	}
+
+	MemSet( state, 0, sizeof( generalState ) );
+	state->slot = aggstate->genstate_count;
+
+	aggstate->genstate_count++;
+	aggstate->genstate_live++;
+
+	/* All memory of the group is released with this context */
+	state->groupcxt = AllocSetContextCreate( aggstate->aggcontext, "GroupContext", 
+											 ALLOCSET_DEFAULT_MINSIZE,
+											 ALLOCSET_DEFAULT_INITSIZE, 
+											 ALLOCSET_DEFAULT_MAXSIZE );
+
+	MemoryContextSwitchTo( state->groupcxt );
+
+	genStateInit( state, n );
+
+	MemoryContextSwitchTo( oldcxt );
+
+	return state;
+}
+
+/* findGenState
  *
- * Create a map with a variable, a range and a probability.
+ * Get the state of the group of duplicates of a call of a final function of 
+ * conf() or aconf(). NULL is returned if the group is empty.
  */
-Map * 
-create_map (int var, int rng, int neg, prob prob)
+generalState *
+findGenState(FunctionCallInfo fcinfo)
 {
-  	Map* m      = (Map*) palloc (sizeof(Map));
-  	m->var      = var;
-  	m->rng      = rng;
-  	m->neg      = neg;
-  	m->prob     = prob;
-  
-  	return m;
+	if( PG_ARGISNULL( 0 ) )
+		return NULL;
+
+	return ( ( AggState * ) fcinfo->context )->genstates[ PG_GETARG_INT32( 0 ) ];
 }
 
-/* advance
+/* releaseGenState
  *
- * Add a world set descriptor.
+ * Release the memory of a group of duplicates after its result has been
+ * computed. With hashing, the final function may be called again for the
+ * same group if the hash table is rescanned, so the result is kept. 
+ * Otherwise, the states can be reused once all confidence aggregates of
+ * the group are finalized.
  */
-void 
-advance(int n, generalState *state, WSD* wsd)
+void
+releaseGenState(FunctionCallInfo fcinfo, generalState *state, float4 result)
 {
-	int i, j;
+	AggState *aggstate = ( AggState * ) fcinfo->context;
 
-	/* Initialize S if it is NULL */
-	if( S == NULL )
+	if( state->spill != NULL )
 	{
-		genStateInit( state ); 
+		BufFileClose( state->spill->file );
+		MemoryContextDelete( state->spill->cxt );
+		state->spill = NULL;
 	}
 
-	/* Expand the size of S if it reaches its limit */
-	if(NUM_WSDS >= current_size - 1)
+	MemoryContextDelete( state->groupcxt );
+	state->groupcxt = NULL;
+	state->clauses = NULL;
+	state->num_wsds = 0;
+
+	state->finalized = true;
+	state->result = result;
+
+	if( ( ( Agg * ) aggstate->ss.ps.plan )->aggstrategy != AGG_HASHED )
 	{
-		current_size = current_size * 2;
-		S = ( WSD ** ) repalloc( S, current_size * sizeof( WSD * ) );
+		aggstate->genstate_live--;
+
+		if( aggstate->genstate_live == 0 )
+			aggstate->genstate_count = 0;
 	}
+}
+
+/* advance
+ *
+ * Append a world set descriptor to the lineage of a state. Its n mappings 
+ * are given by the arrays of variables, range values and probabilities.
+ */
+void 
+advance(generalState *state, FunctionCallInfo fcinfo, int n, 
+		varType *vars, rngType *rngs, prob *probs)
+{
+	clauseStore *S;
+	int first;
+	MemoryContext oldcxt;
+
+	if( n != state->wsd_len )
+		elog( ERROR, "world set descriptors of a group differ in length" );
+
+	oldcxt = MemoryContextSwitchTo( state->groupcxt );
+
+	reserveClause( state );
+
+	S = state->clauses;
+
+	/* Insert the mappings of the world set descriptor */
+	first = MAP( state, state->num_wsds, 0 );
+
+	memcpy( S->var + first, vars, n * sizeof( varType ) );
+	memcpy( S->rng + first, rngs, n * sizeof( rngType ) );
+	memcpy( S->map_prob + first, probs, n * sizeof( prob ) );
+
+	insertClause( state );
+
+	/* Write the lineage to disk if it exceeds conf_work_mem */
+	if( lineageSize( state ) > conf_work_mem * 1024L )
+		spillLineage( state, ( ( AggState * ) fcinfo->context )->aggcontext );
+
+	MemoryContextSwitchTo( oldcxt );
+}
+
+/* reserveClause
+ *
+ * Make room for one more clause in the lineage of a state.
+ */
+static void
+reserveClause(generalState *state)
+{
+	clauseStore *S = state->clauses;
+	int n = state->wsd_len;
+
+	/* Expand the lineage if it reaches its limit */
+	if( state->num_wsds >= state->wsd_max )
+	{
+		state->wsd_max = state->wsd_max * 2;
+		S->var = ( varType * ) repalloc( S->var, state->wsd_max * n * sizeof( varType ) );
+		S->rng = ( rngType * ) repalloc( S->rng, state->wsd_max * n * sizeof( rngType ) );
+		S->map_prob = ( prob * ) repalloc( S->map_prob, state->wsd_max * n * sizeof( prob ) );
+		S->wt_index = ( int * ) repalloc( S->wt_index, state->wsd_max * n * sizeof( int ) );
+		S->rng_index = ( int * ) repalloc( S->rng_index, state->wsd_max * n * sizeof( int ) );
+		S->prob = ( prob * ) repalloc( S->prob, state->wsd_max * sizeof( prob ) );
+	}
+}
+
+/* insertClause
+ *
+ * Add the clause whose mappings have been stored after the last clause of
+ * the lineage to the lineage.
+ */
+static void
+insertClause(generalState *state)
+{
+	clauseStore *S = state->clauses;
+	int n = state->wsd_len;
+	int first = MAP( state, state->num_wsds, 0 );
+	int i, j;
 
-	/* Insert the world set descriptor */
-	S[ NUM_WSDS ] = wsd;
-	
 	/* Loop every map in the world set descriptor */
 	for (i = 0; i < n - 1; i++)
 	{
@@ -80,27 +286,385 @@ advance(int n, generalState *state, WSD* wsd)
 			 * This is necessary because the following calculation assumes that 
 			 * there is no duplicate map.
 			 */
-			if( S[ NUM_WSDS ]->data[ i ]->var == S[ NUM_WSDS ]->data[ j ]->var )
+			if( S->var[ first + i ] == S->var[ first + j ] )
 			{
-				S[ NUM_WSDS ]->data[ j ]->var = RESERVED_VAR;
-				S[ NUM_WSDS ]->data[ j ]->rng = RNG_FOR_RESERVED_VAR;
-				S[ NUM_WSDS ]->data[ j ]->prob = 1;
+				S->var[ first + j ] = RESERVED_VAR;
+				S->rng[ first + j ] = RNG_FOR_RESERVED_VAR;
+				S->map_prob[ first + j ] = 1;
 			}
 		} 
 	}
 
+	S->prob[ state->num_wsds ] = 1.0;
+
 	/* Loop the maps */
 	for( j = 0; j < n; j++ )
 	{
 		/* Calculate the probability of the world set descriptor */
-		S[ NUM_WSDS ]->prob *= S[ NUM_WSDS ]->data[ j ]->prob;
+		S->prob[ state->num_wsds ] *= S->map_prob[ first + j ];
 		
 		/* Update the local world table */
-		updateWorldTable( state, S[ NUM_WSDS ]->data[ j ] ); 
+		updateWorldTable( state, first + j ); 
+
+		/* Record the clause in the inverted index of the range value */
+		addClauseEntry( state, state->num_wsds, j );
 	}
 
 	/* Increase the counter */
-	NUM_WSDS++;
+	state->num_wsds++;
+}
+
+/* lineageSize
+ *
+ * Estimate the memory used by the lineage of a state.
+ */
+static Size
+lineageSize(generalState *state)
+{
+	return state->num_wsds * CLAUSE_SIZE( state->wsd_len ) + 
+		state->wt_entry_count * WT_ENTRY_SIZE;
+}
+
+/* spillLineage
+ *
+ * Append the clauses in memory to the temporary file of a state, and start 
+ * over with an empty lineage in memory. The file is created in a child of 
+ * parent with the first spill.
+ */
+static void
+spillLineage(generalState *state, MemoryContext parent)
+{
+	lineageSpill *spill = state->spill;
+	clauseStore *S = state->clauses;
+	int n = state->wsd_len;
+	MemoryContext oldcxt;
+	int i;
+
+	if( spill == NULL )
+	{
+		MemoryContext cxt = AllocSetContextCreate( parent, "LineageSpill", 
+												   ALLOCSET_DEFAULT_MINSIZE,
+												   ALLOCSET_DEFAULT_INITSIZE, 
+												   ALLOCSET_DEFAULT_MAXSIZE );
+
+		oldcxt = MemoryContextSwitchTo( cxt );
+
+		spill = ( lineageSpill * ) palloc( sizeof( lineageSpill ) );
+		spill->cxt = cxt;
+		spill->file = BufFileCreateTemp( false );
+		spill->num_clauses = 0;
+		state->spill = spill;
+
+		MemoryContextSwitchTo( oldcxt );
+	}
+
+	for( i = 0; i < state->num_wsds; i++ )
+	{
+		int first = MAP( state, i, 0 );
+
+		writeClause( spill->file, n, S->var + first, S->rng + first, S->map_prob + first );
+	}
+
+	spill->num_clauses += state->num_wsds;
+
+	/* Start over with an empty lineage */
+	MemoryContextReset( state->groupcxt );
+
+	oldcxt = MemoryContextSwitchTo( state->groupcxt );
+	genStateInit( state, n );
+	MemoryContextSwitchTo( oldcxt );
+}
+
+/* lineageProb
+ *
+ * Compute the probability of the lineage of a state with the given function.
+ *
+ * If the lineage has been spilled, the clauses are partitioned on disk into
+ * sets of independent components, each of which fits into conf_work_mem. The
+ * components are found with a union-find forest over the variables, which 
+ * needs memory per variable rather than per clause. The sets are loaded one 
+ * at a time, and the probability of the lineage is 1 - (1 - p_1)...(1 - p_k)
+ * over the probabilities p_i of the k sets. A component that does not fit 
+ * into conf_work_mem on its own is still loaded as a whole.
+ */
+prob
+lineageProb(generalState *state, lineageProbFunc compute)
+{
+	lineageSpill *spill = state->spill;
+	int n = state->wsd_len;
+	spillForest forest;
+	HASHCTL ctl;
+	varType *vars;
+	rngType *rngs;
+	prob *probs;
+	int *part_of;
+	BufFile **parts;
+	long capacity, part_size;
+	int nparts, i;
+	float8 none = 1;	/* probability that no clause is true */
+	MemoryContext oldcxt;
+
+	if( spill == NULL )
+		return compute( state, 1 );
+
+	/* Write the rest of the clauses, so that all of them are on disk */
+	spillLineage( state, NULL );
+
+	oldcxt = MemoryContextSwitchTo( spill->cxt );
+
+	vars = ( varType * ) palloc( n * sizeof( varType ) );
+	rngs = ( rngType * ) palloc( n * sizeof( rngType ) );
+	probs = ( prob * ) palloc( n * sizeof( prob ) );
+
+	/* Connect the variables of every clause */
+	MemSet( &ctl, 0, sizeof( ctl ) );
+	ctl.keysize = sizeof( varType );
+	ctl.entrysize = sizeof( spillVarEntry );
+	ctl.hash = tag_hash;
+	ctl.hcxt = spill->cxt;
+	forest.vars = hash_create( "conf() spilled variables", FORESTINITSIZE, &ctl, 
+							   HASH_ELEM | HASH_FUNCTION | HASH_CONTEXT );
+	forest.max_nodes = FORESTINITSIZE;
+	forest.parent = ( int * ) palloc( forest.max_nodes * sizeof( int ) );
+	forest.size = ( long * ) palloc( forest.max_nodes * sizeof( long ) );
+	forest.parent[0] = 0;
+	forest.size[0] = 0;
+	forest.num_nodes = 1;
+
+	rewindFile( spill->file );
+
+	while( readClause( spill->file, n, vars, rngs, probs ) )
+		forest.size[ clauseRoot( &forest, n, vars, true ) ]++;
+
+	/* Pack the components into sets of at most capacity clauses */
+	capacity = Max( conf_work_mem * 1024L / ( long ) CLAUSE_SIZE( n ), 1 );
+	part_of = ( int * ) palloc( forest.num_nodes * sizeof( int ) );
+	part_size = 0;
+	nparts = 0;
+
+	for( i = 0; i < forest.num_nodes; i++ )
+	{
+		if( forest.parent[i] != i || forest.size[i] == 0 )
+			continue;
+
+		/* Start a new set if the component does not fit into the current one */
+		if( nparts == 0 || part_size + forest.size[i] > capacity )
+		{
+			nparts++;
+			part_size = 0;
+		}
+
+		part_of[i] = nparts - 1;
+		part_size += forest.size[i];
+	}
+
+	/* Distribute the clauses to one temporary file per set */
+	parts = ( BufFile ** ) palloc( nparts * sizeof( BufFile * ) );
+
+	if( nparts == 1 )
+		parts[0] = spill->file;
+	else
+	{
+		for( i = 0; i < nparts; i++ )
+			parts[i] = BufFileCreateTemp( false );
+
+		rewindFile( spill->file );
+
+		while( readClause( spill->file, n, vars, rngs, probs ) )
+			writeClause( parts[ part_of[ clauseRoot( &forest, n, vars, false ) ] ], 
+						 n, vars, rngs, probs );
+	}
+
+	hash_destroy( forest.vars );
+
+	/* Compute the probabilities of the sets one at a time */
+	for( i = 0; i < nparts; i++ )
+	{
+		rewindFile( parts[i] );
+
+		MemoryContextReset( state->groupcxt );
+		MemoryContextSwitchTo( state->groupcxt );
+		genStateInit( state, n );
+
+		while( loadClause( state, parts[i] ) )
+			;
+
+		none *= 1 - compute( state, nparts );
+
+		MemoryContextSwitchTo( spill->cxt );
+
+		if( parts[i] != spill->file )
+			BufFileClose( parts[i] );
+	}
+
+	MemoryContextSwitchTo( oldcxt );
+
+	return 1 - none;
+}
+
+/* loadClause
+ *
+ * Read the next clause of a temporary file into the lineage of a state. 
+ * Return false at the end of the file.
+ */
+static bool
+loadClause(generalState *state, BufFile *file)
+{
+	clauseStore *S;
+	int first;
+
+	reserveClause( state );
+
+	S = state->clauses;
+	first = MAP( state, state->num_wsds, 0 );
+
+	if( !readClause( file, state->wsd_len, S->var + first, S->rng + first, S->map_prob + first ) )
+		return false;
+
+	insertClause( state );
+
+	return true;
+}
+
+/* writeClause
+ *
+ * Write a clause of n mappings to a temporary file.
+ */
+static void
+writeClause(BufFile *file, int n, varType *vars, rngType *rngs, prob *probs)
+{
+	if( BufFileWrite( file, ( void * ) vars, n * sizeof( varType ) ) != n * sizeof( varType ) ||
+		BufFileWrite( file, ( void * ) rngs, n * sizeof( rngType ) ) != n * sizeof( rngType ) ||
+		BufFileWrite( file, ( void * ) probs, n * sizeof( prob ) ) != n * sizeof( prob ) )
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not write to conf() temporary file: %m")));
+}
+
+/* readClause
+ *
+ * Read a clause of n mappings from a temporary file. Return false at the end
+ * of the file.
+ */
+static bool
+readClause(BufFile *file, int n, varType *vars, rngType *rngs, prob *probs)
+{
+	size_t nread = BufFileRead( file, ( void * ) vars, n * sizeof( varType ) );
+
+	if( nread == 0 )
+		return false;
+
+	if( nread != n * sizeof( varType ) ||
+		BufFileRead( file, ( void * ) rngs, n * sizeof( rngType ) ) != n * sizeof( rngType ) ||
+		BufFileRead( file, ( void * ) probs, n * sizeof( prob ) ) != n * sizeof( prob ) )
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not read from conf() temporary file: %m")));
+
+	return true;
+}
+
+/* rewindFile
+ *
+ * Go back to the start of a temporary file.
+ */
+static void
+rewindFile(BufFile *file)
+{
+	if( BufFileSeek( file, 0, 0L, SEEK_SET ) != 0 )
+		ereport(ERROR,
+				(errcode_for_file_access(),
+				 errmsg("could not rewind conf() temporary file: %m")));
+}
+
+/* forestNode
+ *
+ * Get the node of a variable in the union-find forest, adding it if needed.
+ */
+static int
+forestNode(spillForest *forest, varType var)
+{
+	bool found;
+	spillVarEntry *entry = ( spillVarEntry * ) hash_search( forest->vars, ( void * ) &var, 
+															 HASH_ENTER, &found );
+
+	if( !found )
+	{
+		if( forest->num_nodes == forest->max_nodes )
+		{
+			forest->max_nodes = forest->max_nodes * 2;
+			forest->parent = ( int * ) repalloc( forest->parent, forest->max_nodes * sizeof( int ) );
+			forest->size = ( long * ) repalloc( forest->size, forest->max_nodes * sizeof( long ) );
+		}
+
+		entry->node = forest->num_nodes++;
+		forest->parent[ entry->node ] = entry->node;
+		forest->size[ entry->node ] = 0;
+	}
+
+	return entry->node;
+}
+
+/* forestFind
+ *
+ * Find the root of a node, halving the path to it.
+ */
+static int
+forestFind(spillForest *forest, int node)
+{
+	while( forest->parent[ node ] != node )
+	{
+		forest->parent[ node ] = forest->parent[ forest->parent[ node ] ];
+		node = forest->parent[ node ];
+	}
+
+	return node;
+}
+
+/* clauseRoot
+ *
+ * Return the root of the component of a clause. If connect is set, the 
+ * components of all variables of the clause are merged first; otherwise 
+ * this must have been done before.
+ */
+static int
+clauseRoot(spillForest *forest, int n, varType *vars, bool connect)
+{
+	int root = -1;
+	int j;
+
+	for( j = 0; j < n; j++ )
+	{
+		int r;
+
+		/* The reserved variable has a single value of probability 1 */
+		if( vars[j] == RESERVED_VAR )
+			continue;
+
+		r = forestFind( forest, forestNode( forest, vars[j] ) );
+
+		if( !connect )
+			return r;
+
+		if( root == -1 )
+			root = r;
+		else if( r != root )
+		{
+			/* Hang the smaller component below the larger one */
+			if( forest->size[ r ] > forest->size[ root ] )
+			{
+				int tmp = r;
+
+				r = root;
+				root = tmp;
+			}
+
+			forest->parent[ r ] = root;
+			forest->size[ root ] += forest->size[ r ];
+		}
+	}
+
+	return ( root == -1 ) ? 0 : root;
 }
 
 /* getMissingRngs
@@ -157,40 +721,341 @@ getMissingRngs(generalState *s)
 	}
 }
 
-/* computeEntryPointers
+/* addClauseEntry
  *
- * Compute the entry ponters in the clauses with the offsets.
+ * Append a clause to the inverted index of the range value of one of its 
+ * maps. The map must already have been inserted into the local world table.
  */
 void
-computeEntryPointers(generalState *s)
+addClauseEntry(generalState *s, int clause, int column)
 {
-	Map *map;	
-	int i, k;
-	
-	/* Loop over all clauses */
-    for(i = 0; i < NUM_WSDS; i++)
-    {
-    	/* Loop over all variables */
-      	for(k = 0; k < WSD_LEN; k++)
-      	{
-      		map = S[i]->data[k];
-      	
-      		map->wt_entry = s->wt_entries + map->wt_offset;
-      		
-      		map->rng_entry = map->wt_entry->rng_entries + map->rng_offset;
-        }
-    }
+	rngEntry *rng_entry = RNG_ENTRY( s, MAP( s, clause, column ) );
+	clauseEntry *clause_entry;
+
+	/* Allocate the array lazily, most range values are only used once */
+	if( rng_entry->clause_entries == NULL )
+	{
+		rng_entry->clause_entry_max = CLAUSEENTRYSIZE;
+		rng_entry->clause_entries = 
+			( clauseEntry * ) palloc( rng_entry->clause_entry_max * sizeof( clauseEntry ) );
+	}
+	/* If the limit of the clause entries is reached, increase the capacity by 2 */
+	else if( rng_entry->clause_entry_count == rng_entry->clause_entry_max )
+	{
+		rng_entry->clause_entry_max = rng_entry->clause_entry_max * 2;
+		rng_entry->clause_entries = 
+			( clauseEntry * ) repalloc( rng_entry->clause_entries, rng_entry->clause_entry_max * sizeof( clauseEntry ) );
+	}
+
+	clause_entry = rng_entry->clause_entries + rng_entry->clause_entry_count;
+	clause_entry->clause = clause;
+	clause_entry->column = column;
+
+	rng_entry->clause_entry_count++;
 }
 
+/* rebuildClauseIndex
+ *
+ * Rebuild the inverted index from scratch. This is needed if the clauses 
+ * have been reordered after they were added.
+ */
+void
+rebuildClauseIndex(generalState *s)
+{
+	worldTableEntry *wt_entry;
+	int i, j;
+
+	/* Empty the clause lists of all range values */
+	for( i = 0; i < s->wt_entry_count; i++ )
+	{
+		wt_entry = s->wt_entries + i;
+
+		for( j = 0; j < wt_entry->rng_entry_count; j++ )
+			( wt_entry->rng_entries + j )->clause_entry_count = 0;
+	}
+
+	/* Loop over all clauses and their maps */
+	for( i = 0; i < s->num_wsds; i++ )
+		for( j = 0; j < s->wsd_len; j++ )
+			addClauseEntry( s, i, j );
+}
+
+/* findIndependentSplit 
+ *
+ * Partition the given wsd set into 2 independent sets; the first set is 
+ * returned and contains the wsds connected to the first wsd in the set.
+ *
+ * Two wsds are dependent if they share a variable whose mappings are not 
+ * dropped in either of them. Instead of comparing all pairs of wsds, the 
+ * connected component is collected with the inverted index: every variable 
+ * reached is expanded only once per search. The posting lists of a variable
+ * cover all clauses of the group, so when they are longer than the mappings
+ * of the clauses of the set still unreached, these clauses are checked
+ * directly instead.
+ */
+bitset *
+findIndependentSplit(bitset *set, generalState *s)
+{
+	bitset *subset;
+	int top = 0;
+	int first;
+	int unreached;
+
+	if (bitset_test_empty(set))
+		return NULL;
+
+	first = bitset_first_bit_set(set);
+
+	subset = allocBitset(s);
+	bitset_reset(subset);
+
+	/* The stack can never hold more than all clauses */
+	if (s->clause_stack == NULL)
+		s->clause_stack = (int *) palloc(s->num_wsds * sizeof(int));
+
+	/* Start a new search so that no variable counts as visited */
+	s->visit_stamp++;
+
+	bitset_set_bit(subset, first);
+	s->clause_stack[top++] = first;
+	unreached = bitset_count_set(set) - 1;
+
+	while (top > 0 && unreached > 0)
+	{
+		int first = MAP( s, s->clause_stack[--top], 0 );
+		int k;
+
+		/* Loop over the variables of the clause */
+		for (k = 0; k < s->wsd_len && unreached > 0; k++)
+		{
+			worldTableEntry *wt_entry;
+			int postings = 0;
+			int i, j;
+
+			/* Dropped mappings do not make clauses dependent */
+			if (s->clauses->rng[first + k] == -1)
+				continue;
+
+			wt_entry = WT_ENTRY(s, first + k);
+
+			/* All clauses sharing the variable have already been reached */
+			if (wt_entry->visited == s->visit_stamp)
+				continue;
+
+			wt_entry->visited = s->visit_stamp;
+
+			for (i = 0; i < wt_entry->rng_entry_count; i++)
+				postings += ( wt_entry->rng_entries + i )->clause_entry_count;
+
+			/* Check the unreached clauses of the set for the variable */
+			if (postings > unreached * s->wsd_len)
+			{
+				int clause;
+
+				for (clause = bitset_first_bit_set(set); clause != -1; clause = bitset_next_bit_set(set, clause + 1))
+				{
+					int m = MAP( s, clause, 0 );
+
+					if (bitset_test_bit(subset, clause))
+						continue;
+
+					for (j = 0; j < s->wsd_len; j++)
+					{
+						if (s->clauses->rng[m + j] != -1 && WT_ENTRY(s, m + j) == wt_entry)
+						{
+							bitset_set_bit(subset, clause);
+							s->clause_stack[top++] = clause;
+							unreached--;
+							break;
+						}
+					}
+				}
+
+				continue;
+			}
+
+			/* Reach all clauses in the set using the variable */
+			for (i = 0; i < wt_entry->rng_entry_count; i++)
+			{
+				rngEntry *rng_entry = wt_entry->rng_entries + i;
+
+				for (j = 0; j < rng_entry->clause_entry_count; j++)
+				{
+					clauseEntry *clause_entry = rng_entry->clause_entries + j;
+
+					if (bitset_test_bit(set, clause_entry->clause) && 
+						!bitset_test_bit(subset, clause_entry->clause) &&
+						s->clauses->rng[ MAP( s, clause_entry->clause, clause_entry->column ) ] != -1)
+					{
+						bitset_set_bit(subset, clause_entry->clause);
+						s->clause_stack[top++] = clause_entry->clause;
+						unreached--;
+					}
+				}
+			}
+		}
+	}
+
+	return subset;
+}
+
+/* findWsdsWithoutVar
+ *
+ * Find the wsds in a set that do not contain a mapping of the variable of the
+ * given world table entry. Return NULL if there is none.
+ */
+bitset *
+findWsdsWithoutVar(bitset *set, worldTableEntry *wt_entry, generalState *s)
+{
+	bitset *subset = allocBitset(s);
+	int i, j;
+
+	bitset_copy(set, subset);
+
+	/* Remove every clause using the variable */
+	for (i = 0; i < wt_entry->rng_entry_count; i++)
+	{
+		rngEntry *rng_entry = wt_entry->rng_entries + i;
+
+		for (j = 0; j < rng_entry->clause_entry_count; j++)
+			bitset_clear_bit(subset, ( rng_entry->clause_entries + j )->clause);
+	}
+
+	if (bitset_test_empty(subset))
+	{
+		freeBitset(s, subset);
+		return NULL;
+	}
+
+	return subset;
+}
+
+/* findWsdsWithVarRng
+ *
+ * Find the wsds of a set that contain the mapping var->rng of the given range
+ * entry; all these mappings are *temporarily* dropped. Return NULL if there is
+ * no such wsd. If a wsd is left without mappings, the probability of the wsds
+ * agreeing with var->rng is just that of the mapping: the mappings are 
+ * restored at once and an empty set is returned.
+ *
+ * Otherwise the dropped mappings are recorded on the drop stack, and must be 
+ * restored with resetWsdsWithVarRng() before any mapping dropped earlier. 
+ * Only these mappings are restored, so the mappings dropped by the outer 
+ * levels of the recursion stay dropped.
+ */
+bitset *
+findWsdsWithVarRng(bitset *set, rngEntry *rng_entry, generalState *s)
+{
+	clauseStore *S = s->clauses;
+	bitset *subset = NULL;
+	int found_empty_wsd = 0;
+	int base = s->drop_top;
+	int i;
+
+	/* A mapping is on the stack at most once, and every frame drops one */
+	if (s->drop_stack == NULL)
+		s->drop_stack = (int *) palloc(2 * s->num_wsds * s->wsd_len * sizeof(int));
+
+	for (i = 0; i < rng_entry->clause_entry_count; i++)
+	{
+		int clause = ( rng_entry->clause_entries + i )->clause;
+		int m = MAP( s, clause, ( rng_entry->clause_entries + i )->column );
+
+		/* Stop once a clause is exhausted, but only after all its mappings are dropped */
+		if (found_empty_wsd && !bitset_test_bit(subset, clause))
+			break;
+
+		if (bitset_test_bit(set, clause) && S->rng[m] == rng_entry->rng)
+		{
+			if (subset == NULL)
+			{
+				subset = allocBitset(s);
+				bitset_reset(subset);
+			}
+
+			bitset_set_bit(subset, clause);
+
+			S->rng[m] = -1;
+			S->prob[clause] /= S->map_prob[m];
+			s->drop_stack[s->drop_top++] = m;
+
+			if (S->prob[clause] == 1.0)
+				found_empty_wsd = 1;
+		}
+	}
+
+	if (subset == NULL)
+		return NULL;
+
+	/* The number of mappings dropped closes the frame */
+	s->drop_stack[s->drop_top] = s->drop_top - base;
+	s->drop_top++;
+
+	if (found_empty_wsd)
+	{
+		resetWsdsWithVarRng(s);
+		bitset_reset(subset);
+	}
+
+	return subset;
+}
+
+/* resetWsdsWithVarRng
+ *
+ * Restore the mappings dropped by the last call of findWsdsWithVarRng() that
+ * has not been reset yet.
+ */
+void
+resetWsdsWithVarRng(generalState *s)
+{
+	clauseStore *S = s->clauses;
+	int n = s->drop_stack[--s->drop_top];
+
+	while (n-- > 0)
+	{
+		int m = s->drop_stack[--s->drop_top];
+		int clause = m / s->wsd_len;
+
+		S->rng[m] = RNG_ENTRY(s, m)->rng;
+		S->prob[clause] *= S->map_prob[m];
+	}
+}
+
+/* allocBitset
+ *
+ * Allocate a bitset over all clauses. The bitsets freed with freeBitset()
+ * are reused, so the recursion of the confidence computation does not need
+ * to allocate memory once it has reached its maximal depth.
+ */
+bitset *
+allocBitset(generalState *s)
+{
+	if (s->bitset_pool == NULL)
+		s->bitset_pool = bitset_pool_init(s->num_wsds);
+
+	return bitset_pool_get(s->bitset_pool);
+}
+
+/* freeBitset
+ *
+ * Return a bitset allocated with allocBitset() for reuse.
+ */
+void
+freeBitset(generalState *s, bitset *set)
+{
+	bitset_pool_put(s->bitset_pool, set);
+}
 
 /* updateWorldTable
  *
- * Insert a map to the local world table.
+ * Insert the map at position m of the lineage to the local world table.
  */
 void 
-updateWorldTable(generalState *s, Map *map)
+updateWorldTable(generalState *s, int m)
 {
-	int index = HASHFUNC(map->var, s->mask);
+	clauseStore *S = s->clauses;
+	varType var = S->var[m];
+	int index = HASHFUNC(var, s->mask);
 	worldTableEntry *wt_entry;
 	rngEntry *rng_entry;
 	int i, wt_entry_index;
@@ -201,37 +1066,37 @@ updateWorldTable(generalState *s, Map *map)
 	if (s->HT[index] == NULL)
 	{
 		/* Create a new entry for the variable */        
-		wt_entry_index = wtEntryInit( map->var, s );
+		wt_entry_index = wtEntryInit( var, s );
 		
 		/* Create a list and add the entry */
 		create_bucket(s, index);
 		
-		mlappend(s->HT[index], map->var, wt_entry_index);
+		mlappend(s->HT[index], var, wt_entry_index);
 	}
 	/* If there exists a list for the hash table entry, find a match in the list 
 	 * or create an entry in the list.
 	 */
 	else
 	{     
-		wt_entry_index = search(s->HT[index], map->var);
+		wt_entry_index = search(s->HT[index], var);
 
 		/* If a match is not found, create an entry for the variable */
 		if (wt_entry_index == KEY_NOT_FOUND)
 		{ 
-			wt_entry_index = wtEntryInit(map->var, s);
+			wt_entry_index = wtEntryInit(var, s);
 			
-			/* NOTES: We can not use index instead of HASHFUNC(map->var, s->mask) 
+			/* NOTES: We can not use index instead of HASHFUNC(var, s->mask) 
 			 * because index is static and may be invalid after the table is expanded
 			 */
-			while (BUCKETISFULL(s->HT[HASHFUNC(map->var, s->mask)]))
+			while (BUCKETISFULL(s->HT[HASHFUNC(var, s->mask)]))
 			{	
-				if (s->HT[HASHFUNC(map->var, s->mask)]->nbits == s->nbits)
+				if (s->HT[HASHFUNC(var, s->mask)]->nbits == s->nbits)
 					expand_hashtable(s);
 				
-				distribute_elements(s, map->var, HASHFUNC(map->var, s->mask));
+				distribute_elements(s, var, HASHFUNC(var, s->mask));
 			}
 			
-			mlappend(s->HT[HASHFUNC(map->var, s->mask)], map->var, wt_entry_index);
+			mlappend(s->HT[HASHFUNC(var, s->mask)], var, wt_entry_index);
 		}
 	}
 	
@@ -239,23 +1104,23 @@ updateWorldTable(generalState *s, Map *map)
 	wt_entry = s->wt_entries + wt_entry_index;  	
 
 	/* Set the world table entry in the clause */
-	map->wt_offset = wt_entry_index;
+	S->wt_index[m] = wt_entry_index;
 
 	/* Step 2: Find the entry for the range value in the local world table entry */
 	for(i = 0; i < wt_entry->rng_entry_count; i++)
 	{
 		rng_entry = wt_entry->rng_entries + i;
 		
-		if (rng_entry->rng == map->rng)
+		if (rng_entry->rng == S->rng[m])
 		{
 			/* Set the index of the range entry */
-			map->rng_offset = i;
+			S->rng_index[m] = i;
 			return;
 		}
 	}
 	
 	/* Set the index of the range entry after initializing a new one */
-	map->rng_offset = rngEntryInit(map->rng, map->prob, wt_entry);
+	S->rng_index[m] = rngEntryInit(S->rng[m], S->map_prob[m], wt_entry);
 }
 
 /* rngEntryInit
@@ -270,6 +1135,9 @@ rngEntryInit( rngType rng, prob p, worldTableEntry *wt_entry )
 	rngEntry *rng_entry = wt_entry->rng_entries + wt_entry->rng_entry_count; 
 	rng_entry->p = p;
 	rng_entry->rng = rng;
+	rng_entry->clause_entries = NULL;
+	rng_entry->clause_entry_max = 0;
+	rng_entry->clause_entry_count = 0;
 	
 	/* Increase the counter for world table entry */
 	wt_entry->rng_entry_count++;
@@ -303,6 +1171,7 @@ wtEntryInit(varType v, generalState *s)
 	wt_entry->rng_entries = ( rngEntry * ) palloc0( RNGENTRYSIZE * sizeof( rngEntry ) );
 	wt_entry->rng_entry_count = 0;
 	wt_entry->rng_entry_max = RNGENTRYSIZE;
+	wt_entry->visited = 0;
 	
 	/* Increase the counter in the local world table */
 	s->wt_entry_count++;
@@ -321,14 +1190,25 @@ wtEntryInit(varType v, generalState *s)
 
 /* genStateInit
  *
- * Initialize the state structure.
+ * Initialize the state structure for clauses of n mappings.
  */
 void 
-genStateInit(generalState *state)
+genStateInit(generalState *state, int n)
 {
-	NUM_WSDS = 0;
-	current_size = 100;
-	S = ( WSD ** ) palloc0(current_size * sizeof(WSD *));
+	clauseStore *S;
+
+	state->num_wsds = 0;
+	state->wsd_len = n;
+	state->wsd_max = 100;
+
+	S = ( clauseStore * ) palloc( sizeof( clauseStore ) );
+	S->var = ( varType * ) palloc( state->wsd_max * n * sizeof( varType ) );
+	S->rng = ( rngType * ) palloc( state->wsd_max * n * sizeof( rngType ) );
+	S->map_prob = ( prob * ) palloc( state->wsd_max * n * sizeof( prob ) );
+	S->wt_index = ( int * ) palloc( state->wsd_max * n * sizeof( int ) );
+	S->rng_index = ( int * ) palloc( state->wsd_max * n * sizeof( int ) );
+	S->prob = ( prob * ) palloc( state->wsd_max * sizeof( prob ) );
+	state->clauses = S;
 
 	state->nbits = INIT_NBITS;
 	state->mask = GETMASK(INIT_NBITS);
@@ -337,6 +1217,13 @@ genStateInit(generalState *state)
 	state->wt_entries = ( worldTableEntry * ) palloc0( WTINITSIZE * sizeof( worldTableEntry ) );
 	state->wt_entry_max = WTINITSIZE;
 	state->wt_entry_count = 0;
+
+	state->visit_stamp = 0;
+	state->clause_stack = NULL;
+	state->drop_stack = NULL;
+	state->drop_top = 0;
+	state->comp_cache = NULL;
+	state->bitset_pool = NULL;
 }
 
 /* resetCount
@@ -393,8 +1280,9 @@ printState( generalState *state )
  * Print all world set descriptors with a bitset.
  */
 void 
-printWSD(bitset* set)
+printWSD(bitset* set, generalState *state)
 {
+	clauseStore *S = state->clauses;
 	int i, j;
 	myLog("Print WSDs:\n");
 
@@ -403,18 +1291,18 @@ printWSD(bitset* set)
 		return;
 	}
 
-	for ( i = 0; i < NUM_WSDS; i++)
+	for ( i = 0; i < state->num_wsds; i++)
 	{	
 		if (bitset_test_bit(set, i)) 
 		{
-			for ( j = 0; j < WSD_LEN; j++)
+			for ( j = 0; j < state->wsd_len; j++)
 			{
-				myLogi( S[i]->data[j]->var ); 
-				myLogi( S[i]->data[j]->rng );
-				myLogf( S[i]->data[j]->prob ); 
+				myLogi( S->var[ MAP( state, i, j ) ] ); 
+				myLogi( S->rng[ MAP( state, i, j ) ] );
+				myLogf( S->map_prob[ MAP( state, i, j ) ] ); 
 				myLog("\t");
 			}
-			myLog("prob");  myLogf( S[i]->prob ); nl(1);
+			myLog("prob");  myLogf( S->prob[i] ); nl(1);
 		}
 	}
 	
@@ -427,22 +1315,23 @@ printWSD(bitset* set)
  */
 
 void 
-printWSD2(int a)
+printWSD2(generalState *state)
 {
+	clauseStore *S = state->clauses;
 	int i, j;
 	myLog("Print WSDs:\n");
 
-	for ( i = 0; i < NUM_WSDS; i++)
+	for ( i = 0; i < state->num_wsds; i++)
 	{	
-		for ( j = 0; j < WSD_LEN; j++)
+		for ( j = 0; j < state->wsd_len; j++)
 		{
-			myLogi( S[i]->data[j]->var ); 
-			myLogi( S[i]->data[j]->rng );
-			myLogf( S[i]->data[j]->prob ); 
+			myLogi( S->var[ MAP( state, i, j ) ] ); 
+			myLogi( S->rng[ MAP( state, i, j ) ] );
+			myLogf( S->map_prob[ MAP( state, i, j ) ] ); 
 			myLog("\t");
 		}
 		
-		myLog("prob");  myLogf( S[i]->prob ); nl(1);
+		myLog("prob");  myLogf( S->prob[i] ); nl(1);
 	}
 	
 	nl(1);
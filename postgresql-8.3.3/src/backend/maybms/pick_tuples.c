@@ -57,7 +57,7 @@
  * The rewriting is 
  *       select 
  *			a, c, 
- *			nextval('varid') as _v0, 
+ *			nextid('varid') as _v0, 
  *			1 as _d0, 
  *			test_from_0_to_1(R.p+S.p) as _p0
  *		 from 
@@ -119,7 +119,7 @@ rewrite_pick_tuples(SelectStmt *sel)
 {
 	/* Add variable ID to the target list */
 	sel->targetList = lappend(sel->targetList,
-		type_cast_to_int4(make_ResTarget_with_func_char(catStrInt(VARNAME, 0), "nextval", VARIDSEQ)));
+		type_cast_to_int4(make_ResTarget_with_func_char(catStrInt(VARNAME, 0), NEXTID, VARIDSEQ)));
 	
 	sel->targetList = lappend(sel->targetList, 
 		make_ResTarget_with_int(catStrInt(DOMAINNAME, 0), 1));
@@ -9,28 +9,30 @@
  *-------------------------------------------------------------------------
  */
  
-/* Repair-key is done purely by rewriting queries. Right now, the operation is 
- * compressed in only one query. 
+/* Repair-key is done by rewriting queries and a dedicated plan node. The
+ * rewriting produces only one query, which reads the input once.
  *
  * We consider the general situation in which the input is a bag in which the 
- * same tuple occurs several times. The rewriting will be much simpler in case 
- * the input is a set.
+ * same tuple occurs several times. The duplicates of a tuple with the same
+ * weight are the same alternative, i.e., they share its domain value and its
+ * weight counts only once. Copies of a tuple with different weights are
+ * separate alternatives.
  * 
- * Logically, we separate repair-key into the following 4 steps:   
+ * Logically, we separate repair-key into the following 3 steps:   
  *
- * (1)Eliminate the duplicates in the input relation or result of a select statement
- *    and calculate the corresponding weight of every tuple.
- * (2)On top of the result of (1), assign a domain value to every tuple.
- *    Note that we do NOT perform this in every group of tuples sharing the 
- *    same key because it is not feasible only via query rewriting. As a result, domain
- *    values are unique in the whole database, which satisfies the requirement that they
- *    are unique in every disjoint block. 
- * (3)On top of the result of (1), sum up the weights of every group of tuples 
- *    sharing the same key and assign a variable value to this group. This can be easily 
- *    achieved using aggregate function SUM. Note that, the results may be wrong without
- *    duplicate elimination performed first.
- * (4)Do a join on the input,results of (2) and (3) and calculate the weight of 
- *    a tuple by dividing the original weight by the sum in (2). 
+ * (1)Sort the input relation or result of a select statement on the key, and
+ *    within a key on all other columns and the weight, so that the tuples
+ *    sharing the same key form a block and the duplicates of a tuple follow it.
+ * (2)For every block, assign a domain value to every distinct tuple and sum up
+ *    the weights of the distinct tuples. Note that domain values are unique in
+ *    the whole database, which satisfies the requirement that they are unique
+ *    in every disjoint block. 
+ * (3)Assign a variable value to the block, and calculate the probability of a
+ *    tuple by dividing its weight by the sum in (2). 
+ *
+ * Step (1) is done by the rewriting and steps (2) and (3) by the REPAIRKEY plan
+ * node (executor/nodeRepairKey.c), which keeps the tuples of the current block
+ * in a tuplestore, so that huge blocks spill to disk.
  *
  * In addition to what is described above, the issue of non-positive weight 
  * values should also be taken into account. Right now, all tuples with weight 
@@ -42,43 +44,43 @@
  *
  * The current implementation generates a query tree representing the following query:
  *
- *  SELECT target-list, _V, _D, _W / _S as _P FROM
- *   input 
- *   NATURAL JOIN
- *   ( SELECT key, SUM(_W) as _S, nextval('varid') as _V 
-       FROM duplicate-elimination AS temp GROUP BY key ) AS var
- *   NATURAL JOIN 
- *   ( SELECT *, nextval('domid') as _D, _W 
-       FROM duplicate-elimination as temp ) AS domain;
+ *  SELECT target-list, 0 AS _V, 0 AS _D,
+ *         test_nagative( cast( weight-expression as real ) ) AS _P 
+ *  FROM input WHERE weight-expression <> 0 ORDER BY keys, target-list, _P;
  *
- *  where input is (SELECT target-list FROM ...) and duplicate-elimination is
- *  SELECT DISTINCT target-list, test_nagative( cast( weight-expression as real ) ) AS _W 
- *  FROM input WHERE weight-expression <> 0.
+ *  where input is (SELECT target-list FROM ...), and the select records the 
+ *  number of keys, which makes the planner put the REPAIRKEY node on top of it. 
+ *  _V and _D are placeholders for the variable and domain values, and _P holds
+ *  the weight until the node replaces it by the probability.
  *
- *  There are several points worth noticing in duplicate-elimination:
+ *  There are several points worth noticing:
  *  (1) The type casting of the weight-expression to a real is necessary because
- *      if both _W and _S are integers, _W / _S is also an integer. This will cause
- *      the bugs like 1 / 3 = 0. 
+ *      _P has the type of a probability. 
  *  (2) test_nagative is a scalar function that issues an error message if the 
  *      input is a negative, otherwise return the input. In postgres, an error 
  *      message stops the whole query so repair-key will not continue.
  *  (3) When weight-expression is missing, we assign a weight 1 to every 
  *      distinct tuple.
- *  (4) Tuples with weight as 0 are filtered in duplicate-elimination. 
+ *  (4) Tuples with weight as 0 are filtered. 
+ *  (5) With PARTITION i OF n, the where clause also keeps only the keys whose
+ *      hash falls into the i-th of n partitions. n sessions can run the n
+ *      partitions at the same time, one creating the table and the others
+ *      inserting into it. Their blocks are disjoint, and nextid() gives each
+ *      session its own IDs.
  *
  *  In this approach, as the database is initialized, two sequences varid and 
  *  domid are created, which are used to generate variable and domain IDs in 
- *  the rewriting. They both begin from 1. Variable 0 is a reserved variable
+ *  the REPAIRKEY node. They both begin from 1. Variable 0 is a reserved variable
  *  with binary distribution 0 and 1 whose probability is 0 and 1 respectively. 
+ *  The IDs are taken with nextid(), which is nextval() with the values reserved
+ *  in blocks per backend, so that they do not take the lock of the sequence for
+ *  every tuple.
  *
- *  One drawback of the above-mentioned implementation is that some tasks are
- *  performed several times because PostgreSQL can not identify the same sub-query
- *  and execute them more than once. For example, duplicate-elimination are 
- *  included twice and according to the query plans of repair-key, it is actually 
- *  executed twice in the plan. A possible approach is to dump the temporary 
- *  results to the disc. This is especially efficient should the input query of 
- *  repair-key is extremely huge.
- *
+ *  An earlier implementation did the same purely by rewriting, with a join of
+ *  the input, a duplicate elimination assigning the domain values and a
+ *  GROUP BY on the duplicate elimination summing up the weights. PostgreSQL
+ *  could not identify the same sub-query, so the duplicate elimination was
+ *  executed twice and joined back to the input.
  */
  
 #include "postgres.h"
@@ -101,16 +103,13 @@
 
 /* Local functions */
 
-static A_Expr *make_division_expr(char *dividend, char *divisor);
 static List *get_repair_key_target_list(SelectStmt *sel);
 static List *target_list_to_ColumnRef(List *target_list);
-static Node *make_natural_join(Node *table1, Node *table2);
-static ResTarget *make_ResTarget_with_AExpr(char *resname, A_Expr *expr);
-static ResTarget *make_ResTarget_with_Func_ColumnRef(char *resname, char *funcname, char *columnname);
+static List *make_repair_key_sort_clause(List *keys, List *targetList);
+static Node *make_repair_key_partition_clause(List *keys, int partition,
+											  int npartitions);
+static A_Const *make_int_const(int value);
 static SelectStmt *rewrite_repair_key(SelectStmt *sel);
-static SelectStmt *assign_domain_ID(SelectStmt *sel, List *targetList, List *distinctClause);
-static SelectStmt *assign_var_ID(SelectStmt *sel, List *targetList, List *distinctClause, List *keys);
-static SelectStmt *duplicate_removal(SelectStmt *sel, List *targetList, List *distinctClause);
 
 /* #define TEST */
 
@@ -161,17 +160,16 @@ ProcessRepairKey(SelectStmt *sel)
 static SelectStmt *
 rewrite_repair_key(SelectStmt *sel)
 {
-	List *distinctClause;
-	List *keys = sel->repairkey;
-	RangeSubselect *sub1, *sub2, *sub3;
 	SelectStmt *new = makeNode(SelectStmt);
-	Node *join;
+	ResTarget *weight;
 
 	/* The output of repair-key have all targets in the input  */
 	new->targetList = get_repair_key_target_list(sel);
 	
-	/* The distinct clause is used in the duplicate elimination.  */
-	distinctClause = target_list_to_ColumnRef(new->targetList);
+	/* Sort on the key and then on all targets, for the REPAIRKEY node. The
+	 * distinct keys lead the sort clause. */
+	new->sortClause = make_repair_key_sort_clause(sel->repairkey, new->targetList);
+	new->repairKeyCols = list_length(new->sortClause) - list_length(new->targetList);
 	
 	/* Move the into clause to the output select.  */
 	new->intoClause = sel->intoClause;
@@ -179,178 +177,157 @@ rewrite_repair_key(SelectStmt *sel)
 	/* Set the into clause of the input query to NULL */
 	sel->intoClause = NULL;
 
-	/* Set the from clause of the output */
-	sub1 = makeRangeSubselect("temp1", sel);
-	sub2 = makeRangeSubselect("temp2", assign_domain_ID(sel, new->targetList, distinctClause));
-	sub3 = makeRangeSubselect("temp3", assign_var_ID(sel, new->targetList, distinctClause, keys));
-	
-	join = make_natural_join(make_natural_join((Node *) sub1, (Node *) sub2), (Node *) sub3);
-
-	new->fromClause = lappend(new->fromClause, join);
-
-	/* Add variable ID to the target list */
+	/* Add placeholders of variable ID and domain ID to the target list */
 	new->targetList = lappend(new->targetList,
-		type_cast_to_int4(makeResTargetWithColumnRef(NULL, catStrInt(VARNAME, 0))));
+		type_cast_to_int4(make_ResTarget_with_int(catStrInt(VARNAME, 0), 0)));
 	
-	/* Add domain ID to the target list */
 	new->targetList = lappend(new->targetList,
-		type_cast_to_int4(makeResTargetWithColumnRef(NULL, catStrInt(DOMAINNAME, 0))));
-	
-	/* Add _W / _S to the target list */
-	new->targetList =
-		lappend(new->targetList,
-				type_cast_weight_by(make_ResTarget_with_AExpr(catStrInt(PROBNAME, 0), 
-				make_division_expr("_W", "_S") )));
+		type_cast_to_int4(make_ResTarget_with_int(catStrInt(DOMAINNAME, 0), 0)));
 
-	#ifdef TEST
-		myLog("********************rewriteRepairKey\n");
-		myLog( pretty_format_node_dump(nodeToString(new)));
-	#endif
+	/* Add the weight to the target list */
+	if(sel->weightby != NULL)
+	{
+		A_Const *con = (A_Const *) makeNode(A_Const);
+		FuncCall *func = makeNode(FuncCall);
 
-	return new;
-}
+		/* Make a constant 0 */
+		con->val.type = T_Float;
+		con->val.val.str = "0";
 
-/* assign_domain_ID
- *
- *  This generates a query that assigns domain IDs to each distinct tuple.
- *  The output of the function is like the following:
- *
- *	SELECT *, nextval('domid') as _D, _W FROM duplicate-elimination;
- */
-static SelectStmt *
-assign_domain_ID(SelectStmt *sel, List *targetList, List *distinctClause)
-{
-	/* Get the results of duplicate-elimination */
-	SelectStmt *new = (SelectStmt *) duplicate_removal(sel, targetList, distinctClause);
+		/* Add the constraint that the weight is not 0 */
+		new->whereClause = 
+			(Node *) makeA_Expr(AEXPR_OP, list_make1(makeString("<>")), 
+								copyObject(sel->weightby->val), (Node *) con, 0);
+
+		/* Put the cast value in the test function */
+		weight = type_cast_weight_by(sel->weightby);
+		func->funcname = list_make1(makeString(TESTNEGATIVE));
+		func->args = list_make1(weight->val);
+		weight->val = (Node *) func;
+	}
+	else
+		weight = type_cast_weight_by(make_ResTarget_with_float(NULL, "1.0"));
+
+	/* Keep only the keys of the partition to be repaired */
+	if (sel->npartitions > 0)
+	{
+		Node *clause = make_repair_key_partition_clause(sel->repairkey,
+									sel->partition, sel->npartitions);
+
+		if (new->whereClause == NULL)
+			new->whereClause = clause;
+		else
+			new->whereClause = 
+				(Node *) makeA_Expr(AEXPR_AND, NULL, new->whereClause, clause, 0);
+	}
+
+	weight->name = catStrInt(PROBNAME, 0);
+	new->targetList = lappend(new->targetList, weight);
+
+	/* Sort on the weight last, so that the REPAIRKEY node sees the copies of a
+	 * tuple with different weights as different tuples */
+	{
+		SortBy *sortby = makeNode(SortBy);
+		ColumnRef *cref = makeNode(ColumnRef);
 
-	/* Add the domain ID to the target list */
-	new->targetList =
-		lappend(new->targetList, make_ResTarget_with_func_char(catStrInt(DOMAINNAME, 0), "nextval", DOMAINIDSEQ));
+		cref->fields = list_make1(makeString(weight->name));
+		sortby->node = (Node *) cref;
+		new->sortClause = lappend(new->sortClause, sortby);
+	}
+
+	new->fromClause = lappend(new->fromClause, makeRangeSubselect("temp", sel));
 
 	#ifdef TEST
-		myLog("********************assignDomainID\n");
+		myLog("********************rewriteRepairKey\n");
 		myLog( pretty_format_node_dump(nodeToString(new)));
 	#endif
 
 	return new;
 }
 
-/* assign_var_ID
+/* make_repair_key_sort_clause
  *
- *  This generates a query that assign variable ID to each distinct tuples on 
- *  key values.
- *  The output is a query tree representing a query like the following:
- *
- *	   SELECT keys, SUM(_W) as _S, nextval('varid') as _V 
- *     FROM duplicate-elimination GROUP BY keys
+ * Return the sort clause of the keys followed by all targets. Duplicate keys
+ * are removed, because the number of keys must match the sort clause after
+ * parse analysis.
  */
-static SelectStmt *
-assign_var_ID(SelectStmt *sel, List *targetList, List *distinctClause, List *keys)
+static List *
+make_repair_key_sort_clause(List *keys, List *targetList)
 {
-	SelectStmt *new = (SelectStmt *) makeNode(SelectStmt);
-	SelectStmt *sub = duplicate_removal(sel, targetList, distinctClause);
+	ListCell *cell;
+	List *exprs = NIL;
+	List *result = NIL;
 
-	/* Add the key to the target list */
-	new->targetList = list_copy(keys);
-	
-	/* Add variable ID to the target list */
-	new->targetList = lappend(new->targetList,
-				make_ResTarget_with_func_char(catStrInt(VARNAME, 0), "nextval", VARIDSEQ));
-				
-	/* Add aggregate function SUM to the target list */
-	new->targetList = lappend(new->targetList,
-				make_ResTarget_with_Func_ColumnRef("_S", "sum", "_W"));
+	/* Collect the distinct keys */
+	foreach(cell, keys)
+	{
+		Node *expr = ((ResTarget *) lfirst(cell))->val;
 
-	/* Add duplicate-elimination to the from clause */
-	new->fromClause = lappend(new->fromClause, makeRangeSubselect("temp", sub));
+		if (!list_member(exprs, expr))
+			exprs = lappend(exprs, expr);
+	}
 
-	/* Add the key to the group clause */
-	new->groupClause = target_list_to_ColumnRef(keys);
-	
-	/* NOTE: This is necessary otherwise the results are sometimes wrong.  */
-	new->distinctClause = list_make1(NIL);
+	/* Append all targets */
+	exprs = list_concat(exprs, target_list_to_ColumnRef(targetList));
 
-	#ifdef TEST
-		myLog("********************assignVarID\n");
-		myLog( pretty_format_node_dump(nodeToString(new)));
-	#endif
+	foreach(cell, exprs)
+	{
+		SortBy *sortby = makeNode(SortBy);
+		sortby->node = copyObject(lfirst(cell));
 
-	return new;
+		result = lappend(result, sortby);
+	}
+
+	return result;
 }
 
-/*  duplicate_removal
- * 
- *  This generates a query that removes the duplicates from input select statement.
- *  The output is a query tree representing a query like the following:
- * 
- *  SELECT DISTINCT target-list, test_nagative( cast( weight-expression as real ) ) AS _W 
- *  FROM input WHERE weight-expression <> 0.
+/* make_repair_key_partition_clause
+ *
+ * Return the condition that the hash of the keys falls into the given one of
+ * npartitions partitions, counted from 1:
+ *
+ *   (keyhash(...keyhash(0, key1)..., keyn) & 2147483647) % npartitions
+ *      = partition - 1
+ *
+ * keyhash() hashes with the hash function of the equality of the type, so all
+ * tuples of a block fall into the same partition.
  */
-static SelectStmt *
-duplicate_removal(SelectStmt *sel, List *targetList, List *distinctClause)
+static Node *
+make_repair_key_partition_clause(List *keys, int partition, int npartitions)
 {
-	SelectStmt *new = (SelectStmt *) makeNode(SelectStmt);
-	A_Const *con = (A_Const *) makeNode(A_Const);
-	
-	/* Set the target list */
-	new->targetList = list_copy(targetList);
-	
-	new->groupClause = list_copy(distinctClause);
-	
-	/* Add keyword DISTINCT */
-	new->distinctClause = list_make1(NIL);
-	
-	/* Add keyword DISTINCT */
-	new->fromClause = lappend(new->fromClause, makeRangeSubselect("temp", sel));
-	
-	/* Make a constant 0 */
-	con->val.type = T_Float;
-	con->val.val.str = "0";
+	ListCell *cell;
+	Node *hash = (Node *) make_int_const(0);
 
-	if(sel->weightby != NULL)
+	foreach(cell, keys)
 	{
-		/* Put the cast value in the test function */
-		ResTarget 	*res = type_cast_weight_by(sel->weightby);
-		FuncCall	*func = makeNode(FuncCall);
-		func->funcname = list_make1(makeString(TESTNEGATIVE));
-		func->args = list_make1(res->val);
-		res->val = (Node *) func;
-		
-		new->targetList = lappend(new->targetList, res);
-		
-		/* Add the constraint that the weight is not 0 */
-		new->whereClause = 
-			(Node *) makeA_Expr(AEXPR_OP, list_make1(makeString("<>")), 
-								sel->weightby->val, (Node *) con, 0);
+		FuncCall *func = makeNode(FuncCall);
+
+		func->funcname = list_make1(makeString(KEYHASH));
+		func->args = list_make2(hash, copyObject(((ResTarget *) lfirst(cell))->val));
+		hash = (Node *) func;
 	}
-	else
-		new->targetList = lappend(new->targetList, make_ResTarget_with_float("_W",
-				"1.0"));
 
-	#ifdef TEST
-		myLog("********************duplicate removal\n");
-		myLog( pretty_format_node_dump(nodeToString(new)));
-		myLog("********************duplicate removal sel\n");
-		myLog( pretty_format_node_dump(nodeToString(sel)));
-	#endif
+	hash = (Node *) makeA_Expr(AEXPR_OP, list_make1(makeString("&")), 
+							   hash, (Node *) make_int_const(0x7FFFFFFF), 0);
+	hash = (Node *) makeA_Expr(AEXPR_OP, list_make1(makeString("%")), 
+							   hash, (Node *) make_int_const(npartitions), 0);
 
-	return new;
+	return (Node *) makeA_Expr(AEXPR_OP, list_make1(makeString("=")), 
+							   hash, (Node *) make_int_const(partition - 1), 0);
 }
 
-/* make_natural_join
+/* make_int_const
  *
- * Return a natural join with two nodes.
+ * Make an integer constant.
  */
-static Node *
-make_natural_join(Node *table1, Node *table2)
+static A_Const *
+make_int_const(int value)
 {
-	JoinExpr *join = (JoinExpr *) makeNode(JoinExpr);
-	join->jointype = 0;
-	join->isNatural = true;
-	join->larg = table1;
-	join->rarg = table2;
+	A_Const *con = (A_Const *) makeNode(A_Const);
+
+	con->val = *(makeInteger(value));
 
-	return (Node *) join;
+	return con;
 }
 
 /* get_repair_key_target_list
@@ -421,54 +398,3 @@ target_list_to_ColumnRef(List *target_list)
 
 	return result;
 }
-
-
-/* make_division_expr
- * 
- * Make a division expression.
- */
-static A_Expr *
-make_division_expr(char *dividend, char *divisor)
-{
-	ColumnRef *cref1 = makeNode(ColumnRef);
-	ColumnRef *cref2 = makeNode(ColumnRef);
-
-	cref1->fields = list_make1(makeString(dividend));
-	cref2->fields = list_make1(makeString(divisor));
-
-	return makeSimpleA_Expr(AEXPR_OP, "/", (Node *) cref1, (Node *) cref2, 0);
-}
-
-/* make_ResTarget_with_Func_ColumnRef
- *
- * Make a ResTarget with a FuncCall name and a Column name.
- */
-static ResTarget *
-make_ResTarget_with_Func_ColumnRef(char *resname, char *funcname, char *columnname)
-{
-	ResTarget *res = (ResTarget *) makeNode(ResTarget);
-	FuncCall *func = (FuncCall *) makeNode(FuncCall);
-	ColumnRef *cref = (ColumnRef *) makeNode(ColumnRef);
-
-	cref->fields = list_make1(makeString(columnname));
-	func->funcname = list_make1(makeString(funcname));
-	func->args = list_make1(cref);
-	res->val = (Node *) func;
-	res->name = resname;
-
-	return res;
-}
-
-/* make_ResTarget_with_AExpr
- *
- * Make a ResTarget with an expression.
- */
-static ResTarget *
-make_ResTarget_with_AExpr(char *resname, A_Expr *expr)
-{
-	ResTarget *res = (ResTarget *) makeNode(ResTarget);
-	res->val = (Node *) expr;
-	res->name = resname;
-
-	return res;
-}
@@ -44,9 +44,9 @@
  * rewriting for conf and aconf is much more complicated. For hierarchical
  * conjunctive query without self-join, conf is handled by operator HQ, whose
  * rewriting requires sorting on data and variable columns. Otherwise, conf and 
- * aconf are treated in the same way by sorting on data columns. The sorting is 
- * not necessary for correct confidence computation but leads to less memory 
- * consumption. Search function generalRewrite() for more details.   
+ * aconf are treated in the same way by feeding them with the condition columns
+ * and leaving the grouping strategy to the planner. Search function 
+ * generalRewrite() for more details.   
  *
  * 6. The next step is the rewriting of repair-key and pick-tuples, which must
  * be placed after the rewriting of confidence computation functions whose 
@@ -72,6 +72,8 @@
 #include "maybms/rewrite.h"
 #include "maybms/rewrite_updates.h"
 #include "maybms/supported.h"
+#include "maybms/urelinfo.h"
+#include "maybms/wsd.h"
 #include "utils/fmgroids.h"
 #include "utils/array.h"
 #include "utils/syscache.h"
@@ -94,10 +96,11 @@ static void put_args_to_tconf_independent(char typeArray[], List *fields, FuncCa
 /* Functions related to rewriting of confidence computation operators. */
 static void put_args_general(FuncCall *func, int n);
 static void put_args_HQ(FuncCall *func, int n);
+static Node *makeArrayArg(List *elements);
 static void HQ_rewriting(SelectStmt *sel, List *varOrder, FuncCall *func);
 static List *newResTargets(List *varOrder, char *name);
-static List *put_args_to_conf_general(char typeArray[], int tripleCount[], 
-	List *fields, char *name);
+static ResTarget *put_wsd_to_conf_general(char typeArray[], int tripleCount[],
+	List *fields);
 static void generalRewrite(SelectStmt *sel, char typeArray[], int tripleCount[], 
 	List *fields, FuncCall *func);
 
@@ -137,11 +140,13 @@ static bool is_a_general_case(List *flist, char typeArray[]);
 static bool has_inequalities(A_Expr *node);
 
 /* Functions related to rewriting. */
+static Node *makeConditionPairs(List *rel, int triples);
 static void remove_mutual_exclusiveness(SelectStmt *sel, char typeArray[], 
 	int tripleCount[], List *fields);
 static SelectStmt *add_condition_columns(SelectStmt *sel, char typeArray[],
 	int tripleCount[], List *fields, bool **isFromRepairKey);
 static List *get_sort_clause(List *targetList);
+static void sort_groups(SelectStmt *sel);
 	
 /* process
  *
@@ -151,6 +156,8 @@ Node *
 process(Node *parsetree)
 {
 	char *error = NULL;
+	SignatureState *sig = currentSignature;
+	SelectStmt *select;
 
 	/* Test code */
 	#ifdef TEST
@@ -177,8 +184,14 @@ process(Node *parsetree)
 	switch (nodeTag(parsetree))
 	{
 		case T_SelectStmt:
-			return (Node *) process_select((SelectStmt *) parsetree);
-			break;
+			select = process_select((SelectStmt *) parsetree);
+
+			/* Keep the signature of a hierarchical conf() in the query or
+			 * one of its subqueries with the query. */
+			if (currentSignature != sig)
+				select->signature = currentSignature;
+
+			return (Node *) select;
 		case T_InsertStmt:
 			return (Node *) processInsert((InsertStmt *) parsetree);
 		case T_UpdateStmt:
@@ -247,6 +260,7 @@ process_select(SelectStmt *sel)
 	sgList 			*sglist;
 	FuncCall 		*conf = NULL, *tconf = NULL, *aconf = NULL, *esum, *ecount;
 	SelectStmt 		*result = sel;
+	SignatureState	*sig;
 	MemoryContext 	oldcxt;
 
 	/* Test code */
@@ -356,15 +370,12 @@ process_select(SelectStmt *sel)
 				goto repairkey;
 			}
 
-			/* Initialize the signature context if it is NULL  */
-			if(signaturecxt == NULL)
-			{
-				signaturecxt = AllocSetContextCreate(NULL, "SignatureContext", ALLOCSET_DEFAULT_MINSIZE,
-						ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);
-			}
+			/* Each query gets its own signature, which the plans cached for 
+			 * the query keep. */
+			sig = NewSignature();
 
 			/* Context switch should be done before the subgoal list generation */
-			oldcxt = MemoryContextSwitchTo(signaturecxt);
+			oldcxt = MemoryContextSwitchTo(sig->context);
 
 			sglist = geneSGList((A_Expr *) result->whereClause, NULL, result->fromClause);			
 			
@@ -381,6 +392,9 @@ process_select(SelectStmt *sel)
 				
 				/* Switch back to the old context */
 				MemoryContextSwitchTo(oldcxt);
+
+				/* Make it the signature conf() uses */
+				UseSignature(sig);
 	
 				/* Get the variable order for sorting */
 				varOrder = getVarOrder(sigTreeRoot, NULL);
@@ -927,7 +941,8 @@ expand_columnref_star_one_relation(char type, int tripleCount, List *fields,
 {
 	RangeVar 	*rv;
 	Relation	rel;
-	int			i, conColumnNum = 0;
+	URelationInfo *info;
+	int			i, k, conColumnNum = 0;
 	List		*result = NULL;
 	ResTarget	*res, *temp;
 	ColumnRef	*cref;
@@ -950,13 +965,17 @@ expand_columnref_star_one_relation(char type, int tripleCount, List *fields,
 		/* Get the attribute list from catalog */
 		rv = (RangeVar *) relation;
 		rel = relation_openrv(rv, NoLock);
+		info = RelationGetURelationInfo(rel);
 		
-		for (i = 0; i < rel->rd_att->natts; i++)
+		for (i = 0, k = 0; i < rel->rd_att->natts; i++)
 		{
-			/* We assume that all columns prefixed by VARNAME, 
-			 * PROBNAME or DOMAINNAME are condition columns. 
+			/* Skip the condition columns, whose attnums are in ascending 
+			 * order in info->condattrs. 
 			 */
-			if (!isConditionAttribute(NameStr(rel->rd_att->attrs[i]->attname)))
+			if (k < info->ncondattrs 
+				&& info->condattrs[k] == rel->rd_att->attrs[i]->attnum)
+				k++;
+			else if (!rel->rd_att->attrs[i]->attisdropped)
 			{
 				res = makeNode(ResTarget);
 				cref = makeNode(ColumnRef);
@@ -1218,31 +1237,23 @@ ColumnDef *makeColumnDef(char *name, int count)
 
 /* put_args_to_tconf
  *
- * This is to put the probability columns of all involved relations or
- * sub-queries into the the argument list of tconf.
+ * This is to put the condition columns of all involved relations or
+ * sub-queries into the argument list of tconf.
  *
- * We make a tconf for urelations and tuple-independent respectively.
- * The input tconf take the product of these two tconf as its parameters.
- * This is to increase the number of relations and sub-queries involved by
- * computing two independent probabilities.
+ * The variables, range values and probabilities of the urelations are passed
+ * as three arrays, and the probabilities of the tuple-independent relations as
+ * a fourth one, which is simply multiplied into the result. For instance,
  *
- * TODO: In fact, tconf for tuple-independent relations are simply the product
- * of the probabilities of the joined tuples. Therefore, we do not actually
- * tconf of tuple-independent relations. However, to unify the interfaces with
- * tconf of urelations, we can use this: tconf( product of probs ).
+ * tconf(ARRAY[R._v0, S._v0], ARRAY[R._d0, S._d0], ARRAY[R._p0, S._p0], ARRAY[T._p0])
  */
 static void
 put_args_to_tconf(SelectStmt *sel, char typeArray[], int tripleCount[],
 	List *fields, FuncCall *func)
 {
 	ListCell *cell;
-	int relCount = 0, i, j;
-	char *columnName = NULL;
-	FuncCall *func_urelation = copyObject(func);
-	FuncCall *func_independent = copyObject(func);
-	ColumnRef *cref;
+	int relCount = 0, i;
+	List *vars = NIL, *rngs = NIL, *probs = NIL, *independent = NIL;
 	List *field;
-	A_Expr *product = makeNode( A_Expr );
 
 	foreach(cell, fields){
 		field = (List *) lfirst(cell);
@@ -1252,44 +1263,19 @@ put_args_to_tconf(SelectStmt *sel, char typeArray[], int tripleCount[],
 			case TABLETYPE_CERTAIN:
 				break;
 			/* If the table is tuple-independent, its probability column is put
-			 * into func_independent. */
+			 * into the array of independent probabilities. */
 			case TABLETYPE_INDEPENDENT:
-				cref = makeNode( ColumnRef );
-				cref->fields = list_copy( field );
-				cref->fields = list_truncate( cref->fields, list_length( cref->fields ) - 1 );
-				cref->fields = lappend(cref->fields, makeString( catStrInt( PROBNAME, 0 )));
-				func_independent->args = lappend(func_independent->args, cref);
+				independent = lappend(independent,
+						makeColumnRef(PROBNAME, 0, field));
 				break;
-			/* If the table is a urelation, its probability columns are put into
-			 * func_urelation. */
+			/* If the table is a urelation, its condition columns are put into
+			 * the arrays of variables, range values and probabilities. */
 			case TABLETYPE_URELATION:
-
 				for( i = 0; i < tripleCount[ relCount ]; i++ )
 				{
-					for ( j = 0; j < 3; j++ )
-					{
-						switch( j )
-						{
-							case 0:
-								columnName = VARNAME;
-								break;
-							case 1:
-								columnName = DOMAINNAME;
-								break;
-							case 2:
-								columnName = PROBNAME;
-								break;
-							default:
-								elog(ERROR, "Invalid column name!\n");
-						}
-
-						cref = makeNode(ColumnRef);
-						cref->fields = list_copy(field);
-						cref->fields = list_truncate(cref->fields, list_length(cref->fields) - 1);
-						cref->fields = lappend(cref->fields, makeString(catStrInt(columnName, i)));
-						func_urelation->args = lappend(func_urelation->args, cref);
-
-					}
+					vars = lappend(vars, makeColumnRef(VARNAME, i, field));
+					rngs = lappend(rngs, makeColumnRef(DOMAINNAME, i, field));
+					probs = lappend(probs, makeColumnRef(PROBNAME, i, field));
 				}
 				break;
 
@@ -1300,14 +1286,16 @@ put_args_to_tconf(SelectStmt *sel, char typeArray[], int tripleCount[],
 		relCount++;
 	}
 
-	/* put the product of two function tconf as the argument of the input tconf */
-	product->name = list_make1( makeString( "*" ) );
-	product->lexpr = ( Node * ) func_urelation;
-	product->rexpr = ( Node * ) func_independent;
-	func->args = list_make1(product);
+	if (vars != NIL)
+	{
+		func->args = list_make3(makeArrayArg(vars), makeArrayArg(rngs),
+				makeArrayArg(probs));
 
-	func_urelation->agg_star = false;
-	func_independent->agg_star = false;
+		if (independent != NIL)
+			func->args = lappend(func->args, makeArrayArg(independent));
+	}
+	else if (independent != NIL)
+		func->args = list_make1(makeArrayArg(independent));
 
 	sel->whereClause = processWhereClause(sel->whereClause);
 	remove_mutual_exclusiveness(sel, typeArray, tripleCount, fields);
@@ -1341,11 +1329,13 @@ put_args_to_tconf(SelectStmt *sel, char typeArray[], int tripleCount[],
  *
  * For queries with group-by, PostgreSQL will estimate the costs and choose one
  * between Group strategy and Hash strategy. For Hashing strategy, we have to
- * store the lineage of every group of duplicates, which can consume huge amount
- * of memory. However, for Group strategy, we only need to store the lineage for
- * one group of duplicates in the memory. To take advantage of this, we rewrite
- * the query by adding sorting on all group-by columns and force PostgreSQL to 
- * adopt Group strategy in duplicate elimination.  
+ * store the lineage of every group of duplicates at the same time, whereas
+ * Group strategy only stores the lineage of one group but requires sorting
+ * the whole input. Since every group keeps its own state (see localcond.c), 
+ * both strategies are supported, and the planner takes the size of the
+ * lineage into account when it considers hashing (see count_agg_clauses()).
+ * The groups are ordered by the group-by columns afterwards, which is much
+ * cheaper than sorting the lineage.
  *
  * For instance, let R1 and R2 be one-dimension U-relations. Suppose the query is 
  *   
@@ -1353,11 +1343,16 @@ put_args_to_tconf(SelectStmt *sel, char typeArray[], int tripleCount[],
  *
  * It is rewritten into
  *
- * SELECT A, B, conf(_v0, _d0, _p0, _v1, _d1, _p1) 
- * FROM (SELECT A,B, R1._v0 as _v0, R1._d0 as _d0, R1._p0 as _p0, 
-                     R2._v0 as _v1, R2._d0 as _d1, R2._p0 as _p1 
- *       FROM R1, R2 ORDER BY A, B ) R
- * GROUP BY A, B; 
+ * SELECT A, B, conf(_wsd) 
+ * FROM (SELECT A,B, wsd(ARRAY[R1._v0, R2._v0], ARRAY[R1._d0, R2._d0],
+ *                       ARRAY[R1._p0, R2._p0]) as _wsd
+ *       FROM R1, R2) R
+ * GROUP BY A, B ORDER BY A, B; 
+ *
+ * The condition columns of a tuple are packed into a single wsd (see wsd.c)
+ * in the sub-selection, which is not pulled up, so that the sorting or 
+ * hashing of the groups carries one short value instead of three columns per
+ * triple.
  *
  * NOTE: This function should be almost the same as HQ_rewrite. If HQ_rewrite
  * is changed, please also check that whether the change is needed here.
@@ -1394,29 +1389,29 @@ generalRewrite(SelectStmt *sel, char typeArray[], int tripleCount[],
 	subsel->targetList = NULL;
 	add_referenced_columns(sel, subsel);
 
-	/* Generate the sortClause of the sub-selection */
-	/* TODO: This argument of this function should be sel->groupClause */
-	subsel->sortClause = get_sort_clause(subsel->targetList);
+	/* The sub-selection need not be sorted, since the lineage is grouped by
+	 * the outer selection */
+	subsel->sortClause = NULL;
 	
-	/* Add the condition columns to the targetList */
-	subsel->targetList = list_concat(subsel->targetList, put_args_to_conf_general(
-			typeArray, tripleCount, fields, VARNAME));
-	subsel->targetList = list_concat(subsel->targetList, put_args_to_conf_general(
-			typeArray, tripleCount, fields, DOMAINNAME));
-	subsel->targetList = list_concat(subsel->targetList, put_args_to_conf_general(
-			typeArray, tripleCount, fields, PROBNAME));
+	/* Add the condition of a tuple as a wsd to the targetList */
+	if (calculate_total_triples(tripleCount, list_length(subsel->fromClause)) > 0)
+		subsel->targetList = lappend(subsel->targetList,
+				put_wsd_to_conf_general(typeArray, tripleCount, fields));
 
 	/* Add the consistency check in the sub-selection */
 	subsel->whereClause = processWhereClause(subsel->whereClause);
 	remove_mutual_exclusiveness(subsel, typeArray, tripleCount, fields);
 
-	/* Set the arguments of conf() or aconf() as the condition columns in the sub-selection */
+	/* Set the argument of conf() or aconf() as the wsd in the sub-selection */
 	func->agg_star = false;
 	put_args_general(func,
 			calculate_total_triples(tripleCount, list_length(subsel->fromClause)));
 
 	/* Deal with the relation reference in the outermost selection */
 	handle_relation_reference(sel, subsel);
+
+	/* Order the groups by the group-by columns */
+	sort_groups(sel);
 	
 	#ifdef TEST		
 		myLog("sel-----------------------------------------------------------");	
@@ -1474,16 +1469,20 @@ add_referenced_columns(SelectStmt *outer, SelectStmt *inner)
 /* remove_mutual_exclusiveness
  *
  * For example, R->v0 = S->v0  --->  R->d0 = S->d0
- * is added to the where clause as (R->v0 != S->v0) OR (R->d0 = S->d0)
+ * must hold for every pair of triples of two urelations R and S. This is 
+ * added to the where clause as a single qual per pair of urelations,
+ *
+ * ARRAY[R._v0, R._d0, R._v1, R._d1, ...] &? ARRAY[S._v0, S._d0, ...]
  *
+ * which is checked by wsd_consistent_arrays() (see wsd.c). The qual refers to
+ * both relations only, so it is applied at their join.
  */
 static void 
 remove_mutual_exclusiveness(SelectStmt *sel, char typeArray[], int tripleCount[], List *fields)
 {
-	int i, j, k, l, len = list_length(fields);
+	int i, j, len = list_length(fields);
 	List *rel1, *rel2;
-	A_Expr *equal, *inequal, *or;
-	Node *v1, *v2, *r1, *r2;
+	A_Expr *consistent;
 	
 	/* Fill the where clause */
 	fill_where_clause(sel);
@@ -1492,7 +1491,7 @@ remove_mutual_exclusiveness(SelectStmt *sel, char typeArray[], int tripleCount[]
 	for (i = 0; i < len - 1; i++)
 	{
 		/* We do not care certain and tuple-independent relations. */
-		if (typeArray[i] != TABLETYPE_URELATION)
+		if (typeArray[i] != TABLETYPE_URELATION || tripleCount[i] == 0)
 			continue;
 
 		/* Retrieve the name of the relation. */
@@ -1502,43 +1501,42 @@ remove_mutual_exclusiveness(SelectStmt *sel, char typeArray[], int tripleCount[]
 		for (j = i + 1; j < len; j++)
 		{
 			/* We do not care certain and tuple-independent relations. */
-			if (typeArray[j] != TABLETYPE_URELATION)
+			if (typeArray[j] != TABLETYPE_URELATION || tripleCount[j] == 0)
 				continue;
 
 			/* Retrieve the name of the relation. */
 			rel2 = (List *) list_nth(fields, j);
 			
-			/* Loop all the condition triples in relation 1. */
-			for (k = 0; k < tripleCount[i]; k++)
-			{
-				v1 = makeColumnRef(VARNAME, k, rel1);
-
-				r1 = makeColumnRef(DOMAINNAME, k, rel1);
+			/* Make the consistency check of the two relations. */
+			consistent = makeA_Expr(AEXPR_OP, list_make1(makeString(WSDCONSISTENT)),
+					makeConditionPairs(rel1, tripleCount[i]),
+					makeConditionPairs(rel2, tripleCount[j]), 0);
+			
+			/*Add it to the where clause. */
+			sel->whereClause = (Node *) makeA_Expr(AEXPR_AND, NULL,
+					(Node *) consistent, sel->whereClause, 0);
+		}
+	}
+}
 
-				/* Loop all the condition triples in relation 2. */
-				for (l = 0; l < tripleCount[j]; l++)
-				{
-					v2 = makeColumnRef(VARNAME, l, rel2);
+/* makeConditionPairs
+ *
+ * Make the array of the variables and range values of a urelation for the
+ * consistency check: ARRAY[_v0, _d0, _v1, _d1, ...]
+ */
+static Node *
+makeConditionPairs(List *rel, int triples)
+{
+	List *elements = NIL;
+	int k;
 
-					r2 = makeColumnRef(DOMAINNAME, l, rel2);
-					
-					/* Make the inequality expression, v1 <> v2. */
-					inequal = makeA_Expr(AEXPR_OP, list_make1(makeString("<>")), v1, v2, 0);
-					
-					/* Make the equality expression, d1 = d2. */
-					equal = makeA_Expr(AEXPR_OP, list_make1(makeString("=")), r1, r2, 0);
-					
-					/* Combine the two expressions to become  v1 = v2 implies d1 = d2. */
-					or = makeA_Expr(AEXPR_OR, NULL, (Node *) inequal,
-							(Node *) equal, 0);
-					
-					/*Add it to the where clause. */
-					sel->whereClause = (Node *) makeA_Expr(AEXPR_AND, NULL,
-							(Node *) or, sel->whereClause, 0);
-				}
-			}
-		}
+	for (k = 0; k < triples; k++)
+	{
+		elements = lappend(elements, makeColumnRef(VARNAME, k, rel));
+		elements = lappend(elements, makeColumnRef(DOMAINNAME, k, rel));
 	}
+
+	return makeArrayArg(elements);
 }
 
 /* HQ_rewriting
@@ -1578,7 +1576,9 @@ HQ_rewriting(SelectStmt *sel, List *varOrder, FuncCall *func)
 	subsel->targetList = list_concat(subsel->targetList, newResTargets(
 			varOrder, VARNAME));
 
-	/* Generate the sortClause of the sub-selection */
+	/* Generate the sortClause of the sub-selection. Unlike in generalRewrite,
+	 * this is needed for the 1scan algorithm, which requires the lineage of a
+	 * group to be ordered by the variable columns (see SPROUT.c). */
 	subsel->sortClause = get_sort_clause(subsel->targetList);
 	
 	subsel->targetList = list_concat(subsel->targetList, newResTargets(
@@ -1591,6 +1591,9 @@ HQ_rewriting(SelectStmt *sel, List *varOrder, FuncCall *func)
 
 	/* Deal with the relation reference in the outermost selection */
 	handle_relation_reference(sel, subsel);
+
+	/* Order the groups by the group-by columns */
+	sort_groups(sel);
 	
 	#ifdef TEST
 		myLog( pretty_format_node_dump(nodeToString(subsel)));		 
@@ -1614,38 +1617,21 @@ calculate_total_triples(int tripleCount[], int n)
 
 /* put_args_general
  *
- * Put the condition columns of a query into the the argument list for
- * non-HQ conf() or aconf(). 
+ * Put the condition of a query into the the argument list for non-HQ conf() 
+ * or aconf(), which is the wsd computed in the sub-selection.
  */
 static void 
 put_args_general(FuncCall *func, int n)
 {
-	int 		i, k;
 	ColumnRef 	*cref;
-	char		*name;
 
-	for (i = 0; i < n; i++)
-	{		
-		for(k =0; k < 3; k++)
-		{
-			switch (k)
-			{
-				case 0:
-					name = VARNAME;
-					break;
-				case 1:
-					name = DOMAINNAME;
-					break;
-				default:
-					name = PROBNAME;
-					break;
-			}
-			
-			cref = makeNode(ColumnRef);
-			cref->fields = list_make1(makeString(catStrInt(name, i)));
-			func->args = lappend(func->args, cref);
-		}
-	}
+	/* Without condition columns, conf() and aconf() take no wsd */
+	if (n == 0)
+		return;
+
+	cref = makeNode(ColumnRef);
+	cref->fields = list_make1(makeString(WSDNAME));
+	func->args = lappend(func->args, cref);
 }
 
 /* generateFields
@@ -1675,46 +1661,57 @@ generateFields(List *flist)
 /* put_args_HQ
  *
  * Put the condition columns of a query into the the argument list for HQ conf().
+ * The variables and probabilities are passed as two arrays.
  */
 static void 
 put_args_HQ(FuncCall *func, int n)
 {	
-	int 		i, k;
+	int 		i;
+	List		*vars = NIL, *probs = NIL;
 	ColumnRef 	*cref;
-	char		*name;
 
 	for (i = 0; i < n; i++)
 	{		
-		for(k =0; k < 2; k++)
-		{
-			switch (k)
-			{
-				case 0:
-					name = VARNAME;
-					break;
-				default:
-					name = PROBNAME;
-					break;
-			}
-			
-			cref = makeNode(ColumnRef);
-			cref->fields = list_make1(makeString(catStrInt(name, i)));
-			func->args = lappend(func->args, cref);
-		}
+		cref = makeNode(ColumnRef);
+		cref->fields = list_make1(makeString(catStrInt(VARNAME, i)));
+		vars = lappend(vars, cref);
+
+		cref = makeNode(ColumnRef);
+		cref->fields = list_make1(makeString(catStrInt(PROBNAME, i)));
+		probs = lappend(probs, cref);
 	}
+
+	func->args = lappend(func->args, makeArrayArg(vars));
+	func->args = lappend(func->args, makeArrayArg(probs));
+}
+
+/* makeArrayArg
+ *
+ * Make an array constructor, ARRAY[e1, ..., en], of a list of expressions. The
+ * condition columns are passed to tconf(), conf() and aconf() this way.
+ */
+static Node *
+makeArrayArg(List *elements)
+{
+	ArrayExpr *arr = makeNode(ArrayExpr);
+
+	arr->elements = elements;
+
+	return (Node *) arr;
 }
 
 /* put_args_to_tconf_independent
  *
  * This is the rewriting for tconf() without general urelations.
- * The relations or sub-queries involved are certain or tuple-independent.
+ * The relations or sub-queries involved are certain or tuple-independent, and
+ * the probability columns of the tuple-independent ones are passed as an array.
  */
 static void
 put_args_to_tconf_independent(char typeArray[], List *fields, FuncCall *func)
 {
 	ListCell *cell;
-	ColumnRef *cref;
 	List *field;
+	List *probs = NIL;
 	int count = 0;
 
 	foreach(cell, fields){
@@ -1724,13 +1721,7 @@ put_args_to_tconf_independent(char typeArray[], List *fields, FuncCall *func)
 		{
 			/* Only tuple-independent tables have probability columns */
 			case TABLETYPE_INDEPENDENT:
-				cref = makeNode( ColumnRef );
-				cref->fields = list_copy( field );
-				cref->fields = list_truncate(cref->fields,
-											list_length(cref->fields) - 1);
-				cref->fields = lappend(cref->fields,
-										makeString(catStrInt(PROBNAME, 0)));
-				func->args = lappend(func->args, cref);
+				probs = lappend(probs, makeColumnRef(PROBNAME, 0, field));
 				break;
 
 			default:
@@ -1739,50 +1730,51 @@ put_args_to_tconf_independent(char typeArray[], List *fields, FuncCall *func)
 
 		count++;
 	}
+
+	if (probs != NIL)
+		func->args = lappend(func->args, makeArrayArg(probs));
 }
 
-/* put_args_to_conf_general
+/* put_wsd_to_conf_general
  *
- * Put the condition columns into conf which involves urelations.
- * TODO: This functions now only one kind of condition columns. Improve it to 
- * put all the condition columns once. Maybe this can be merged with 
- * function add_condition_columns.
+ * Make the target of the sub-selection of conf() or aconf() that packs the 
+ * condition columns of all urelations into a wsd:
  *
+ * wsd(ARRAY[R._v0, ..., S._v0, ...], ARRAY[R._d0, ...], ARRAY[R._p0, ...]) AS _wsd
  */
-static List *
-put_args_to_conf_general(char typeArray[], int tripleCount[], List *fields, char *name)
+static ResTarget *
+put_wsd_to_conf_general(char typeArray[], int tripleCount[], List *fields)
 {
-	List *list = NULL;
+	List *vars = NIL, *rngs = NIL, *probs = NIL;
 	ListCell *cell;
-	ColumnRef *cref;
-	ResTarget *res;
-	int targetCounter = 1, counter = 0, j = 0;
+	FuncCall *func = makeNode(FuncCall);
+	ResTarget *res = makeNode(ResTarget);
+	int targetCounter = 0, j;
 
 	/* Loop the all relations */
 	foreach(cell, fields)
 	{
+		List *field = (List *) lfirst(cell);
+
 		/* Loop all the triples of the condition columns. */
-		for(j = 0; j < tripleCount[ targetCounter - 1 ]; j++)
+		for(j = 0; j < tripleCount[ targetCounter ]; j++)
 		{
-			res = makeNode(ResTarget);
-			cref = makeNode(ColumnRef);
-			cref->fields = list_copy((List *)lfirst(cell));
-			cref->fields = list_truncate(cref->fields, list_length(cref->fields) - 1);
-
-			cref->fields = lappend(cref->fields, makeString(catStrInt(name, j)));
-			res->val= (Node *) cref;
-
-			res->name = catStrInt(name, counter);
-
-			list = lappend(list, res);
-
-			counter++;
+			vars = lappend(vars, makeColumnRef(VARNAME, j, field));
+			rngs = lappend(rngs, makeColumnRef(DOMAINNAME, j, field));
+			probs = lappend(probs, makeColumnRef(PROBNAME, j, field));
 		}
 
 		targetCounter++;
 	}
 
-	return list;
+	func->funcname = list_make1(makeString(WSDFUNCNAME));
+	func->args = list_make3(makeArrayArg(vars), makeArrayArg(rngs),
+			makeArrayArg(probs));
+
+	res->val = (Node *) func;
+	res->name = WSDNAME;
+
+	return res;
 }
 
 /* lookup_res_by_func 
@@ -1989,7 +1981,7 @@ is_self_join(List *fromClause)
 	int 		i, j;
 	Node		*node1, *node2;
 	RangeVar	*rv1, *rv2;
-	Relation	rel1, rel2;
+	URelationInfo *info1, *info2;
 	bool		self_join = false;
 	
 	for (i = 0; i < list_length(fromClause) - 2; i++)
@@ -2018,15 +2010,14 @@ is_self_join(List *fromClause)
 				rv2 = (RangeVar *) node2;
 				
 			/* Compare two range vars and return true if they are the same. */	
-			rel1 = relation_openrv(rv1, NoLock);
-			rel2 = relation_openrv(rv2, NoLock);
+			info1 = getURelationInfo(rv1);
+			info2 = getURelationInfo(rv2);
 			
-			/* Do not return until close the relation */
-			if (rel1->rd_id == rel2->rd_id)
+			if (info1->relid == info2->relid)
 				self_join = true;
 			
-			relation_close(rel1, NoLock);
-			relation_close(rel2, NoLock);
+			pfree(info1);
+			pfree(info2);
 			
 			if (self_join)
 				return true;
@@ -2080,7 +2071,7 @@ is_a_general_case(List *flist, char typeArray[])
 	ListCell *cell;
 	Node *node;
 	RangeVar *rv;
-	Relation rel;
+	URelationInfo *info;
 	int count = 0, i = 0;
 	RangeSubselect *sub;
 	SelectStmt *subsel;
@@ -2095,9 +2086,9 @@ is_a_general_case(List *flist, char typeArray[])
 			/* If it is a range variable, get the relation type from catalog.  */
 			case T_RangeVar:
 				rv = (RangeVar *) node;
-				rel = relation_openrv(rv, NoLock);
-				typeArray[count] = rel->rd_rel->tabletype;
-				relation_close(rel, NoLock);
+				info = getURelationInfo(rv);
+				typeArray[count] = info->tabletype;
+				pfree(info);
 				break;
 
 			/* If it is a range sub-select, get the relation type from the select. */
@@ -2155,6 +2146,32 @@ get_sort_clause(List *targetList)
 	return result;
 }
 
+/* sort_groups
+ *
+ * Order the result of the outermost selection by its group-by columns, unless
+ * it is ordered already. With hashing, the groups are not returned in the
+ * order of the sub-selection.
+ */	
+static void
+sort_groups(SelectStmt *sel)
+{
+	ListCell *cell;
+
+	if (sel->sortClause != NULL)
+		return;
+
+	/* Loop the group clause */
+	foreach(cell, sel->groupClause)
+	{
+		/* Create the SortBy object */
+		SortBy *sortby = makeNode(SortBy);
+		sortby->node = copyObject(lfirst(cell));
+
+		/* Add it to the sort clause */
+		sel->sortClause = lappend(sel->sortClause, sortby);
+	}
+}
+
 /* has_inequalities
  *
  * Return ture if the query contains inequalities("<"). 
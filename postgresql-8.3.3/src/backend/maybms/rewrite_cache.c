@@ -0,0 +1,396 @@
+/*-------------------------------------------------------------------------
+ *
+ * rewrite_cache.c
+ *	  Cache of rewritten queries.
+ *
+ *	  pg_parse_query rewrites every SELECT that references U-relations or
+ *	  uses conf(), repair-key or another MayBMS construct, which looks up the
+ *	  relations of the query in the catalog and, for conf() of hierarchical
+ *	  queries, computes the signature. Clients that prepare the same query
+ *	  again and again, like dashboards refreshing conf() values, repeat this
+ *	  work on every prepare. So the rewritten parse tree of a single SELECT
+ *	  that was rewritten is kept here by its text and the search_path it was
+ *	  rewritten under, together with its signature (see signature.c). Queries
+ *	  the rewriting leaves alone are not kept, since they would be parsed
+ *	  anyway.
+ *
+ *	  The rewriting only depends on the catalog entries of the relations of
+ *	  the query, so an entry keeps the OIDs of these relations and is dropped
+ *	  on a relcache invalidation of one of them, like the ones sent by ALTER
+ *	  TABLE, DROP TABLE or a new key constraint. A relation created or renamed
+ *	  later may take the name of one of them in the search_path, so the names
+ *	  are looked up again on every hit.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "access/hash.h"
+#include "access/xact.h"
+#include "catalog/namespace.h"
+#include "maybms/rewrite_cache.h"
+#include "maybms/signature.h"
+#include "utils/inval.h"
+#include "utils/memutils.h"
+
+#define REWRITE_CACHE_BUCKETS	64
+#define REWRITE_CACHE_SIZE		256
+
+typedef struct RewriteCacheEntry
+{
+	uint32		hashvalue;		/* hash of the query text */
+	char	   *query_string;	/* text of the query */
+	OverrideSearchPath *search_path;	/* search_path of the rewriting */
+	Node	   *parsetree;		/* rewritten parse tree */
+	SignatureState *signature;	/* its signature, or NULL */
+	List	   *relations;		/* RangeVars of the relations of the query */
+	Oid		   *relids;			/* their OIDs at the time of the rewriting */
+	int			nrelids;
+	MemoryContext context;		/* holds the entry and all of the above */
+	struct RewriteCacheEntry *next;
+} RewriteCacheEntry;
+
+static MemoryContext RewriteCacheContext = NULL;
+static RewriteCacheEntry *rewriteCache[REWRITE_CACHE_BUCKETS];
+static int	rewriteCacheCount = 0;
+
+static void InitRewriteCache(void);
+static void FlushRewriteCache(void);
+static void RemoveRewriteCacheEntry(RewriteCacheEntry **link);
+static void RewriteCacheCallback(Datum arg, Oid relid);
+static bool sameSearchPath(OverrideSearchPath *p1, OverrideSearchPath *p2);
+static bool sameRelations(RewriteCacheEntry *entry);
+static void collectRelations(Node *node, List **relations);
+
+/* GetCachedRewrite
+ *
+ * Get a copy of the rewritten parse tree of a query as the list 
+ * pg_parse_query returns, or NIL if the query is not in the cache. On a hit,
+ * the signature of the query becomes the current one.
+ */
+List *
+GetCachedRewrite(const char *query_string)
+{
+	RewriteCacheEntry **link;
+	RewriteCacheEntry *entry;
+	OverrideSearchPath *search_path;
+	uint32		hashvalue;
+
+	/* The search_path can only be looked up in a valid transaction */
+	if (rewriteCacheCount == 0 || !IsTransactionState() ||
+		IsAbortedTransactionBlockState())
+		return NIL;
+
+	/* Drop the entries of the relations changed since the last lookup */
+	AcceptInvalidationMessages();
+
+	if (rewriteCacheCount == 0)
+		return NIL;
+
+	hashvalue = DatumGetUInt32(hash_any((const unsigned char *) query_string,
+										strlen(query_string)));
+
+	search_path = NULL;
+
+	for (link = &rewriteCache[hashvalue % REWRITE_CACHE_BUCKETS];
+		 (entry = *link) != NULL; link = &entry->next)
+	{
+		if (entry->hashvalue != hashvalue ||
+			strcmp(entry->query_string, query_string) != 0)
+			continue;
+
+		if (search_path == NULL)
+			search_path = GetOverrideSearchPath(CurrentMemoryContext);
+
+		if (!sameSearchPath(entry->search_path, search_path))
+			continue;
+
+		/* A name now stands for another relation, so rewrite again */
+		if (!sameRelations(entry))
+		{
+			RemoveRewriteCacheEntry(link);
+			return NIL;
+		}
+
+		if (entry->signature)
+			RestoreSignature(entry->signature);
+
+		/* The parser scribbles on its input, so hand out a copy */
+		return list_make1(copyObject(entry->parsetree));
+	}
+
+	return NIL;
+}
+
+/* GetRewriteRelations
+ *
+ * Get the relations a query references, before it is rewritten, as a list
+ * of RangeVars for CacheRewrite.
+ */
+List *
+GetRewriteRelations(Node *parsetree)
+{
+	List	   *relations = NIL;
+
+	collectRelations(parsetree, &relations);
+
+	return relations;
+}
+
+/* CacheRewrite
+ *
+ * Keep the rewritten parse tree of a query, which references the relations
+ * GetRewriteRelations returned for it.
+ */
+void
+CacheRewrite(const char *query_string, List *relations, Node *parsetree)
+{
+	RewriteCacheEntry *entry;
+	MemoryContext context, oldcxt;
+	ListCell   *cell;
+	Oid		   *relids;
+	uint32		hashvalue;
+	int			bucket, i;
+
+	if (!IsTransactionState() || IsAbortedTransactionBlockState())
+		return;
+
+	/* The relations as the rewriting found them; a query that references a
+	 * relation that does not exist fails later on, so it is not kept. */
+	relids = (Oid *) palloc(Max(list_length(relations), 1) * sizeof(Oid));
+	i = 0;
+
+	foreach(cell, relations)
+	{
+		relids[i] = RangeVarGetRelid((RangeVar *) lfirst(cell), true);
+
+		if (!OidIsValid(relids[i]))
+			return;
+
+		i++;
+	}
+
+	if (RewriteCacheContext == NULL)
+		InitRewriteCache();
+
+	/* Start over when the cache is full */
+	if (rewriteCacheCount >= REWRITE_CACHE_SIZE)
+		FlushRewriteCache();
+
+	hashvalue = DatumGetUInt32(hash_any((const unsigned char *) query_string,
+										strlen(query_string)));
+	bucket = hashvalue % REWRITE_CACHE_BUCKETS;
+
+	context = AllocSetContextCreate(RewriteCacheContext,
+									"RewriteCacheEntry",
+									ALLOCSET_SMALL_MINSIZE,
+									ALLOCSET_SMALL_INITSIZE,
+									ALLOCSET_DEFAULT_MAXSIZE);
+
+	oldcxt = MemoryContextSwitchTo(context);
+
+	entry = (RewriteCacheEntry *) palloc(sizeof(RewriteCacheEntry));
+	entry->hashvalue = hashvalue;
+	entry->query_string = pstrdup(query_string);
+	entry->search_path = GetOverrideSearchPath(context);
+	entry->parsetree = copyObject(parsetree);
+	entry->signature = GetParseTreeSignature(entry->parsetree);
+	entry->relations = (List *) copyObject(relations);
+	entry->nrelids = list_length(relations);
+	entry->relids = (Oid *) palloc(Max(entry->nrelids, 1) * sizeof(Oid));
+	memcpy(entry->relids, relids, entry->nrelids * sizeof(Oid));
+	entry->context = context;
+	entry->next = rewriteCache[bucket];
+
+	MemoryContextSwitchTo(oldcxt);
+
+	pfree(relids);
+
+	rewriteCache[bucket] = entry;
+	rewriteCacheCount++;
+}
+
+static void
+InitRewriteCache(void)
+{
+	RewriteCacheContext = AllocSetContextCreate(CacheMemoryContext,
+												"RewriteCacheContext",
+												ALLOCSET_SMALL_MINSIZE,
+												ALLOCSET_SMALL_INITSIZE,
+												ALLOCSET_DEFAULT_MAXSIZE);
+
+	MemSet(rewriteCache, 0, sizeof(rewriteCache));
+	rewriteCacheCount = 0;
+
+	CacheRegisterRelcacheCallback(RewriteCacheCallback, (Datum) 0);
+}
+
+static void
+FlushRewriteCache(void)
+{
+	int			i;
+
+	for (i = 0; i < REWRITE_CACHE_BUCKETS; i++)
+		while (rewriteCache[i] != NULL)
+			RemoveRewriteCacheEntry(&rewriteCache[i]);
+}
+
+/* RemoveRewriteCacheEntry
+ *
+ * Unlink the entry *link points to and free it.
+ */
+static void
+RemoveRewriteCacheEntry(RewriteCacheEntry **link)
+{
+	RewriteCacheEntry *entry = *link;
+
+	*link = entry->next;
+
+	if (entry->signature)
+		ReleaseSignature(entry->signature);
+
+	MemoryContextDelete(entry->context);
+
+	rewriteCacheCount--;
+}
+
+/* RewriteCacheCallback
+ *
+ * Relcache invalidation callback. A changed relation may change its type or
+ * its condition columns, so drop the queries that reference it. An invalid
+ * relid stands for all relations.
+ */
+static void
+RewriteCacheCallback(Datum arg, Oid relid)
+{
+	RewriteCacheEntry **link;
+	RewriteCacheEntry *entry;
+	int			i, k;
+
+	if (rewriteCacheCount == 0)
+		return;
+
+	if (!OidIsValid(relid))
+	{
+		FlushRewriteCache();
+		return;
+	}
+
+	for (i = 0; i < REWRITE_CACHE_BUCKETS; i++)
+	{
+		link = &rewriteCache[i];
+
+		while ((entry = *link) != NULL)
+		{
+			for (k = 0; k < entry->nrelids; k++)
+				if (entry->relids[k] == relid)
+					break;
+
+			if (k < entry->nrelids)
+				RemoveRewriteCacheEntry(link);
+			else
+				link = &entry->next;
+		}
+	}
+}
+
+static bool
+sameSearchPath(OverrideSearchPath *p1, OverrideSearchPath *p2)
+{
+	return p1->addCatalog == p2->addCatalog &&
+		p1->addTemp == p2->addTemp &&
+		equal(p1->schemas, p2->schemas);
+}
+
+/* sameRelations
+ *
+ * Check that the names of the relations of a cached query still stand for
+ * the relations the query was rewritten with.
+ */
+static bool
+sameRelations(RewriteCacheEntry *entry)
+{
+	ListCell   *cell;
+	int			i = 0;
+
+	foreach(cell, entry->relations)
+	{
+		if (RangeVarGetRelid((RangeVar *) lfirst(cell), true) != entry->relids[i])
+			return false;
+
+		i++;
+	}
+
+	return true;
+}
+
+/* collectRelations
+ *
+ * Append the RangeVars in the FROM clauses of a raw parse tree to a list,
+ * including the ones of subqueries, joins, set operations and sub-selects
+ * in expressions, which the rewriting looks up in the catalog.
+ */
+static void
+collectRelations(Node *node, List **relations)
+{
+	ListCell   *cell;
+
+	if (node == NULL)
+		return;
+
+	switch (nodeTag(node))
+	{
+		case T_List:
+			foreach(cell, (List *) node)
+				collectRelations(lfirst(cell), relations);
+			break;
+		case T_RangeVar:
+			*relations = lappend(*relations, copyObject(node));
+			break;
+		case T_SelectStmt:
+			{
+				SelectStmt *select = (SelectStmt *) node;
+
+				collectRelations((Node *) select->targetList, relations);
+				collectRelations((Node *) select->fromClause, relations);
+				collectRelations(select->whereClause, relations);
+				collectRelations(select->havingClause, relations);
+				collectRelations((Node *) select->larg, relations);
+				collectRelations((Node *) select->rarg, relations);
+			}
+			break;
+		case T_JoinExpr:
+			collectRelations(((JoinExpr *) node)->larg, relations);
+			collectRelations(((JoinExpr *) node)->rarg, relations);
+			collectRelations(((JoinExpr *) node)->quals, relations);
+			break;
+		case T_RangeSubselect:
+			collectRelations(((RangeSubselect *) node)->subquery, relations);
+			break;
+		case T_ResTarget:
+			collectRelations(((ResTarget *) node)->val, relations);
+			break;
+		case T_A_Expr:
+			collectRelations(((A_Expr *) node)->lexpr, relations);
+			collectRelations(((A_Expr *) node)->rexpr, relations);
+			break;
+		case T_BoolExpr:
+			collectRelations((Node *) ((BoolExpr *) node)->args, relations);
+			break;
+		case T_SubLink:
+			collectRelations(((SubLink *) node)->testexpr, relations);
+			collectRelations(((SubLink *) node)->subselect, relations);
+			break;
+		case T_FuncCall:
+			collectRelations((Node *) ((FuncCall *) node)->args, relations);
+			break;
+		case T_TypeCast:
+			collectRelations(((TypeCast *) node)->arg, relations);
+			break;
+		default:
+			;
+	}
+}
@@ -22,6 +22,7 @@
 #include "maybms/rewrite.h"
 #include "maybms/rewrite_updates.h"
 #include "maybms/supported.h"
+#include "maybms/urelinfo.h"
 #include "utils/fmgroids.h"
 #include "utils/array.h"
 #include "utils/syscache.h"
@@ -63,34 +64,10 @@ int getTripleCount(Node *node)
 
 int getTripleCountRelation(RangeVar *rv)
 {
-	Relation rel;
-	char table_type;
-	int i;
-	int count;
-	int condition_attr_count = 0;
-
-	count = 0;
-	
-	rel = relation_openrv(rv, NoLock);
-	table_type = rel->rd_rel->tabletype;
+	URelationInfo *info = getURelationInfo(rv);
+	int count = info->tripleCount;
 
-	if(table_type == TABLETYPE_INDEPENDENT)
-		count= 1;
-	else if (table_type == TABLETYPE_URELATION)
-	{
-		for (i = 0; i < rel->rd_att->natts; i++)
-		{
-			if(isConditionAttribute(NameStr(rel->rd_att->attrs[i]->attname)))
-			{
-				condition_attr_count = condition_attr_count + 1;
-			}					
-		}
-		count = condition_attr_count / 3;
-	}
-	else if(table_type == TABLETYPE_CERTAIN)
-		count = 0;
-	
-	relation_close(rel, NoLock);
+	pfree(info);
 	
 	return count;
 }
@@ -20,6 +20,7 @@
 #include "maybms/rewrite.h"
 #include "maybms/rewrite_updates.h"
 #include "maybms/supported.h"
+#include "maybms/urelinfo.h"
 #include "utils/fmgroids.h"
 #include "utils/array.h"
 #include "utils/syscache.h"
@@ -83,11 +84,9 @@ int *getTripleCounts(List *flist)
 	Node 			*node;
 	RangeVar 		*rv;
 	SelectStmt		*select;
-	Relation 		rel;
+	URelationInfo	*info;
 	int 			count = 0;
 	int 			*result = palloc0(list_length(flist) * sizeof(int));
-	char 			type;
-	int 			i, conColCount = 0;
 	RangeSubselect 	*sub;
 	SelectStmt 		*subsel;
 
@@ -97,30 +96,9 @@ int *getTripleCounts(List *flist)
 		{
 			case T_RangeVar:
 				rv = (RangeVar *) node;
-				rel = relation_openrv(rv, NoLock);
-				type = rel->rd_rel->tabletype;
-
-				if(type == TABLETYPE_INDEPENDENT)
-					*(result + count) = 1;
-				else if (type == TABLETYPE_URELATION)
-				{
-					/* reset the counter */
-					conColCount = 0;
-					
-					for (i = 0; i < rel->rd_att->natts; i++)
-					{
-						/* We assume that all columns prefixed by VARNAME, 
-						 * PROBNAME or DOMAINNAME are condition columns. 
-						 */
-						if (isConditionAttribute(NameStr(rel->rd_att->attrs[i]->attname)))
-							conColCount++;
-					}
-
-					*(result + count) = conColCount / 3;
-				}
-
-					//count++;
-				relation_close(rel, NoLock);
+				info = getURelationInfo(rv);
+				*(result + count) = info->tripleCount;
+				pfree(info);
 				break;
 
 			case T_SelectStmt:
@@ -411,7 +389,11 @@ rewrite_set_operation(SelectStmt *sel)
 		
 		/* TODO: Handle the alias and relation reference. */
 		if (sel->repairkey != NULL)
+		{
 			result->repairkey = copyObject(sel->repairkey);		
+			result->partition = sel->partition;
+			result->npartitions = sel->npartitions;
+		}
 		else if (sel->pickingType != ' ')
 			result->pickingType = sel->pickingType;
 		
@@ -31,6 +31,7 @@
  */ 
 
 #include "postgres.h"
+#include "access/xact.h"
 #include "nodes/print.h"
 #include "nodes/pg_list.h"
 #include "nodes/makefuncs.h"
@@ -76,6 +77,14 @@ static bool relIsJoined(Node *rel, sgTreeNode *node);
 static List *copyFromList(List *list);
 static int nattr(subGoal *sg);
 static bool sgInChildSGLists(subGoal *sg, sgTreeNode *sgNode);
+static void AtEOXact_Signature(XactEvent event, void *arg);
+
+/* The signature the globals sgTreeRoot, sigTreeRoot, isOneScan and relList
+ * belong to */
+SignatureState *currentSignature = NULL;
+
+/* All signatures that are not freed yet */
+static List *signatures = NIL;
 
 /*  ProcessSignature
  *
@@ -1532,3 +1541,157 @@ sameRel(Node *n1, Node *n2)
 
 	return false;
 }
+
+/*  NewSignature
+ *
+ *  Create an empty signature in its own memory context. The caller builds
+ *  the signature in sig->context and passes it to UseSignature.
+ *
+ *  A signature is freed at the end of the transaction if no cache entry
+ *  uses it. Parse trees do not count as users since they do not outlive
+ *  the transaction unless a cache entry keeps them.
+ */
+SignatureState *
+NewSignature(void)
+{
+	static bool callbackRegistered = false;
+	MemoryContext context;
+	MemoryContext oldcxt;
+	SignatureState *sig;
+
+	if (!callbackRegistered)
+	{
+		RegisterXactCallback(AtEOXact_Signature, NULL);
+		callbackRegistered = true;
+	}
+
+	context = AllocSetContextCreate(TopMemoryContext, "SignatureContext", 
+									ALLOCSET_DEFAULT_MINSIZE,
+									ALLOCSET_DEFAULT_INITSIZE, 
+									ALLOCSET_DEFAULT_MAXSIZE);
+
+	sig = MemoryContextAllocZero(context, sizeof(SignatureState));
+	sig->context = context;
+
+	oldcxt = MemoryContextSwitchTo(TopMemoryContext);
+	signatures = lappend(signatures, sig);
+	MemoryContextSwitchTo(oldcxt);
+
+	return sig;
+}
+
+/*  UseSignature
+ *
+ *  Store the signature built by ProcessSignature in sig and make it the 
+ *  current one.
+ */
+void
+UseSignature(SignatureState *sig)
+{
+	sig->sgTreeRoot = sgTreeRoot;
+	sig->sigTreeRoot = sigTreeRoot;
+	sig->isOneScan = isOneScan;
+	sig->relList = relList;
+
+	currentSignature = sig;
+	signaturecxt = sig->context;
+}
+
+/*  RestoreSignature
+ *
+ *  Make a signature stored before the current one again.
+ */
+void
+RestoreSignature(SignatureState *sig)
+{
+	if (sig == currentSignature)
+		return;
+
+	sgTreeRoot = sig->sgTreeRoot;
+	sigTreeRoot = sig->sigTreeRoot;
+	isOneScan = sig->isOneScan;
+	relList = sig->relList;
+
+	currentSignature = sig;
+	signaturecxt = sig->context;
+}
+
+/*  GetParseTreeSignature
+ *
+ *  Get the signature a rewritten query was rewritten with and count the
+ *  caller as a user of it. Return NULL if the query has no signature.
+ */
+SignatureState *
+GetParseTreeSignature(Node *parsetree)
+{
+	SignatureState *sig;
+
+	if (parsetree == NULL || !IsA(parsetree, SelectStmt))
+		return NULL;
+
+	sig = ((SelectStmt *) parsetree)->signature;
+
+	if (sig != NULL)
+		sig->refcount++;
+
+	return sig;
+}
+
+/*  ReleaseSignature
+ *
+ *  Drop a use of a signature. The signature itself is freed at the end of
+ *  the transaction, since a query running in it may still compute conf().
+ */
+void
+ReleaseSignature(SignatureState *sig)
+{
+	Assert(sig->refcount > 0);
+
+	sig->refcount--;
+}
+
+/*  AtEOXact_Signature
+ *
+ *  Free the signatures without users at the end of a transaction.
+ */
+static void
+AtEOXact_Signature(XactEvent event, void *arg)
+{
+	List	   *keep = NIL;
+	ListCell   *cell;
+	MemoryContext oldcxt;
+
+	if (signatures == NIL)
+		return;
+
+	oldcxt = MemoryContextSwitchTo(TopMemoryContext);
+
+	foreach(cell, signatures)
+	{
+		SignatureState *sig = (SignatureState *) lfirst(cell);
+
+		if (sig->refcount > 0)
+		{
+			keep = lappend(keep, sig);
+			continue;
+		}
+
+		if (sig == currentSignature)
+		{
+			sgTreeRoot = NULL;
+			sigTreeRoot = NULL;
+			isOneScan = false;
+			relList = NIL;
+
+			currentSignature = NULL;
+			signaturecxt = NULL;
+		}
+
+		MemoryContextDelete(sig->context);
+	}
+
+	list_free(signatures);
+	signatures = keep;
+
+	MemoryContextSwitchTo(oldcxt);
+}
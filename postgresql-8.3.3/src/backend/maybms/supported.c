@@ -21,6 +21,7 @@
 #include "maybms/rewrite.h"
 #include "maybms/rewrite_updates.h"
 #include "maybms/supported.h"
+#include "maybms/urelinfo.h"
 #include "utils/fmgroids.h"
 #include "utils/array.h"
 #include "utils/syscache.h"
@@ -89,18 +90,18 @@ bool isCertainRelation(const RangeVar *rv)
 {
 	bool certain = false;
 	/* check relation type in the catalog */
-	Relation rel = relation_openrv(rv, NoLock);
-	if (rel->rd_rel->tabletype == TABLETYPE_CERTAIN)
+	URelationInfo *info = getURelationInfo(rv);
+	if (info->tabletype == TABLETYPE_CERTAIN)
 		certain = true;
 
 	/* TODO: fix the labeling of tables in the catalog
 	 * currently some tables don't have a type stored - in this case should
 	 * we interpret them as certain? */
-	else if (rel->rd_rel->tabletype != TABLETYPE_INDEPENDENT
-			&& rel->rd_rel->tabletype != TABLETYPE_URELATION)
+	else if (info->tabletype != TABLETYPE_INDEPENDENT
+			&& info->tabletype != TABLETYPE_URELATION)
 		certain = true;
 
-	relation_close(rel, NoLock);
+	pfree(info);
 
 	return certain;
 }
@@ -0,0 +1,93 @@
+/*-------------------------------------------------------------------------
+ *
+ * urelinfo.c
+ *	  The MayBMS metadata of a relation cached in its relcache entry.
+ *
+ *	  The rewriting looks up the type of every relation in the FROM clause
+ *	  several times, and the number of its triples of condition columns and
+ *	  which columns are condition columns, too. These only change when the
+ *	  relation is altered, so they are computed on the first lookup and kept
+ *	  in rd_urelinfo of the relcache entry. ALTER TABLE and every other 
+ *	  change of pg_class or pg_attribute send a relcache invalidation, which
+ *	  frees rd_urelinfo (see RelationClearRelation), and the next lookup 
+ *	  computes it again.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+#include "access/heapam.h"
+#include "catalog/pg_class.h"
+#include "nodes/parsenodes.h"
+#include "maybms/supported.h"
+#include "maybms/urelinfo.h"
+#include "utils/memutils.h"
+
+/* RelationGetURelationInfo
+ *
+ * Get the metadata of an open relation. The result lives in the relcache
+ * entry, so it is valid until the relation is closed and must not be 
+ * modified. 
+ */
+URelationInfo *
+RelationGetURelationInfo(Relation rel)
+{
+	URelationInfo *info = rel->rd_urelinfo;
+	TupleDesc	tupdesc;
+	int			i, n = 0;
+
+	if (info != NULL)
+		return info;
+
+	tupdesc = RelationGetDescr(rel);
+
+	info = MemoryContextAlloc(CacheMemoryContext, URELINFOSZ(tupdesc->natts));
+	info->relid = RelationGetRelid(rel);
+	info->tabletype = rel->rd_rel->tabletype;
+
+	/* We assume that all columns prefixed by VARNAME, PROBNAME or DOMAINNAME
+	 * are condition columns. */
+	for (i = 0; i < tupdesc->natts; i++)
+	{
+		if (tupdesc->attrs[i]->attisdropped)
+			continue;
+
+		if (isConditionAttribute(NameStr(tupdesc->attrs[i]->attname)))
+			info->condattrs[n++] = tupdesc->attrs[i]->attnum;
+	}
+	info->ncondattrs = n;
+
+	if (info->tabletype == TABLETYPE_INDEPENDENT)
+		info->tripleCount = 1;
+	else if (info->tabletype == TABLETYPE_URELATION)
+		info->tripleCount = n / 3;
+	else
+		info->tripleCount = 0;
+
+	rel->rd_urelinfo = info;
+
+	return info;
+}
+
+/* getURelationInfo
+ *
+ * Get the metadata of the relation a range variable refers to. The result is
+ * a copy in the current memory context.
+ */
+URelationInfo *
+getURelationInfo(const RangeVar *rv)
+{
+	Relation	rel = relation_openrv(rv, NoLock);
+	URelationInfo *cached = RelationGetURelationInfo(rel);
+	Size		size = URELINFOSZ(cached->ncondattrs);
+	URelationInfo *info = palloc(size);
+
+	memcpy(info, cached, size);
+
+	relation_close(rel, NoLock);
+
+	return info;
+}
@@ -11,6 +11,7 @@
 
 #include "maybms/localcond.h"
 #include "maybms/conf_comp.h"
+#include "maybms/conf_cache.h"
 
 /* In case of variable elimination we can now use one of two
  * heuristics: minlog and minmax, as detailed in the paper.
@@ -19,117 +20,9 @@ int WHICH_HEURISTIC = 0;
 
 /* Local functions */
 
-static bitset* find_independent_split(bitset* set);
-static bitset* find_wsds_with_var_rng(bitset* set, int var, int rng);
-static bitset* find_wsds_without_var(bitset* set, int var);
-static void dfs (bitset* set, bitset* set_to_construct, int idx);
-static void reset_wsds_var_rng(bitset* set, int var, int rng);
-static int wsd_ind (WSD* d1, WSD* d2);
-static int compare_map (Map* m1, Map* m2);
 static worldTableEntry * choose_var_minlog(bitset* set, generalState *state );
 static prob indve_compute_prob (bitset* set, generalState *state );
-
-/* find_independent_split 
- *
- * Partition the given wsd set into 2 independent sets
- * first set is returned and contains dependent wsds.
- */
-static bitset*
-find_independent_split(bitset* set)
-{
-	int i = 0;
-	bitset *subset;
-
-  	if (bitset_test_empty(set))
-    	return NULL;
-
-  	subset  = bitset_init(NUM_WSDS);
-  	bitset_reset(subset);
-
-  	while (i < NUM_WSDS && !bitset_test_bit(set,i))
-    	i++;
-
-  	if (i == NUM_WSDS)
-		elog(ERROR, "An invalid input of bitset!");
-
-  	dfs(set,subset,i);
-  
-  	return subset;
-}
-
-static void
-dfs (bitset* set, bitset* set_to_construct, int idx)
-{ 
-	int j;
-  	bitset_set_bit(set_to_construct,idx);
-  	for ( j=0; j<NUM_WSDS; j++)
-    	if (bitset_test_bit(set,j) && !bitset_test_bit(set_to_construct,j) &&
-    		!wsd_ind(S[idx],S[j]) && idx != j)
-      	dfs(set,set_to_construct,j);
-}
-
-/* wsd_ind
- *
- * Return 0 if not independent and 1 if independent.
- */
-static int 
-wsd_ind (WSD* d1, WSD* d2)
-{
-  	int is_independent = 1;
-
-  	int i=0;
-  	
-	while (i<WSD_LEN && is_independent)
-    {
-   		int j=0;
-      
-		while (j<WSD_LEN && compare_map(d1->data[i],d2->data[j]) == 0)
-        	j++;
-      	
-		if (j < WSD_LEN)
-        	is_independent = 0;
-
-      	i++;
-    }
-
-  	return is_independent;
-  
-}
-
-/*  compare_map
- *
- *  Return
- *  -2: equal 
- *  -1: mutex 
- *  0: different vars
- *  2: same vars, diff rng, both neg
- *  3: same vars, diff rng, diff neg (the positive one constrains the negative one)
- */
-static int
-compare_map (Map* m1, Map* m2)
-{
-	if (!m1 || !m2 || m1->rng == -1 || m2->rng == -1)
-		return 0;
-
-	if (m1->var == m2->var)
-	{
-		if (m1->rng == m2->rng)
-    	{
-      		if (m1->neg == m2->neg)
-				return -2;
-      		else
-				return -1;
-		}
-    	else if (m1->neg != m2->neg)
-			return 3;
-  		else if (m1->neg && m2->neg)
-	  		return 2;
-		else 
-	  		return -1;
-  	}
-  
-  	return 0;
-}
+static prob ws_tree_prob( generalState *state, int nparts );
 
 /* minlog_estimate
  *
@@ -156,15 +49,17 @@ choose_var_minlog(bitset* set, generalState *state)
 	resetCount( state );
 
 	/* Loop the world set descriptors and count the appearances of every range value  */
-	for( i = 0; i < NUM_WSDS; i++)
+	for( i = 0; i < state->num_wsds; i++)
     	if (bitset_test_bit(set, i)) 
 		{
-      		for ( j = 0; j < WSD_LEN; j++) 
+			int first = MAP( state, i, 0 );
+
+      		for ( j = 0; j < state->wsd_len; j++) 
 			{
 				/* If the range value is valid, increase its count */
-				if( S[i]->data[j]->rng >= 0 )
+				if( state->clauses->rng[first + j] >= 0 )
 				{
-					S[i]->data[j]->rng_entry->count++;
+					RNG_ENTRY( state, first + j )->count++;
 				}
       		}
       		
@@ -219,116 +114,6 @@ choose_var_minlog(bitset* set, generalState *state)
   	return result;
 }
 
-/* find_wsds_without_var
- *
- * Find the wsds that do not contain mapping of the given var
- */
-static bitset*
-find_wsds_without_var(bitset* set, int var)
-{
-  	bitset *subset  = NULL;
-	int i;
- 
- 	/* Loop the world set descriptors */
-  	for ( i = 0; i < NUM_WSDS; i++)
-    	if (bitset_test_bit(set,i)) 
-		{
-      		int j = 0;
-      		
-			while (j < WSD_LEN && S[i]->data[j]->var != var)
-				j++;
-
-      		if (j == WSD_LEN) 
-			{
-				if (subset == NULL) 
-				{
-	  				subset = bitset_init(NUM_WSDS);
-	  				bitset_reset(subset);
-				}
-	
-				bitset_set_bit(subset,i);
-      		}
-    	}
-  
-  	return subset;
-}
-
-/* find_wsds_with_var_rng 
- *
- * Find the world set descriptors that contain mapping var->rng; also *temporarily* drop this mapping.
- */
-static bitset*
-find_wsds_with_var_rng(bitset* set, int var, int rng)
-{
-  	bitset *subset  = NULL;
-  	int found_empty_wsd = 0;
-	int i = 0;
-	
-  	while (i < NUM_WSDS && !found_empty_wsd) 
-  	{
-    	if (bitset_test_bit(set,i)) 
-    	{
-      		int j = 0;
-      		
-      		while (j < WSD_LEN && (S[i]->data[j]->var != var || S[i]->data[j]->rng != rng))
-				j++;
-				
-      		if (j < WSD_LEN) 
-      		{
-				if (subset == NULL) 
-				{
-	  				subset = bitset_init(NUM_WSDS);
-	  				bitset_reset(subset);
-				}
-	
-			bitset_set_bit(subset,i);
-
-			/* Mark the used choices of rng for that var. */
-			S[i]->data[j]->rng = -1;
-			S[i]->prob /= S[i]->data[j]->prob;
-
-			/* Check if the remaining S[i] is empty, 
-			 * in which case the prob of all wsds agreeing with (var,rng) is just S[i]->data[j]->prob
-			 */
-			if (S[i]->prob == 1.0)
-	  			found_empty_wsd = 1;
-      		}
-    	}
-    	
-    	i++;
-  	}
-  
-  	if (found_empty_wsd) 
-  	{
-  		reset_wsds_var_rng(subset, var, rng);
-    	bitset_reset(subset);
-  	}
-
-  	return subset;
-}
-
-/* reset_wsds_var_rng
- *
- * The temporarily dropped mappings (see find_wsds_with_var_rng) are restored.
- */
-static void
-reset_wsds_var_rng(bitset* set, int var, int rng)
-{
-	int i; int j;
-
-	/* Loop the world set descriptors */
-  	for ( i = 0; i < NUM_WSDS; i++)
-    	if (bitset_test_bit(set,i))
-    		/* Restore the world set descriptors */
-      		for ( j = 0; j < WSD_LEN; j++)
-				if(S[i]->data[j]->var == var) 
-				{
-	  				S[i]->data[j]->rng = rng;
-	  				S[i]->prob *= S[i]->data[j]->prob;
-				}
-  
-}
-
 /* indve_compute_prob
  *
  * Compute the probability of a given set of wsds using independent
@@ -343,13 +128,13 @@ indve_compute_prob(bitset* set, generalState *state )
   	int i;
   	bitset *subset;
   	int pos;
-  	int var;		
 	prob p_without_var = -1;
 	prob cur_prob = 0.0;
     worldTableEntry *wt_entry;
 	rngEntry *rng_entry;
 	bitset* subset_without_var;
 	bitset* subset_var_rng;
+	compCacheEntry *pending = NULL;
 
 	/* Return 0 if the set if empty */
   	if (bitset_test_empty(set))
@@ -358,7 +143,7 @@ indve_compute_prob(bitset* set, generalState *state )
 	}
 
   	/* Find subset of S independent of the rest (subset repr. dependent wsds) */
-  	subset = find_independent_split(set);
+  	subset = findIndependentSplit(set, state);
  
   	/* Process the left subset containing dependent wsds */      
   
@@ -366,7 +151,10 @@ indve_compute_prob(bitset* set, generalState *state )
 
 	/* Special case of 1 wsd */
 	if (pos != -1) 
-    	p_left = S[pos]->prob;
+    	p_left = state->clauses->prob[pos];
+	/* The component has been computed on another branch */
+	else if (state->comp_cache != NULL && compCacheLookup(state, subset, &p_left, &pending))
+		;
     /* Subset contains more than one wsd */
  	else 
  	{		
@@ -375,12 +163,15 @@ indve_compute_prob(bitset* set, generalState *state )
 		/* All vars are used in the wsd set */
 		if (wt_entry == NULL)
 		{ 
+			if (pending != NULL)
+				compCacheInsert(state, pending, 1.0);
+
+			freeBitset(state, subset);
+
 			return 1.0;
    		}
 
-		var = wt_entry->var;
-
-		subset_without_var = find_wsds_without_var(subset, var);
+		subset_without_var = findWsdsWithoutVar(subset, wt_entry, state);
 
 		rng_entry = wt_entry->rng_entries;
 
@@ -388,7 +179,7 @@ indve_compute_prob(bitset* set, generalState *state )
 		for ( i = 0; i < wt_entry->rng_entry_count; i++) 
 		{
 			cur_prob = ( rng_entry + i )->p;
-			subset_var_rng = find_wsds_with_var_rng(subset, var, ( rng_entry + i )->rng );
+			subset_var_rng = findWsdsWithVarRng(subset, rng_entry + i, state);
 
 		  	if (subset_var_rng == NULL) 
 		  	{
@@ -407,12 +198,12 @@ indve_compute_prob(bitset* set, generalState *state )
 				{
 		  			bitset_union(subset_var_rng, subset_without_var);
 					cur_prob *= indve_compute_prob (subset_var_rng, state);
-					reset_wsds_var_rng(subset_var_rng, var, ( rng_entry + i )->rng );
+					resetWsdsWithVarRng(state);
 				}
 		  	}
 
 			if (subset_var_rng)
-				bitset_free(subset_var_rng);
+				freeBitset(state, subset_var_rng);
 
 			p_left += cur_prob;
 
@@ -421,22 +212,28 @@ indve_compute_prob(bitset* set, generalState *state )
 		  	{
 		  		
 				if (subset_without_var)
-					bitset_free(subset_without_var);
+					freeBitset(state, subset_without_var);
 				
-				bitset_free(subset);
+				freeBitset(state, subset);
+
+				if (pending != NULL)
+					compCacheInsert(state, pending, 1.0);
 						  	
 				return 1.0;
 		  	}
     	}
     	
 		if (subset_without_var)
-			bitset_free(subset_without_var);
+			freeBitset(state, subset_without_var);
+
+		if (pending != NULL)
+			compCacheInsert(state, pending, p_left);
   	}
 
 	/* Stop early */
   	if (p_left == 1.0) 
   	{
-  		bitset_free(subset);
+  		freeBitset(state, subset);
   		
     	return 1.0;
   	}
@@ -446,7 +243,7 @@ indve_compute_prob(bitset* set, generalState *state )
   	bitset_negate(set,subset);
   	p_right = indve_compute_prob(subset, state );
   	
-  	bitset_free(subset);
+  	freeBitset(state, subset);
 
   	/* Combine the probabilities of left and right subsets */
 
@@ -454,230 +251,55 @@ indve_compute_prob(bitset* set, generalState *state )
 }
 
 
-/* Following are transition functions for ws-tree algorithm.
- * They are actually only dummies and the task is done in the MACRO accum
- */
-
-/* TODO: We can use arrays to store the condition columns in the future. */
-
-/* conf_accum1_ge
- *
- * Transition function for exact confidence computation with 1 triple of 
- * condition columns 
- */
-Datum 
-conf_accum1_ge(PG_FUNCTION_ARGS)
-{
-	accum( 1 , 0 )
-}
-
-/* conf_accum2_ge
- *
- * Transition function for exact confidence computation with 2 triples of 
- * condition columns 
- */
-Datum 
-conf_accum2_ge(PG_FUNCTION_ARGS)
-{
-	accum( 2 , 0 )
-}
-
-/* conf_accum3_ge
- *
- * Transition function for exact confidence computation with 3 triples of 
- * condition columns 
- */
-Datum 
-conf_accum3_ge(PG_FUNCTION_ARGS)
-{
-	accum( 3 , 0 )
-}
-
-/* conf_accum4_ge
- *
- * Transition function for exact confidence computation with 4 triples of 
- * condition columns 
- */
-Datum 
-conf_accum4_ge(PG_FUNCTION_ARGS)
-{
-	accum( 4 , 0 )
-}
-
-/* conf_accum5_ge
- *
- * Transition function for exact confidence computation with 5 triples of 
- * condition columns 
- */
-Datum 
-conf_accum5_ge(PG_FUNCTION_ARGS)
-{
-	accum( 5 , 0 )
-}
-
-/* conf_accum6_ge
- *
- * Transition function for exact confidence computation with 6 triples of 
- * condition columns 
- */
-Datum 
-conf_accum6_ge(PG_FUNCTION_ARGS)
-{
-	accum( 6 , 0 )
-}
-
-/* conf_accum7_ge
- *
- * Transition function for exact confidence computation with 7 triples of 
- * condition columns 
- */
-Datum 
-conf_accum7_ge(PG_FUNCTION_ARGS)
-{
-	accum( 7 , 0 )
-}
-
-/* conf_accum8_ge
- *
- * Transition function for exact confidence computation with 8 triples of 
- * condition columns 
- */
-Datum 
-conf_accum8_ge(PG_FUNCTION_ARGS)
-{
-	accum( 8 , 0 )
-}
-
-/* conf_accum9_ge
- *
- * Transition function for exact confidence computation with 9 triples of 
- * condition columns 
- */
-Datum 
-conf_accum9_ge(PG_FUNCTION_ARGS)
-{
-	accum( 9 , 0 )
-}
-
-/* conf_accum10_ge
+/* conf_accum_ge
  *
- * Transition function for exact confidence computation with 10 triples of 
- * condition columns 
+ * Transition function for exact confidence computation. It appends the 
+ * clause of a tuple to the lineage of the state of its group, and returns the
+ * index of the state as the transition value. The condition columns of the 
+ * tuple are passed as arrays of variables, range values and probabilities 
+ * (see condvec.c).
  */
 Datum 
-conf_accum10_ge(PG_FUNCTION_ARGS)
+conf_accum_ge(PG_FUNCTION_ARGS)
 {
-	accum( 10 , 0 )
-}
+	varType *vars;
+	rngType *rngs;
+	prob *probs;
+	int n = getCondColumns( fcinfo, 1, &vars, &rngs, &probs );
+	generalState *state = getGenState( fcinfo, n );
 
-/* conf_accum11_ge
- *
- * Transition function for exact confidence computation with 11 triples of 
- * condition columns 
- */
-Datum 
-conf_accum11_ge(PG_FUNCTION_ARGS)
-{
-	accum( 11 , 0 )
-}
+	advance( state, fcinfo, n, vars, rngs, probs );
 
-/* conf_accum12_ge
- *
- * Transition function for exact confidence computation with 12 triples of 
- * condition columns 
- */
-Datum 
-conf_accum12_ge(PG_FUNCTION_ARGS)
-{
-	accum( 12 , 0 )
+	PG_RETURN_INT32( state->slot );
 }
 
-/* conf_accum13_ge
+/* ws_tree_prob
  *
- * Transition function for exact confidence computation with 13 triples of 
- * condition columns 
+ * Compute the exact probability of the clauses of a state in memory.
  */
-Datum 
-conf_accum13_ge(PG_FUNCTION_ARGS)
-{
-	accum( 13 , 0 )
-}
-
-/* conf_accum14_ge
- *
- * Transition function for exact confidence computation with 14 triples of 
- * condition columns 
- */
-Datum 
-conf_accum14_ge(PG_FUNCTION_ARGS)
-{
-	accum( 14 , 0 )
-}
-
-/* conf_accum15_ge
- *
- * Transition function for exact confidence computation with 15 triples of 
- * condition columns 
- */
-Datum 
-conf_accum15_ge(PG_FUNCTION_ARGS)
+static prob
+ws_tree_prob(generalState *state, int nparts)
 {
-	accum( 15 , 0 )
-}
+	prob result;
+	bitset* set;
 
-/* conf_accum16_ge
- *
- * Transition function for exact confidence computation with 16 triples of 
- * condition columns 
- */
-Datum 
-conf_accum16_ge(PG_FUNCTION_ARGS)
-{
-	accum( 16 , 0 )
-}
+	/* Complete the local world table */
+	getMissingRngs( state ); 
+  	
+  	/* bitset related operation */
+  	set = allocBitset(state);  
+  	bitset_set(set);             
 
-/* conf_accum17_ge
- *
- * Transition function for exact confidence computation with 17 triples of 
- * condition columns 
- */
-Datum 
-conf_accum17_ge(PG_FUNCTION_ARGS)
-{
-	accum( 17 , 0 )
-}
+	/* Create the cache of component probabilities */
+	state->comp_cache = compCacheInit(state);
 
-/* conf_accum18_ge
- *
- * Transition function for exact confidence computation with 18 triples of 
- * condition columns 
- */
-Datum 
-conf_accum18_ge(PG_FUNCTION_ARGS)
-{
-	accum( 18 , 0 )
-}
+	/* Compute the probability */
+    result = indve_compute_prob(set, state ); 
 
-/* conf_accum19_ge
- *
- * Transition function for exact confidence computation with 19 triples of 
- * condition columns 
- */
-Datum 
-conf_accum19_ge(PG_FUNCTION_ARGS)
-{
-	accum( 19 , 0 )
-}
+	compCacheReport(state->comp_cache, "conf");
+	state->comp_cache = NULL;
 
-/* conf_accum20_ge
- *
- * Transition function for exact confidence computation with 20 triples of 
- * condition columns 
- */
-Datum 
-conf_accum20_ge(PG_FUNCTION_ARGS)
-{
-	accum( 20 , 0 )
+	return result;
 }
 
 /* conf_final_ge
@@ -687,41 +309,30 @@ conf_accum20_ge(PG_FUNCTION_ARGS)
 Datum 
 conf_final_ge(PG_FUNCTION_ARGS)
 {
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate;
+	generalState *state = findGenState( fcinfo );
 	prob result = 0;
-	bitset* set;
 	MemoryContext oldcxt;
 	
 	/* Return 0 if there is no tuple */
-	if (groupcxt == NULL)
+	if (state == NULL)
 		PG_RETURN_FLOAT4(0);	
+
+	/* The group has been computed before a rescan */
+	if (state->finalized)
+		PG_RETURN_FLOAT4(state->result);
 	
 	/* Switch to the group context */
-	oldcxt = MemoryContextSwitchTo( groupcxt ); 
-
-	/* Complete the local world table */
-	getMissingRngs( state ); 
-
-	/* Compute the entry pointers of all clauses */
-	computeEntryPointers(state);
-  	
-  	/* bitset related operation */
-  	set = bitset_init(NUM_WSDS);  
-  	bitset_set(set);             
+	oldcxt = MemoryContextSwitchTo( state->groupcxt ); 
 
 	/* Compute the probability */
-    result = indve_compute_prob(set, state ); 
+	result = lineageProb( state, ws_tree_prob );
 	
 	/* Switch back to the old context */
 	MemoryContextSwitchTo( oldcxt );
-	MemoryContextDelete( groupcxt );
-	
-	/* Set the world-set-descriptor-related global variables to NULL */
-	NUM_WSDS = 0;
-	S = NULL;
-	groupcxt = NULL;      
+
+	/* Release the memory of the group of duplicates */
+	releaseGenState( fcinfo, state, result );
 
 	/* Return the result */
 	PG_RETURN_FLOAT4( result );	
 }
-
@@ -0,0 +1,809 @@
+/*-------------------------------------------------------------------------
+ *
+ * wsd.c
+ *	  Implementation of the world-set descriptor type wsd.
+ *
+ *	  A wsd is the condition of a tuple in one column: the mappings var->rng
+ *	  of its triples of condition columns and their probabilities. The
+ *	  rewriting of conf() and aconf() (see rewrite.c) packs the condition
+ *	  columns of a tuple into a wsd once, below the sorting or hashing of the
+ *	  groups, which then carry one short value instead of three columns per
+ *	  triple.
+ *
+ *	  The mappings are sorted by variable and range value. A duplicate mapping
+ *	  is replaced by the reserved variable with probability 1, like in
+ *	  insertClause() (see localcond.c), so that the wsds of the tuples of a
+ *	  query keep the same number of mappings, which conf() and aconf()
+ *	  require. Every mapping is encoded as a varint of the difference to the
+ *	  previous variable followed by a zigzag varint of the range value, so a
+ *	  mapping of the consecutive variables of a U-relation mostly takes two
+ *	  bytes. The probabilities are stored in front of the mappings, so they
+ *	  can be read in place.
+ *
+ *	  The text representation is {var:rng:prob,...}.
+ *
+ *	  The consistency check of two urelations in the rewritten queries also
+ *	  lives here: the operator &? on the arrays of variables and range values
+ *	  of both relations, with its selectivity estimators.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include "postgres.h"
+
+#include <ctype.h>
+#include <float.h>
+
+#include "lib/stringinfo.h"
+#include "maybms/condvec.h"
+#include "maybms/localcond.h"
+#include "maybms/wsd.h"
+#include "utils/array.h"
+#include "utils/selfuncs.h"
+#include "utils/syscache.h"
+
+/* Number of mappings that are sorted on the stack */
+#define STACK_PAIRS 32
+
+/* The maximal length of a varint of 32 bits */
+#define MAXVARINTLEN 5
+
+/*
+ * Up to this many pairs of mappings, the consistency check of two urelations
+ * compares all pairs. Beyond, one side is sorted and searched.
+ */
+#define NESTED_LOOP_PAIRS 64
+
+/* Selectivity of the consistency check if the arguments are not known */
+#define DEFAULT_CONSISTENT_SEL 0.99
+
+typedef struct wsdPair
+{
+	varType var;
+	rngType rng;
+	prob p;
+} wsdPair;
+
+/* State of reading the encoded mappings of a wsd */
+typedef struct wsdIter
+{
+	unsigned char *pos;
+	uint32 key;
+	int left;
+} wsdIter;
+
+static int comparePairs(const void *a, const void *b);
+static void orderPairs(int n, wsdPair *pairs);
+static int sortPairs(int n, wsdPair *pairs);
+static WsdType *encodeWsd(int n, wsdPair *pairs);
+static void initIter(wsdIter *iter, WsdType *wsd);
+static bool nextPair(wsdIter *iter, varType *var, rngType *rng);
+static int findVar(wsdPair *pairs, int n, varType var);
+static double numDistinct(PlannerInfo *root, Node *node, int varRelid);
+static Selectivity consistentSelectivity(PlannerInfo *root, List *args, int varRelid);
+
+/*
+ * The variables are mapped to unsigned keys that keep their order, so that the
+ * differences of sorted variables are never negative. The range values are
+ * zigzag encoded, so that small negative ones stay short.
+ */
+#define VAR_TO_KEY(v)	((uint32) (v) ^ 0x80000000)
+#define KEY_TO_VAR(k)	((varType) ((k) ^ 0x80000000))
+#define RNG_TO_ZIGZAG(r)	(((uint32) (r) << 1) ^ (uint32) ((r) >> 31))
+#define ZIGZAG_TO_RNG(z)	((rngType) (((z) >> 1) ^ -((int32) ((z) & 1))))
+
+static unsigned char *
+putVarint(unsigned char *pos, uint32 x)
+{
+	while (x >= 0x80)
+	{
+		*pos++ = (unsigned char) (x | 0x80);
+		x >>= 7;
+	}
+
+	*pos++ = (unsigned char) x;
+
+	return pos;
+}
+
+static unsigned char *
+getVarint(unsigned char *pos, uint32 *x)
+{
+	uint32 result = 0;
+	int shift = 0;
+
+	while (*pos & 0x80)
+	{
+		result |= (uint32) (*pos++ & 0x7F) << shift;
+		shift += 7;
+	}
+
+	*x = result | ((uint32) *pos++ << shift);
+
+	return pos;
+}
+
+/* comparePairs
+ *
+ * Order the mappings by variable and range value.
+ */
+static int
+comparePairs(const void *a, const void *b)
+{
+	const wsdPair *p1 = (const wsdPair *) a;
+	const wsdPair *p2 = (const wsdPair *) b;
+
+	if (p1->var != p2->var)
+		return p1->var < p2->var ? -1 : 1;
+
+	if (p1->rng != p2->rng)
+		return p1->rng < p2->rng ? -1 : 1;
+
+	return 0;
+}
+
+/* orderPairs
+ *
+ * Sort the mappings. The conditions of tuples are short, so insertion sort is
+ * used unless there are many mappings.
+ */
+static void
+orderPairs(int n, wsdPair *pairs)
+{
+	int i, j;
+
+	if (n > STACK_PAIRS)
+		qsort(pairs, n, sizeof(wsdPair), comparePairs);
+	else
+	{
+		for (i = 1; i < n; i++)
+		{
+			wsdPair pair = pairs[i];
+
+			for (j = i; j > 0 && comparePairs(&pairs[j - 1], &pair) > 0; j--)
+				pairs[j] = pairs[j - 1];
+
+			pairs[j] = pair;
+		}
+	}
+}
+
+/* sortPairs
+ *
+ * Sort the mappings and replace the duplicates by the reserved variable, which
+ * keeps the number of mappings. Return the number of mappings.
+ */
+static int
+sortPairs(int n, wsdPair *pairs)
+{
+	bool reserved = false;
+	int i, m;
+
+	orderPairs(n, pairs);
+
+	for (i = 1, m = 0; i < n; i++)
+	{
+		if (comparePairs(&pairs[m], &pairs[i]) != 0)
+			m = i;
+		else if (pairs[i].var != RESERVED_VAR || pairs[i].rng != RNG_FOR_RESERVED_VAR)
+		{
+			pairs[i].var = RESERVED_VAR;
+			pairs[i].rng = RNG_FOR_RESERVED_VAR;
+			pairs[i].p = 1;
+			reserved = true;
+		}
+	}
+
+	/* The reserved mappings have to be moved to their place */
+	if (reserved)
+		orderPairs(n, pairs);
+
+	return n;
+}
+
+/* encodeWsd
+ *
+ * Make a wsd of n sorted mappings.
+ */
+static WsdType *
+encodeWsd(int n, wsdPair *pairs)
+{
+	WsdType *wsd;
+	unsigned char *pos;
+	uint32 key = 0;
+	int i;
+
+	wsd = (WsdType *) palloc(WSDHDRSZ + n * (sizeof(prob) + 2 * MAXVARINTLEN));
+	wsd->npairs = n;
+
+	for (i = 0; i < n; i++)
+		WSD_PROBS(wsd)[i] = pairs[i].p;
+
+	pos = WSD_PAIRS(wsd);
+
+	for (i = 0; i < n; i++)
+	{
+		pos = putVarint(pos, VAR_TO_KEY(pairs[i].var) - key);
+		pos = putVarint(pos, RNG_TO_ZIGZAG(pairs[i].rng));
+		key = VAR_TO_KEY(pairs[i].var);
+	}
+
+	SET_VARSIZE(wsd, pos - (unsigned char *) wsd);
+
+	return wsd;
+}
+
+static void
+initIter(wsdIter *iter, WsdType *wsd)
+{
+	iter->pos = WSD_PAIRS(wsd);
+	iter->key = 0;
+	iter->left = WSD_NPAIRS(wsd);
+}
+
+/* nextPair
+ *
+ * Read the next mapping of a wsd. Return false if there is none.
+ */
+static bool
+nextPair(wsdIter *iter, varType *var, rngType *rng)
+{
+	uint32 delta, zigzag;
+
+	if (iter->left == 0)
+		return false;
+
+	iter->pos = getVarint(iter->pos, &delta);
+	iter->pos = getVarint(iter->pos, &zigzag);
+	iter->key += delta;
+	iter->left--;
+
+	*var = KEY_TO_VAR(iter->key);
+	*rng = ZIGZAG_TO_RNG(zigzag);
+
+	return true;
+}
+
+/* makeWsd
+ *
+ * Make a wsd of n triples of condition columns given in any order.
+ */
+WsdType *
+makeWsd(int n, varType *vars, rngType *rngs, prob *probs)
+{
+	wsdPair stackPairs[STACK_PAIRS];
+	wsdPair *pairs = n > STACK_PAIRS ? palloc(n * sizeof(wsdPair)) : stackPairs;
+	WsdType *wsd;
+	int i;
+
+	for (i = 0; i < n; i++)
+	{
+		pairs[i].var = vars[i];
+		pairs[i].rng = rngs[i];
+		pairs[i].p = probs[i];
+	}
+
+	wsd = encodeWsd(sortPairs(n, pairs), pairs);
+
+	if (pairs != stackPairs)
+		pfree(pairs);
+
+	return wsd;
+}
+
+/* wsdDecode
+ *
+ * Get the triples of condition columns of a wsd. The variables and range values
+ * are decoded into arrays allocated in the current memory context, while the
+ * probabilities are read in place. Return the number of triples.
+ */
+int
+wsdDecode(WsdType *wsd, varType **vars, rngType **rngs, prob **probs)
+{
+	wsdIter iter;
+	int i = 0;
+
+	*vars = (varType *) palloc((WSD_NPAIRS(wsd) + 1) * sizeof(varType));
+	*rngs = (rngType *) palloc((WSD_NPAIRS(wsd) + 1) * sizeof(rngType));
+	*probs = WSD_PROBS(wsd);
+
+	initIter(&iter, wsd);
+
+	while (nextPair(&iter, &(*vars)[i], &(*rngs)[i]))
+		i++;
+
+	return i;
+}
+
+/* wsd_in
+ *
+ * Input function of wsd: {var:rng:prob,...}
+ */
+Datum
+wsd_in(PG_FUNCTION_ARGS)
+{
+	char *str = PG_GETARG_CSTRING(0);
+	char *pos = str, *end;
+	int n = 0, size = 8;
+	wsdPair *pairs = palloc(size * sizeof(wsdPair));
+	WsdType *wsd;
+
+	while (isspace((unsigned char) *pos))
+		pos++;
+
+	if (*pos++ != '{')
+		goto syntax_error;
+
+	while (isspace((unsigned char) *pos))
+		pos++;
+
+	if (*pos == '}')
+		pos++;
+	else
+	{
+		for (;;)
+		{
+			if (n == size)
+			{
+				size *= 2;
+				pairs = repalloc(pairs, size * sizeof(wsdPair));
+			}
+
+			pairs[n].var = strtol(pos, &end, 10);
+			if (end == pos || *end != ':')
+				goto syntax_error;
+			pos = end + 1;
+
+			pairs[n].rng = strtol(pos, &end, 10);
+			if (end == pos || *end != ':')
+				goto syntax_error;
+			pos = end + 1;
+
+			pairs[n].p = strtod(pos, &end);
+			if (end == pos)
+				goto syntax_error;
+			pos = end;
+
+			if (pairs[n].p < 0 || pairs[n].p > 1)
+				ereport(ERROR,
+						(errcode(ERRCODE_NUMERIC_VALUE_OUT_OF_RANGE),
+						 errmsg("probability %g of wsd is not between 0 and 1",
+								pairs[n].p)));
+			n++;
+
+			while (isspace((unsigned char) *pos))
+				pos++;
+
+			if (*pos == '}')
+			{
+				pos++;
+				break;
+			}
+
+			if (*pos++ != ',')
+				goto syntax_error;
+
+			while (isspace((unsigned char) *pos))
+				pos++;
+		}
+	}
+
+	while (isspace((unsigned char) *pos))
+		pos++;
+
+	if (*pos != '\0')
+		goto syntax_error;
+
+	wsd = encodeWsd(sortPairs(n, pairs), pairs);
+
+	pfree(pairs);
+
+	PG_RETURN_WSD_P(wsd);
+
+syntax_error:
+	ereport(ERROR,
+			(errcode(ERRCODE_INVALID_TEXT_REPRESENTATION),
+			 errmsg("invalid input syntax for type wsd: \"%s\"", str)));
+
+	PG_RETURN_NULL();
+}
+
+/* wsd_out
+ *
+ * Output function of wsd.
+ */
+Datum
+wsd_out(PG_FUNCTION_ARGS)
+{
+	WsdType *wsd = PG_GETARG_WSD_P(0);
+	StringInfoData buf;
+	wsdIter iter;
+	varType var;
+	rngType rng;
+	int i = 0;
+
+	initStringInfo(&buf);
+	appendStringInfoChar(&buf, '{');
+
+	initIter(&iter, wsd);
+
+	while (nextPair(&iter, &var, &rng))
+	{
+		if (i > 0)
+			appendStringInfoChar(&buf, ',');
+
+		appendStringInfo(&buf, "%d:%d:%.*g", var, rng, FLT_DIG,
+						 WSD_PROBS(wsd)[i++]);
+	}
+
+	appendStringInfoChar(&buf, '}');
+
+	PG_RETURN_CSTRING(buf.data);
+}
+
+/* wsd_make
+ *
+ * wsd(int4[], int4[], float4[]): make a wsd of the arrays of variables, range
+ * values and probabilities of condition columns.
+ */
+Datum
+wsd_make(PG_FUNCTION_ARGS)
+{
+	varType *vars;
+	rngType *rngs;
+	prob *probs;
+	int n = getCondColumns(fcinfo, 0, &vars, &rngs, &probs);
+
+	PG_RETURN_WSD_P(makeWsd(n, vars, rngs, probs));
+}
+
+/* wsd_and
+ *
+ * The conjunction of two wsds. The mappings of both are merged, and the result
+ * is inconsistent if they contradict each other. A mapping in both wsds is
+ * kept once and the other copy becomes a reserved mapping, like in sortPairs().
+ */
+Datum
+wsd_and(PG_FUNCTION_ARGS)
+{
+	WsdType *a = PG_GETARG_WSD_P(0);
+	WsdType *b = PG_GETARG_WSD_P(1);
+	wsdPair *pairs = palloc((WSD_NPAIRS(a) + WSD_NPAIRS(b) + 1) * sizeof(wsdPair));
+	wsdIter ia, ib;
+	wsdPair pa, pb;
+	bool hasA, hasB;
+	bool reserved = false;
+	int i = 0, j = 0, n = 0;
+
+	initIter(&ia, a);
+	initIter(&ib, b);
+
+	hasA = nextPair(&ia, &pa.var, &pa.rng);
+	hasB = nextPair(&ib, &pb.var, &pb.rng);
+
+	while (hasA || hasB)
+	{
+		int cmp;
+
+		if (hasA)
+			pa.p = WSD_PROBS(a)[i];
+		if (hasB)
+			pb.p = WSD_PROBS(b)[j];
+
+		cmp = !hasB ? -1 : !hasA ? 1 : comparePairs(&pa, &pb);
+
+		if (cmp <= 0)
+		{
+			pairs[n++] = pa;
+			i++;
+			hasA = nextPair(&ia, &pa.var, &pa.rng);
+
+			/* The mapping is in both wsds */
+			if (cmp == 0)
+			{
+				pairs[n].var = RESERVED_VAR;
+				pairs[n].rng = RNG_FOR_RESERVED_VAR;
+				pairs[n++].p = 1;
+				reserved = true;
+
+				j++;
+				hasB = nextPair(&ib, &pb.var, &pb.rng);
+			}
+		}
+		else
+		{
+			pairs[n++] = pb;
+			j++;
+			hasB = nextPair(&ib, &pb.var, &pb.rng);
+		}
+	}
+
+	/* The reserved mappings have to be moved to their place */
+	if (reserved)
+		orderPairs(n, pairs);
+
+	PG_RETURN_WSD_P(encodeWsd(n, pairs));
+}
+
+/* wsd_consistent
+ *
+ * Check whether two wsds are consistent, i.e. whether their conjunction does
+ * not map a variable to two range values.
+ */
+Datum
+wsd_consistent(PG_FUNCTION_ARGS)
+{
+	WsdType *a = PG_GETARG_WSD_P(0);
+	WsdType *b = PG_GETARG_WSD_P(1);
+	wsdIter ia, ib;
+	varType va, vb, last = 0;
+	rngType ra, rb, lastRng = 0;
+	bool hasA, hasB, hasLast = false;
+
+	initIter(&ia, a);
+	initIter(&ib, b);
+
+	hasA = nextPair(&ia, &va, &ra);
+	hasB = nextPair(&ib, &vb, &rb);
+
+	while (hasA || hasB)
+	{
+		varType var;
+		rngType rng;
+
+		if (hasA && (!hasB || va < vb || (va == vb && ra <= rb)))
+		{
+			var = va;
+			rng = ra;
+			hasA = nextPair(&ia, &va, &ra);
+		}
+		else
+		{
+			var = vb;
+			rng = rb;
+			hasB = nextPair(&ib, &vb, &rb);
+		}
+
+		if (hasLast && var == last && rng != lastRng)
+			PG_RETURN_BOOL(false);
+
+		last = var;
+		lastRng = rng;
+		hasLast = true;
+	}
+
+	PG_RETURN_BOOL(true);
+}
+
+/* wsd_prob
+ *
+ * The probability of a wsd: the product of the probabilities of its mappings,
+ * or 0 if it is inconsistent.
+ */
+Datum
+wsd_prob(PG_FUNCTION_ARGS)
+{
+	WsdType *wsd = PG_GETARG_WSD_P(0);
+	wsdIter iter;
+	varType var, last = 0;
+	rngType rng, lastRng = 0;
+	prob result = 1;
+	int i = 0;
+
+	initIter(&iter, wsd);
+
+	while (nextPair(&iter, &var, &rng))
+	{
+		/* Repeated mappings are the reserved variable, which is consistent */
+		if (i > 0 && var == last && rng != lastRng)
+			PG_RETURN_FLOAT4(0);
+
+		result *= WSD_PROBS(wsd)[i++];
+		last = var;
+		lastRng = rng;
+	}
+
+	PG_RETURN_FLOAT4(result);
+}
+
+/* findVar
+ *
+ * Find the first of the sorted mappings with a variable. Return n if there is
+ * none.
+ */
+static int
+findVar(wsdPair *pairs, int n, varType var)
+{
+	int low = 0, high = n;
+
+	while (low < high)
+	{
+		int mid = (low + high) / 2;
+
+		if (pairs[mid].var < var)
+			low = mid + 1;
+		else
+			high = mid;
+	}
+
+	return low < n && pairs[low].var == var ? low : n;
+}
+
+/* wsd_consistent_arrays
+ *
+ * int4[] &? int4[]: check whether the conditions of two tuples of urelations
+ * are consistent. Each array holds the variables and range values of a tuple
+ * in turns, ARRAY[_v0, _d0, _v1, _d1, ...]. The conditions are inconsistent 
+ * if the tuples map a variable to different range values. Like the former
+ * predicates (_v0 <> _v0') OR (_d0 = _d0'), the result is null if there are
+ * nulls.
+ */
+Datum
+wsd_consistent_arrays(PG_FUNCTION_ARGS)
+{
+	ArrayType *a = PG_GETARG_ARRAYTYPE_P(0);
+	ArrayType *b = PG_GETARG_ARRAYTYPE_P(1);
+	int32 *pa, *pb;
+	int na, nb, i, j;
+
+	if (ARR_HASNULL(a) || ARR_HASNULL(b))
+		PG_RETURN_NULL();
+
+	na = ArrayGetNItems(ARR_NDIM(a), ARR_DIMS(a)) / 2;
+	nb = ArrayGetNItems(ARR_NDIM(b), ARR_DIMS(b)) / 2;
+	pa = (int32 *) ARR_DATA_PTR(a);
+	pb = (int32 *) ARR_DATA_PTR(b);
+
+	if (na * nb <= NESTED_LOOP_PAIRS)
+	{
+		for (i = 0; i < na; i++)
+			for (j = 0; j < nb; j++)
+				if (pa[2 * i] == pb[2 * j] && pa[2 * i + 1] != pb[2 * j + 1])
+					PG_RETURN_BOOL(false);
+	}
+	else
+	{
+		wsdPair *pairs;
+
+		/* Sort the mappings of the longer condition and search the others */
+		if (na > nb)
+		{
+			int32 *p = pa;
+			int n = na;
+
+			pa = pb;
+			na = nb;
+			pb = p;
+			nb = n;
+		}
+
+		pairs = (wsdPair *) palloc(nb * sizeof(wsdPair));
+
+		for (j = 0; j < nb; j++)
+		{
+			pairs[j].var = pb[2 * j];
+			pairs[j].rng = pb[2 * j + 1];
+		}
+
+		qsort(pairs, nb, sizeof(wsdPair), comparePairs);
+
+		for (i = 0; i < na; i++)
+		{
+			for (j = findVar(pairs, nb, pa[2 * i]);
+				 j < nb && pairs[j].var == pa[2 * i]; j++)
+			{
+				if (pairs[j].rng != pa[2 * i + 1])
+				{
+					pfree(pairs);
+					PG_RETURN_BOOL(false);
+				}
+			}
+		}
+
+		pfree(pairs);
+	}
+
+	PG_RETURN_BOOL(true);
+}
+
+static double
+numDistinct(PlannerInfo *root, Node *node, int varRelid)
+{
+	VariableStatData vardata;
+	double nd;
+
+	examine_variable(root, node, varRelid, &vardata);
+	nd = get_variable_numdistinct(&vardata);
+	ReleaseVariableStats(vardata);
+
+	return nd < 1.0 ? 1.0 : nd;
+}
+
+/* consistentSelectivity
+ *
+ * Estimate the fraction of pairs of tuples whose conditions are consistent.
+ * Two mappings of the pairs contradict each other if they have the same 
+ * variable, which happens with probability 1/max(nd(v), nd(v')) as for an
+ * equi-join, and different range values, which happens with probability
+ * 1 - 1/max(nd(d), nd(d')). The mappings are assumed to be independent.
+ */
+static Selectivity
+consistentSelectivity(PlannerInfo *root, List *args, int varRelid)
+{
+	List *left, *right;
+	double *ndLeft, *ndRight;
+	Selectivity sel = 1.0;
+	ListCell *cell;
+	int nl, nr, i, j;
+
+	if (list_length(args) != 2 || !IsA(linitial(args), ArrayExpr) ||
+		!IsA(lsecond(args), ArrayExpr))
+		return DEFAULT_CONSISTENT_SEL;
+
+	left = ((ArrayExpr *) linitial(args))->elements;
+	right = ((ArrayExpr *) lsecond(args))->elements;
+	nl = list_length(left);
+	nr = list_length(right);
+
+	if (nl % 2 != 0 || nr % 2 != 0)
+		return DEFAULT_CONSISTENT_SEL;
+
+	ndLeft = (double *) palloc((nl + 1) * sizeof(double));
+	ndRight = (double *) palloc((nr + 1) * sizeof(double));
+
+	i = 0;
+	foreach(cell, left)
+		ndLeft[i++] = numDistinct(root, (Node *) lfirst(cell), varRelid);
+
+	j = 0;
+	foreach(cell, right)
+		ndRight[j++] = numDistinct(root, (Node *) lfirst(cell), varRelid);
+
+	for (i = 0; i < nl; i += 2)
+	{
+		for (j = 0; j < nr; j += 2)
+		{
+			double sameVar = 1.0 / Max(ndLeft[i], ndRight[j]);
+			double otherRng = 1.0 - 1.0 / Max(ndLeft[i + 1], ndRight[j + 1]);
+
+			sel *= 1.0 - sameVar * otherRng;
+		}
+	}
+
+	pfree(ndLeft);
+	pfree(ndRight);
+
+	CLAMP_PROBABILITY(sel);
+
+	return sel;
+}
+
+/* wsdconsistentsel
+ *
+ * Restriction selectivity of the consistency check &?.
+ */
+Datum
+wsdconsistentsel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	List *args = (List *) PG_GETARG_POINTER(2);
+	int varRelid = PG_GETARG_INT32(3);
+
+	PG_RETURN_FLOAT8((float8) consistentSelectivity(root, args, varRelid));
+}
+
+/* wsdconsistentjoinsel
+ *
+ * Join selectivity of the consistency check &?.
+ */
+Datum
+wsdconsistentjoinsel(PG_FUNCTION_ARGS)
+{
+	PlannerInfo *root = (PlannerInfo *) PG_GETARG_POINTER(0);
+	List *args = (List *) PG_GETARG_POINTER(2);
+
+	PG_RETURN_FLOAT8((float8) consistentSelectivity(root, args, 0));
+}
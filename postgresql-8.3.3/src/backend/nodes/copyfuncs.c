@@ -619,6 +619,35 @@ _copyUnique(Unique *from)
 	return newnode;
 }
 
+/* MAYBMS BEGIN */
+/*
+ * _copyRepairKey
+ */
+static RepairKey *
+_copyRepairKey(RepairKey *from)
+{
+	RepairKey  *newnode = makeNode(RepairKey);
+
+	/*
+	 * copy node superclass fields
+	 */
+	CopyPlanFields((Plan *) from, (Plan *) newnode);
+
+	/*
+	 * copy remainder of node
+	 */
+	COPY_SCALAR_FIELD(numCols);
+	COPY_SCALAR_FIELD(numKeyCols);
+	COPY_POINTER_FIELD(sortColIdx, from->numCols * sizeof(AttrNumber));
+	COPY_POINTER_FIELD(eqOperators, from->numCols * sizeof(Oid));
+	COPY_SCALAR_FIELD(varColIdx);
+	COPY_SCALAR_FIELD(domColIdx);
+	COPY_SCALAR_FIELD(probColIdx);
+
+	return newnode;
+}
+/* MAYBMS END */
+
 /*
  * _copyHash
  */
@@ -736,6 +765,9 @@ _copyIntoClause(IntoClause *from)
 	COPY_NODE_FIELD(options);
 	COPY_SCALAR_FIELD(onCommit);
 	COPY_STRING_FIELD(tableSpaceName);
+	/* MAYBMS BEGIN */
+	COPY_SCALAR_FIELD(tabletype);
+	/* MAYBMS END */
 
 	return newnode;
 }
@@ -1869,6 +1901,9 @@ _copyQuery(Query *from)
 	COPY_NODE_FIELD(limitCount);
 	COPY_NODE_FIELD(rowMarks);
 	COPY_NODE_FIELD(setOperations);
+	/* MAYBMS BEGIN */
+	COPY_SCALAR_FIELD(repairKeyCols);
+	/* MAYBMS END */
 
 	return newnode;
 }
@@ -1934,6 +1969,10 @@ _copySelectStmt(SelectStmt *from)
 	COPY_SCALAR_FIELD(all);
 	COPY_NODE_FIELD(larg);
 	COPY_NODE_FIELD(rarg);
+	/* MAYBMS BEGIN */
+	COPY_SCALAR_FIELD(signature);
+	COPY_SCALAR_FIELD(repairKeyCols);
+	/* MAYBMS END */
 
 	return newnode;
 }
@@ -3095,6 +3134,11 @@ copyObject(void *from)
 		case T_Unique:
 			retval = _copyUnique(from);
 			break;
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+			retval = _copyRepairKey(from);
+			break;
+		/* MAYBMS END */
 		case T_Hash:
 			retval = _copyHash(from);
 			break;
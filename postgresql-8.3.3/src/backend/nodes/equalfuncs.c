@@ -768,6 +768,9 @@ _equalQuery(Query *a, Query *b)
 	COMPARE_NODE_FIELD(limitCount);
 	COMPARE_NODE_FIELD(rowMarks);
 	COMPARE_NODE_FIELD(setOperations);
+	/* MAYBMS BEGIN */
+	COMPARE_SCALAR_FIELD(repairKeyCols);
+	/* MAYBMS END */
 
 	return true;
 }
@@ -593,6 +593,33 @@ _outUnique(StringInfo str, Unique *node)
 		appendStringInfo(str, " %u", node->uniqOperators[i]);
 }
 
+/* MAYBMS BEGIN */
+static void
+_outRepairKey(StringInfo str, RepairKey *node)
+{
+	int			i;
+
+	WRITE_NODE_TYPE("REPAIRKEY");
+
+	_outPlanInfo(str, (Plan *) node);
+
+	WRITE_INT_FIELD(numCols);
+	WRITE_INT_FIELD(numKeyCols);
+
+	appendStringInfo(str, " :sortColIdx");
+	for (i = 0; i < node->numCols; i++)
+		appendStringInfo(str, " %d", node->sortColIdx[i]);
+
+	appendStringInfo(str, " :eqOperators");
+	for (i = 0; i < node->numCols; i++)
+		appendStringInfo(str, " %u", node->eqOperators[i]);
+
+	WRITE_INT_FIELD(varColIdx);
+	WRITE_INT_FIELD(domColIdx);
+	WRITE_INT_FIELD(probColIdx);
+}
+/* MAYBMS END */
+
 static void
 _outSetOp(StringInfo str, SetOp *node)
 {
@@ -1592,6 +1619,8 @@ _outSelectStmt(StringInfo str, SelectStmt *node)
 	WRITE_NODE_FIELD(targetList);
 	WRITE_NODE_FIELD(repairkey);
 	WRITE_NODE_FIELD(weightby);
+	WRITE_INT_FIELD(partition);
+	WRITE_INT_FIELD(npartitions);
 	WRITE_NODE_FIELD(fromClause);
 	WRITE_NODE_FIELD(whereClause);
 	WRITE_NODE_FIELD(groupClause);
@@ -1750,6 +1779,9 @@ _outQuery(StringInfo str, Query *node)
 	WRITE_NODE_FIELD(limitCount);
 	WRITE_NODE_FIELD(rowMarks);
 	WRITE_NODE_FIELD(setOperations);
+	/* MAYBMS BEGIN */
+	WRITE_INT_FIELD(repairKeyCols);
+	/* MAYBMS END */
 }
 
 static void
@@ -2144,6 +2176,11 @@ _outNode(StringInfo str, void *obj)
 			case T_Unique:
 				_outUnique(str, obj);
 				break;
+			/* MAYBMS BEGIN */
+			case T_RepairKey:
+				_outRepairKey(str, obj);
+				break;
+			/* MAYBMS END */
 			case T_SetOp:
 				_outSetOp(str, obj);
 				break;
@@ -154,6 +154,9 @@ _readQuery(void)
 	READ_NODE_FIELD(limitCount);
 	READ_NODE_FIELD(rowMarks);
 	READ_NODE_FIELD(setOperations);
+	/* MAYBMS BEGIN */
+	READ_INT_FIELD(repairKeyCols);
+	/* MAYBMS END */
 
 	READ_DONE();
 }
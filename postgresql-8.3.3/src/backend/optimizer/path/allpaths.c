@@ -815,6 +815,15 @@ subquery_is_pushdown_safe(Query *subquery, Query *topquery,
 	if (subquery->limitOffset != NULL || subquery->limitCount != NULL)
 		return false;
 
+	/* MAYBMS BEGIN */
+	/*
+	 * Neither into a repair-key, since the probabilities are normalized over
+	 * all tuples of a block.
+	 */
+	if (subquery->repairKeyCols > 0)
+		return false;
+	/* MAYBMS END */
+
 	/* Are we at top level, or looking at a setop component? */
 	if (subquery == topquery)
 	{
@@ -3237,6 +3237,85 @@ make_unique(Plan *lefttree, List *distinctList)
 	return node;
 }
 
+/* MAYBMS BEGIN */
+/*
+ * sortList is a list of SortClauses, identifying the targetlist items that
+ * the input of a repair-key is sorted on, the first numKeyCols of which form
+ * its key.  The input plan must already be sorted accordingly, and its last
+ * three columns must be the triple of condition columns produced by the
+ * rewriting of repair-key.
+ */
+RepairKey *
+make_repairkey(Plan *lefttree, List *sortList, int numKeyCols)
+{
+	RepairKey  *node = makeNode(RepairKey);
+	Plan	   *plan = &node->plan;
+	int			numCols = list_length(sortList);
+	int			natts = 0;
+	int			keyno = 0;
+	AttrNumber *sortColIdx;
+	Oid		   *eqOperators;
+	ListCell   *l;
+
+	copy_plan_costsize(plan, lefttree);
+
+	/*
+	 * Charge one cpu_operator_cost per comparison per input tuple, and
+	 * another one for the condition columns.  The blocks of tuples are read
+	 * twice, but usually from memory.
+	 */
+	plan->total_cost += cpu_operator_cost * plan->plan_rows * (numCols + 1);
+
+	plan->targetlist = lefttree->targetlist;
+	plan->qual = NIL;
+	plan->lefttree = lefttree;
+	plan->righttree = NULL;
+
+	/*
+	 * convert SortClause list into arrays of attr indexes and equality
+	 * operators, as wanted by executor
+	 */
+	Assert(numKeyCols > 0 && numKeyCols <= numCols);
+	sortColIdx = (AttrNumber *) palloc(sizeof(AttrNumber) * numCols);
+	eqOperators = (Oid *) palloc(sizeof(Oid) * numCols);
+
+	foreach(l, sortList)
+	{
+		SortClause *sortcl = (SortClause *) lfirst(l);
+		TargetEntry *tle = get_sortgroupclause_tle(sortcl, plan->targetlist);
+
+		sortColIdx[keyno] = tle->resno;
+		eqOperators[keyno] = get_equality_op_for_ordering_op(sortcl->sortop);
+		if (!OidIsValid(eqOperators[keyno]))	/* shouldn't happen */
+			elog(ERROR, "could not find equality operator for ordering operator %u",
+				 sortcl->sortop);
+		keyno++;
+	}
+
+	/* The triple of condition columns precedes any resjunk columns */
+	foreach(l, plan->targetlist)
+	{
+		TargetEntry *tle = (TargetEntry *) lfirst(l);
+
+		if (!tle->resjunk)
+			natts = tle->resno;
+	}
+
+	if (natts < 3)
+		elog(ERROR, "repair-key input has no condition columns");
+
+	node->numCols = numCols;
+	node->numKeyCols = numKeyCols;
+	node->sortColIdx = sortColIdx;
+	node->eqOperators = eqOperators;
+	node->varColIdx = natts - 2;
+	node->domColIdx = natts - 1;
+	node->probColIdx = natts;
+
+	return node;
+}
+/* MAYBMS END */
+
 /*
  * distinctList is a list of SortClauses, identifying the targetlist items
  * that should be considered by the SetOp filter.  The input path must
@@ -3442,6 +3521,9 @@ is_projection_capable_plan(Plan *plan)
 		case T_SetOp:
 		case T_Limit:
 		case T_Append:
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+		/* MAYBMS END */
 			return false;
 		default:
 			break;
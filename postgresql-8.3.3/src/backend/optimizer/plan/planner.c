@@ -1178,6 +1178,16 @@ grouping_planner(PlannerInfo *root, double tuple_fraction)
 			result_plan->plan_rows = dNumGroups;
 	}
 
+	/* MAYBMS BEGIN */
+	/*
+	 * If the query is a repair-key, add the REPAIRKEY node on top of the
+	 * sorted input.
+	 */
+	if (parse->repairKeyCols > 0)
+		result_plan = (Plan *) make_repairkey(result_plan, parse->sortClause,
+											  parse->repairKeyCols);
+	/* MAYBMS END */
+
 	/*
 	 * Finally, if there is a LIMIT/OFFSET clause, add the LIMIT node.
 	 */
@@ -1532,6 +1542,11 @@ choose_hashed_grouping(PlannerInfo *root,
 	hashentrysize += agg_counts->transitionSpace;
 	/* plus the per-hash-entry overhead */
 	hashentrysize += hash_agg_entry_size(agg_counts->numAggs);
+	/* MAYBMS BEGIN */
+	/* plus the lineage of all input rows of the group kept by conf() */
+	if (agg_counts->lineageSpace > 0 && dNumGroups > 0)
+		hashentrysize += agg_counts->lineageSpace * (cheapest_path_rows / dNumGroups);
+	/* MAYBMS END */
 
 	if (hashentrysize * dNumGroups > work_mem * 1024L)
 		return false;
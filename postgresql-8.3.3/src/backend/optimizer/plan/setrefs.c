@@ -337,6 +337,9 @@ set_plan_refs(PlannerGlobal *glob, Plan *plan, int rtoffset)
 		case T_Sort:
 		case T_Unique:
 		case T_SetOp:
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+		/* MAYBMS END */
 
 			/*
 			 * These plan types don't actually bother to evaluate their
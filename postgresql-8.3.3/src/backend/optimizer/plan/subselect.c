@@ -1290,6 +1290,9 @@ finalize_plan(PlannerInfo *root, Plan *plan,
 		case T_Unique:
 		case T_SetOp:
 		case T_Group:
+		/* MAYBMS BEGIN */
+		case T_RepairKey:
+		/* MAYBMS END */
 			break;
 
 		default:
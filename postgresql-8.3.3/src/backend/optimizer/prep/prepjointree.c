@@ -21,6 +21,9 @@
  */
 #include "postgres.h"
 
+/* MAYBMS BEGIN */
+#include "catalog/pg_type.h"
+/* MAYBMS END */
 #include "nodes/makefuncs.h"
 #include "optimizer/clauses.h"
 #include "optimizer/prep.h"
@@ -670,6 +673,28 @@ is_simple_subquery(Query *subquery)
 	if (contain_volatile_functions((Node *) subquery->targetList))
 		return false;
 
+	/* MAYBMS BEGIN */
+
+	/*
+	 * Don't pull up a subquery that packs the condition columns of its tuples
+	 * into a wsd. The rewriting of conf() and aconf() puts the wsd there so
+	 * that the sorting or hashing above carries it instead of the condition
+	 * columns.
+	 */
+	{
+		ListCell   *l;
+
+		foreach(l, subquery->targetList)
+		{
+			TargetEntry *tle = (TargetEntry *) lfirst(l);
+
+			if (!IsA(tle->expr, Var) && exprType((Node *) tle->expr) == WSDOID)
+				return false;
+		}
+	}
+
+	/* MAYBMS END */
+
 	/*
 	 * Hack: don't try to pull up a subquery with an empty jointree.
 	 * query_planner() will correctly generate a Result plan for a jointree
@@ -27,6 +27,9 @@
 #include "catalog/pg_type.h"
 #include "executor/executor.h"
 #include "executor/functions.h"
+/* MAYBMS BEGIN */
+#include "maybms/wsd.h"
+/* MAYBMS END */
 #include "miscadmin.h"
 #include "nodes/makefuncs.h"
 #include "optimizer/clauses.h"
@@ -480,6 +483,37 @@ count_agg_clauses_walker(Node *node, AggClauseCounts *counts)
 			counts->transitionSpace += avgwidth + 2 * sizeof(void *);
 		}
 
+		/* MAYBMS BEGIN */
+
+		/*
+		 * The confidence aggregates keep the lineage of all input rows of a
+		 * group until the group is finalized. Each condition column takes
+		 * about two words of the lineage (see localcond.h). The condition
+		 * columns are passed as arrays, so the elements of an array
+		 * constructor are counted instead of the array itself. The number of
+		 * triples in a wsd column is unknown, so it is guessed.
+		 */
+		if (IsLineageAggregate(aggref->aggfnoid))
+		{
+			int			numColumns = 0;
+
+			foreach(l, aggref->args)
+			{
+				Node	   *arg = (Node *) lfirst(l);
+
+				if (IsA(arg, ArrayExpr))
+					numColumns += list_length(((ArrayExpr *) arg)->elements);
+				else if (exprType(arg) == WSDOID)
+					numColumns += 3 * WSD_EST_PAIRS;
+				else
+					numColumns++;
+			}
+
+			counts->lineageSpace += numColumns * 2 * sizeof(int32);
+		}
+
+		/* MAYBMS END */
+
 		/*
 		 * Complain if the aggregate's arguments contain any aggregates;
 		 * nested agg functions are semantically nonsensical.
@@ -706,6 +706,24 @@ transformSelectStmt(ParseState *pstate, SelectStmt *stmt)
 	qry->havingQual = transformWhereClause(pstate, stmt->havingClause,
 										   "HAVING");
 
+	/* MAYBMS BEGIN */
+	/*
+	 * The ORDER BY of a rewritten repair-key starts with its key.  Count the
+	 * key items left after removing duplicates, which the ORDER BY as a
+	 * whole keeps in front.
+	 */
+	if (stmt->repairKeyCols > 0)
+	{
+		List	   *keys = list_truncate(list_copy(stmt->sortClause),
+										 stmt->repairKeyCols);
+
+		qry->repairKeyCols = list_length(transformSortClause(pstate,
+															 keys,
+															 &qry->targetList,
+															 true));
+	}
+	/* MAYBMS END */
+
 	/*
 	 * Transform sorting/grouping stuff.  Do ORDER BY first because both
 	 * transformGroupClause and transformDistinctClause need the results.
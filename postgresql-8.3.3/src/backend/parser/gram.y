@@ -183,7 +183,7 @@ static Node *makeXmlExpr(XmlExprOp op, char *name, List *named_args, List *args)
 %type <chr> OptPickingType
 %type <target> OptProb
 %type <target> repairkey_target_el
-%type <list> repairkey_target_list
+%type <list> repairkey_target_list OptRepairKeyPartition
 
 /* MAYBMS END */
 
@@ -432,7 +432,7 @@ static Node *makeXmlExpr(XmlExprOp op, char *name, List *named_args, List *args)
 	OBJECT_P OF OFF OFFSET OIDS OLD ON ONLY OPERATOR OPTION OR
 	ORDER OUT_P OUTER_P OVERLAPS OVERLAY OWNED OWNER
 
-	PARSER PARTIAL PASSWORD PLACING PLANS POSITION POSSIBLE /* MAYBMS */
+	PARSER PARTIAL PARTITION /* MAYBMS */ PASSWORD PLACING PLANS POSITION POSSIBLE /* MAYBMS */
 	PRECISION PRESERVE PREPARE PREPARED PRIMARY
 	PRIOR PRIVILEGES PROBABILITY /* MAYBMS */ PROCEDURAL PROCEDURE
 
@@ -2478,7 +2478,7 @@ OptProb:
  */
  
 RepairKeyStmt:
-		REPAIR KEY repairkey_target_list IN_P RepairKeyFrom WEIGHTBY
+		REPAIR KEY repairkey_target_list IN_P RepairKeyFrom OptRepairKeyPartition WEIGHTBY
 				{					
 					SelectStmt *n = (SelectStmt *)$5;
 					
@@ -2487,11 +2487,33 @@ RepairKeyStmt:
 							"relations");
 						
 					n->repairkey = $3;
-					n->weightby = $6;
+					n->weightby = $7;
+					if ($6 != NIL)
+					{
+						n->partition = linitial_int($6);
+						n->npartitions = lsecond_int($6);
+					}
 					$$ = (Node *)n;
 				}
 		;
 
+/*
+ * PARTITION i OF n repairs only the keys of the input that hash into the
+ * i-th of n partitions, so that n sessions can build a U-relation together.
+ */
+OptRepairKeyPartition:
+	PARTITION Iconst OF Iconst
+		{
+			if ($4 < 1 || $2 < 1 || $2 > $4)
+				ereport(ERROR,
+						(errcode(ERRCODE_SYNTAX_ERROR),
+						 errmsg("repair-key partition %d of %d does not exist",
+								$2, $4)));
+			$$ = list_make2_int($2, $4);
+		}
+	| /* EMPTY */		{ $$ = NIL; }
+	;
+
 /* IMPORTANT NOTE: When we removed the parentheses around the target list in 
  * repair-key, we got 1 shift/reduce conflict. This conflicts with the rules:
  *
@@ -9330,6 +9352,7 @@ unreserved_keyword:
 			| OWNER
 			| PARSER
 			| PARTIAL
+			| PARTITION  	/* MAYBMS */
 			| PASSWORD
 			| PLANS
 			| PREPARE
@@ -273,6 +273,7 @@ static const ScanKeyword ScanKeywords[] = {
 	{"owner", OWNER, UNRESERVED_KEYWORD},
 	{"parser", PARSER, UNRESERVED_KEYWORD},
 	{"partial", PARTIAL, UNRESERVED_KEYWORD},
+	{"partition", PARTITION, UNRESERVED_KEYWORD},	/* MAYBMS */
 	{"password", PASSWORD, UNRESERVED_KEYWORD},
 	{"pick", PICK, RESERVED_KEYWORD},  			/* MAYBMS */
 	{"placing", PLACING, RESERVED_KEYWORD},
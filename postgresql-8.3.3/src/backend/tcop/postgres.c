@@ -47,6 +47,10 @@
 #include "libpq/pqformat.h"
 #include "libpq/pqsignal.h"
 #include "miscadmin.h"
+/* MAYBMS BEGIN */
+#include "maybms/rewrite_cache.h"
+#include "maybms/supported.h"
+/* MAYBMS END */
 #include "nodes/print.h"
 #include "optimizer/planner.h"
 #include "parser/analyze.h"
@@ -550,7 +554,14 @@ pg_parse_query(const char *query_string)
 	List	   *raw_parsetree_list;
 	/* MAYBMS BEGIN */
 	List	   *processed_parsetree_list = NIL;
+	List	   *cache_relations = NIL;
+	bool		cache_rewrite;
 	ListCell   *parsetree_item;
+
+	/* A query rewritten before needs neither parsing nor rewriting */
+	processed_parsetree_list = GetCachedRewrite(query_string);
+	if (processed_parsetree_list != NIL)
+		return processed_parsetree_list;
 	/* MAYBMS END */
 
 	if (log_parser_stats)
@@ -575,6 +586,19 @@ pg_parse_query(const char *query_string)
 #endif
 
 	/* MAYBMS BEGIN */
+	/*
+	 * Keep the rewriting of a single query that MayBMS rewrites, but not of
+	 * CREATE TABLE AS.  The relations of the query are taken before the
+	 * rewriting changes it.
+	 */
+	cache_rewrite = list_length(raw_parsetree_list) == 1 &&
+		IsA(linitial(raw_parsetree_list), SelectStmt) &&
+		((SelectStmt *) linitial(raw_parsetree_list))->intoClause == NULL &&
+		requiresRewriting(linitial(raw_parsetree_list));
+
+	if (cache_rewrite)
+		cache_relations = GetRewriteRelations(linitial(raw_parsetree_list));
+
 	foreach(parsetree_item, raw_parsetree_list)
 	{		
 		Node	   *parsetree = (Node *) lfirst(parsetree_item);
@@ -585,6 +609,10 @@ pg_parse_query(const char *query_string)
 		processed_parsetree_list = lappend(processed_parsetree_list, parsetree);
 	}
 
+	if (cache_rewrite)
+		CacheRewrite(query_string, cache_relations,
+					 linitial(processed_parsetree_list));
+
 	return processed_parsetree_list;
 	/* MAYBMS END */
 }
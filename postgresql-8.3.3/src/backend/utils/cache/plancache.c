@@ -43,6 +43,9 @@
 #include "access/transam.h"
 #include "catalog/namespace.h"
 #include "executor/executor.h"
+/* MAYBMS BEGIN */
+#include "maybms/signature.h"
+/* MAYBMS END */
 #include "optimizer/clauses.h"
 #include "storage/lmgr.h"
 #include "tcop/pquery.h"
@@ -171,6 +174,9 @@ CreateCachedPlan(Node *raw_parse_tree,
 	plansource->plan = NULL;
 	plansource->context = source_context;
 	plansource->orig_plan = NULL;
+	/* MAYBMS BEGIN */
+	plansource->signature = GetParseTreeSignature(raw_parse_tree);
+	/* MAYBMS END */
 
 	/*
 	 * Copy the current output plans into the plancache entry.
@@ -253,6 +259,9 @@ FastCreateCachedPlan(Node *raw_parse_tree,
 	plansource->plan = NULL;
 	plansource->context = context;
 	plansource->orig_plan = NULL;
+	/* MAYBMS BEGIN */
+	plansource->signature = GetParseTreeSignature(raw_parse_tree);
+	/* MAYBMS END */
 
 	/*
 	 * Store the current output plans into the plancache entry.
@@ -358,6 +367,11 @@ DropCachedPlan(CachedPlanSource *plansource)
 	/* Remove it from the list */
 	cached_plans_list = list_delete_ptr(cached_plans_list, plansource);
 
+	/* MAYBMS BEGIN */
+	if (plansource->signature)
+		ReleaseSignature(plansource->signature);
+	/* MAYBMS END */
+
 	/* Decrement child CachePlan's refcount and drop if no longer needed */
 	if (plansource->plan)
 		ReleaseCachedPlan(plansource->plan, false);
@@ -400,6 +414,12 @@ RevalidateCachedPlan(CachedPlanSource *plansource, bool useResOwner)
 	/* Validity check that we were given a CachedPlanSource */
 	Assert(list_member_ptr(cached_plans_list, plansource));
 
+	/* MAYBMS BEGIN */
+	/* conf() of a hierarchical query computes in the signature of the query */
+	if (plansource->signature)
+		RestoreSignature(plansource->signature);
+	/* MAYBMS END */
+
 	/*
 	 * If the plan currently appears valid, acquire locks on the referenced
 	 * objects; then check again.  We need to do it this way to cover the race
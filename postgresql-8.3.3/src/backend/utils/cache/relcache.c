@@ -1797,6 +1797,10 @@ RelationClearRelation(Relation relation, bool rebuild)
 		pfree(relation->rd_rel);
 	if (relation->rd_options)
 		pfree(relation->rd_options);
+	/* MAYBMS BEGIN */
+	if (relation->rd_urelinfo)
+		pfree(relation->rd_urelinfo);
+	/* MAYBMS END */
 	list_free(relation->rd_indexlist);
 	bms_free(relation->rd_indexattr);
 	if (relation->rd_indexcxt)
@@ -3599,6 +3603,9 @@ load_relcache_init_file(void)
 		rel->rd_createSubid = InvalidSubTransactionId;
 		rel->rd_newRelfilenodeSubid = InvalidSubTransactionId;
 		rel->rd_amcache = NULL;
+		/* MAYBMS BEGIN */
+		rel->rd_urelinfo = NULL;
+		/* MAYBMS END */
 		MemSet(&rel->pgstat_info, 0, sizeof(rel->pgstat_info));
 
 		/*
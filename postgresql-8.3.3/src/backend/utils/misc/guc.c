@@ -67,6 +67,10 @@
 #include "utils/ps_status.h"
 #include "utils/tzparser.h"
 #include "utils/xml.h"
+/* MAYBMS BEGIN */
+#include "maybms/conf_cache.h"
+#include "maybms/localcond.h"
+/* MAYBMS END */
 
 #ifndef PG_KRB_SRVTAB
 #define PG_KRB_SRVTAB ""
@@ -1092,6 +1096,17 @@ static struct config_bool ConfigureNamesBool[] =
 		false, NULL, NULL
 	},
 
+	/* MAYBMS BEGIN */
+	{
+		{"conf_cache_stats", PGC_USERSET, STATS_MONITORING,
+			gettext_noop("Reports the component cache statistics of exact conf()."),
+			NULL
+		},
+		&conf_cache_stats,
+		false, NULL, NULL
+	},
+	/* MAYBMS END */
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, false, NULL, NULL
@@ -1774,6 +1789,49 @@ static struct config_int ConfigureNamesInt[] =
 		-1, -1, INT_MAX, NULL, NULL
 	},
 
+	/* MAYBMS BEGIN */
+	{
+		{"conf_cache_size", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory to be used for the component cache of exact conf()."),
+			gettext_noop("Zero disables the cache."),
+			GUC_UNIT_KB
+		},
+		&conf_cache_size,
+		1024, 0, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"conf_work_mem", PGC_USERSET, RESOURCES_MEM,
+			gettext_noop("Sets the maximum memory to be used for the lineage of a group in conf() and aconf()."),
+			gettext_noop("Larger lineage is written to temporary files and processed "
+						 "one set of independent components at a time."),
+			GUC_UNIT_KB
+		},
+		&conf_work_mem,
+		65536, 64, MAX_KILOBYTES, NULL, NULL
+	},
+
+	{
+		{"aconf_threads", PGC_USERSET, RESOURCES_KERNEL,
+			gettext_noop("Sets the number of threads computing the Monte Carlo estimates of aconf()."),
+			gettext_noop("The backend counts as one of them. Values above 1 need a platform "
+						 "with POSIX threads, otherwise the backend computes all estimates.")
+		},
+		&aconf_threads,
+		1, 1, 256, NULL, NULL
+	},
+
+	{
+		{"aconf_seed", PGC_USERSET, CLIENT_CONN_STATEMENT,
+			gettext_noop("Sets the seed of the random streams of aconf()."),
+			gettext_noop("aconf() returns the same result on the same lineage for the same seed, "
+						 "independently of aconf_threads.")
+		},
+		&aconf_seed,
+		0, 0, INT_MAX, NULL, NULL
+	},
+	/* MAYBMS END */
+
 	/* End-of-list marker */
 	{
 		{NULL, 0, 0, NULL, NULL}, NULL, 0, 0, 0, NULL, NULL
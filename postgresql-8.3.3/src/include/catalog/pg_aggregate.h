@@ -230,48 +230,18 @@ DATA(insert ( 2901 xmlconcat2	  -					0	142		_null_ ));
 
 DATA(insert ( 123456730	conf_accum0	conf_final		0	23	_null_ ));
 DATA(insert ( 123456732	conf_accum1	-		0	700	"0" ));
-DATA(insert ( 123456734	conf_accum2	conf_final		0	23	_null_ ));
-DATA(insert ( 123456736	conf_accum3	conf_final		0	23	_null_ ));
-DATA(insert ( 123456738	conf_accum4	conf_final		0	23	_null_ ));
-DATA(insert ( 123456740	conf_accum5	conf_final		0	23	_null_ ));
-DATA(insert ( 123456742	conf_accum6	conf_final		0	23	_null_ ));
-DATA(insert ( 123456744	conf_accum7	conf_final		0	23	_null_ ));
-DATA(insert ( 123456746	conf_accum8	conf_final		0	23	_null_ ));
-DATA(insert ( 123456748	conf_accum9	conf_final		0	23	_null_ ));
-DATA(insert ( 123456750	conf_accum10	conf_final		0	23	_null_ ));
-
-DATA(insert ( 123456801	conf_accum1_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456802	conf_accum2_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456803	conf_accum3_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456804	conf_accum4_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456805	conf_accum5_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456806	conf_accum6_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456807	conf_accum7_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456808	conf_accum8_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456809	conf_accum9_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456810	conf_accum10_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456811	conf_accum11_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456812	conf_accum12_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456813	conf_accum13_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456814	conf_accum14_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456815	conf_accum15_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456816	conf_accum16_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456817	conf_accum17_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456818	conf_accum18_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456819	conf_accum19_ge	conf_final_ge		0	23	_null_ ));
-DATA(insert ( 123456820	conf_accum20_ge	conf_final_ge		0	23	_null_ ));
+DATA(insert ( 123456752	conf_accum	conf_final		0	23	_null_ ));
+
+/*
+ * The transition functions of the aggregates of arrays and of a wsd share
+ * their names, so they are given by OID.
+ */
+DATA(insert ( 123456821	123456861	conf_final_ge		0	23	_null_ ));
+DATA(insert ( 123456822	123456862	conf_final_ge		0	23	_null_ ));
 
 DATA(insert ( 123456900	aconf_accum0	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456901	aconf_accum1	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456902	aconf_accum2	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456903	aconf_accum3	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456904	aconf_accum4	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456905	aconf_accum5	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456906	aconf_accum6	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456907	aconf_accum7	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456908	aconf_accum8	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456909	aconf_accum9	aconf_final		0	23	_null_ ));
-DATA(insert ( 123456910	aconf_accum10	aconf_final		0	23	_null_ ));
+DATA(insert ( 123456911	123456960	aconf_final		0	23	_null_ ));
+DATA(insert ( 123456912	123456961	aconf_final		0	23	_null_ ));
 
 /* functions related to argmax() */
 /*
@@ -301,16 +271,19 @@ DATA(insert ( 123459023	argmax_int4_int4_accum	-		    0	 23	_null_ ));
 DATA(insert ( 123459024	argmax_int4_int8_accum	-		    0	 23	_null_ ));
 
 
-DATA(insert ( 123460001	conf_appro_accum1_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460002	conf_appro_accum2_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460003	conf_appro_accum3_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460004	conf_appro_accum4_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460005	conf_appro_accum5_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460006	conf_appro_accum6_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460007	conf_appro_accum7_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460008	conf_appro_accum8_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460009	conf_appro_accum9_ge	conf_appro_final_ge		0	23	_null_ ));
-DATA(insert ( 123460010	conf_appro_accum10_ge	conf_appro_final_ge		0	23	_null_ ));
+DATA(insert ( 123460011	123460111	conf_appro_final_ge		0	23	_null_ ));
+DATA(insert ( 123460012	123460112	conf_appro_final_ge		0	23	_null_ ));
+
+/*
+ * The confidence aggregates that keep the lineage of a group of duplicates in
+ * memory until the group is finalized: conf() of hierarchical queries, conf()
+ * and aconf() of U-relations and the approximate conf().
+ */
+#define IsLineageAggregate(aggfnoid) \
+	((aggfnoid) == 123456752 || (aggfnoid) == 123456821 || \
+	 (aggfnoid) == 123456822 || (aggfnoid) == 123456900 || \
+	 (aggfnoid) == 123456911 || (aggfnoid) == 123456912 || \
+	 (aggfnoid) == 123460011 || (aggfnoid) == 123460012)
 
 /* MAYBMS END */
 
@@ -941,6 +941,14 @@ DATA(insert OID = 3694 (  "<@"	   PGNSP PGUID b f f 3615	 3615	 16 3693	0	 tsq_m
 DATA(insert OID = 3762 (  "@@"	   PGNSP PGUID b f f 25		 25		 16    0	0	 ts_match_tt	contsel    contjoinsel	 ));
 DATA(insert OID = 3763 (  "@@"	   PGNSP PGUID b f f 25		 3615	 16    0	0	 ts_match_tq	contsel    contjoinsel	 ));
 
+/* MAYBMS BEGIN */
+/* wsd operators */
+DATA(insert OID = 123461010 (  "&&"	   PGNSP PGUID b f f 123461000 123461000 123461000 123461010 0 wsd_and - - ));
+/* wsd_consistent is overloaded, so the functions are given by OID */
+DATA(insert OID = 123461011 (  "&?"	   PGNSP PGUID b f f 123461000 123461000 16 123461011 0 123461005 wsdconsistentsel wsdconsistentjoinsel ));
+DATA(insert OID = 123461012 (  "&?"	   PGNSP PGUID b f f 1007 1007 16 123461012 0 123461007 wsdconsistentsel wsdconsistentjoinsel ));
+/* MAYBMS END */
+
 
 /*
  * function prototypes
@@ -4428,43 +4428,18 @@ DATA(insert OID = 123457999 (  test_negative		   PGNSP PGUID 12 1 0 f f t f i 1
 /****************************** Functions related to tconf() **********************************************************/
 
 /* 00 - 100*/
-DATA(insert OID = 123458000 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 0 700 "" _null_ _null_ _null_	product0 - _null_ _null_ ));
-DATA(insert OID = 123458001 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 1 700 "700" _null_ _null_ _null_	product1 - _null_ _null_ ));
-DATA(insert OID = 123458002 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 2 700 "700 700" _null_ _null_ _null_	product2 - _null_ _null_ ));
-DATA(insert OID = 123458003 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 3 700 "700 700 700" _null_ _null_ _null_	product3 - _null_ _null_ ));
-DATA(insert OID = 123458004 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 4 700 "700 700 700 700" _null_ _null_ _null_	product4 - _null_ _null_ ));
-DATA(insert OID = 123458005 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 5 700 "700 700 700 700 700" _null_ _null_ _null_	product5 - _null_ _null_ ));
-DATA(insert OID = 123458006 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 6 700 "700 700 700 700 700 700" _null_ _null_ _null_	product6 - _null_ _null_ ));
-DATA(insert OID = 123458007 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 7 700 "700 700 700 700 700 700 700" _null_ _null_ _null_	product7 - _null_ _null_ ));
-DATA(insert OID = 123458008 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 8 700 "700 700 700 700 700 700 700 700" _null_ _null_ _null_	product8 - _null_ _null_ ));
-DATA(insert OID = 123458009 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 9 700 "700 700 700 700 700 700 700 700 700" _null_ _null_ _null_	product9 - _null_ _null_ ));
-DATA(insert OID = 123458010 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 10 700 "700 700 700 700 700 700 700 700 700 700" _null_ _null_ _null_	product10 - _null_ _null_ ));
+DATA(insert OID = 123458000 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 0 700 "" _null_ _null_ _null_	product - _null_ _null_ ));
+DATA(insert OID = 123458011 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 1 700 "1021" _null_ _null_ _null_	product - _null_ _null_ ));
 
 /* 201 - 300*/
-DATA(insert OID = 123458201 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 3 700 "23 23 700" _null_ _null_ _null_	product1_ge - _null_ _null_ ));
-DATA(insert OID = 123458202 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 6 700 "23 23 700 23 23 700" _null_ _null_ _null_	product2_ge - _null_ _null_ ));
-DATA(insert OID = 123458203 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 9 700 "23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product3_ge - _null_ _null_ ));
-DATA(insert OID = 123458204 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 12 700 "23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product4_ge - _null_ _null_ ));
-DATA(insert OID = 123458205 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 15 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product5_ge - _null_ _null_ ));
-DATA(insert OID = 123458206 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 18 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product6_ge - _null_ _null_ ));
-DATA(insert OID = 123458207 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 21 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product7_ge - _null_ _null_ ));
-DATA(insert OID = 123458208 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 24 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product8_ge - _null_ _null_ ));
-DATA(insert OID = 123458209 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 27 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product9_ge - _null_ _null_ ));
-DATA(insert OID = 123458210 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 30 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_	product10_ge - _null_ _null_ ));
+DATA(insert OID = 123458211 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 3 700 "1007 1007 1021" _null_ _null_ _null_	product_ge - _null_ _null_ ));
+DATA(insert OID = 123458212 (  tconf		   PGNSP PGUID 12 1 0 f f t f i 4 700 "1007 1007 1021 1021" _null_ _null_ _null_	product_ge - _null_ _null_ ));
 /****************************** Functions related to conf() **********************************************************/
 
 /* 30 - 50 */
 DATA(insert OID = 123456730 (  conf				PGNSP PGUID 12 1 0 t f f f i 0 700 "" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
 DATA(insert OID = 123456732 (  conf				PGNSP PGUID 12 1 0 t f f f i 2 700 "23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456734 (  conf				PGNSP PGUID 12 1 0 t f f f i 4 700 "23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456736 (  conf				PGNSP PGUID 12 1 0 t f f f i 6 700 "23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456738 (  conf				PGNSP PGUID 12 1 0 t f f f i 8 700 "23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456740 (  conf				PGNSP PGUID 12 1 0 t f f f i 10 700 "23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456742 (  conf				PGNSP PGUID 12 1 0 t f f f i 12 700 "23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456744 (  conf				PGNSP PGUID 12 1 0 t f f f i 14 700 "23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456746 (  conf				PGNSP PGUID 12 1 0 t f f f i 16 700 "23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456748 (  conf				PGNSP PGUID 12 1 0 t f f f i 18 700 "23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456750 (  conf				PGNSP PGUID 12 1 0 t f f f i 20 700 "23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123456752 (  conf				PGNSP PGUID 12 1 0 t f f f i 2 700 "1007 1021" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
 
 /* 60 - 80: 
 	The first argument is a pointer. 
@@ -4473,62 +4448,18 @@ DATA(insert OID = 123456750 (  conf				PGNSP PGUID 12 1 0 t f f f i 20 700 "23 7
 	Please note that the transacion state is stored in AggState. */
 DATA(insert OID = 123456760 (  conf_accum0				PGNSP PGUID 12 1 0 f f f f i 1 23 "23" _null_ _null_ _null_  conf_accum0 - _null_ _null_ ));
 DATA(insert OID = 123456762 (  conf_accum1				PGNSP PGUID 12 1 0 f f f f i 3 700 "700 23 700" _null_ _null_ _null_  conf_accum1 - _null_ _null_ ));
-DATA(insert OID = 123456764 (  conf_accum2				PGNSP PGUID 12 1 0 f f f f i 5 23 "23 23 700 23 700" _null_ _null_ _null_  conf_accum2 - _null_ _null_ ));
-DATA(insert OID = 123456766 (  conf_accum3				PGNSP PGUID 12 1 0 f f f f i 7 23 "23 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum3 - _null_ _null_ ));
-DATA(insert OID = 123456768 (  conf_accum4				PGNSP PGUID 12 1 0 f f f f i 9 23 "23 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum4 - _null_ _null_ ));
-DATA(insert OID = 123456770 (  conf_accum5				PGNSP PGUID 12 1 0 f f f f i 11 23 "23 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum5 - _null_ _null_ ));
-DATA(insert OID = 123456772 (  conf_accum6				PGNSP PGUID 12 1 0 f f f f i 13 23 "23 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum6 - _null_ _null_ ));
-DATA(insert OID = 123456774 (  conf_accum7				PGNSP PGUID 12 1 0 f f f f i 15 23 "23 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum7 - _null_ _null_ ));
-DATA(insert OID = 123456776 (  conf_accum8				PGNSP PGUID 12 1 0 f f f f i 17 23 "23 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum8 - _null_ _null_ ));
-DATA(insert OID = 123456778 (  conf_accum9				PGNSP PGUID 12 1 0 f f f f i 19 23 "23 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum9 - _null_ _null_ ));
-DATA(insert OID = 123456780 (  conf_accum10				PGNSP PGUID 12 1 0 f f f f i 21 23 "23 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700 23 700" _null_ _null_ _null_  conf_accum10 - _null_ _null_ ));
+DATA(insert OID = 123456782 (  conf_accum				PGNSP PGUID 12 1 0 f f f f i 3 23 "23 1007 1021" _null_ _null_ _null_  conf_accum - _null_ _null_ ));
 
 /* 91 - 100: ONLY NEED ONE FINAL FUNCTION */
 DATA(insert OID = 123456791 (  conf_final				PGNSP PGUID 12 1 0 f f f f i 1 700 "23" _null_ _null_ _null_  conf_final - _null_ _null_ ));
 
 /* 801 - 840 */
-DATA(insert OID = 123456801 (  conf				PGNSP PGUID 12 1 0 t f f f i 3 700 "23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456802 (  conf				PGNSP PGUID 12 1 0 t f f f i 6 700 "23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456803 (  conf				PGNSP PGUID 12 1 0 t f f f i 9 700 "23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456804 (  conf				PGNSP PGUID 12 1 0 t f f f i 12 700 "23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456805 (  conf				PGNSP PGUID 12 1 0 t f f f i 15 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456806 (  conf				PGNSP PGUID 12 1 0 t f f f i 18 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456807 (  conf				PGNSP PGUID 12 1 0 t f f f i 21 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456808 (  conf				PGNSP PGUID 12 1 0 t f f f i 24 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456809 (  conf				PGNSP PGUID 12 1 0 t f f f i 27 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456810 (  conf				PGNSP PGUID 12 1 0 t f f f i 30 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456811 (  conf				PGNSP PGUID 12 1 0 t f f f i 33 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456812 (  conf				PGNSP PGUID 12 1 0 t f f f i 36 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456813 (  conf				PGNSP PGUID 12 1 0 t f f f i 39 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456814 (  conf				PGNSP PGUID 12 1 0 t f f f i 42 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456815 (  conf				PGNSP PGUID 12 1 0 t f f f i 45 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456816 (  conf				PGNSP PGUID 12 1 0 t f f f i 48 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456817 (  conf				PGNSP PGUID 12 1 0 t f f f i 51 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456818 (  conf				PGNSP PGUID 12 1 0 t f f f i 54 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456819 (  conf				PGNSP PGUID 12 1 0 t f f f i 57 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456820 (  conf				PGNSP PGUID 12 1 0 t f f f i 60 700 "23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123456821 (  conf				PGNSP PGUID 12 1 0 t f f f i 3 700 "1007 1007 1021" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123456822 (  conf				PGNSP PGUID 12 1 0 t f f f i 1 700 "123461000" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
 
 /* 841 - 880 */
-DATA(insert OID = 123456841 (  conf_accum1_ge				PGNSP PGUID 12 1 0 f f f f i 4 23 "23 23 23 700" _null_ _null_ _null_  conf_accum1_ge - _null_ _null_ ));
-DATA(insert OID = 123456842 (  conf_accum2_ge				PGNSP PGUID 12 1 0 f f f f i 7 23 "23 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum2_ge - _null_ _null_ ));
-DATA(insert OID = 123456843 (  conf_accum3_ge				PGNSP PGUID 12 1 0 f f f f i 10 23 "23 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum3_ge - _null_ _null_ ));
-DATA(insert OID = 123456844 (  conf_accum4_ge				PGNSP PGUID 12 1 0 f f f f i 13 23 "23 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum4_ge - _null_ _null_ ));
-DATA(insert OID = 123456845 (  conf_accum5_ge				PGNSP PGUID 12 1 0 f f f f i 16 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum5_ge - _null_ _null_ ));
-DATA(insert OID = 123456846 (  conf_accum6_ge				PGNSP PGUID 12 1 0 f f f f i 19 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum6_ge - _null_ _null_ ));
-DATA(insert OID = 123456847 (  conf_accum7_ge				PGNSP PGUID 12 1 0 f f f f i 22 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum7_ge - _null_ _null_ ));
-DATA(insert OID = 123456848 (  conf_accum8_ge				PGNSP PGUID 12 1 0 f f f f i 25 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum8_ge - _null_ _null_ ));
-DATA(insert OID = 123456849 (  conf_accum9_ge				PGNSP PGUID 12 1 0 f f f f i 28 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum9_ge - _null_ _null_ ));
-DATA(insert OID = 123456850 (  conf_accum10_ge				PGNSP PGUID 12 1 0 f f f f i 31 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum10_ge - _null_ _null_ ));
-DATA(insert OID = 123456851 (  conf_accum11_ge				PGNSP PGUID 12 1 0 f f f f i 34 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum11_ge - _null_ _null_ ));
-DATA(insert OID = 123456852 (  conf_accum12_ge				PGNSP PGUID 12 1 0 f f f f i 37 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum12_ge - _null_ _null_ ));
-DATA(insert OID = 123456853 (  conf_accum13_ge				PGNSP PGUID 12 1 0 f f f f i 40 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum13_ge - _null_ _null_ ));
-DATA(insert OID = 123456854 (  conf_accum14_ge				PGNSP PGUID 12 1 0 f f f f i 43 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum14_ge - _null_ _null_ ));
-DATA(insert OID = 123456855 (  conf_accum15_ge				PGNSP PGUID 12 1 0 f f f f i 46 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum15_ge - _null_ _null_ ));
-DATA(insert OID = 123456856 (  conf_accum16_ge				PGNSP PGUID 12 1 0 f f f f i 49 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum16_ge - _null_ _null_ ));
-DATA(insert OID = 123456857 (  conf_accum17_ge				PGNSP PGUID 12 1 0 f f f f i 52 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum17_ge - _null_ _null_ ));
-DATA(insert OID = 123456858 (  conf_accum18_ge				PGNSP PGUID 12 1 0 f f f f i 55 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum18_ge - _null_ _null_ ));
-DATA(insert OID = 123456859 (  conf_accum19_ge				PGNSP PGUID 12 1 0 f f f f i 58 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum19_ge - _null_ _null_ ));
-DATA(insert OID = 123456860 (  conf_accum20_ge				PGNSP PGUID 12 1 0 f f f f i 61 23 "23 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_accum20_ge - _null_ _null_ ));
+DATA(insert OID = 123456861 (  conf_accum_ge				PGNSP PGUID 12 1 0 f f f f i 4 23 "23 1007 1007 1021" _null_ _null_ _null_  conf_accum_ge - _null_ _null_ ));
+DATA(insert OID = 123456862 (  conf_accum_ge				PGNSP PGUID 12 1 0 f f f f i 2 23 "23 123461000" _null_ _null_ _null_  conf_accum_ge - _null_ _null_ ));
 
 /* 891 - 900: ONLY NEED ONE FINAL FUNCTION */
 DATA(insert OID = 123456891 (  conf_final_ge				PGNSP PGUID 12 1 0 f f f f i 1 700 "23" _null_ _null_ _null_  conf_final_ge - _null_ _null_ ));
@@ -4537,29 +4468,13 @@ DATA(insert OID = 123456891 (  conf_final_ge				PGNSP PGUID 12 1 0 f f f f i 1 7
 
 /* 900 - 950: aggregate aconf() */
 DATA(insert OID = 123456900 (  aconf				PGNSP PGUID 12 1 0 t f f f i 2 700 "700 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456901 (  aconf				PGNSP PGUID 12 1 0 t f f f i 5 700 "700 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456902 (  aconf				PGNSP PGUID 12 1 0 t f f f i 8 700 "700 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456903 (  aconf				PGNSP PGUID 12 1 0 t f f f i 11 700 "700 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456904 (  aconf				PGNSP PGUID 12 1 0 t f f f i 14 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456905 (  aconf				PGNSP PGUID 12 1 0 t f f f i 17 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456906 (  aconf				PGNSP PGUID 12 1 0 t f f f i 20 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456907 (  aconf				PGNSP PGUID 12 1 0 t f f f i 23 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456908 (  aconf				PGNSP PGUID 12 1 0 t f f f i 26 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456909 (  aconf				PGNSP PGUID 12 1 0 t f f f i 29 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123456910 (  aconf				PGNSP PGUID 12 1 0 t f f f i 32 700 "700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123456911 (  aconf				PGNSP PGUID 12 1 0 t f f f i 5 700 "700 700 1007 1007 1021" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123456912 (  aconf				PGNSP PGUID 12 1 0 t f f f i 3 700 "700 700 123461000" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
 
 /* 951 - 999: state functions aconf_accum for aconf() */
 DATA(insert OID = 123456950 (  aconf_accum0				PGNSP PGUID 12 1 0 f f f f i 3 23 "23 700 700" _null_ _null_ _null_  aconf_accum0 - _null_ _null_ ));
-DATA(insert OID = 123456951 (  aconf_accum1				PGNSP PGUID 12 1 0 f f f f i 6 23 "23 700 700 23 23 700" _null_ _null_ _null_  aconf_accum1 - _null_ _null_ ));
-DATA(insert OID = 123456952 (  aconf_accum2				PGNSP PGUID 12 1 0 f f f f i 9 23 "23 700 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum2 - _null_ _null_ ));
-DATA(insert OID = 123456953 (  aconf_accum3				PGNSP PGUID 12 1 0 f f f f i 12 23 "23 700 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum3 - _null_ _null_ ));
-DATA(insert OID = 123456954 (  aconf_accum4				PGNSP PGUID 12 1 0 f f f f i 15 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum4 - _null_ _null_ ));
-DATA(insert OID = 123456955 (  aconf_accum5				PGNSP PGUID 12 1 0 f f f f i 18 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum5 - _null_ _null_ ));
-DATA(insert OID = 123456956 (  aconf_accum6				PGNSP PGUID 12 1 0 f f f f i 21 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum6 - _null_ _null_ ));
-DATA(insert OID = 123456957 (  aconf_accum7				PGNSP PGUID 12 1 0 f f f f i 24 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum7 - _null_ _null_ ));
-DATA(insert OID = 123456958 (  aconf_accum8				PGNSP PGUID 12 1 0 f f f f i 27 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum8 - _null_ _null_ ));
-DATA(insert OID = 123456959 (  aconf_accum9				PGNSP PGUID 12 1 0 f f f f i 30 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum9 - _null_ _null_ ));
-DATA(insert OID = 1234569510 (  aconf_accum10				PGNSP PGUID 12 1 0 f f f f i 33 23 "23 700 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aconf_accum10 - _null_ _null_ ));
+DATA(insert OID = 123456960 (  aconf_accum				PGNSP PGUID 12 1 0 f f f f i 6 23 "23 700 700 1007 1007 1021" _null_ _null_ _null_  aconf_accum - _null_ _null_ ));
+DATA(insert OID = 123456961 (  aconf_accum				PGNSP PGUID 12 1 0 f f f f i 4 23 "23 700 700 123461000" _null_ _null_ _null_  aconf_accum - _null_ _null_ ));
 
 /* 7000: ONLY NEED ONE FINAL FUNCTION. final function aconf_final for aconf */
 DATA(insert OID = 123457000 (  aconf_final				PGNSP PGUID 12 1 0 f f f f i 1 700 "23" _null_ _null_ _null_  aconf_final - _null_ _null_ ));
@@ -4610,33 +4525,45 @@ DATA(insert OID = 123459524 (  argmax_int4_int8_accum				PGNSP PGUID 12 1 0 f f
 
 
 /* 801 - 840 */
-DATA(insert OID = 123460001 (  conf				PGNSP PGUID 12 1 0 t f f f i 5 700 "1043 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460002 (  conf				PGNSP PGUID 12 1 0 t f f f i 8 700 "1043 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460003 (  conf				PGNSP PGUID 12 1 0 t f f f i 11 700 "1043 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460004 (  conf				PGNSP PGUID 12 1 0 t f f f i 14 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460005 (  conf				PGNSP PGUID 12 1 0 t f f f i 17 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460006 (  conf				PGNSP PGUID 12 1 0 t f f f i 20 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460007 (  conf				PGNSP PGUID 12 1 0 t f f f i 23 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460008 (  conf				PGNSP PGUID 12 1 0 t f f f i 26 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460009 (  conf				PGNSP PGUID 12 1 0 t f f f i 29 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
-DATA(insert OID = 123460010 (  conf				PGNSP PGUID 12 1 0 t f f f i 32 700 "1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123460011 (  conf				PGNSP PGUID 12 1 0 t f f f i 5 700 "1043 700 1007 1007 1021" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
+DATA(insert OID = 123460012 (  conf				PGNSP PGUID 12 1 0 t f f f i 3 700 "1043 700 123461000" _null_ _null_ _null_  aggregate_dummy - _null_ _null_ ));
 
 /* 841 - 880 */
-DATA(insert OID = 123460101 (  conf_appro_accum1_ge				PGNSP PGUID 12 1 0 f f f f i 6 23 "23 1043 700 23 23 700" _null_ _null_ _null_  conf_appro_accum1_ge - _null_ _null_ ));
-DATA(insert OID = 123460102 (  conf_appro_accum2_ge				PGNSP PGUID 12 1 0 f f f f i 9 23 "23 1043 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum2_ge - _null_ _null_ ));
-DATA(insert OID = 123460103 (  conf_appro_accum3_ge				PGNSP PGUID 12 1 0 f f f f i 12 23 "23 1043 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum3_ge - _null_ _null_ ));
-DATA(insert OID = 123460104 (  conf_appro_accum4_ge				PGNSP PGUID 12 1 0 f f f f i 15 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum4_ge - _null_ _null_ ));
-DATA(insert OID = 123460105 (  conf_appro_accum5_ge				PGNSP PGUID 12 1 0 f f f f i 18 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum5_ge - _null_ _null_ ));
-DATA(insert OID = 123460106 (  conf_appro_accum6_ge				PGNSP PGUID 12 1 0 f f f f i 21 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum6_ge - _null_ _null_ ));
-DATA(insert OID = 123460107 (  conf_appro_accum7_ge				PGNSP PGUID 12 1 0 f f f f i 24 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum7_ge - _null_ _null_ ));
-DATA(insert OID = 123460108 (  conf_appro_accum8_ge				PGNSP PGUID 12 1 0 f f f f i 27 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum8_ge - _null_ _null_ ));
-DATA(insert OID = 123460109 (  conf_appro_accum9_ge				PGNSP PGUID 12 1 0 f f f f i 30 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum9_ge - _null_ _null_ ));
-DATA(insert OID = 123460110 (  conf_appro_accum10_ge				PGNSP PGUID 12 1 0 f f f f i 33 23 "23 1043 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700 23 23 700" _null_ _null_ _null_  conf_appro_accum10_ge - _null_ _null_ ));
+DATA(insert OID = 123460111 (  conf_appro_accum_ge				PGNSP PGUID 12 1 0 f f f f i 6 23 "23 1043 700 1007 1007 1021" _null_ _null_ _null_  conf_appro_accum_ge - _null_ _null_ ));
+DATA(insert OID = 123460112 (  conf_appro_accum_ge				PGNSP PGUID 12 1 0 f f f f i 4 23 "23 1043 700 123461000" _null_ _null_ _null_  conf_appro_accum_ge - _null_ _null_ ));
 
 
 /* 891 - 900: ONLY NEED ONE FINAL FUNCTION */
 DATA(insert OID = 123460201 (  conf_appro_final_ge				PGNSP PGUID 12 1 0 f f f f i 1 700 "23" _null_ _null_ _null_  conf_appro_final_ge - _null_ _null_ ));
 
+/****************************** Functions related to the type wsd **********************************************************/
+
+DATA(insert OID = 123461001 (  wsd_in				PGNSP PGUID 12 1 0 f f t f i 1 123461000 "2275" _null_ _null_ _null_  wsd_in - _null_ _null_ ));
+DESCR("I/O");
+DATA(insert OID = 123461002 (  wsd_out				PGNSP PGUID 12 1 0 f f t f i 1 2275 "123461000" _null_ _null_ _null_  wsd_out - _null_ _null_ ));
+DESCR("I/O");
+DATA(insert OID = 123461003 (  wsd				PGNSP PGUID 12 1 0 f f t f i 3 123461000 "1007 1007 1021" _null_ _null_ _null_  wsd_make - _null_ _null_ ));
+DESCR("world-set descriptor of condition columns");
+DATA(insert OID = 123461004 (  wsd_and				PGNSP PGUID 12 1 0 f f t f i 2 123461000 "123461000 123461000" _null_ _null_ _null_  wsd_and - _null_ _null_ ));
+DESCR("conjunction of world-set descriptors");
+DATA(insert OID = 123461005 (  wsd_consistent				PGNSP PGUID 12 1 0 f f t f i 2 16 "123461000 123461000" _null_ _null_ _null_  wsd_consistent - _null_ _null_ ));
+DESCR("world-set descriptors are consistent");
+DATA(insert OID = 123461006 (  wsd_prob				PGNSP PGUID 12 1 0 f f t f i 1 700 "123461000" _null_ _null_ _null_  wsd_prob - _null_ _null_ ));
+DESCR("probability of world-set descriptor");
+DATA(insert OID = 123461007 (  wsd_consistent				PGNSP PGUID 12 1 0 f f t f i 2 16 "1007 1007" _null_ _null_ _null_  wsd_consistent_arrays - _null_ _null_ ));
+DESCR("conditions of two tuples of urelations are consistent");
+DATA(insert OID = 123461008 (  wsdconsistentsel				PGNSP PGUID 12 1 0 f f t f s 4 701 "2281 26 2281 23" _null_ _null_ _null_  wsdconsistentsel - _null_ _null_ ));
+DESCR("restriction selectivity of consistency check");
+DATA(insert OID = 123461009 (  wsdconsistentjoinsel				PGNSP PGUID 12 1 0 f f t f s 4 701 "2281 26 2281 21" _null_ _null_ _null_  wsdconsistentjoinsel - _null_ _null_ ));
+DESCR("join selectivity of consistency check");
+
+/****************************** Variable and domain IDs **********************************************************/
+
+DATA(insert OID = 123461020 (  nextid				PGNSP PGUID 12 1 0 f f t f v 1 20 "2205" _null_ _null_ _null_  nextid_oid - _null_ _null_ ));
+DESCR("sequence next value, reserved in blocks per backend");
+DATA(insert OID = 123461021 (  keyhash				PGNSP PGUID 12 1 0 f f f f i 2 23 "23 2283" _null_ _null_ _null_  keyhash - _null_ _null_ ));
+DESCR("combine a hash value with the hash of a key");
+
 
 
 /* MAYBMS END */
@@ -576,6 +576,12 @@ DATA(insert OID = 2970 ( txid_snapshot	PGNSP PGUID -1 f b t \054 0 0 2949 txid_s
 DESCR("txid snapshot");
 DATA(insert OID = 2949 ( _txid_snapshot PGNSP PGUID -1 f b t \054 0 2970 0 array_in array_out array_recv array_send - - - d x f 0 -1 0 _null_ _null_ ));
 
+/* MAYBMS BEGIN */
+DATA(insert OID = 123461000 ( wsd		PGNSP PGUID -1 f b t \054 0 0 0 wsd_in wsd_out - - - - - i x f 0 -1 0 _null_ _null_ ));
+DESCR("world-set descriptor, the condition of a tuple of a U-relation");
+#define WSDOID			123461000
+/* MAYBMS END */
+
 /*
  * pseudo-types
  *
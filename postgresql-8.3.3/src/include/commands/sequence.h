@@ -83,6 +83,9 @@ typedef struct xl_seq_rec
 
 extern Datum nextval(PG_FUNCTION_ARGS);
 extern Datum nextval_oid(PG_FUNCTION_ARGS);
+/* MAYBMS BEGIN */
+extern Datum nextid_oid(PG_FUNCTION_ARGS);
+/* MAYBMS END */
 extern Datum currval_oid(PG_FUNCTION_ARGS);
 extern Datum setval_oid(PG_FUNCTION_ARGS);
 extern Datum setval3_oid(PG_FUNCTION_ARGS);
@@ -0,0 +1,22 @@
+/*-------------------------------------------------------------------------
+ *
+ * nodeRepairKey.h
+ *
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+#ifndef NODEREPAIRKEY_H
+#define NODEREPAIRKEY_H
+
+#include "nodes/execnodes.h"
+
+extern int	ExecCountSlotsRepairKey(RepairKey *node);
+extern RepairKeyState *ExecInitRepairKey(RepairKey *node, EState *estate, int eflags);
+extern TupleTableSlot *ExecRepairKey(RepairKeyState *node);
+extern void ExecEndRepairKey(RepairKeyState *node);
+extern void ExecReScanRepairKey(RepairKeyState *node, ExprContext *exprCtxt);
+
+#endif   /* NODEREPAIRKEY_H */
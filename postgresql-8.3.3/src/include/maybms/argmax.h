@@ -12,6 +12,9 @@
 /* warning function for negative weight */
 extern Datum test_negative(PG_FUNCTION_ARGS);
 extern Datum test_from_0_to_1(PG_FUNCTION_ARGS);
+
+/* hash of the key of a repair-key partition */
+extern Datum keyhash(PG_FUNCTION_ARGS);
  
 /* varchar */
 extern Datum argmax_varchar_float4_accum(PG_FUNCTION_ARGS);
@@ -20,6 +20,14 @@ typedef struct {
 	size_t nbits;
 } bitset;
 
+/* A pool of free bitsets of the same size */
+typedef struct bitset_pool {
+	bitset **free;
+	int free_count;
+	int free_max;
+	size_t nbits;
+} bitset_pool;
+
 bitset *bitset_init(size_t nbits);
 void bitset_union(bitset *set1, bitset *set2);
 void bitset_subtract(bitset *from_set, bitset *what);
@@ -32,11 +40,16 @@ void bitset_copy(bitset *from, bitset *to);
 void bitset_free(bitset *set);
 void bitset_print(bitset *set);
 
+bitset_pool *bitset_pool_init(size_t nbits);
+bitset *bitset_pool_get(bitset_pool *pool);
+void bitset_pool_put(bitset_pool *pool, bitset *set);
+
 void bitset_clear_bit(bitset *set, size_t pos);
 void bitset_set_bit(bitset *set, size_t pos);
 int bitset_test_bit(bitset *set, size_t pos);
 int bitset_test_singleton(bitset *set);
 int bitset_first_bit_set(bitset *set);
+int bitset_next_bit_set(bitset *set, size_t from);
 int bitset_test_empty(bitset *set);
 
 #endif
@@ -0,0 +1,22 @@
+/*-------------------------------------------------------------------------
+ *
+ * condvec.h
+ *	  Reading the condition columns passed to tconf(), conf() and aconf().
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef CONDVEC_H_
+#define CONDVEC_H_
+
+#include "fmgr.h"
+#include "maybms/signature.h"
+
+extern int getCondColumns(FunctionCallInfo fcinfo, int narg, varType **vars,
+						  rngType **rngs, prob **probs);
+extern int getCondProbs(FunctionCallInfo fcinfo, int narg, prob **probs);
+
+#endif /* CONDVEC_H_ */
@@ -0,0 +1,59 @@
+/*-------------------------------------------------------------------------
+ *
+ * conf_cache.h
+ *	  	Component cache for exact confidence computation in conf().
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef _CONF_CACHE_H_
+#define _CONF_CACHE_H_
+
+#include "maybms/bitset.h"
+#include "nodes/execnodes.h"
+
+/* GUC variables */
+extern int conf_cache_size;
+extern bool conf_cache_stats;
+
+/*
+ * An entry of the component cache. The key lists the clauses of a component
+ * in increasing order, each followed by the negated (1-based) columns of its
+ * temporarily dropped mappings.
+ */
+typedef struct compCacheEntry
+{
+	uint32 hash;
+	int keylen;
+	int *key;
+	prob prob;
+	struct compCacheEntry *next;		/* next entry in the same bucket */
+	struct compCacheEntry *lru_prev;	/* more recently used entry */
+	struct compCacheEntry *lru_next;	/* less recently used entry */
+} compCacheEntry;
+
+typedef struct compCache
+{
+	compCacheEntry **buckets;
+	int nbuckets;
+	int entry_count;
+	compCacheEntry *lru_head;
+	compCacheEntry *lru_tail;
+	Size used;					/* bytes used by the entries */
+	Size budget;				/* maximal bytes used by the entries */
+	int *keybuf;				/* scratch space for building keys */
+	int keybuf_max;
+	long hits;
+	long misses;
+	long evictions;
+} compCache;
+
+extern compCache *compCacheInit(generalState *state);
+extern bool compCacheLookup(generalState *state, bitset *set, prob *result, compCacheEntry **pending);
+extern void compCacheInsert(generalState *state, compCacheEntry *entry, prob result);
+extern void compCacheReport(compCache *cache, const char *func);
+
+#endif
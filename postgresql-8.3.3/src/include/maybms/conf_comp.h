@@ -11,80 +11,24 @@
  
 /****************************** Functions related to tconf() **********************************************************/
 
-extern Datum product0(PG_FUNCTION_ARGS);
-extern Datum product1(PG_FUNCTION_ARGS);
-extern Datum product2(PG_FUNCTION_ARGS);
-extern Datum product3(PG_FUNCTION_ARGS);
-extern Datum product4(PG_FUNCTION_ARGS);
-extern Datum product5(PG_FUNCTION_ARGS);
-extern Datum product6(PG_FUNCTION_ARGS);
-extern Datum product7(PG_FUNCTION_ARGS);
-extern Datum product8(PG_FUNCTION_ARGS);
-extern Datum product9(PG_FUNCTION_ARGS);
-extern Datum product10(PG_FUNCTION_ARGS);
-
-extern Datum product1_ge(PG_FUNCTION_ARGS);
-extern Datum product2_ge(PG_FUNCTION_ARGS);
-extern Datum product3_ge(PG_FUNCTION_ARGS);
-extern Datum product4_ge(PG_FUNCTION_ARGS);
-extern Datum product5_ge(PG_FUNCTION_ARGS);
-extern Datum product6_ge(PG_FUNCTION_ARGS);
-extern Datum product7_ge(PG_FUNCTION_ARGS);
-extern Datum product8_ge(PG_FUNCTION_ARGS);
-extern Datum product9_ge(PG_FUNCTION_ARGS);
-extern Datum product10_ge(PG_FUNCTION_ARGS);
+extern Datum product(PG_FUNCTION_ARGS);
+extern Datum product_ge(PG_FUNCTION_ARGS);
 /****************************** Functions related to conf() **********************************************************/
 
 extern Datum conf_accum0(PG_FUNCTION_ARGS);
 extern Datum conf_accum1(PG_FUNCTION_ARGS);
-extern Datum conf_accum2(PG_FUNCTION_ARGS);
-extern Datum conf_accum3(PG_FUNCTION_ARGS);
-extern Datum conf_accum4(PG_FUNCTION_ARGS);
-extern Datum conf_accum5(PG_FUNCTION_ARGS);
-extern Datum conf_accum6(PG_FUNCTION_ARGS);
-extern Datum conf_accum7(PG_FUNCTION_ARGS);
-extern Datum conf_accum8(PG_FUNCTION_ARGS);
-extern Datum conf_accum9(PG_FUNCTION_ARGS);
-extern Datum conf_accum10(PG_FUNCTION_ARGS);
+extern Datum conf_accum(PG_FUNCTION_ARGS);
 
 extern Datum conf_final(PG_FUNCTION_ARGS);
 
-extern Datum conf_accum1_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum2_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum3_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum4_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum5_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum6_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum7_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum8_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum9_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum10_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum11_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum12_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum13_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum14_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum15_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum16_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum17_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum18_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum19_ge(PG_FUNCTION_ARGS);
-extern Datum conf_accum20_ge(PG_FUNCTION_ARGS);
+extern Datum conf_accum_ge(PG_FUNCTION_ARGS);
 
 extern Datum conf_final_ge(PG_FUNCTION_ARGS);
 
 /****************************** Functions related to aonf() **********************************************************/
 
 extern Datum aconf_accum0(PG_FUNCTION_ARGS);
-extern Datum aconf_accum1(PG_FUNCTION_ARGS);
-extern Datum aconf_accum2(PG_FUNCTION_ARGS);
-extern Datum aconf_accum3(PG_FUNCTION_ARGS);
-extern Datum aconf_accum4(PG_FUNCTION_ARGS);
-extern Datum aconf_accum5(PG_FUNCTION_ARGS);
-extern Datum aconf_accum6(PG_FUNCTION_ARGS);
-extern Datum aconf_accum7(PG_FUNCTION_ARGS);
-extern Datum aconf_accum8(PG_FUNCTION_ARGS);
-extern Datum aconf_accum9(PG_FUNCTION_ARGS);
-extern Datum aconf_accum10(PG_FUNCTION_ARGS);
+extern Datum aconf_accum(PG_FUNCTION_ARGS);
 
 extern Datum aconf_final(PG_FUNCTION_ARGS);
 
@@ -93,16 +37,7 @@ extern Datum aconf_final(PG_FUNCTION_ARGS);
 
 
 
-extern Datum conf_appro_accum1_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum2_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum3_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum4_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum5_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum6_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum7_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum8_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum9_ge(PG_FUNCTION_ARGS);
-extern Datum conf_appro_accum10_ge(PG_FUNCTION_ARGS);
+extern Datum conf_appro_accum_ge(PG_FUNCTION_ARGS);
 
 extern Datum conf_appro_final_ge(PG_FUNCTION_ARGS);
 
@@ -18,158 +18,91 @@
 #include "maybms/bitset.h"
 #include "nodes/execnodes.h"
 #include "maybms/conf_comp.h"
+#include "maybms/condvec.h"
 #include "nodes/pg_list.h"
+#include "storage/buffile.h"
 #include "utils/memutils.h"
 
+/* GUC variables */
+extern int conf_work_mem;
+extern int aconf_threads;
+extern int aconf_seed;
+
 #define RESERVED_VAR 0
 #define RNG_FOR_RESERVED_VAR 1
 #define RNG_FOR_RESERVED_VAR_NEGATIVE 0
 
-#define conf_appro_accum( n ) \
-	MemoryContext oldcxt; \
-	int j = 0; \
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate; \
-	WSD *wsd; \
-	VarChar *source = PG_GETARG_VARCHAR_PP( 1 ); \
-	appro_approach = VARDATA_ANY(source); \
-	appro_epsilon = PG_GETARG_FLOAT4( 2 ); \
-	if ( groupcxt == NULL )\
-	{ \
-		groupcxt = AllocSetContextCreate( NULL, "GroupContext",  ALLOCSET_DEFAULT_MINSIZE, \
-                                        	 ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);\
-    }\
-    oldcxt = MemoryContextSwitchTo( groupcxt ); \
-    wsd = (WSD*) palloc(sizeof(WSD));	\
-	WSD_LEN = n; \
-    wsd->data = (Map**)palloc(WSD_LEN*sizeof(Map*)); \
-    wsd->prob = 1.0; \
-	for( j = 0; j < WSD_LEN; j++ ){ \
-		wsd->data[ j ] = \
-		create_map ( PG_GETARG_INT32( 2 + 1 + j*3 ), PG_GETARG_INT32( 2 + 2 + j*3 ), 0, PG_GETARG_FLOAT4( 2 + 3 + j*3 ) ); \
-	} \
-	advance( WSD_LEN, state, wsd  ); \
-	MemoryContextSwitchTo( oldcxt ); \
-	PG_RETURN_DATUM( 1 ); 
-
-/* This macro should always be in sync with MACRO aconf_accum except two differences:
- * 1. epsilon and delta is set in aconf_accum.
- * 2. The first two arguments in aconf_accum are epsilon and delta.
- *
- * To be less erro prone, aconf_accum should call accum. However, this will cause 
- * the warnings from the compiler. 
- */
-#define accum( n, narg ) \
-	MemoryContext oldcxt; \
-	int j = 0; \
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate; \
-	WSD *wsd; \
-	if ( groupcxt == NULL )\
-	{ \
-		groupcxt = AllocSetContextCreate( NULL, "GroupContext",  ALLOCSET_DEFAULT_MINSIZE, \
-                                        	 ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);\
-    }\
-    oldcxt = MemoryContextSwitchTo( groupcxt ); \
-    wsd = (WSD*) palloc(sizeof(WSD));	\
-	WSD_LEN = n; \
-    wsd->data = (Map**)palloc(WSD_LEN*sizeof(Map*)); \
-    wsd->prob = 1.0; \
-	for( j = 0; j < WSD_LEN; j++ ){ \
-		wsd->data[ j ] = \
-		create_map ( PG_GETARG_INT32( narg + 1 + j*3 ), PG_GETARG_INT32( narg + 2 + j*3 ), 0, PG_GETARG_FLOAT4( narg + 3 + j*3 ) ); \
-	} \
-	advance( WSD_LEN, state, wsd  ); \
-	MemoryContextSwitchTo( oldcxt ); \
-	PG_RETURN_DATUM( 1 ); 
-
-/* This macro should always be in sync with MACRO aconf_accum except two differences:
- * 1. epsilon and delta is set in aconf_accum.
- * 2. The first two arguments in aconf_accum are epsilon and delta.
+/*
+ * The clauses (world set descriptors) of a group of duplicates. Every clause
+ * is a conjunction of wsd_len mappings var->rng, and its probability is the
+ * product of the probabilities of its mappings.
  *
- * To be less erro prone, aconf_accum should call accum. However, this will cause 
- * the warnings from the compiler. 
+ * The clauses are stored column-wise: mapping j of clause i is found at
+ * position MAP(s, i, j) of the mapping arrays. The scans over all clauses thus 
+ * read consecutive memory and only touch the fields they need.
  */
-#define aconf_accum( n ) \
-	MemoryContext oldcxt; \
-	int j = 0; \
-	generalState *state = ( ( AggState *) fcinfo->context )->genstate; \
-	WSD *wsd; \
-	epsilon = PG_GETARG_FLOAT4( 1 ); \
-	delta = PG_GETARG_FLOAT4( 2 ); \
-	if ( groupcxt == NULL )\
-	{ \
-		groupcxt = AllocSetContextCreate( NULL, "GroupContext",  ALLOCSET_DEFAULT_MINSIZE, \
-                                        	 ALLOCSET_DEFAULT_INITSIZE, ALLOCSET_DEFAULT_MAXSIZE);\
-    }\
-    oldcxt = MemoryContextSwitchTo( groupcxt ); \
-    wsd = (WSD*) palloc(sizeof(WSD));	\
-	WSD_LEN = n; \
-    wsd->data = (Map**)palloc(WSD_LEN*sizeof(Map*)); \
-    wsd->prob = 1.0; \
-	for( j = 0; j < WSD_LEN; j++ ){ \
-		wsd->data[ j ] = \
-		create_map ( PG_GETARG_INT32( 2 + 1 + j*3 ), PG_GETARG_INT32( 2 + 2 + j*3 ), 0, PG_GETARG_FLOAT4( 2 + 3 + j*3 ) ); \
-	} \
-	advance( WSD_LEN, state, wsd  ); \
-	MemoryContextSwitchTo( oldcxt ); \
-	PG_RETURN_DATUM( 1 ); 
-
-
-/* number of input world-set descriptors */
-int NUM_WSDS;
-int current_size;
-
-/* size of input world-set descriptors */
-int WSD_LEN;
+typedef struct clauseStore
+{
+	varType *var;
+	rngType *rng;		/* -1 while the mapping is temporarily dropped */
+	prob *map_prob;		/* probability of var->rng */
+	int *wt_index;		/* entry of var in the local world table */
+	int *rng_index;		/* entry of rng in the world table entry of var */
+	prob *prob;			/* probabilities of the clauses */
+} clauseStore;
 
 /*
- * Map = var assignment var->rng with probability prob. we also keep
- * reference to the world-set descriptor (wsd_host) using this
- * mapping. neg is only used in case of mutex computation to
- * succinctly represent as not(var->rng) all other assignments of
- * variable var.
+ * The clauses of a group whose lineage has exceeded conf_work_mem. Each
+ * clause is written as its wsd_len variables, range values and probabilities.
+ * The spill lives in its own memory context, since the memory of the group
+ * is reset whenever the clauses in memory are written out.
  */
-typedef struct 
+typedef struct lineageSpill
 {
-  	int var;
-  	int rng;
-  	int neg;
-  	prob prob; /* of var->rng; if neg=1, then the real prob is 1-prob. */
-	int wt_offset;
-	worldTableEntry *wt_entry; /* this is computed with wt_offset */
-	int rng_offset;
-	rngEntry *rng_entry; /* this is computed with rng_offset */
-} Map;
+	MemoryContext cxt;
+	BufFile *file;
+	long num_clauses;	/* number of clauses in file */
+} lineageSpill;
 
-/* 
- * A world-set decriptor is an array of assignments of different vars.
- * its probability is the product of prob of its var assignments.
+/*
+ * Computes the probability of the clauses of a state that are in memory. If
+ * the lineage has been spilled, this is one of nparts independent parts of it.
  */
-typedef struct
-{
-  Map** data;
-  prob prob;
-} WSD;
+typedef prob (*lineageProbFunc) ( generalState *state, int nparts );
 
-WSD** S;
+/* Position of mapping column of clause in the mapping arrays of state s */
+#define MAP( s, clause, column ) ( ( clause ) * ( s )->wsd_len + ( column ) )
 
-// The memory context for a group of duplicates
-MemoryContext groupcxt;
+/* World table entry and range entry of the mapping at position m of state s */
+#define WT_ENTRY( s, m ) ( ( s )->wt_entries + ( s )->clauses->wt_index[ m ] )
+#define RNG_ENTRY( s, m ) ( WT_ENTRY( s, m )->rng_entries + ( s )->clauses->rng_index[ m ] )
 
-extern Map* create_map (int var, int rng, int neg, prob prob );
-extern void genStateInit( generalState *state );
-extern void updateWorldTable( generalState *s, Map *map );
+extern generalState *getGenState( FunctionCallInfo fcinfo, int n );
+extern generalState *findGenState( FunctionCallInfo fcinfo );
+extern void releaseGenState( FunctionCallInfo fcinfo, generalState *state, float4 result );
+extern void genStateInit( generalState *state, int n );
+extern void updateWorldTable( generalState *s, int m );
 extern int wtEntryInit( varType v, generalState *s );
 extern int rngEntryInit( rngType rng, prob p, worldTableEntry *wt_entry );
 extern void getMissingRngs( generalState *s );
 extern void resetCount( generalState *s );
 extern void resetTau( generalState *s );
-extern void advance(int n, generalState *state, WSD* wsd);
-extern void computeEntryPointers(generalState *s);
+extern void advance(generalState *state, FunctionCallInfo fcinfo, int n,
+					varType *vars, rngType *rngs, prob *probs);
+extern prob lineageProb(generalState *state, lineageProbFunc compute);
+extern void addClauseEntry(generalState *s, int clause, int column);
+extern void rebuildClauseIndex(generalState *s);
+extern bitset *findIndependentSplit(bitset *set, generalState *s);
+extern bitset *findWsdsWithoutVar(bitset *set, worldTableEntry *wt_entry, generalState *s);
+extern bitset *findWsdsWithVarRng(bitset *set, rngEntry *rng_entry, generalState *s);
+extern void resetWsdsWithVarRng(generalState *s);
+extern bitset *allocBitset(generalState *s);
+extern void freeBitset(generalState *s, bitset *set);
 
 extern void printState( generalState *state );
 extern void printBucket( generalState *state );
-extern void printWSD(bitset* set);
-extern void printWSD2(int a);
+extern void printWSD(bitset* set, generalState *state);
+extern void printWSD2(generalState *state);
 
 extern mList* mlist_make(int nbits);
 extern void mlappend(mList* list, varType key, int index);
@@ -20,9 +20,11 @@
 #define ECOUNT "ecount"
 #define TESTNEGATIVE "test_negative"
 #define TESTFROMZEROTOONE "test_from_0_to_1"
+#define KEYHASH "keyhash"
 
 #define DOMAINIDSEQ "domid"
 #define VARIDSEQ "varid"
+#define NEXTID "nextid"
 #define WORLDTABLE "world_table"
 
 /* Utility functions */
@@ -0,0 +1,22 @@
+/*-------------------------------------------------------------------------
+ *
+ * rewrite_cache.h
+ *	  Cache of rewritten queries.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef REWRITE_CACHE_H_
+#define REWRITE_CACHE_H_
+
+#include "nodes/pg_list.h"
+
+extern List *GetCachedRewrite(const char *query_string);
+extern List *GetRewriteRelations(Node *parsetree);
+extern void CacheRewrite(const char *query_string, List *relations,
+			 Node *parsetree);
+
+#endif /* REWRITE_CACHE_H_ */
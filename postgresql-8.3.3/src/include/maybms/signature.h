@@ -9,6 +9,9 @@
  *-------------------------------------------------------------------------
  */
  
+#ifndef SIGNATURE_H_
+#define SIGNATURE_H_
+
 #include "fmgr.h"
 #include "nodes/parsenodes.h"
 #include "utils/memutils.h"
@@ -87,6 +90,29 @@ List *relList;
 
 MemoryContext signaturecxt;
 
+/* The signature of a rewritten hierarchical query. The rewritten SelectStmt
+ * points to it, and the plans cached for the query keep it alive, so that
+ * conf() finds the signature of the query it is computed in even if other
+ * queries were rewritten in between.
+ */
+typedef struct SignatureState
+{
+	sgTreeNode *sgTreeRoot;
+	sigNode    *sigTreeRoot;
+	bool		isOneScan;
+	List	   *relList;
+	MemoryContext context;		/* holds the trees above */
+	int			refcount;		/* number of cache entries using it */
+} SignatureState;
+
+extern SignatureState *currentSignature;
+
+extern SignatureState *NewSignature(void);
+extern void UseSignature(SignatureState *sig);
+extern void RestoreSignature(SignatureState *sig);
+extern SignatureState *GetParseTreeSignature(Node *parsetree);
+extern void ReleaseSignature(SignatureState *sig);
+
 /* Functions related to processing query trees */
 extern Node *process( Node *parsetree );
 
@@ -104,3 +130,5 @@ extern void drawsgNode( sgTreeNode *root, int n );
 extern void printsglist( sgList *list );
 extern int fillLeafNode( sigNode *node, sigNode **vars );
 extern sigNode *addNonJoinedRelation( sgTreeNode *sgRoot, sigNode *oldRoot, List *frlist );
+
+#endif /* SIGNATURE_H_ */
@@ -0,0 +1,34 @@
+/*-------------------------------------------------------------------------
+ *
+ * urelinfo.h
+ *	  The MayBMS metadata of a relation cached in its relcache entry.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef URELINFO_H_
+#define URELINFO_H_
+
+#include "nodes/primnodes.h"
+#include "utils/rel.h"
+
+typedef struct URelationInfo
+{
+	Oid			relid;			/* OID of the relation */
+	char		tabletype;		/* pg_class.tabletype */
+	int			tripleCount;	/* number of triples of condition columns */
+	int			ncondattrs;		/* number of condition columns */
+	AttrNumber	condattrs[1];	/* VARIABLE LENGTH ARRAY of the attnums of
+								 * the condition columns, in ascending order */
+} URelationInfo;
+
+#define URELINFOSZ(n) \
+	(offsetof(URelationInfo, condattrs) + Max(n, 1) * sizeof(AttrNumber))
+
+extern URelationInfo *RelationGetURelationInfo(Relation rel);
+extern URelationInfo *getURelationInfo(const RangeVar *rv);
+
+#endif /* URELINFO_H_ */
@@ -0,0 +1,64 @@
+/*-------------------------------------------------------------------------
+ *
+ * wsd.h
+ *	  Declarations for the world-set descriptor type wsd.
+ *
+ *	  A wsd stores the whole condition of a tuple, i.e. the mappings var->rng
+ *	  of its triples of condition columns with their probabilities, in one
+ *	  varlena value. The mappings are sorted by variable and encoded as
+ *	  varints of the differences of consecutive variables and of the range
+ *	  values. The probabilities are stored as an array in front of them.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#ifndef WSD_H_
+#define WSD_H_
+
+#include "fmgr.h"
+#include "maybms/signature.h"
+
+#define WSDFUNCNAME "wsd"
+#define WSDNAME "_wsd"
+#define WSDCONSISTENT "&?"
+
+typedef struct
+{
+	int32		vl_len_;		/* varlena header (do not touch directly!) */
+	int32		npairs;			/* number of mappings var->rng */
+	prob		probs[1];		/* VARIABLE LENGTH ARRAY, followed by the
+								 * encoded mappings */
+} WsdType;
+
+#define WSDHDRSZ			offsetof(WsdType, probs)
+#define WSD_NPAIRS(w)		((w)->npairs)
+#define WSD_PROBS(w)		((w)->probs)
+#define WSD_PAIRS(w)		((unsigned char *) ((w)->probs + (w)->npairs))
+
+#define DatumGetWsdP(X)		((WsdType *) PG_DETOAST_DATUM(X))
+#define PG_GETARG_WSD_P(n)	DatumGetWsdP(PG_GETARG_DATUM(n))
+#define PG_RETURN_WSD_P(x)	PG_RETURN_POINTER(x)
+
+/*
+ * The planner cannot see the number of mappings in a wsd column, so it
+ * assumes this many in the lineage estimate of conf() and aconf().
+ */
+#define WSD_EST_PAIRS		4
+
+extern WsdType *makeWsd(int n, varType *vars, rngType *rngs, prob *probs);
+extern int wsdDecode(WsdType *wsd, varType **vars, rngType **rngs, prob **probs);
+
+extern Datum wsd_in(PG_FUNCTION_ARGS);
+extern Datum wsd_out(PG_FUNCTION_ARGS);
+extern Datum wsd_make(PG_FUNCTION_ARGS);
+extern Datum wsd_and(PG_FUNCTION_ARGS);
+extern Datum wsd_consistent(PG_FUNCTION_ARGS);
+extern Datum wsd_prob(PG_FUNCTION_ARGS);
+extern Datum wsd_consistent_arrays(PG_FUNCTION_ARGS);
+extern Datum wsdconsistentsel(PG_FUNCTION_ARGS);
+extern Datum wsdconsistentjoinsel(PG_FUNCTION_ARGS);
+
+#endif /* WSD_H_ */
@@ -1395,10 +1395,18 @@ typedef struct argmaxState{
 	int64 int64MAX;
 }argmaxState;
 
+typedef struct clauseEntry{
+	int clause;					/* index of the clause in S */
+	int column;					/* position of the mapping in the clause */
+}clauseEntry;
+
 typedef struct rngEntry{
 	rngType rng;
 	prob p;
 	int count;
+	clauseEntry *clause_entries;	/* clauses containing var->rng, in clause order */
+	int clause_entry_max;
+	int clause_entry_count;
 }rngEntry;
 
 typedef struct worldTableEntry{
@@ -1409,19 +1417,54 @@ typedef struct worldTableEntry{
 	int tau;
 	bool met;
 	int occur_count;
+	int visited;				/* stamp of the last component search visiting it */
 }worldTableEntry;
 
+/*
+ * The state of conf() or aconf() for one group of duplicates. All the memory
+ * of the computation lives in groupcxt.
+ */
 typedef struct generalState{
+	int slot;					/* index in the states of the AggState */
+	MemoryContext groupcxt;		/* memory context of the group of duplicates */
+	struct clauseStore *clauses;	/* the lineage of the group */
+	int num_wsds;				/* number of clauses in the lineage */
+	int wsd_len;				/* number of mappings in each clause */
+	int wsd_max;				/* number of clauses the lineage can hold */
+	struct lineageSpill *spill;	/* clauses written to disk, NULL if none */
 	worldTableEntry *wt_entries;
 	mList **HT;	
 	int nbits;
 	int mask;
 	int wt_entry_max;
 	int wt_entry_count;
+	int visit_stamp;			/* stamp of the current component search */
+	int *clause_stack;			/* scratch stack used in component search */
+	int *drop_stack;			/* mappings temporarily dropped by the recursion */
+	int drop_top;				/* number of entries in drop_stack */
+	struct compCache *comp_cache;	/* probabilities of components in exact conf */
+	struct bitset_pool *bitset_pool;	/* free bitsets of the recursion */
+	double epsilon;				/* error of aconf() */
+	double delta;				/* probability of exceeding the error in aconf() */
+	char appro_approach;		/* 'R' for relative, 'A' for absolute approximation in conf() */
+	bool is_relative;			/* appro_approach is 'R' */
+	prob appro_epsilon;			/* error of the approximation in conf() */
+	float8 stopping_number;		/* bound on the error of the decomposition tree */
+	bool has_satisfied_stopping_condition;
+	bool finalized;				/* result has been computed */
+	float4 result;
 } generalState;
 
+/*
+ * The state of conf() for hierarchical queries (see SPROUT.c) for one group
+ * of duplicates. The lineage and the partial sums live in groupcxt.
+ */
 typedef struct stateData{
 	
+	MemoryContext groupcxt;		/* memory context of the group of duplicates */
+	bool finalized;				/* result has been computed */
+	prob result;
+
 	int NoOfVars;
 	sigNode **vars;
 
@@ -1449,6 +1492,7 @@ typedef struct lineageTable{
 	varprob *head;
 	varprob *tail;
 	varprob *cursor;
+	int count;					/* number of tuples */
 }lineageTable;
 
 typedef struct AggHashEntryData
@@ -1493,7 +1537,10 @@ typedef struct AggState
 	AggHashEntry currentEntry;  /* The current entry of hashing */
 	stateData *state;			/* The pointer to the structure storing the calculation state for HQ */
 	lineageTable *lineage;		/* The lineage of current duplicate group */
-	generalState *genstate;		/* The pointer to the structure storing the lineage for conf and aconf */
+	generalState **genstates;	/* The states of conf and aconf, indexed by their transition values */
+	int genstate_count;			/* The number of states used */
+	int genstate_max;			/* The number of states allocated */
+	int genstate_live;			/* The number of states not finalized yet */
 	argmaxState *argmax;		/* The pointer to the structure storing the information for argmax */
 	
 	/* MAYBMS END */
@@ -1586,4 +1633,33 @@ typedef struct LimitState
 	TupleTableSlot *subSlot;	/* tuple last obtained from subplan */
 } LimitState;
 
+/* MAYBMS BEGIN */
+/* ----------------
+ *	 RepairKeyState information
+ *
+ *		RepairKey nodes read the tuples of one key block from their sorted
+ *		input into a tuplestore, which spills to disk for huge blocks, give
+ *		each distinct tuple a new domain value and sum up the weights of
+ *		the distinct tuples.  Then they return the tuples of the block with
+ *		a new variable for the block and the weight divided by the sum as
+ *		probability.
+ * ----------------
+ */
+typedef struct RepairKeyState
+{
+	PlanState	ps;				/* its first field is NodeTag */
+	FmgrInfo   *eqfunctions;	/* per-field lookup data for equality fns */
+	MemoryContext tempContext;	/* short-term context for comparisons and
+								 * the result tuple */
+	TupleTableSlot *prevSlot;	/* tuple last read from the subplan */
+	TupleTableSlot *blockSlot;	/* tuple last read from the block */
+	void	   *block;			/* tuplestore of the current block */
+	float8		weightsum;		/* sum of the weights of the block */
+	int32		var;			/* variable of the block */
+	Oid			varSeq;			/* sequence of the variables */
+	Oid			domSeq;			/* sequence of the domain values */
+	bool		done;			/* input exhausted? */
+} RepairKeyState;
+/* MAYBMS END */
+
 #endif   /* EXECNODES_H */
@@ -67,6 +67,9 @@ typedef enum NodeTag
 	T_Hash,
 	T_SetOp,
 	T_Limit,
+	/* MAYBMS BEGIN */
+	T_RepairKey,
+	/* MAYBMS END */
 
 	/*
 	 * TAGS FOR PLAN STATE NODES (execnodes.h)
@@ -99,6 +102,9 @@ typedef enum NodeTag
 	T_HashState,
 	T_SetOpState,
 	T_LimitState,
+	/* MAYBMS BEGIN */
+	T_RepairKeyState,
+	/* MAYBMS END */
 
 	/*
 	 * TAGS FOR PRIMITIVE NODES (primnodes.h)
@@ -131,6 +131,12 @@ typedef struct Query
 
 	Node	   *setOperations;	/* set-operation tree if this is top level of
 								 * a UNION/INTERSECT/EXCEPT query */
+
+	/* MAYBMS BEGIN */
+	int			repairKeyCols;	/* if > 0, the query is a repair-key, and
+								 * this many leading items of sortClause
+								 * are its key */
+	/* MAYBMS END */
 } Query;
 
 
@@ -771,6 +777,13 @@ typedef struct SelectStmt
 								 * Currently, it can only be 'I'.
 								 */
 	ResTarget  *prob;			/* the probability of a tuple */
+	struct SignatureState *signature;	/* the signature of a rewritten
+										 * hierarchical conf() query */
+	int			repairKeyCols;	/* if > 0, the select is a rewritten
+								 * repair-key, and this many leading items
+								 * of sortClause are its key */
+	int			partition;		/* repair only partition of npartitions */
+	int			npartitions;	/* hash partitions of the key, or 0 */
 	/* MAYBMS END */
 
 	/*
@@ -558,4 +558,27 @@ typedef struct Limit
 	Node	   *limitCount;		/* COUNT parameter, or NULL if none */
 } Limit;
 
+/* MAYBMS BEGIN */
+/* ----------------
+ *		repair-key node
+ *
+ * The input is sorted on the key of the repair-key and then on all other
+ * columns, so that duplicates are adjacent.  Its last three columns are the
+ * triple of condition columns: the variable and domain columns are
+ * placeholders, and the probability column holds the weight of the tuple.
+ * ----------------
+ */
+typedef struct RepairKey
+{
+	Plan		plan;
+	int			numCols;		/* number of sort columns */
+	int			numKeyCols;		/* number of leading ones forming the key */
+	AttrNumber *sortColIdx;		/* their indexes in the target list */
+	Oid		   *eqOperators;	/* equality operators to compare with */
+	AttrNumber	varColIdx;		/* index of the variable column */
+	AttrNumber	domColIdx;		/* index of the domain column */
+	AttrNumber	probColIdx;		/* index of the probability column */
+} RepairKey;
+/* MAYBMS END */
+
 #endif   /* PLANNODES_H */
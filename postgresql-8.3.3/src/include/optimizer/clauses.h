@@ -26,6 +26,9 @@ typedef struct
 	int			numAggs;		/* total number of aggregate calls */
 	int			numDistinctAggs;	/* number that use DISTINCT */
 	Size		transitionSpace;	/* for pass-by-ref transition data */
+	/* MAYBMS BEGIN */
+	Size		lineageSpace;	/* per input row for the lineage of conf() */
+	/* MAYBMS END */
 } AggClauseCounts;
 
 
@@ -60,6 +60,10 @@ typedef struct CachedPlanSource
 	struct CachedPlan *plan;	/* link to plan, or NULL if not valid */
 	MemoryContext context;		/* context containing this CachedPlanSource */
 	struct CachedPlan *orig_plan;		/* link to plan owning my context */
+	/* MAYBMS BEGIN */
+	struct SignatureState *signature;	/* signature of a hierarchical
+										 * conf() query, or NULL */
+	/* MAYBMS END */
 } CachedPlanSource;
 
 /*
@@ -193,6 +193,17 @@ typedef struct RelationData
 	List	   *rd_indpred;		/* index predicate tree, if any */
 	void	   *rd_amcache;		/* available for use by index AM */
 
+	/* MAYBMS BEGIN */
+
+	/*
+	 * rd_urelinfo caches the MayBMS metadata of the relation (see
+	 * maybms/urelinfo.c). It is computed on first use, NULL until then, and
+	 * is a single chunk palloc'd in CacheMemoryContext.
+	 */
+	struct URelationInfo *rd_urelinfo;
+
+	/* MAYBMS END */
+
 	/* use "struct" here to avoid needing to include pgstat.h: */
 	struct PgStat_TableStatus *pgstat_info;		/* statistics collection area */
 } RelationData;
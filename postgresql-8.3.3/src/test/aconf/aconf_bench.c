@@ -0,0 +1,500 @@
+/*-------------------------------------------------------------------------
+ *
+ * aconf_bench.c
+ *	  	Benchmark of the Monte Carlo steps of aconf() in backend/maybms/aconf.c.
+ *
+ *	  The lineages are the triangles of a complete graph with random edges,
+ *	  and the runs of 3 variables of a chain.
+ *	  The Karp-Luby estimates per second of compute_estimator() are compared
+ *	  with a reference estimator that scans all weights and clauses for every
+ *	  estimate, and aconf_prob() is timed with several threads.
+ *
+ *	  aconf.c is included, since the functions measured are local to it.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "aconf.c"
+
+#define NESTIMATES 200000
+#define MAXTHREADS 8
+
+/*
+ * The backend functions used by aconf.c and localcond.c.  Memory is never
+ * released, and the lineage is far below conf_work_mem, so it is never
+ * written to temporary files.
+ */
+MemoryContext CurrentMemoryContext = NULL;
+ErrorContextCallback *error_context_stack = NULL;
+sigjmp_buf *PG_exception_stack = NULL;
+volatile bool InterruptPending = false;
+
+static void
+fail(const char *what)
+{
+	fprintf(stderr, "%s is not available in the benchmark\n", what);
+	exit(1);
+}
+
+void *
+MemoryContextAlloc(MemoryContext context, Size size)
+{
+	void *p = malloc(size > 0 ? size : 1);
+
+	if (p == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+void *
+MemoryContextAllocZero(MemoryContext context, Size size)
+{
+	void *p = MemoryContextAlloc(context, size);
+
+	memset(p, 0, size);
+
+	return p;
+}
+
+void *
+repalloc(void *pointer, Size size)
+{
+	void *p = realloc(pointer, size);
+
+	if (p == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+void
+pfree(void *pointer)
+{
+	free(pointer);
+}
+
+MemoryContext
+AllocSetContextCreate(MemoryContext parent, const char *name,
+					  Size minContextSize, Size initBlockSize, Size maxBlockSize)
+{
+	return NULL;
+}
+
+void
+MemoryContextDelete(MemoryContext context)
+{
+}
+
+void
+MemoryContextReset(MemoryContext context)
+{
+}
+
+void
+ProcessInterrupts(void)
+{
+}
+
+void
+elog_start(const char *filename, int lineno, const char *funcname)
+{
+}
+
+void
+elog_finish(int elevel, const char *fmt,...)
+{
+	va_list		ap;
+
+	if (elevel < ERROR)
+		return;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+	exit(1);
+}
+
+bool
+errstart(int elevel, const char *filename, int lineno, const char *funcname)
+{
+	return elevel >= ERROR;
+}
+
+void
+errfinish(int dummy,...)
+{
+	fail("ereport");
+}
+
+int
+errmsg(const char *fmt,...)
+{
+	return 0;
+}
+
+int
+errcode_for_file_access(void)
+{
+	return 0;
+}
+
+void
+pg_re_throw(void)
+{
+	fprintf(stderr, "PG_RE_THROW is not available in the benchmark\n");
+	exit(1);
+}
+
+Datum
+Float4GetDatum(float4 X)
+{
+	fail("Float4GetDatum");
+	return 0;
+}
+
+int
+getCondColumns(FunctionCallInfo fcinfo, int narg, varType **vars,
+			   rngType **rngs, prob **probs)
+{
+	fail("getCondColumns");
+	return 0;
+}
+
+BufFile *
+BufFileCreateTemp(bool interXact)
+{
+	fail("BufFileCreateTemp");
+	return NULL;
+}
+
+void
+BufFileClose(BufFile *file)
+{
+	fail("BufFileClose");
+}
+
+size_t
+BufFileRead(BufFile *file, void *ptr, size_t size)
+{
+	fail("BufFileRead");
+	return 0;
+}
+
+size_t
+BufFileWrite(BufFile *file, void *ptr, size_t size)
+{
+	fail("BufFileWrite");
+	return 0;
+}
+
+int
+BufFileSeek(BufFile *file, int fileno, long offset, int whence)
+{
+	fail("BufFileSeek");
+	return 0;
+}
+
+HTAB *
+hash_create(const char *tabname, long nelem, HASHCTL *info, int flags)
+{
+	fail("hash_create");
+	return NULL;
+}
+
+void *
+hash_search(HTAB *hashp, const void *keyPtr, HASHACTION action, bool *foundPtr)
+{
+	fail("hash_search");
+	return NULL;
+}
+
+void
+hash_destroy(HTAB *hashp)
+{
+	fail("hash_destroy");
+}
+
+uint32
+tag_hash(const void *key, Size keysize)
+{
+	fail("tag_hash");
+	return 0;
+}
+
+/* Lineage */
+
+/*
+ * Set up the lineage of the triangles of the complete graph on n nodes.  The
+ * variable of an edge has the value 1 with probability 1/2 if dom is 0, and
+ * otherwise one of dom values with probability 1/dom each, which depends on
+ * the triangle.  The values left out are completed by aconf_prob().
+ */
+static generalState *
+make_triangles(int n, int dom)
+{
+	generalState *state = (generalState *) MemoryContextAllocZero(NULL, sizeof(generalState));
+	int a, b, c, k;
+
+	genStateInit(state, 3);
+
+	for (a = 0; a < n; a++)
+		for (b = a + 1; b < n; b++)
+			for (c = b + 1; c < n; c++)
+			{
+				varType vars[3];
+				rngType rngs[3];
+				prob probs[3];
+
+				vars[0] = a * n + b + 1;
+				vars[1] = b * n + c + 1;
+				vars[2] = a * n + c + 1;
+
+				for (k = 0; k < 3; k++)
+				{
+					rngs[k] = dom ? (a * 7 + b * 3 + c + k) % dom + 1 : 1;
+					probs[k] = dom ? 1.0 / dom : 0.5;
+				}
+
+				advance(state, NULL, 3, vars, rngs, probs);
+			}
+
+	getMissingRngs(state);
+
+	return state;
+}
+
+/*
+ * Set up the lineage of a chain of n variables with dom values each, whose
+ * clauses are all runs of 3 consecutive variables.  A clause checked by the
+ * estimator reads few variables besides its leader.
+ */
+static generalState *
+make_chain(int n, int dom)
+{
+	generalState *state = (generalState *) MemoryContextAllocZero(NULL, sizeof(generalState));
+	int a, k;
+
+	genStateInit(state, 3);
+
+	for (a = 0; a + 2 < n; a++)
+	{
+		varType vars[3];
+		rngType rngs[3];
+		prob probs[3];
+
+		for (k = 0; k < 3; k++)
+		{
+			vars[k] = a + k + 1;
+			rngs[k] = (a * 5 + k) % dom + 1;
+			probs[k] = 1.0 / dom;
+		}
+
+		advance(state, NULL, 3, vars, rngs, probs);
+	}
+
+	getMissingRngs(state);
+
+	return state;
+}
+
+/* Reference estimator */
+
+/*
+ * The Karp-Luby estimator as computed before the alias tables: the clause and
+ * the value of every variable are picked by scanning the weights, and every
+ * clause is tested against the world.
+ */
+static prob
+ref_estimator(generalState *state, aconfWorker *worker, prob *clause_bag_prob, uint64 n)
+{
+	clauseStore *S = state->clauses;
+	int len = state->wsd_len;
+	int c_tau = 0;
+	float8 x;
+	int i, j, k;
+
+	worker->random = prng_step(n);
+
+	/* Pick a clause */
+	x = prng_float(worker);
+
+	for (i = 0; i < state->num_wsds - 1; i++)
+	{
+		x -= clause_bag_prob[i];
+
+		if (x < 0)
+			break;
+	}
+
+	/* Complete the world */
+	for (j = 0; j < state->wt_entry_count; j++)
+	{
+		worldTableEntry *entry = state->wt_entries + j;
+
+		x = prng_float(worker);
+
+		for (k = 0; k < entry->rng_entry_count - 1; k++)
+		{
+			x -= entry->rng_entries[k].p;
+
+			if (x < 0)
+				break;
+		}
+
+		worker->tau[j] = k;
+	}
+
+	for (k = MAP(state, i, 0); k < MAP(state, i + 1, 0); k++)
+		worker->tau[S->wt_index[k]] = S->rng_index[k];
+
+	/* Count the clauses satisfied by the world */
+	for (i = 0; i < state->num_wsds; i++)
+	{
+		for (k = MAP(state, i, 0); k < MAP(state, i, len); k++)
+			if (worker->tau[S->wt_index[k]] != S->rng_index[k])
+				break;
+
+		if (k == MAP(state, i, len))
+			c_tau++;
+	}
+
+	return (prob) 1 / (prob) c_tau;
+}
+
+/* Benchmark driver */
+
+static double
+get_time(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/*
+ * Compare the estimates per second of compute_estimator() and the reference
+ * estimator on the same lineage.  The means of both must agree.
+ */
+static void
+bench_estimator(const char *name, generalState *state)
+{
+	aconfSampler sampler;
+	aconfPool pool;
+	prob *clause_bag_prob = (prob *) palloc(state->num_wsds * sizeof(prob));
+	prob nM = 0;
+	double start, time_alias, time_ref;
+	double sum_alias = 0, sum_ref = 0;
+	int i;
+
+	for (i = 0; i < state->num_wsds; i++)
+		nM += state->clauses->prob[i];
+
+	for (i = 0; i < state->num_wsds; i++)
+		clause_bag_prob[i] = state->clauses->prob[i] / nM;
+
+	aconf_threads = 1;
+	sampler_init(&sampler, state, clause_bag_prob);
+	pool_init(&pool, state, &sampler);
+
+	start = get_time();
+
+	for (i = 0; i < NESTIMATES; i++)
+		sum_alias += compute_estimator(state, &sampler, pool.workers, i);
+
+	time_alias = get_time() - start;
+
+	start = get_time();
+
+	for (i = 0; i < NESTIMATES; i++)
+		sum_ref += ref_estimator(state, pool.workers, clause_bag_prob, i);
+
+	time_ref = get_time() - start;
+
+	pool_shutdown(&pool);
+
+	printf("%-24s %8d %8d %8d %12.0f %12.0f %10.4f %10.4f\n", name,
+		   state->num_wsds, state->wt_entry_count, sampler.num_leader_vars,
+		   NESTIMATES / time_ref, NESTIMATES / time_alias,
+		   sum_ref / NESTIMATES * nM, sum_alias / NESTIMATES * nM);
+
+	if (fabs(sum_alias - sum_ref) > 0.02 * sum_ref)
+	{
+		fprintf(stderr, "%s: the mean estimates differ\n", name);
+		exit(1);
+	}
+}
+
+/*
+ * Time aconf_prob() with 1 to MAXTHREADS threads.  All results must be the
+ * same.
+ */
+static void
+bench_threads(const char *name, generalState *state)
+{
+	prob first = 0;
+	int threads;
+
+	state->epsilon = 0.02;
+	state->delta = 0.05;
+
+	for (threads = 1; threads <= MAXTHREADS; threads *= 2)
+	{
+		double start = get_time();
+		prob result;
+
+		aconf_threads = threads;
+		result = aconf_prob(state, 1);
+
+		printf("%-24s %8d %12.3f %10.4f\n", name, threads, get_time() - start, result);
+
+		if (threads == 1)
+			first = result;
+		else if (result != first)
+		{
+			fprintf(stderr, "%s: %d threads give %g, 1 thread gives %g\n",
+					name, threads, result, first);
+			exit(1);
+		}
+	}
+}
+
+int
+main(int argc, char **argv)
+{
+	generalState *boolean = make_triangles(16, 0);
+	generalState *valued = make_triangles(30, 4);
+	generalState *chain = make_chain(3000, 8);
+
+	printf("%-24s %8s %8s %8s %12s %12s %10s %10s\n", "lineage", "clauses", "vars",
+		   "leaders", "ref/s", "alias/s", "ref mean", "alias mean");
+
+	bench_estimator("triangles K16, Boolean", boolean);
+	bench_estimator("triangles K30, 4 values", valued);
+	bench_estimator("chain of 3000, 8 values", chain);
+
+	printf("\n%-24s %8s %12s %10s\n", "lineage", "threads", "seconds", "aconf");
+
+	bench_threads("triangles K16, Boolean", boolean);
+	bench_threads("triangles K30, 4 values", valued);
+	bench_threads("chain of 3000, 8 values", chain);
+
+	return 0;
+}
@@ -0,0 +1,308 @@
+/*-------------------------------------------------------------------------
+ *
+ * bitset_bench.c
+ *	  	Microbenchmark of the bitset kernels in backend/maybms/bitset.c.
+ *
+ *	  The word-level kernels of bitset.c are compared against the former
+ *	  bit-at-a-time implementations, which are kept here as reference. Both
+ *	  are run on sets of 10^3 to 10^6 bits, and their results are checked
+ *	  against each other.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <limits.h>
+#include <sys/time.h>
+
+#include "maybms/bitset.h"
+#include "maybms/utils.h"
+
+/* The backend memory management used by bitset.c is replaced by malloc */
+MemoryContext CurrentMemoryContext = NULL;
+
+void *
+MemoryContextAlloc(MemoryContext context, Size size)
+{
+	void *p = malloc(size > 0 ? size : 1);
+
+	if (p == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+void
+pfree(void *pointer)
+{
+	free(pointer);
+}
+
+void myLog(char *text) { fputs(text, stdout); }
+void myLogi(int a) { printf("%d", a); }
+void nl(int a) { while (a-- > 0) putchar('\n'); }
+
+/* Reference implementations that test one bit at a time */
+
+static size_t
+old_count_set(bitset *set)
+{
+	size_t count = 0;
+	size_t i;
+
+	for (i = 0; i < set->nbits; i++)
+		if (bitset_test_bit(set, i))
+			count++;
+
+	return count;
+}
+
+static void
+old_set(bitset *set)
+{
+	size_t i;
+
+	for (i = 0; i < set->nbits; i++)
+		bitset_set_bit(set, i);
+}
+
+static void
+old_subtract(bitset *from_set, bitset *what)
+{
+	size_t i;
+
+	for (i = 0; i < from_set->nbits; i++)
+		if (bitset_test_bit(what, i))
+			bitset_clear_bit(from_set, i);
+}
+
+static void
+old_negate(bitset *ref_set, bitset *to_negate)
+{
+	size_t i;
+
+	for (i = 0; i < ref_set->nbits; i++)
+	{
+		if (bitset_test_bit(ref_set, i))
+		{
+			if (bitset_test_bit(to_negate, i))
+				bitset_clear_bit(to_negate, i);
+			else
+				bitset_set_bit(to_negate, i);
+		}
+	}
+}
+
+static int
+old_first_bit_set(bitset *set)
+{
+	size_t i = 0;
+
+	while (i < set->nbits && !bitset_test_bit(set, i))
+		i++;
+
+	if (i < set->nbits)
+		return i;
+
+	return -1;
+}
+
+static int
+old_test_singleton(bitset *set)
+{
+	int pos = -1;
+	size_t i = 0;
+	int how_many = 0;
+
+	while (i < set->nbits && how_many < 2)
+	{
+		if (bitset_test_bit(set, i))
+		{
+			how_many++;
+			pos = i;
+		}
+		i++;
+	}
+
+	if (how_many == 1)
+		return pos;
+
+	return -1;
+}
+
+static int
+old_test_empty(bitset *set)
+{
+	return old_first_bit_set(set) == -1;
+}
+
+/* Benchmark driver */
+
+static double
+now(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+static void
+fill_random(bitset *set, int percent)
+{
+	size_t i;
+
+	bitset_reset(set);
+
+	for (i = 0; i < set->nbits; i++)
+		if (rand() % 100 < percent)
+			bitset_set_bit(set, i);
+}
+
+static void
+check(const char *what, size_t nbits, long old_result, long new_result)
+{
+	if (old_result != new_result)
+	{
+		fprintf(stderr, "%s on %lu bits: old kernel returned %ld, new kernel %ld\n",
+				what, (unsigned long) nbits, old_result, new_result);
+		exit(1);
+	}
+}
+
+static void
+check_sets(const char *what, bitset *a, bitset *b)
+{
+	size_t i;
+
+	for (i = 0; i < a->nbits; i++)
+		if (bitset_test_bit(a, i) != bitset_test_bit(b, i))
+		{
+			fprintf(stderr, "%s on %lu bits: results differ at bit %lu\n",
+					what, (unsigned long) a->nbits, (unsigned long) i);
+			exit(1);
+		}
+
+	check(what, a->nbits, old_count_set(a), bitset_count_set(b));
+}
+
+static void
+report(const char *what, size_t nbits, int reps, double old_time, double new_time)
+{
+	printf("%-16s %8lu %12.1f %12.1f %8.1fx\n", what, (unsigned long) nbits,
+		   old_time * 1e9 / reps, new_time * 1e9 / reps,
+		   new_time > 0 ? old_time / new_time : 0.0);
+}
+
+/*
+ * Time the old and the new kernel of a scalar-valued operation on set and
+ * check that both return the same result.
+ */
+#define BENCH_SCALAR(what, old_call, new_call) \
+	do { \
+		long old_result = 0, new_result = 0; \
+		double start; \
+		double old_time, new_time; \
+		int r; \
+		start = now(); \
+		for (r = 0; r < reps; r++) \
+			old_result += (long) (old_call); \
+		old_time = now() - start; \
+		start = now(); \
+		for (r = 0; r < reps; r++) \
+			new_result += (long) (new_call); \
+		new_time = now() - start; \
+		check(what, nbits, old_result, new_result); \
+		report(what, nbits, reps, old_time, new_time); \
+	} while (0)
+
+/*
+ * Time the old and the new kernel of an in-place operation on target, which
+ * is restored from source before each call, and compare the resulting sets.
+ * The times include the restoring copy.
+ */
+#define BENCH_INPLACE(what, source, old_call, new_call) \
+	do { \
+		double start; \
+		double old_time, new_time; \
+		int r; \
+		start = now(); \
+		for (r = 0; r < reps; r++) \
+		{ \
+			bitset_copy(source, old_target); \
+			old_call; \
+		} \
+		old_time = now() - start; \
+		start = now(); \
+		for (r = 0; r < reps; r++) \
+		{ \
+			bitset_copy(source, new_target); \
+			new_call; \
+		} \
+		new_time = now() - start; \
+		check_sets(what, old_target, new_target); \
+		report(what, nbits, reps, old_time, new_time); \
+	} while (0)
+
+static void
+bench(size_t nbits)
+{
+	/* Keep the amount of work per size roughly constant */
+	int reps = (int) (20000000 / nbits) + 1;
+	bitset *dense = bitset_init(nbits);
+	bitset *sparse = bitset_init(nbits);
+	bitset *empty = bitset_init(nbits);
+	bitset *last = bitset_init(nbits);
+	bitset *old_target = bitset_init(nbits);
+	bitset *new_target = bitset_init(nbits);
+
+	fill_random(dense, 50);
+	fill_random(sparse, 1);
+	bitset_reset(empty);
+	bitset_reset(last);
+	bitset_set_bit(last, nbits - 1);
+
+	BENCH_SCALAR("count_set", old_count_set(dense), bitset_count_set(dense));
+	BENCH_SCALAR("test_empty", old_test_empty(empty), bitset_test_empty(empty));
+	BENCH_SCALAR("first_bit_set", old_first_bit_set(last), bitset_first_bit_set(last));
+	BENCH_SCALAR("test_singleton", old_test_singleton(last), bitset_test_singleton(last));
+	BENCH_SCALAR("test_singleton2", old_test_singleton(sparse), bitset_test_singleton(sparse));
+	BENCH_INPLACE("set", empty, old_set(old_target), bitset_set(new_target));
+	BENCH_INPLACE("negate", sparse, old_negate(dense, old_target), bitset_negate(dense, new_target));
+	BENCH_INPLACE("subtract", dense, old_subtract(old_target, sparse), bitset_subtract(new_target, sparse));
+
+	bitset_free(dense);
+	bitset_free(sparse);
+	bitset_free(empty);
+	bitset_free(last);
+	bitset_free(old_target);
+	bitset_free(new_target);
+}
+
+int
+main(int argc, char **argv)
+{
+	size_t nbits;
+
+	srand(42);
+
+	printf("%-16s %8s %12s %12s %9s\n", "kernel", "bits", "old ns/op", "new ns/op", "speedup");
+
+	for (nbits = 1000; nbits <= 1000000; nbits *= 10)
+	{
+		bench(nbits);
+
+		/* Also exercise a size that is not a multiple of the word size */
+		bench(nbits + 37);
+	}
+
+	return 0;
+}
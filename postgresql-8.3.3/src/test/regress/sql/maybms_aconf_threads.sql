@@ -0,0 +1,62 @@
+--test for aconf() with several threads and a fixed seed
+
+create table s as select i from generate_series(1, 20) i;
+
+create table T as pick tuples from s independently with probability 0.1;
+
+--the probability that T is not empty is 0.878423
+set aconf_seed = 1;
+
+create table A1 as select aconf(.05,.05) as p from T;
+
+set aconf_threads = 4;
+
+create table A4 as select aconf(.05,.05) as p from T;
+
+--the result only depends on the seed, not on the number of threads
+select A1.p = A4.p as same_result, A4.p between 0.8 and 0.95 as close_to_conf 
+from A1, A4;
+
+reset aconf_threads;
+reset aconf_seed;
+
+drop table s;
+drop table T;
+drop table A1;
+drop table A4;
+
+--groups of clauses sharing variables, computed with 1, 2 and 4 threads
+create table edges as select a.i as u, b.i as v 
+from generate_series(1, 8) a, generate_series(1, 8) b where a.i < b.i;
+
+create table G as pick tuples from edges independently with probability 0.5;
+
+set aconf_seed = 7;
+
+create table P1 as select e1.u, aconf(.05,.01) as p from G e1, G e2 where e1.v = e2.u group by e1.u;
+
+set aconf_threads = 2;
+
+create table P2 as select e1.u, aconf(.05,.01) as p from G e1, G e2 where e1.v = e2.u group by e1.u;
+
+set aconf_threads = 4;
+
+create table P4 as select e1.u, aconf(.05,.01) as p from G e1, G e2 where e1.v = e2.u group by e1.u;
+
+reset aconf_threads;
+reset aconf_seed;
+
+create table C as select e1.u, conf() as p from G e1, G e2 where e1.v = e2.u group by e1.u;
+
+--every group has the same result with any number of threads
+select count(*) as groups, 
+       sum(case when P1.p = P2.p and P1.p = P4.p then 1 else 0 end) as same_result,
+       sum(case when abs(P1.p - C.p) <= 0.1 * C.p then 1 else 0 end) as close_to_conf
+from P1, P2, P4, C where P1.u = P2.u and P1.u = P4.u and P1.u = C.u;
+
+drop table edges;
+drop table G;
+drop table P1;
+drop table P2;
+drop table P4;
+drop table C;
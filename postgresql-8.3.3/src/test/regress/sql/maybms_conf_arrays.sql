@@ -0,0 +1,22 @@
+--test for conf(), tconf() and aconf() on more triples of condition columns
+--than the former fixed-arity functions took
+
+create table c (k integer, v integer, w float4);
+
+insert into c select k, 1, 9 from generate_series(1, 25) k;
+insert into c select k, 2, 1 from generate_series(1, 25) k;
+
+create table r as repair key k in c weight by w;
+
+--25 triples of condition columns on 25 variables, 0.9^25 = 0.071790
+select round(conf()::numeric, 4) as conf25 from r r1, r r2, r r3, r r4, r r5, r r6, r r7, r r8, r r9, r r10, r r11, r r12, r r13, r r14, r r15, r r16, r r17, r r18, r r19, r r20, r r21, r r22, r r23, r r24, r r25 where r1.k = 1 and r1.v = 1 and r2.k = 2 and r2.v = 1 and r3.k = 3 and r3.v = 1 and r4.k = 4 and r4.v = 1 and r5.k = 5 and r5.v = 1 and r6.k = 6 and r6.v = 1 and r7.k = 7 and r7.v = 1 and r8.k = 8 and r8.v = 1 and r9.k = 9 and r9.v = 1 and r10.k = 10 and r10.v = 1 and r11.k = 11 and r11.v = 1 and r12.k = 12 and r12.v = 1 and r13.k = 13 and r13.v = 1 and r14.k = 14 and r14.v = 1 and r15.k = 15 and r15.v = 1 and r16.k = 16 and r16.v = 1 and r17.k = 17 and r17.v = 1 and r18.k = 18 and r18.v = 1 and r19.k = 19 and r19.v = 1 and r20.k = 20 and r20.v = 1 and r21.k = 21 and r21.v = 1 and r22.k = 22 and r22.v = 1 and r23.k = 23 and r23.v = 1 and r24.k = 24 and r24.v = 1 and r25.k = 25 and r25.v = 1;
+
+select round(tconf()::numeric, 4) as tconf25 from r r1, r r2, r r3, r r4, r r5, r r6, r r7, r r8, r r9, r r10, r r11, r r12, r r13, r r14, r r15, r r16, r r17, r r18, r r19, r r20, r r21, r r22, r r23, r r24, r r25 where r1.k = 1 and r1.v = 1 and r2.k = 2 and r2.v = 1 and r3.k = 3 and r3.v = 1 and r4.k = 4 and r4.v = 1 and r5.k = 5 and r5.v = 1 and r6.k = 6 and r6.v = 1 and r7.k = 7 and r7.v = 1 and r8.k = 8 and r8.v = 1 and r9.k = 9 and r9.v = 1 and r10.k = 10 and r10.v = 1 and r11.k = 11 and r11.v = 1 and r12.k = 12 and r12.v = 1 and r13.k = 13 and r13.v = 1 and r14.k = 14 and r14.v = 1 and r15.k = 15 and r15.v = 1 and r16.k = 16 and r16.v = 1 and r17.k = 17 and r17.v = 1 and r18.k = 18 and r18.v = 1 and r19.k = 19 and r19.v = 1 and r20.k = 20 and r20.v = 1 and r21.k = 21 and r21.v = 1 and r22.k = 22 and r22.v = 1 and r23.k = 23 and r23.v = 1 and r24.k = 24 and r24.v = 1 and r25.k = 25 and r25.v = 1;
+
+select aconf(0.05, 0.05) between 0.06 and 0.085 as aconf_ok from r r1, r r2, r r3, r r4, r r5, r r6, r r7, r r8, r r9, r r10, r r11, r r12, r r13, r r14, r r15, r r16, r r17, r r18, r r19, r r20, r r21, r r22, r r23, r r24, r r25 where r1.k = 1 and r1.v = 1 and r2.k = 2 and r2.v = 1 and r3.k = 3 and r3.v = 1 and r4.k = 4 and r4.v = 1 and r5.k = 5 and r5.v = 1 and r6.k = 6 and r6.v = 1 and r7.k = 7 and r7.v = 1 and r8.k = 8 and r8.v = 1 and r9.k = 9 and r9.v = 1 and r10.k = 10 and r10.v = 1 and r11.k = 11 and r11.v = 1 and r12.k = 12 and r12.v = 1 and r13.k = 13 and r13.v = 1 and r14.k = 14 and r14.v = 1 and r15.k = 15 and r15.v = 1 and r16.k = 16 and r16.v = 1 and r17.k = 17 and r17.v = 1 and r18.k = 18 and r18.v = 1 and r19.k = 19 and r19.v = 1 and r20.k = 20 and r20.v = 1 and r21.k = 21 and r21.v = 1 and r22.k = 22 and r22.v = 1 and r23.k = 23 and r23.v = 1 and r24.k = 24 and r24.v = 1 and r25.k = 25 and r25.v = 1;
+
+--25 triples of condition columns on the same variable
+select r1.v, round(conf()::numeric, 4) as conf25 from r r1, r r2, r r3, r r4, r r5, r r6, r r7, r r8, r r9, r r10, r r11, r r12, r r13, r r14, r r15, r r16, r r17, r r18, r r19, r r20, r r21, r r22, r r23, r r24, r r25 where r1.k = 1 and r2.k = 1 and r3.k = 1 and r4.k = 1 and r5.k = 1 and r6.k = 1 and r7.k = 1 and r8.k = 1 and r9.k = 1 and r10.k = 1 and r11.k = 1 and r12.k = 1 and r13.k = 1 and r14.k = 1 and r15.k = 1 and r16.k = 1 and r17.k = 1 and r18.k = 1 and r19.k = 1 and r20.k = 1 and r21.k = 1 and r22.k = 1 and r23.k = 1 and r24.k = 1 and r25.k = 1 group by r1.v;
+
+drop table c;
+drop table r;
@@ -0,0 +1,60 @@
+--test for the component cache of exact conf()
+
+create table node (n integer);
+insert into node values (1), (2), (3), (4), (5);
+
+create table inout (bit integer, p float);
+insert into inout values (1, 0.5), (0, 0.5);
+
+create table total_order as
+(
+   select n1.n as u, n2.n as v
+   from node n1, node n2
+   where n1.n < n2.n
+);
+
+create table to_subset as
+(
+   repair key u,v
+   in (select * from total_order, inout)
+   weight by p
+);
+
+create table edge0 as (select u,v from to_subset where bit=1);
+
+--the probability of a triangle in RANDGRAPH(5) is 0.621094
+select conf() as triangle_prob
+from   edge0 e1, edge0 e2, edge0 e3
+where  e1.v = e2.u and e2.v = e3.v and e1.u = e3.u
+and    e1.u < e2.u and e2.u < e3.v;
+
+--the probability of a 4-clique in RANDGRAPH(5) is 0.0644531
+select conf() as fourclique_prob
+from   edge0 e1, edge0 e2, edge0 e3, edge0 e4, edge0 e5, edge0 e6
+where  e1.v = e2.u and e2.v = e3.u and e1.u = e4.u and e4.v = e2.v
+and    e5.u = e2.u and e5.v = e3.v and e6.u = e1.u and e6.v = e3.v
+and    e1.u < e2.u and e2.u < e3.u and e3.u < e3.v;
+
+--a cache that is too small for all components evicts entries
+set conf_cache_size = 1;
+
+select conf() as triangle_prob
+from   edge0 e1, edge0 e2, edge0 e3
+where  e1.v = e2.u and e2.v = e3.v and e1.u = e3.u
+and    e1.u < e2.u and e2.u < e3.v;
+
+--the cache is disabled
+set conf_cache_size = 0;
+
+select conf() as triangle_prob
+from   edge0 e1, edge0 e2, edge0 e3
+where  e1.v = e2.u and e2.v = e3.v and e1.u = e3.u
+and    e1.u < e2.u and e2.u < e3.v;
+
+reset conf_cache_size;
+
+drop table node;
+drop table inout;
+drop table total_order;
+drop table to_subset;
+drop table edge0;
@@ -0,0 +1,20 @@
+--test for conf() and aconf() on lineage that exceeds conf_work_mem
+
+create table s as select i from generate_series(1, 20000) i;
+
+create table T as pick tuples from s independently with probability 0.00005;
+
+--the probability that T is not empty is 0.632130
+select round(conf()::numeric, 2) as nonempty_prob from T;
+
+--the lineage is written to temporary files and split into parts
+set conf_work_mem = 64;
+
+select round(conf()::numeric, 2) as nonempty_prob from T;
+
+select aconf(0.1, 0.01) between 0.5 and 0.8 as nonempty_prob_ok from T;
+
+reset conf_work_mem;
+
+drop table s;
+drop table T;
@@ -0,0 +1,23 @@
+--test for conf() with hashed and sorted grouping
+
+create table r (k int, v varchar, p int);
+insert into r values (1, 'a', 1), (1, 'b', 3), (2, 'a', 1), (2, 'b', 1);
+
+create table U as repair key k in r weight by p;
+
+--the lineage of the groups is collected in a hash table
+set enable_sort = off;
+
+select v, conf() from U group by v;
+
+reset enable_sort;
+
+--the lineage of the groups is sorted
+set enable_hashagg = off;
+
+select v, conf() from U group by v;
+
+reset enable_hashagg;
+
+drop table r;
+drop table U;
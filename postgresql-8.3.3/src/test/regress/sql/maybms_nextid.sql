@@ -0,0 +1,10 @@
+--test for the variable and domain IDs reserved in blocks
+
+select nextid('varid') as id;
+select nextid('varid') as id;
+
+--the backend has reserved the IDs up to 1024
+select last_value from varid;
+
+--nextval() takes the reserved IDs as well
+select nextval('varid') as id;
@@ -0,0 +1,48 @@
+--test for prepared and repeated conf() of hierarchical queries
+
+create table r0 (a integer);
+insert into r0 values (1), (2);
+create table s0 (a integer, b integer);
+insert into s0 values (1, 1), (1, 2), (2, 1);
+create table t0 (a integer);
+insert into t0 values (1);
+
+create table r as pick tuples from r0 independently with probability 0.5;
+create table s as pick tuples from s0 independently with probability 0.5;
+create table t as pick tuples from t0 independently with probability 0.5;
+
+prepare q as select conf() as prob from r, s where r.a = s.a;
+execute q;
+
+--a query with another signature does not change the one of q
+select conf() as prob from r, s, t where r.a = s.a and s.a = t.a;
+execute q;
+deallocate q;
+
+--the second run takes the rewritten query from the cache
+select conf() as prob from r, s where r.a = s.a;
+select conf() as prob from r, s where r.a = s.a;
+
+--a relation dropped and created again is looked up again
+delete from r0 where a = 2;
+drop table r;
+create table r as pick tuples from r0 independently with probability 0.5;
+select conf() as prob from r, s where r.a = s.a;
+
+--a relation created later with the same name in the search_path is found
+insert into r0 values (2);
+create schema maybms_cache;
+set search_path = maybms_cache, public;
+select conf() as prob from r, s where r.a = s.a;
+create table maybms_cache.r as pick tuples from r0 independently with probability 0.5;
+select conf() as prob from r, s where r.a = s.a;
+reset search_path;
+drop table maybms_cache.r;
+drop schema maybms_cache;
+
+drop table r0;
+drop table s0;
+drop table t0;
+drop table r;
+drop table s;
+drop table t;
@@ -0,0 +1,44 @@
+--test for building a repair-key in hash partitions of the key
+create table s (k integer, v integer, w float);
+insert into s values (1, 1, 1), (1, 2, 3), (2, 1, 1), (2, 2, 1),
+                     (3, 1, 2), (3, 2, 2), (4, 1, 1), (4, 2, 4);
+
+--the partitions together give the same probabilities as one repair-key
+create table r as repair key k in s partition 1 of 2 weight by w;
+insert into r repair key k in s partition 2 of 2 weight by w;
+select k, v, conf() as prob from r group by k, v order by k, v;
+
+select conf() as prob from (repair key k in s partition 1 of 1) r0 where v = 1;
+
+repair key k in s partition 3 of 2;
+
+--every partition is non-empty, the partitions share no key, and together
+--they are the unpartitioned repair-key
+create table r1 as repair key k in s partition 1 of 2 weight by w;
+create table r2 as repair key k in s partition 2 of 2 weight by w;
+create table r0 as repair key k in s weight by w;
+create table c1 as select k, v, conf() as prob from r1 group by k, v;
+create table c2 as select k, v, conf() as prob from r2 group by k, v;
+create table c0 as select k, v, conf() as prob from r0 group by k, v;
+
+select 1 as part, count(*) as tuples, count(distinct k) as keys from c1
+union all
+select 2, count(*), count(distinct k) from c2
+order by part;
+
+select count(*) as shared_keys from c1, c2 where c1.k = c2.k;
+
+select (select count(*) from c0) as unpartitioned, count(*) as matched,
+       sum(case when u.prob = c0.prob then 1 else 0 end) as same_prob
+from (select * from c1 union all select * from c2) u, c0
+where u.k = c0.k and u.v = c0.v;
+
+drop table c0;
+drop table c1;
+drop table c2;
+drop table r0;
+drop table r1;
+drop table r2;
+
+drop table r;
+drop table s;
@@ -0,0 +1,14 @@
+--test that the rewriting sees the columns of an altered U-relation
+create table s (k integer, v integer);
+insert into s values (1, 1), (1, 2), (2, 1), (2, 2);
+create table r as repair key k in s;
+select conf() as prob from r where k = 1 and v = 2;
+
+alter table r add column w integer;
+select conf() as prob from r where k = 1 and w is null;
+
+alter table r drop column v;
+select r1.w, conf() as prob from r r1, r r2 where r1.k = 1 and r2.k = 2 group by r1.w;
+
+drop table r;
+drop table s;
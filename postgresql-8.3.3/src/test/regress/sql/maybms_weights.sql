@@ -37,3 +37,18 @@ insert into r values (1,1,1,-0.000);
 repair key a,b in r weight by w;
 
 drop table r;
+
+--copies of a tuple with different weights are different alternatives
+create table r(a int, b int);
+
+insert into r values (1,1);
+insert into r values (1,1);
+insert into r values (1,2);
+
+create sequence rk_weight;
+create table rk as repair key a in r weight by nextval('rk_weight');
+select count(distinct _d0) as alternatives, round(sum(_p0)::numeric, 4) as prob from rk;
+
+drop table rk;
+drop sequence rk_weight;
+drop table r;
@@ -0,0 +1,27 @@
+--test for the world-set descriptor type wsd
+
+select '{ 5:1:0.5, 3:2:0.25, 5:1:0.5 }'::wsd as w;
+select wsd(array[3, 1], array[1, 2], array[0.5, 0.25]::float4[]) as w;
+select '{1:1:0.5}'::wsd && '{2:1:0.5}'::wsd as w;
+select '{1:1:0.5}'::wsd &? '{2:1:0.5}'::wsd as consistent;
+select '{1:1:0.5}'::wsd &? '{1:2:0.5}'::wsd as consistent;
+select wsd_prob('{1:1:0.5,2:1:0.5}') as prob;
+select wsd_prob('{1:1:0.5}'::wsd && '{1:2:0.5}'::wsd) as prob;
+select '{1:2}'::wsd;
+
+--conf() and aconf() of a join of U-relations take the condition as a wsd
+create table c (k integer, v integer);
+insert into c values (1, 1), (1, 2), (2, 1), (2, 2);
+create table r as repair key k in c;
+select r1.v, conf() as prob from r r1, r r2 where r1.k = 1 and r2.k = 2 group by r1.v;
+select conf() as prob from r r1, r r2 where r1.k = 1 and r2.k = 2 and r1.v = r2.v;
+select aconf(0.05, 0.05) between 0.4 and 0.6 as aconf_ok from r r1, r r2 where r1.k = 1 and r2.k = 2 and r1.v = r2.v;
+--self-joins repeat the mappings of a tuple in the conditions of some tuples
+select conf() as prob from r r1, r r2;
+select r1.v, conf() as prob from r r1, r r2 where r1.v = r2.v group by r1.v order by r1.v;
+drop table c;
+drop table r;
+
+--the consistency check of the conditions of two tuples of urelations
+select array[1, 1, 2, 1] &? array[2, 1, 3, 2] as consistent;
+select array[1, 1, 2, 1] &? array[3, 2, 2, 2] as consistent;
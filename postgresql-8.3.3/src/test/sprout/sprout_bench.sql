@@ -0,0 +1,71 @@
+--
+-- Benchmark of the SPROUT aggregation of conf() on hierarchical queries.
+--
+-- Each relation has 200000 tuples, which are split into 50000 groups of 4
+-- tuples or into 10 groups of 20000 tuples.  All queries are hierarchical
+-- and without self-joins, so conf() is computed by SPROUT.
+--
+
+\set ON_ERROR_STOP 1
+
+DROP TABLE IF EXISTS r, s, t;
+
+--
+-- Many small groups
+--
+CREATE TABLE r AS PICK TUPLES FROM
+	(SELECT i % 50000 AS g, i / 50000 AS a FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+CREATE TABLE s AS PICK TUPLES FROM
+	(SELECT i % 50000 AS g, i / 50000 % 2 AS a, i / 100000 AS b
+	 FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+CREATE TABLE t AS PICK TUPLES FROM
+	(SELECT i % 50000 AS g, i / 50000 % 2 AS a, i / 100000 AS c
+	 FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+ANALYZE r;
+ANALYZE s;
+ANALYZE t;
+
+\timing
+SELECT count(*), sum(p) FROM
+	(SELECT r.g, conf() AS p FROM r, s
+	 WHERE r.g = s.g AND r.a = s.a GROUP BY r.g) x;
+SELECT count(*), sum(p) FROM
+	(SELECT r.g, conf() AS p FROM r, s, t
+	 WHERE r.g = s.g AND s.g = t.g AND r.a = s.a AND s.a = t.a
+	 GROUP BY r.g) x;
+\timing
+
+DROP TABLE r, s, t;
+
+--
+-- Few large groups
+--
+CREATE TABLE r AS PICK TUPLES FROM
+	(SELECT i % 10 AS g, i / 10 AS a FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+CREATE TABLE s AS PICK TUPLES FROM
+	(SELECT i % 10 AS g, i / 10 % 10000 AS a, i / 100000 AS b
+	 FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+CREATE TABLE t AS PICK TUPLES FROM
+	(SELECT i % 10 AS g, i / 10 % 10000 AS a, i / 100000 AS c
+	 FROM generate_series(0, 199999) i)
+	INDEPENDENTLY WITH PROBABILITY 0.5;
+ANALYZE r;
+ANALYZE s;
+ANALYZE t;
+
+\timing
+SELECT count(*), sum(p) FROM
+	(SELECT r.g, conf() AS p FROM r, s
+	 WHERE r.g = s.g AND r.a = s.a GROUP BY r.g) x;
+SELECT count(*), sum(p) FROM
+	(SELECT r.g, conf() AS p FROM r, s, t
+	 WHERE r.g = s.g AND s.g = t.g AND r.a = s.a AND s.a = t.a
+	 GROUP BY r.g) x;
+\timing
+
+DROP TABLE r, s, t;
@@ -0,0 +1,344 @@
+/*-------------------------------------------------------------------------
+ *
+ * tconf_bench.c
+ *	  	Microbenchmark of the tconf() kernels in backend/maybms/tupleconf.c.
+ *
+ *	  product() and product_ge() are called through the function manager
+ *	  interface on one million random tuples, with 1 to 10 relations or
+ *	  triples of condition columns per tuple passed as arrays, and the cost
+ *	  per tuple is reported, for product_ge() also with the construction of
+ *	  its argument arrays. The results of product_ge() are checked against a reference
+ *	  that looks for shared and contradicting variables directly.
+ *
+ *
+ * Copyright (c) 2008, MayBMS Development Group
+ *
+ *-------------------------------------------------------------------------
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <sys/time.h>
+
+#include "postgres.h"
+#include "catalog/pg_type.h"
+#include "fmgr.h"
+#include "maybms/conf_comp.h"
+#include "utils/array.h"
+
+#define NTUPLES 1000000
+#define MAXTRIPLES 10
+
+/*
+ * float4 is passed by reference, so the backend pallocs the result of every
+ * call in the per-tuple memory context.  Here it is kept in a static slot,
+ * which is overwritten by the next call.
+ */
+static float4 result_slot;
+
+Datum
+Float4GetDatum(float4 X)
+{
+	result_slot = X;
+	return PointerGetDatum(&result_slot);
+}
+
+/*
+ * The backend functions used by tupleconf.c and condvec.c.  The arrays built
+ * here are never toasted, and the kernels do not palloc.
+ */
+MemoryContext CurrentMemoryContext = NULL;
+
+void *
+MemoryContextAlloc(MemoryContext context, Size size)
+{
+	void *p = malloc(size > 0 ? size : 1);
+
+	if (p == NULL)
+	{
+		fprintf(stderr, "out of memory\n");
+		exit(1);
+	}
+
+	return p;
+}
+
+void
+pfree(void *pointer)
+{
+	free(pointer);
+}
+
+struct varlena *
+pg_detoast_datum(struct varlena * datum)
+{
+	return datum;
+}
+
+void
+elog_start(const char *filename, int lineno, const char *funcname)
+{
+}
+
+void
+elog_finish(int elevel, const char *fmt,...)
+{
+	va_list		ap;
+
+	va_start(ap, fmt);
+	vfprintf(stderr, fmt, ap);
+	va_end(ap);
+	fputc('\n', stderr);
+	exit(1);
+}
+
+/*
+ * A one-dimensional array without nulls of at most MAXTRIPLES elements, laid
+ * out like the result of the ARRAY[] constructor of the rewritten queries.
+ */
+typedef union
+{
+	ArrayType	hdr;
+	char		space[ARR_OVERHEAD_NONULLS(1) + MAXTRIPLES * sizeof(int32)];
+	double		align;
+} condArray;
+
+static void
+init_array(condArray *a, Oid elemtype, int n)
+{
+	SET_VARSIZE(&a->hdr, ARR_OVERHEAD_NONULLS(1) + n * sizeof(int32));
+	a->hdr.ndim = 1;
+	a->hdr.dataoffset = 0;
+	a->hdr.elemtype = elemtype;
+	ARR_DIMS(&a->hdr)[0] = n;
+	ARR_LBOUND(&a->hdr)[0] = 1;
+}
+
+/* The arguments of all tuples */
+static int32 vars[NTUPLES][MAXTRIPLES];
+static int32 rngs[NTUPLES][MAXTRIPLES];
+static float4 probs[NTUPLES][MAXTRIPLES];
+
+/* Reference implementation of product_ge() */
+
+static float4
+ref_product_ge(int t, int n)
+{
+	float4 result = 1.0;
+	int i, j;
+
+	for (j = 0; j < n; j++)
+	{
+		for (i = 0; i < j; i++)
+			if (vars[t][i] == vars[t][j])
+				break;
+
+		if (i == j)
+			result *= probs[t][j];
+		else if (rngs[t][i] != rngs[t][j])
+			return 0;
+	}
+
+	return result;
+}
+
+/* Benchmark driver */
+
+static double
+get_time(void)
+{
+	struct timeval tv;
+
+	gettimeofday(&tv, NULL);
+
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/*
+ * Generate the tuples.  The variables of a tuple are drawn from 2n values, so
+ * that tuples often share variables, and half of the shared variables
+ * contradict each other.
+ */
+static void
+fill_random(int n)
+{
+	int t, j;
+
+	for (t = 0; t < NTUPLES; t++)
+		for (j = 0; j < n; j++)
+		{
+			vars[t][j] = 1 + rand() % (2 * n);
+			rngs[t][j] = 1 + rand() % 2;
+			probs[t][j] = (float4) (rand() % 1000 + 1) / 1000;
+		}
+}
+
+static void
+bench_product(int n)
+{
+	FunctionCallInfoData fcinfo;
+	condArray p;
+	double start, sum = 0;
+	int t;
+
+	init_array(&p, FLOAT4OID, n);
+
+	fcinfo.nargs = 1;
+	fcinfo.arg[0] = PointerGetDatum(&p);
+	fcinfo.argnull[0] = false;
+
+	start = get_time();
+
+	for (t = 0; t < NTUPLES; t++)
+	{
+		memcpy(ARR_DATA_PTR(&p.hdr), probs[t], n * sizeof(float4));
+
+		sum += DatumGetFloat4(product(&fcinfo));
+	}
+
+	printf("%-12s %8d %12.1f %16.4f\n", "product", n,
+		   (get_time() - start) * 1e9 / NTUPLES, sum);
+}
+
+static void
+bench_product_ge(int n)
+{
+	FunctionCallInfoData fcinfo;
+	condArray v, r, p;
+	double start, sum = 0;
+	int t;
+
+	init_array(&v, INT4OID, n);
+	init_array(&r, INT4OID, n);
+	init_array(&p, FLOAT4OID, n);
+
+	fcinfo.nargs = 3;
+	fcinfo.arg[0] = PointerGetDatum(&v);
+	fcinfo.arg[1] = PointerGetDatum(&r);
+	fcinfo.arg[2] = PointerGetDatum(&p);
+	fcinfo.argnull[0] = fcinfo.argnull[1] = fcinfo.argnull[2] = false;
+
+	start = get_time();
+
+	for (t = 0; t < NTUPLES; t++)
+	{
+		memcpy(ARR_DATA_PTR(&v.hdr), vars[t], n * sizeof(int32));
+		memcpy(ARR_DATA_PTR(&r.hdr), rngs[t], n * sizeof(int32));
+		memcpy(ARR_DATA_PTR(&p.hdr), probs[t], n * sizeof(float4));
+
+		sum += DatumGetFloat4(product_ge(&fcinfo));
+	}
+
+	printf("%-12s %8d %12.1f %16.4f\n", "product_ge", n,
+		   (get_time() - start) * 1e9 / NTUPLES, sum);
+
+	/* Check the results */
+	for (t = 0; t < NTUPLES; t++)
+	{
+		float4 expected = ref_product_ge(t, n);
+		float4 actual;
+
+		memcpy(ARR_DATA_PTR(&v.hdr), vars[t], n * sizeof(int32));
+		memcpy(ARR_DATA_PTR(&r.hdr), rngs[t], n * sizeof(int32));
+		memcpy(ARR_DATA_PTR(&p.hdr), probs[t], n * sizeof(float4));
+
+		actual = DatumGetFloat4(product_ge(&fcinfo));
+
+		if (actual != expected)
+		{
+			fprintf(stderr, "product_ge on %d triples: tuple %d has probability %g, expected %g\n",
+					n, t, actual, expected);
+			exit(1);
+		}
+	}
+}
+
+/*
+ * Build a condition array of a tuple as the executor evaluates the ARRAY[]
+ * constructor: the element datums and nulls are palloc'ed, and then the array
+ * itself by construct_md_array().
+ */
+static ArrayType *
+build_array(Oid elemtype, int n, const int32 *elems)
+{
+	Datum *dvalues = (Datum *) palloc(n * sizeof(Datum));
+	bool *dnulls = (bool *) palloc(n * sizeof(bool));
+	ArrayType *array;
+	int i;
+
+	for (i = 0; i < n; i++)
+	{
+		dvalues[i] = Int32GetDatum(elems[i]);
+		dnulls[i] = false;
+	}
+
+	array = (ArrayType *) palloc(ARR_OVERHEAD_NONULLS(1) + n * sizeof(int32));
+	SET_VARSIZE(array, ARR_OVERHEAD_NONULLS(1) + n * sizeof(int32));
+	array->ndim = 1;
+	array->dataoffset = 0;
+	array->elemtype = elemtype;
+	ARR_DIMS(array)[0] = n;
+	ARR_LBOUND(array)[0] = 1;
+
+	for (i = 0; i < n; i++)
+		((int32 *) ARR_DATA_PTR(array))[i] = DatumGetInt32(dvalues[i]);
+
+	pfree(dvalues);
+	pfree(dnulls);
+
+	return array;
+}
+
+/*
+ * Time product_ge() including the construction of its three arrays for every
+ * tuple, which the executor does before the call.
+ */
+static void
+bench_product_ge_arrays(int n)
+{
+	FunctionCallInfoData fcinfo;
+	double start, sum = 0;
+	int t;
+
+	fcinfo.nargs = 3;
+	fcinfo.argnull[0] = fcinfo.argnull[1] = fcinfo.argnull[2] = false;
+
+	start = get_time();
+
+	for (t = 0; t < NTUPLES; t++)
+	{
+		fcinfo.arg[0] = PointerGetDatum(build_array(INT4OID, n, vars[t]));
+		fcinfo.arg[1] = PointerGetDatum(build_array(INT4OID, n, rngs[t]));
+		fcinfo.arg[2] = PointerGetDatum(build_array(FLOAT4OID, n, (int32 *) probs[t]));
+
+		sum += DatumGetFloat4(product_ge(&fcinfo));
+
+		pfree(DatumGetPointer(fcinfo.arg[0]));
+		pfree(DatumGetPointer(fcinfo.arg[1]));
+		pfree(DatumGetPointer(fcinfo.arg[2]));
+	}
+
+	printf("%-12s %8d %12.1f %16.4f\n", "+ arrays", n,
+		   (get_time() - start) * 1e9 / NTUPLES, sum);
+}
+
+int
+main(int argc, char **argv)
+{
+	int n;
+
+	srand(42);
+
+	printf("%-12s %8s %12s %16s\n", "kernel", "n", "ns/tuple", "sum");
+
+	for (n = 1; n <= MAXTRIPLES; n++)
+	{
+		fill_random(n);
+		bench_product(n);
+		bench_product_ge(n);
+		bench_product_ge_arrays(n);
+	}
+
+	return 0;
+}